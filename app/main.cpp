@@ -1,4 +1,38 @@
 #include "illuminate/illuminate.h"
+#include <cstdio>
+#include <cstring>
 int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+  if (argc > 1 && strcmp(argv[1], "--bake-graph") == 0) {
+    if (argc != 5) {
+      printf("usage: %s --bake-graph <render_graph.json> <material.json> <dst>\n", argv[0]);
+      return 1;
+    }
+    return illuminate::BakeRenderGraph(argv[2], argv[3], argv[4]) ? 0 : 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "--validate-graph") == 0) {
+    const bool fast_fail = argc > 2 && strcmp(argv[2], "--fast-fail") == 0;
+    const int path_index = fast_fail ? 3 : 2;
+    if (argc <= path_index || argc > path_index + 2) {
+      printf("usage: %s --validate-graph [--fast-fail] <render_graph.json> [material.json]\n", argv[0]);
+      return 1;
+    }
+    const char* material_json_path = (argc == path_index + 2) ? argv[path_index + 1] : nullptr;
+    return illuminate::ValidateRenderGraphJson(argv[path_index], material_json_path, fast_fail) ? 0 : 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "--export-graph") == 0) {
+    if (argc != 6 && argc != 7) {
+      printf("usage: %s --export-graph <render_graph.json> <material.json> <dst.dot> <dst_trace.json> [pass_cost.json]\n", argv[0]);
+      return 1;
+    }
+    const char* cost_json_path = (argc == 7) ? argv[6] : nullptr;
+    return illuminate::ExportRenderGraph(argv[2], argv[3], cost_json_path, argv[4], argv[5]) ? 0 : 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "--compare-barriers") == 0) {
+    if (argc != 5) {
+      printf("usage: %s --compare-barriers <render_graph.json> <material.json> <dst_report.json>\n", argv[0]);
+      return 1;
+    }
+    return illuminate::ExportBarrierModeComparison(argv[2], argv[3], argv[4]) ? 0 : 1;
+  }
   return 0;
 }
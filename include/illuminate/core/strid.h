@@ -1,17 +1,125 @@
 #ifndef ILLUMINATE_CORE_STRID_H
 #define ILLUMINATE_CORE_STRID_H
+#include <cstdint>
+#include <cstring>
+#include <string_view>
 #include <type_traits>
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
 namespace illuminate {
+#ifdef USE_64BIT_STR_HASH
+using StrHash = uint64_t;
+#else
 using StrHash = uint32_t;
-static const StrHash kStrHashPrime = 31;
-// https://xueyouchao.github.io/2016/11/16/CompileTimeString/
+#endif
+namespace strid_internal {
+// wyhash final4 (https://github.com/wangyi-fudan/wyhash, public domain) written as constexpr,
+// so that SID() at compile time and CalcStrHash() at runtime return the same value.
+// input is consumed 4/8 bytes at a time with 64x64->128 multiplications instead of a byte-at-a-time polynomial.
+constexpr uint64_t kSecret[] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 Uint128; // __extension__ keeps -Wpedantic quiet about the non-standard type.
+#endif
+constexpr inline void Mum(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+  const auto r = static_cast<Uint128>(*a) * *b;
+  *a = static_cast<uint64_t>(r);
+  *b = static_cast<uint64_t>(r >> 64);
+#else
+  if (!std::is_constant_evaluated()) {
+    *a = _umul128(*a, *b, b);
+    return;
+  }
+  const uint64_t ha = *a >> 32, hb = *b >> 32, la = static_cast<uint32_t>(*a), lb = static_cast<uint32_t>(*b);
+  const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  const uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+constexpr inline uint64_t Mix(uint64_t a, uint64_t b) {
+  Mum(&a, &b);
+  return a ^ b;
+}
+template <uint32_t N>
+constexpr inline uint64_t Read(const char* const p) {
+  if (!std::is_constant_evaluated()) {
+    std::conditional_t<N == 8, uint64_t, uint32_t> v{};
+    memcpy(&v, p, N);
+    return v;
+  }
+  uint64_t v = 0;
+  for (uint32_t i = 0; i < N; i++) {
+    v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (i * 8);
+  }
+  return v;
+}
+constexpr inline uint64_t Read3(const char* const p, const size_t len) {
+  return (static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16) | (static_cast<uint64_t>(static_cast<uint8_t>(p[len >> 1])) << 8) | static_cast<uint8_t>(p[len - 1]);
+}
+constexpr inline uint64_t Hash64(const char* p, const size_t len, uint64_t seed = 0) {
+  seed ^= Mix(seed ^ kSecret[0], kSecret[1]);
+  uint64_t a = 0, b = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (Read<4>(p) << 32) | Read<4>(p + ((len >> 3) << 2));
+      b = (Read<4>(p + len - 4) << 32) | Read<4>(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = Read3(p, len);
+    }
+  } else {
+    auto i = len;
+    if (i >= 48) {
+      auto see1 = seed, see2 = seed;
+      do {
+        seed = Mix(Read<8>(p) ^ kSecret[1], Read<8>(p + 8) ^ seed);
+        see1 = Mix(Read<8>(p + 16) ^ kSecret[2], Read<8>(p + 24) ^ see1);
+        see2 = Mix(Read<8>(p + 32) ^ kSecret[3], Read<8>(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i >= 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = Mix(Read<8>(p) ^ kSecret[1], Read<8>(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = Read<8>(p + i - 16);
+    b = Read<8>(p + i - 8);
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  Mum(&a, &b);
+  return Mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+}
+constexpr inline StrHash HashStr(const std::string_view str) {
+  const auto hash = Hash64(str.data(), str.size());
+#ifdef USE_64BIT_STR_HASH
+  return hash;
+#else
+  return static_cast<StrHash>(hash ^ (hash >> 32));
+#endif
+}
+} // namespace strid_internal
 template <size_t N>
-constexpr inline StrHash CompileTimeStrHash(const char (&str)[N], const StrHash prime = kStrHashPrime, const size_t len = N-1)
+constexpr inline StrHash CompileTimeStrHash(const char (&str)[N])
+{
+  return strid_internal::HashStr(std::string_view(str, N - 1));
+}
+constexpr inline StrHash CompileTimeStrHash(const std::string_view str)
 {
-  return (len <= 1) ? static_cast<std::make_unsigned_t<char>>(str[0]) : (prime * CompileTimeStrHash(str, prime, len-1) + static_cast<std::make_unsigned_t<char>>(str[len-1]));
+  return strid_internal::HashStr(str);
 }
-StrHash CalcStrHash(const char* const str, const StrHash prime = kStrHashPrime);
+StrHash CalcStrHash(const char* const str);
+inline StrHash CalcStrHash(const std::string_view str) { return strid_internal::HashStr(str); }
 StrHash CombineHash(const StrHash& a, const StrHash& b);
+// hashes arbitrary bytes, e.g. to build keys out of arrays of ids.
+inline uint64_t CalcHash64(const void* const data, const size_t bytes, const uint64_t seed = 0) { return strid_internal::Hash64(static_cast<const char*>(data), bytes, seed); }
 }
 #define SID CompileTimeStrHash
 #endif
@@ -0,0 +1,7 @@
+#ifndef ILLUMINATE_D3D12_BARRIER_MODE_COMPARISON_API_H
+#define ILLUMINATE_D3D12_BARRIER_MODE_COMPARISON_API_H
+namespace illuminate {
+// writes a json report comparing barriers of the first frame in the legacy resource state model and as enhanced barriers to dst_report_path.
+bool ExportBarrierModeComparison(const char* const render_graph_json_path, const char* const material_json_path, const char* const dst_report_path);
+}
+#endif
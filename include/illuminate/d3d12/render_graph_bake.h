@@ -0,0 +1,7 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_BAKE_API_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_BAKE_API_H
+namespace illuminate {
+// parses render graph and material json files and writes the resolved graph as a binary blob to dst_path.
+bool BakeRenderGraph(const char* const render_graph_json_path, const char* const material_json_path, const char* const dst_path);
+}
+#endif
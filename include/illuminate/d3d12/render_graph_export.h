@@ -0,0 +1,9 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_EXPORT_API_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_EXPORT_API_H
+namespace illuminate {
+// parses and compiles a render graph json file, then writes a graphviz dot graph to dst_dot_path and a chrome trace json to dst_trace_path.
+// pass times are read from cost_json_path ({"pass name": msec, ...}) if not null, and estimated otherwise.
+bool ExportRenderGraph(const char* const render_graph_json_path, const char* const material_json_path, const char* const cost_json_path,
+                       const char* const dst_dot_path, const char* const dst_trace_path);
+}
+#endif
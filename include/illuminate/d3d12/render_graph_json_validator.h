@@ -0,0 +1,8 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_JSON_VALIDATOR_API_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_JSON_VALIDATOR_API_H
+namespace illuminate {
+// validates a render graph json file, material names are checked as well if material_json_path is not null.
+// errors are logged with their json pointer paths. fast_fail stops at the first error.
+bool ValidateRenderGraphJson(const char* const render_graph_json_path, const char* const material_json_path, const bool fast_fail);
+}
+#endif
@@ -1,6 +1,10 @@
 #ifndef ILLUMINATE_H
 #define ILLUMINATE_H
 #include "core/strid.h"
+#include "d3d12/barrier_mode_comparison.h"
+#include "d3d12/render_graph_bake.h"
+#include "d3d12/render_graph_export.h"
+#include "d3d12/render_graph_json_validator.h"
 #include "math/math.h"
 #include "memory/memory_allocation.h"
 #endif
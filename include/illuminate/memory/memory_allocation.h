@@ -1,5 +1,8 @@
 #ifndef ILLUMINATE_MEMORY_ALLOCATION_H
 #define ILLUMINATE_MEMORY_ALLOCATION_H
+#include <atomic>
+#include <bit>
+#include <cassert>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
@@ -69,40 +72,71 @@ class DoubleBufferedAllocator {
   uint32_t head_index_;
   [[maybe_unused]] std::byte _pad[4]{};
 };
+// lower and higher offsets are packed in a single atomic so that both ends can be allocated from multiple threads without locks.
 class DoubleEndedLinearAllocator {
  public:
   explicit DoubleEndedLinearAllocator(const std::byte* buffer, const uint32_t size_in_byte)
       : head_(reinterpret_cast<uintptr_t>(buffer))
       , size_in_byte_(size_in_byte)
-      , offset_in_byte_lower_(0)
-      , offset_in_byte_higher_(0) {}
+      , offsets_(0) {}
   ~DoubleEndedLinearAllocator() {}
   inline void* AllocateLower(size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize) {
-    auto addr_aligned = AlignAddress(head_ + offset_in_byte_lower_, alignment_in_bytes);
-    auto offset = addr_aligned - head_ + bytes;
-    if (offset + offset_in_byte_higher_ > size_in_byte_) return nullptr;
-    offset_in_byte_lower_ = offset;
-    return reinterpret_cast<void*>(addr_aligned);
+    auto offsets = offsets_.load(std::memory_order_relaxed);
+    while (true) {
+      auto addr_aligned = AlignAddress(head_ + GetLower(offsets), alignment_in_bytes);
+      auto offset = addr_aligned - head_ + bytes;
+      if (offset + GetHigher(offsets) > size_in_byte_) return nullptr;
+      if (offsets_.compare_exchange_weak(offsets, PackOffsets(offset, GetHigher(offsets)), std::memory_order_relaxed)) {
+        return reinterpret_cast<void*>(addr_aligned);
+      }
+    }
   }
-  inline void* AllocateHigher(size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize) {
-    auto addr_aligned = AlignAddressWithoutOffset(head_ + size_in_byte_ - offset_in_byte_higher_ - bytes, alignment_in_bytes);
-    if (addr_aligned < head_ + offset_in_byte_lower_) { return nullptr; }
-    offset_in_byte_higher_ = size_in_byte_ - (addr_aligned - head_);
-    return reinterpret_cast<void*>(addr_aligned);
+  // offset_higher_before receives the higher offset the allocation started from, which tells whether it directly follows a previous one.
+  inline void* AllocateHigher(size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize, size_t* offset_higher_before = nullptr) {
+    auto offsets = offsets_.load(std::memory_order_relaxed);
+    while (true) {
+      if (GetHigher(offsets) + bytes > size_in_byte_) { return nullptr; }
+      auto addr_aligned = AlignAddressWithoutOffset(head_ + size_in_byte_ - GetHigher(offsets) - bytes, alignment_in_bytes);
+      if (addr_aligned < head_ + GetLower(offsets)) { return nullptr; }
+      if (offsets_.compare_exchange_weak(offsets, PackOffsets(GetLower(offsets), size_in_byte_ - (addr_aligned - head_)), std::memory_order_relaxed)) {
+        if (offset_higher_before != nullptr) { *offset_higher_before = GetHigher(offsets); }
+        return reinterpret_cast<void*>(addr_aligned);
+      }
+    }
   }
-  constexpr auto GetOffsetLower() const { return offset_in_byte_lower_; }
-  constexpr auto GetOffsetHigher() const { return offset_in_byte_higher_; }
-  constexpr void ResetLower() { offset_in_byte_lower_ = 0; }
-  constexpr void ResetHigher() { offset_in_byte_higher_ = 0; }
+  auto GetOffsetLower() const { return GetLower(offsets_.load(std::memory_order_relaxed)); }
+  auto GetOffsetHigher() const { return GetHigher(offsets_.load(std::memory_order_relaxed)); }
+  void ResetLower() { offsets_.fetch_and(~kLowerMask, std::memory_order_relaxed); }
+  void ResetHigher() { offsets_.fetch_and(kLowerMask, std::memory_order_relaxed); }
+  // rolls an end back to marker only if its offset still equals expected_offset, i.e. nothing has been allocated from that end since.
+  bool ResetLowerToMarker(const size_t marker, const size_t expected_offset) {
+    auto offsets = offsets_.load(std::memory_order_relaxed);
+    while (GetLower(offsets) == expected_offset) {
+      if (offsets_.compare_exchange_weak(offsets, PackOffsets(marker, GetHigher(offsets)), std::memory_order_relaxed)) { return true; }
+    }
+    return false;
+  }
+  bool ResetHigherToMarker(const size_t marker, const size_t expected_offset) {
+    auto offsets = offsets_.load(std::memory_order_relaxed);
+    while (GetHigher(offsets) == expected_offset) {
+      if (offsets_.compare_exchange_weak(offsets, PackOffsets(GetLower(offsets), marker), std::memory_order_relaxed)) { return true; }
+    }
+    return false;
+  }
+  // higher offset right after ptr was returned from AllocateHigher().
+  auto GetOffsetHigherAt(const void* ptr) const { return size_in_byte_ - (reinterpret_cast<std::uintptr_t>(ptr) - head_); }
   constexpr auto GetBufferSizeInByte() const { return size_in_byte_; }
   auto GetBuffer() const { return reinterpret_cast<std::byte*>(head_); }
  private:
+  static const uint64_t kLowerMask = 0xFFFFFFFFULL;
+  static constexpr size_t GetLower(const uint64_t offsets) { return static_cast<size_t>(offsets & kLowerMask); }
+  static constexpr size_t GetHigher(const uint64_t offsets) { return static_cast<size_t>(offsets >> 32); }
+  static constexpr uint64_t PackOffsets(const size_t lower, const size_t higher) { return static_cast<uint64_t>(lower) | (static_cast<uint64_t>(higher) << 32); }
   DoubleEndedLinearAllocator(const DoubleEndedLinearAllocator&) = delete;
   DoubleEndedLinearAllocator& operator=(const DoubleEndedLinearAllocator&) = delete;
   const std::uintptr_t head_;
   const size_t size_in_byte_;
-  size_t offset_in_byte_lower_;
-  size_t offset_in_byte_higher_;
+  std::atomic<uint64_t> offsets_;
 };
 class StackAllocator {
  public:
@@ -176,6 +210,39 @@ class MemoryAllocationJanitor {
   StackAllocator* allocator_{};
   std::uintptr_t marker_{};
 };
+// releases allocations made from the higher end of DoubleEndedLinearAllocator through the janitor.
+// allocations interleaved with other users of the same end (e.g. other threads) are kept until the allocator is reset.
+class DoubleEndedLinearAllocatorJanitor {
+ public:
+  DoubleEndedLinearAllocatorJanitor(DoubleEndedLinearAllocator* allocator)
+      : allocator_(allocator)
+      , marker_(allocator_->GetOffsetHigher())
+      , offset_begin_(marker_)
+      , offset_end_(marker_)
+  {}
+  virtual ~DoubleEndedLinearAllocatorJanitor() {
+    if (offset_end_ == offset_begin_) { return; }
+    allocator_->ResetHigherToMarker(offset_begin_, offset_end_);
+  }
+  DoubleEndedLinearAllocatorJanitor() = delete;
+  DoubleEndedLinearAllocatorJanitor(const DoubleEndedLinearAllocatorJanitor&) = delete;
+  DoubleEndedLinearAllocatorJanitor& operator=(const DoubleEndedLinearAllocatorJanitor&) = delete;
+  inline void* Allocate(size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize) {
+    size_t offset_before = 0;
+    auto ptr = allocator_->AllocateHigher(bytes, alignment_in_bytes, &offset_before);
+    if (ptr == nullptr) { return nullptr; }
+    // only the latest run of contiguous allocations can be returned.
+    if (offset_before != offset_end_) { offset_begin_ = offset_before; }
+    offset_end_ = allocator_->GetOffsetHigherAt(ptr);
+    return ptr;
+  }
+  constexpr auto GetMarker() const { return marker_; }
+ private:
+  DoubleEndedLinearAllocator* allocator_{};
+  size_t marker_{};
+  size_t offset_begin_{};
+  size_t offset_end_{};
+};
 template <typename A, size_t N>
 class TemporalAllocator {
  public:
@@ -188,6 +255,176 @@ class TemporalAllocator {
   A allocator_;
   std::byte buffer_[N];
 };
+// fixed size blocks carved from pages of a parent allocator (e.g. LinearAllocator or scene arena).
+// freed blocks are linked through their own storage, so both Allocate and Free are O(1).
+// pages are chained and reused after Reset; they return to the parent only when the parent itself is reset.
+template <typename A>
+class BlockPool {
+ public:
+  BlockPool(A* parent, const size_t block_size_in_bytes, const uint32_t block_num_per_page, const size_t block_alignment_in_bytes)
+      : parent_(parent)
+      , block_size_in_bytes_(AlignAddress(block_size_in_bytes < sizeof(FreeBlock) ? sizeof(FreeBlock) : block_size_in_bytes, block_alignment_in_bytes))
+      , block_alignment_in_bytes_(block_alignment_in_bytes)
+      , block_num_per_page_(block_num_per_page)
+  {}
+  ~BlockPool() {}
+  BlockPool() = delete;
+  BlockPool(const BlockPool&) = delete;
+  BlockPool& operator=(const BlockPool&) = delete;
+  void* Allocate() {
+    if (free_list_ != nullptr) {
+      auto block = free_list_;
+      free_list_ = block->next;
+      allocated_block_num_++;
+      return block;
+    }
+    if (page_cursor_ == page_end_ && !ProceedToNextPage()) { return nullptr; }
+    auto block = reinterpret_cast<void*>(page_cursor_);
+    page_cursor_ += block_size_in_bytes_;
+    allocated_block_num_++;
+    return block;
+  }
+  void Free(void* ptr) {
+    if (ptr == nullptr) { return; }
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = free_list_;
+    free_list_ = block;
+    allocated_block_num_--;
+  }
+  // invalidates all blocks but keeps pages for reuse.
+  void Reset() {
+    free_list_ = nullptr;
+    current_page_ = nullptr;
+    page_cursor_ = 0;
+    page_end_ = 0;
+    allocated_block_num_ = 0;
+  }
+  constexpr auto GetBlockSizeInBytes() const { return block_size_in_bytes_; }
+  constexpr auto GetAllocatedBlockNum() const { return allocated_block_num_; }
+  constexpr auto GetPageNum() const { return page_num_; }
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct PageHeader {
+    PageHeader* next;
+  };
+  bool ProceedToNextPage() {
+    auto next_page = (current_page_ == nullptr) ? first_page_ : current_page_->next;
+    if (next_page == nullptr) {
+      const auto header_size = AlignAddress(sizeof(PageHeader), block_alignment_in_bytes_);
+      const auto alignment = block_alignment_in_bytes_ > alignof(PageHeader) ? block_alignment_in_bytes_ : alignof(PageHeader);
+      auto ptr = parent_->Allocate(header_size + block_size_in_bytes_ * block_num_per_page_, alignment);
+      if (ptr == nullptr) { return false; }
+      next_page = new(ptr) PageHeader{nullptr};
+      if (current_page_ == nullptr) {
+        first_page_ = next_page;
+      } else {
+        current_page_->next = next_page;
+      }
+      page_num_++;
+    }
+    current_page_ = next_page;
+    page_cursor_ = AlignAddress(reinterpret_cast<std::uintptr_t>(current_page_) + sizeof(PageHeader), static_cast<std::uintptr_t>(block_alignment_in_bytes_));
+    page_end_ = page_cursor_ + block_size_in_bytes_ * block_num_per_page_;
+    return true;
+  }
+  A* parent_;
+  const size_t block_size_in_bytes_;
+  const size_t block_alignment_in_bytes_;
+  const uint32_t block_num_per_page_;
+  uint32_t page_num_{0};
+  FreeBlock* free_list_{nullptr};
+  PageHeader* first_page_{nullptr};
+  PageHeader* current_page_{nullptr};
+  std::uintptr_t page_cursor_{0};
+  std::uintptr_t page_end_{0};
+  size_t allocated_block_num_{0};
+};
+// allocator for objects of a single type with individual lifetimes.
+// requests that do not fit a block (e.g. HashMap tables) are forwarded to the parent and are released only when the parent itself is reset.
+template <typename T, typename A>
+class PoolAllocator {
+ public:
+  static const uint32_t kDefaultBlockNumPerPage = 64;
+  explicit PoolAllocator(A* parent, const uint32_t block_num_per_page = kDefaultBlockNumPerPage)
+      : parent_(parent)
+      , pool_(parent, sizeof(T), block_num_per_page, GetBlockAlignment())
+  {}
+  ~PoolAllocator() {}
+  PoolAllocator() = delete;
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+  void* Allocate(size_t bytes = sizeof(T), size_t alignment_in_bytes = kDefaultAlignmentSize) {
+    if (!IsServedByPool(bytes, alignment_in_bytes)) { return parent_->Allocate(bytes, alignment_in_bytes); }
+    return pool_.Allocate();
+  }
+  void Free(void* ptr, size_t bytes = sizeof(T), size_t alignment_in_bytes = kDefaultAlignmentSize) {
+    if (!IsServedByPool(bytes, alignment_in_bytes)) { return; }
+    pool_.Free(ptr);
+  }
+  void Reset() { pool_.Reset(); }
+  constexpr auto GetAllocatedBlockNum() const { return pool_.GetAllocatedBlockNum(); }
+  constexpr auto GetPageNum() const { return pool_.GetPageNum(); }
+ private:
+  static constexpr size_t GetBlockAlignment() { return alignof(T) > kDefaultAlignmentSize ? alignof(T) : kDefaultAlignmentSize; }
+  constexpr bool IsServedByPool(const size_t bytes, const size_t alignment_in_bytes) const {
+    return bytes <= pool_.GetBlockSizeInBytes() && alignment_in_bytes <= GetBlockAlignment();
+  }
+  A* parent_;
+  BlockPool<A> pool_;
+};
+// general purpose allocator with power of 2 size classes (16-256 bytes) backed by BlockPool.
+// larger allocations are forwarded to the parent and are released only when the parent is reset.
+// Free() must be called with the same size and alignment passed to Allocate().
+template <typename A>
+class SlabAllocator {
+ public:
+  static const size_t kMinBlockSize = 16;
+  static const size_t kMaxBlockSize = 256;
+  static const uint32_t kSizeClassNum = 5;
+  static const uint32_t kDefaultPageSizeInBytes = 16 * 1024;
+  explicit SlabAllocator(A* parent, const uint32_t page_size_in_bytes = kDefaultPageSizeInBytes)
+      : parent_(parent)
+      , pool_{
+          {parent, 16, page_size_in_bytes / 16, 16},
+          {parent, 32, page_size_in_bytes / 32, 32},
+          {parent, 64, page_size_in_bytes / 64, 64},
+          {parent, 128, page_size_in_bytes / 128, 128},
+          {parent, 256, page_size_in_bytes / 256, 256},
+        }
+  {}
+  ~SlabAllocator() {}
+  SlabAllocator() = delete;
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+  void* Allocate(size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize) {
+    const auto size_class = GetSizeClass(bytes, alignment_in_bytes);
+    if (size_class >= kSizeClassNum) { return parent_->Allocate(bytes, alignment_in_bytes); }
+    return pool_[size_class].Allocate();
+  }
+  void Free(void* ptr, size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize) {
+    const auto size_class = GetSizeClass(bytes, alignment_in_bytes);
+    if (size_class >= kSizeClassNum) { return; }
+    pool_[size_class].Free(ptr);
+  }
+  void Reset() {
+    for (auto& pool : pool_) {
+      pool.Reset();
+    }
+  }
+  constexpr auto GetAllocatedBlockNum(const uint32_t size_class) const { return pool_[size_class].GetAllocatedBlockNum(); }
+  constexpr auto GetPageNum(const uint32_t size_class) const { return pool_[size_class].GetPageNum(); }
+  static constexpr uint32_t GetSizeClass(const size_t bytes, const size_t alignment_in_bytes) {
+    // blocks are aligned to their own size since pages are aligned to the block size.
+    const auto size = bytes > alignment_in_bytes ? bytes : alignment_in_bytes;
+    if (size <= kMinBlockSize) { return 0; }
+    return static_cast<uint32_t>(std::bit_width(size - 1) - std::bit_width(kMinBlockSize - 1));
+  }
+ private:
+  A* parent_;
+  BlockPool<A> pool_[kSizeClassNum];
+};
 template <typename T, typename A>
 auto Allocate(A* allocator, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
   return new(allocator->Allocate(sizeof(T), alignment_in_bytes)) T;
@@ -196,5 +433,11 @@ template <typename T, typename A>
 auto AllocateArray(A* allocator, const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
   return new(allocator->Allocate(sizeof(T) * len, alignment_in_bytes)) T[len];
 }
+template <typename T, typename A>
+void Free(A* allocator, T* ptr, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
+  if (ptr == nullptr) { return; }
+  ptr->~T();
+  allocator->Free(ptr, sizeof(T), alignment_in_bytes);
+}
 }
 #endif
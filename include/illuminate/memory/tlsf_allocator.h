@@ -0,0 +1,60 @@
+#ifndef ILLUMINATE_MEMORY_TLSF_ALLOCATOR_H
+#define ILLUMINATE_MEMORY_TLSF_ALLOCATOR_H
+#include <cstdint>
+#include <cstddef>
+#include "illuminate/memory/memory_allocation.h"
+namespace illuminate {
+namespace tlsf_internal {
+struct BlockHeader;
+}
+/**
+ * two-level segregated fit allocator (http://www.gii.upv.es/tlsf/) over a caller-owned buffer.
+ * Allocate and Free are O(1) with a bitmap lookup of the first level (power of 2) and second level (linear subdivision) free lists.
+ * blocks carry a single size_t header while in use; free blocks are linked through their payload and merged with physical neighbors.
+ * the pool can be grown in place, so that the buffer can be committed on demand.
+ **/
+class TlsfAllocator {
+ public:
+  explicit TlsfAllocator(std::byte* buffer, const size_t size_in_byte);
+  ~TlsfAllocator() {}
+  TlsfAllocator() = delete;
+  TlsfAllocator(const TlsfAllocator&) = delete;
+  TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+  void* Allocate(size_t bytes, size_t alignment_in_bytes = kDefaultAlignmentSize);
+  // size and alignment are not needed and accepted only for compatibility with sized Free (e.g. HashMap).
+  void Free(void* ptr, size_t bytes = 0, size_t alignment_in_bytes = 0);
+  void Reset();
+  // extends the pool to the first size_in_byte bytes of the buffer, which must be accessible by then. the buffer never shrinks.
+  bool Grow(const size_t size_in_byte);
+  constexpr auto GetUsedSizeInBytes() const { return used_size_in_byte_; }
+  constexpr auto GetFreeSizeInBytes() const { return pool_size_in_byte_ - used_size_in_byte_; }
+  size_t GetLargestFreeBlockSizeInBytes() const;
+  constexpr auto GetBufferSizeInByte() const { return size_in_byte_; }
+  auto GetBuffer() const { return buffer_; }
+  static size_t GetAllocationSizeInBytes(const void* ptr);
+  static const size_t kAlignmentSize = 8;
+  static const uint32_t kSlIndexCountLog2 = 4;
+  static const uint32_t kSlIndexCount = 1U << kSlIndexCountLog2;
+  static const uint32_t kFlIndexShift = kSlIndexCountLog2 + 3/*log2(kAlignmentSize)*/;
+  static const uint32_t kFlIndexMax = 32;
+  static const uint32_t kFlIndexCount = kFlIndexMax - kFlIndexShift + 1;
+  static const size_t kSmallBlockSize = size_t{1} << kFlIndexShift;
+ private:
+  using BlockHeader = tlsf_internal::BlockHeader;
+  void InsertFreeBlock(BlockHeader* block);
+  void RemoveFreeBlock(BlockHeader* block);
+  BlockHeader* LocateFreeBlock(const size_t size);
+  BlockHeader* MergePrev(BlockHeader* block);
+  BlockHeader* MergeNext(BlockHeader* block);
+  void TrimFree(BlockHeader* block, const size_t size);
+  BlockHeader* TrimFreeLeading(BlockHeader* block, const size_t size);
+  std::byte* const buffer_;
+  size_t size_in_byte_;
+  size_t pool_size_in_byte_{0};
+  size_t used_size_in_byte_{0};
+  uint32_t fl_bitmap_{0};
+  uint32_t sl_bitmap_[kFlIndexCount]{};
+  BlockHeader* free_list_[kFlIndexCount][kSlIndexCount]{};
+};
+}
+#endif
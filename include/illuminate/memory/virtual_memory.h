@@ -0,0 +1,13 @@
+#ifndef ILLUMINATE_MEMORY_VIRTUAL_MEMORY_H
+#define ILLUMINATE_MEMORY_VIRTUAL_MEMORY_H
+#include <cstdint>
+#include <cstddef>
+namespace illuminate {
+// reserved ranges are inaccessible until committed. committing an already committed range is allowed.
+std::byte* ReserveVirtualMemory(const size_t size_in_bytes);
+bool CommitVirtualMemory(std::byte* addr, const size_t size_in_bytes);
+void DecommitVirtualMemory(std::byte* addr, const size_t size_in_bytes);
+void ReleaseVirtualMemory(std::byte* addr, const size_t size_in_bytes);
+size_t GetVirtualMemoryPageSize();
+}
+#endif
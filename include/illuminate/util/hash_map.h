@@ -1,54 +1,274 @@
 #ifndef ILLUMINATE_UTIL_HASH_MAP_H
 #define ILLUMINATE_UTIL_HASH_MAP_H
+#include <bit>
+#include <cstring>
+#include <utility>
 #include "illuminate/core/strid.h"
+#include "illuminate/memory/memory_allocation.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ILLUMINATE_HASH_MAP_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ILLUMINATE_HASH_MAP_NEON
+#endif
 namespace illuminate {
+namespace hash_map_internal {
+// swiss-table style control bytes: full slots hold 7 bits of the mixed key (0b0xxxxxxx).
+using CtrlByte = int8_t;
+static const CtrlByte kCtrlEmpty   = -128; // 0b10000000
+static const CtrlByte kCtrlDeleted = -2;   // 0b11111110
+#if defined(ILLUMINATE_HASH_MAP_SSE2)
+class Group {
+ public:
+  using Mask = uint32_t;
+  static const uint32_t kWidth = 16;
+  static const uint32_t kMaskShift = 0;
+  explicit Group(const CtrlByte* ctrl) : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+  Mask Match(const CtrlByte h2) const { return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))); }
+  Mask MatchEmpty() const { return Match(kCtrlEmpty); }
+  Mask MatchEmptyOrDeleted() const { return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_))); }
+ private:
+  __m128i ctrl_;
+};
+#elif defined(ILLUMINATE_HASH_MAP_NEON)
+class Group {
+ public:
+  using Mask = uint64_t;
+  static const uint32_t kWidth = 8;
+  static const uint32_t kMaskShift = 3;
+  explicit Group(const CtrlByte* ctrl) : ctrl_(vld1_s8(ctrl)) {}
+  Mask Match(const CtrlByte h2) const { return ToMask(vceq_s8(vdup_n_s8(h2), ctrl_)); }
+  Mask MatchEmpty() const { return Match(kCtrlEmpty); }
+  Mask MatchEmptyOrDeleted() const { return ToMask(vclt_s8(ctrl_, vdup_n_s8(-1))); }
+ private:
+  static Mask ToMask(const uint8x8_t v) { return vget_lane_u64(vreinterpret_u64_u8(v), 0) & 0x8080808080808080ULL; }
+  int8x8_t ctrl_;
+};
+#else
+// portable SWAR fallback. Match() may report false positives, which are rejected by the key comparison.
+class Group {
+ public:
+  using Mask = uint64_t;
+  static const uint32_t kWidth = 8;
+  static const uint32_t kMaskShift = 3;
+  explicit Group(const CtrlByte* ctrl) { std::memcpy(&ctrl_, ctrl, sizeof(ctrl_)); }
+  Mask Match(const CtrlByte h2) const {
+    const auto x = ctrl_ ^ (kLsbs * static_cast<uint8_t>(h2));
+    return (x - kLsbs) & ~x & kMsbs;
+  }
+  Mask MatchEmpty() const { return (ctrl_ & ~(ctrl_ << 6)) & kMsbs; }
+  Mask MatchEmptyOrDeleted() const { return (ctrl_ & ~(ctrl_ << 7)) & kMsbs; }
+ private:
+  static const uint64_t kLsbs = 0x0101010101010101ULL;
+  static const uint64_t kMsbs = 0x8080808080808080ULL;
+  uint64_t ctrl_;
+};
+#endif
+constexpr inline uint64_t MixKey(const StrHash key) {
+  const auto h = static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ULL;
+  return h ^ (h >> 32);
+}
+constexpr inline uint32_t GetH1(const uint64_t hash) { return static_cast<uint32_t>(hash); }
+constexpr inline CtrlByte GetH2(const uint64_t hash) { return static_cast<CtrlByte>(hash >> 57); }
+} // namespace hash_map_internal
+/**
+ * open addressing hash map (swiss table) with control byte group probing.
+ * values are allocated individually from the allocator and their addresses stay valid until the allocator is reset,
+ * while the table itself is reallocated from the allocator on growth (the previous block is left to the arena).
+ * allocators with Free(ptr, bytes, alignment) (e.g. SlabAllocator) get erased values and previous tables back.
+ **/
 template <typename T, typename A>
 class HashMap {
  public:
   static const uint32_t kDefaultTableSize = 32;
   HashMap() {}
-  HashMap(A* allocator, const uint32_t table_size = kDefaultTableSize)
-      : allocator_(allocator)
-      , table_size_(table_size)
-      , table_(AllocateArray<T*>(allocator_, table_size_))
-  {
-    for (uint32_t i = 0; i < table_size_; i++) {
-      table_[i] = nullptr;
-    }
+  HashMap(A* allocator, const uint32_t table_size = kDefaultTableSize) {
+    SetAllocator(allocator, table_size);
   }
   virtual ~HashMap() {}
   void SetAllocator(A* allocator, const uint32_t table_size = kDefaultTableSize) {
     allocator_ = allocator;
-    table_size_ = table_size;
-    table_ = AllocateArray<T*>(allocator_, table_size_);
-    for (uint32_t i = 0; i < table_size_; i++) {
-      table_[i] = nullptr;
-    }
+    AllocateTable(CalcCapacity(table_size));
+  }
+  const T* Get(const StrHash key) const {
+    const auto index = Find(key);
+    return index == kInvalidIndex ? nullptr : values_[index];
+  }
+  T* Get(const StrHash key) {
+    const auto index = Find(key);
+    return index == kInvalidIndex ? nullptr : values_[index];
   }
-  constexpr const uint32_t GetIndex(const StrHash key) const { return key % table_size_; }
-  const T* Get(const StrHash key) const { return table_[GetIndex(key)]; }
-  T* Get(const StrHash key) { return table_[GetIndex(key)]; }
   bool Insert(const StrHash key, T&& val) {
-    auto index = GetIndex(key);
-    if (table_[index] != nullptr) { return false; }
-    table_[index] = Allocate<T>(allocator_);
-    (*table_[index]) = std::move(val);
+    if (Find(key) != kInvalidIndex) { return false; }
+    auto ptr = AllocateValue();
+    if (ptr == nullptr) { return false; }
+    auto value = new(ptr) T(std::move(val));
+    if (!InsertNewKey(key, value)) {
+      ReleaseValue(value);
+      return false;
+    }
     return true;
   }
   bool InsertCopy(const StrHash key, const T& val) {
     auto v = val;
     return Insert(key, std::move(v));
   }
-  void Reserve(const StrHash key) {
-    table_[GetIndex(key)] = Allocate<T>(allocator_);
+  T* Reserve(const StrHash key) {
+    auto index = Find(key);
+    if (index != kInvalidIndex) { return values_[index]; }
+    auto ptr = AllocateValue();
+    if (ptr == nullptr) { return nullptr; }
+    auto value = new(ptr) T;
+    if (!InsertNewKey(key, value)) {
+      ReleaseValue(value);
+      return nullptr;
+    }
+    return value;
   }
   void Replace(const StrHash key, T&& val) {
-    *(table_[GetIndex(key)]) = std::move(val);
+    auto index = Find(key);
+    if (index == kInvalidIndex) {
+      Insert(key, std::move(val));
+      return;
+    }
+    *(values_[index]) = std::move(val);
+  }
+  bool Erase(const StrHash key) {
+    const auto index = Find(key);
+    if (index == kInvalidIndex) { return false; }
+    ReleaseValue(values_[index]);
+    values_[index] = nullptr;
+    SetCtrl(index, hash_map_internal::kCtrlDeleted);
+    size_--;
+    return true;
   }
+  constexpr auto GetSize() const { return size_; }
+  constexpr auto GetCapacity() const { return capacity_; }
+  // bytes allocated up front for the table incl. alignment padding (values are allocated separately), e.g. to size fixed buffers.
+  static constexpr size_t CalcTableSizeInBytes(const uint32_t table_size) { return GetTableSize(CalcCapacity(table_size)) + GetTableAlignment(); }
  private:
+  using Group = hash_map_internal::Group;
+  using CtrlByte = hash_map_internal::CtrlByte;
+  static const uint32_t kInvalidIndex = ~0U;
+  static constexpr bool kAllocatorSupportsFree = requires(A* allocator, void* ptr) { allocator->Free(ptr, size_t{}, size_t{}); };
+  static constexpr uint32_t CalcCapacity(const uint32_t size) {
+    // keep load factor below 7/8.
+    const auto capacity = std::bit_ceil(size + size / 7 + 1);
+    return capacity < Group::kWidth ? Group::kWidth : capacity;
+  }
+  static constexpr uint32_t GetMaxLoad(const uint32_t capacity) { return capacity - capacity / 8; }
+  static constexpr size_t GetValueAlignment() { return alignof(T) > kDefaultAlignmentSize ? alignof(T) : kDefaultAlignmentSize; }
+  // ctrl bytes are followed by a copy of the first group so that group loads never wrap around.
+  static constexpr size_t GetCtrlSize(const uint32_t capacity) { return AlignAddress(static_cast<size_t>(capacity + Group::kWidth), alignof(T*)); }
+  static constexpr size_t GetKeysSize(const uint32_t capacity) { return AlignAddress(sizeof(StrHash) * capacity, alignof(T*)); }
+  static constexpr size_t GetTableSize(const uint32_t capacity) { return GetCtrlSize(capacity) + GetKeysSize(capacity) + sizeof(T*) * capacity; }
+  static constexpr size_t GetTableAlignment() { return alignof(T*) > 16 ? alignof(T*) : 16; }
+  bool AllocateTable(const uint32_t capacity) {
+    if (allocator_ == nullptr) { return false; }
+    const auto ctrl_size = GetCtrlSize(capacity);
+    const auto keys_size = GetKeysSize(capacity);
+    auto ptr = static_cast<std::byte*>(allocator_->Allocate(GetTableSize(capacity), GetTableAlignment()));
+    if (ptr == nullptr) { return false; }
+    ctrl_ = reinterpret_cast<CtrlByte*>(ptr);
+    keys_ = reinterpret_cast<StrHash*>(ptr + ctrl_size);
+    values_ = reinterpret_cast<T**>(ptr + ctrl_size + keys_size);
+    std::memset(ctrl_, static_cast<uint8_t>(hash_map_internal::kCtrlEmpty), capacity + Group::kWidth);
+    capacity_ = capacity;
+    size_ = 0;
+    growth_left_ = GetMaxLoad(capacity);
+    return true;
+  }
+  void* AllocateValue() {
+    if (allocator_ == nullptr) { return nullptr; }
+    return allocator_->Allocate(sizeof(T), GetValueAlignment());
+  }
+  void ReleaseValue(T* value) {
+    value->~T();
+    if constexpr (kAllocatorSupportsFree) {
+      allocator_->Free(value, sizeof(T), GetValueAlignment());
+    }
+  }
+  constexpr uint32_t GetMask() const { return capacity_ - 1; }
+  void SetCtrl(const uint32_t index, const CtrlByte ctrl) {
+    ctrl_[index] = ctrl;
+    if (index < Group::kWidth) {
+      ctrl_[capacity_ + index] = ctrl;
+    }
+  }
+  uint32_t Find(const StrHash key) const {
+    if (capacity_ == 0) { return kInvalidIndex; }
+    const auto hash = hash_map_internal::MixKey(key);
+    const auto h2 = hash_map_internal::GetH2(hash);
+    auto pos = hash_map_internal::GetH1(hash) & GetMask();
+    for (uint32_t step = Group::kWidth; ; step += Group::kWidth) {
+      const Group group(ctrl_ + pos);
+      for (auto mask = group.Match(h2); mask != 0; mask &= mask - 1) {
+        const auto index = (pos + (std::countr_zero(mask) >> Group::kMaskShift)) & GetMask();
+        if (keys_[index] == key) { return index; }
+      }
+      if (group.MatchEmpty() != 0) { return kInvalidIndex; }
+      pos = (pos + step) & GetMask();
+    }
+  }
+  uint32_t FindFirstNonFull(const uint64_t hash) const {
+    auto pos = hash_map_internal::GetH1(hash) & GetMask();
+    for (uint32_t step = Group::kWidth; ; step += Group::kWidth) {
+      const auto mask = Group(ctrl_ + pos).MatchEmptyOrDeleted();
+      if (mask != 0) {
+        return (pos + (std::countr_zero(mask) >> Group::kMaskShift)) & GetMask();
+      }
+      pos = (pos + step) & GetMask();
+    }
+  }
+  bool InsertNewKey(const StrHash key, T* value) {
+    if (capacity_ == 0) { return false; }
+    const auto hash = hash_map_internal::MixKey(key);
+    auto index = FindFirstNonFull(hash);
+    if (growth_left_ == 0 && ctrl_[index] == hash_map_internal::kCtrlEmpty) {
+      // rehash into a new table of the same capacity to drop tombstones when at most half of the max load is in use, grow otherwise.
+      // the current table is kept intact if the new one cannot be allocated.
+      if (!Rehash(size_ * 2 <= GetMaxLoad(capacity_) ? capacity_ : capacity_ * 2)) { return false; }
+      index = FindFirstNonFull(hash);
+    }
+    if (ctrl_[index] == hash_map_internal::kCtrlEmpty) {
+      growth_left_--;
+    }
+    SetCtrl(index, hash_map_internal::GetH2(hash));
+    keys_[index] = key;
+    values_[index] = value;
+    size_++;
+    return true;
+  }
+  bool Rehash(const uint32_t new_capacity) {
+    const auto prev_ctrl = ctrl_;
+    const auto prev_keys = keys_;
+    const auto prev_values = values_;
+    const auto prev_capacity = capacity_;
+    const auto prev_size = size_;
+    if (!AllocateTable(new_capacity)) { return false; }
+    for (uint32_t i = 0; i < prev_capacity; i++) {
+      if (prev_ctrl[i] < 0) { continue; }
+      const auto hash = hash_map_internal::MixKey(prev_keys[i]);
+      const auto index = FindFirstNonFull(hash);
+      SetCtrl(index, hash_map_internal::GetH2(hash));
+      keys_[index] = prev_keys[i];
+      values_[index] = prev_values[i];
+    }
+    size_ = prev_size;
+    growth_left_ -= prev_size;
+    if constexpr (kAllocatorSupportsFree) {
+      allocator_->Free(prev_ctrl, GetTableSize(prev_capacity), GetTableAlignment());
+    }
+    return true;
+  }
   A* allocator_{nullptr};
-  uint32_t table_size_{0};
-  T** table_{nullptr};
+  CtrlByte* ctrl_{nullptr};
+  StrHash* keys_{nullptr};
+  T** values_{nullptr};
+  uint32_t capacity_{0};
+  uint32_t size_{0};
+  uint32_t growth_left_{0};
 };
 }
 #endif
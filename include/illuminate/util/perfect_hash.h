@@ -0,0 +1,133 @@
+#ifndef ILLUMINATE_UTIL_PERFECT_HASH_H
+#define ILLUMINATE_UTIL_PERFECT_HASH_H
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include "illuminate/core/strid.h"
+namespace illuminate {
+namespace perfect_hash_internal {
+constexpr uint32_t Hash(const std::string_view str) {
+  // fnv-1a
+  uint32_t hash = 2166136261U;
+  for (const auto c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619U;
+  }
+  return hash;
+}
+constexpr uint32_t Mix(uint32_t hash, const uint32_t seed) {
+  // murmur3 finalizer so that low bits depend on all bits of hash and seed.
+  hash ^= seed * 0x9e3779b9U;
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bU;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35U;
+  hash ^= hash >> 16;
+  return hash;
+}
+} // namespace perfect_hash_internal
+/**
+ * string -> value table built at compile time (hash and displace).
+ * keys are distributed to buckets by their hash and each bucket searches its own seed which maps all its keys to empty slots,
+ * so Find costs a single pass over the key and a single string comparison regardless of the number of keys.
+ * duplicate keys, duplicate SID values among keys or a failed seed search are reported as compile errors.
+ **/
+template <typename V, size_t N>
+class PerfectHashTable {
+ public:
+  using Entry = std::pair<std::string_view, V>;
+  static_assert(N > 0 && N < 0xFFFF);
+  static constexpr uint32_t kBucketNum = std::bit_ceil(static_cast<uint32_t>(N));
+  static constexpr uint32_t kSlotNum = kBucketNum * 2;
+  consteval explicit PerfectHashTable(const Entry (&entries)[N]) {
+    for (uint32_t i = 0; i < N; i++) {
+      keys_[i] = entries[i].first;
+      values_[i] = entries[i].second;
+      for (uint32_t j = 0; j < i; j++) {
+        if (keys_[i] == keys_[j]) { throw "duplicate key in PerfectHashTable"; }
+        if (CompileTimeStrHash(keys_[i]) == CompileTimeStrHash(keys_[j])) { throw "SID collision in PerfectHashTable"; }
+      }
+    }
+    uint32_t hash[N]{};
+    uint32_t bucket_index[N]{};
+    uint32_t bucket_size[kBucketNum]{};
+    for (uint32_t i = 0; i < N; i++) {
+      hash[i] = perfect_hash_internal::Hash(keys_[i]);
+      bucket_index[i] = GetBucketIndex(hash[i]);
+      bucket_size[bucket_index[i]]++;
+    }
+    for (uint32_t i = 0; i < kSlotNum; i++) {
+      slot_[i] = kEmptySlot;
+    }
+    // place larger buckets first while most slots are still empty.
+    bool bucket_done[kBucketNum]{};
+    for (uint32_t b = 0; b < kBucketNum; b++) {
+      uint32_t bucket = 0;
+      uint32_t max_size = 0;
+      for (uint32_t i = 0; i < kBucketNum; i++) {
+        if (bucket_done[i] || bucket_size[i] <= max_size) { continue; }
+        bucket = i;
+        max_size = bucket_size[i];
+      }
+      if (max_size == 0) { break; }
+      bucket_done[bucket] = true;
+      bucket_seed_[bucket] = FindBucketSeed(bucket, hash, bucket_index);
+      for (uint32_t i = 0; i < N; i++) {
+        if (bucket_index[i] != bucket) { continue; }
+        slot_[GetSlotIndex(hash[i], bucket_seed_[bucket])] = static_cast<uint16_t>(i);
+      }
+    }
+  }
+  constexpr const V* Find(const std::string_view key) const {
+    const auto hash = perfect_hash_internal::Hash(key);
+    const auto index = slot_[GetSlotIndex(hash, bucket_seed_[GetBucketIndex(hash)])];
+    if (index == kEmptySlot || keys_[index] != key) { return nullptr; }
+    return &values_[index];
+  }
+  constexpr bool Contains(const std::string_view key) const { return Find(key) != nullptr; }
+  // reverse lookup in entry order (linear), keys point to the literals passed to the constructor.
+  constexpr const std::string_view* FindKey(const V& value) const {
+    for (uint32_t i = 0; i < N; i++) {
+      if (values_[i] == value) { return &keys_[i]; }
+    }
+    return nullptr;
+  }
+  static constexpr auto GetSize() { return static_cast<uint32_t>(N); }
+ private:
+  static constexpr uint16_t kEmptySlot = 0xFFFF;
+  static constexpr uint32_t kBucketSeedSearchMax = 1U << 16;
+  static constexpr uint32_t GetBucketIndex(const uint32_t hash) {
+    return perfect_hash_internal::Mix(hash, 0) & (kBucketNum - 1);
+  }
+  static constexpr uint32_t GetSlotIndex(const uint32_t hash, const uint32_t seed) {
+    return perfect_hash_internal::Mix(hash, seed) & (kSlotNum - 1);
+  }
+  consteval uint32_t FindBucketSeed(const uint32_t bucket, const uint32_t (&hash)[N], const uint32_t (&bucket_index)[N]) const {
+    for (uint32_t seed = 1; seed < kBucketSeedSearchMax; seed++) {
+      bool occupied[kSlotNum]{};
+      bool found = true;
+      for (uint32_t i = 0; i < N; i++) {
+        if (bucket_index[i] != bucket) { continue; }
+        const auto slot = GetSlotIndex(hash[i], seed);
+        if (slot_[slot] != kEmptySlot || occupied[slot]) {
+          found = false;
+          break;
+        }
+        occupied[slot] = true;
+      }
+      if (found) { return seed; }
+    }
+    throw "PerfectHashTable seed not found";
+  }
+  std::string_view keys_[N]{};
+  V values_[N]{};
+  uint32_t bucket_seed_[kBucketNum]{};
+  uint16_t slot_[kSlotNum]{};
+};
+template <typename V, size_t N>
+consteval auto CreatePerfectHashTable(const std::pair<std::string_view, V> (&entries)[N]) {
+  return PerfectHashTable<V, N>(entries);
+}
+}
+#endif
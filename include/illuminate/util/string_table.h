@@ -0,0 +1,80 @@
+#ifndef ILLUMINATE_UTIL_STRING_TABLE_H
+#define ILLUMINATE_UTIL_STRING_TABLE_H
+#include <cstring>
+#include <string_view>
+#include "illuminate/core/strid.h"
+#include "illuminate/util/hash_map.h"
+namespace illuminate {
+/**
+ * deduplicated string pool indexed by StrHash.
+ * strings are packed null-terminated into pages allocated from the allocator,
+ * returned handles stay valid until the allocator is reset and can be compared by address.
+ * a string whose hash is already taken by a different string is rejected (nullptr).
+ **/
+template <typename A>
+class StringTable {
+ public:
+  static const uint32_t kDefaultPageSizeInBytes = 16 * 1024;
+  static const uint32_t kDefaultTableSize = 256;
+  explicit StringTable(A* allocator, const uint32_t page_size_in_bytes = kDefaultPageSizeInBytes, const uint32_t table_size = kDefaultTableSize)
+      : allocator_(allocator)
+      , page_size_in_bytes_(page_size_in_bytes)
+      , index_(allocator, table_size)
+  {}
+  ~StringTable() {}
+  StringTable() = delete;
+  StringTable(const StringTable&) = delete;
+  StringTable& operator=(const StringTable&) = delete;
+  const char* Intern(const std::string_view str) {
+    return Intern(str, CalcStrHash(str));
+  }
+  const char* Intern(const std::string_view str, const StrHash hash) {
+    if (auto interned = index_.Get(hash); interned != nullptr) {
+      return (str.compare(*interned) == 0) ? *interned : nullptr;
+    }
+    auto dst = AllocateString(str.size() + 1);
+    if (dst == nullptr) { return nullptr; }
+    memcpy(dst, str.data(), str.size());
+    dst[str.size()] = '\0';
+    if (!index_.InsertCopy(hash, dst)) { return nullptr; }
+    return dst;
+  }
+  const char* Find(const StrHash hash) const {
+    auto interned = index_.Get(hash);
+    return interned == nullptr ? nullptr : *interned;
+  }
+  constexpr auto GetSize() const { return index_.GetSize(); }
+  constexpr auto GetPoolSizeInBytes() const { return pool_size_in_bytes_; }
+ private:
+  char* AllocateString(const size_t bytes) {
+    if (bytes > page_size_in_bytes_ / 4) {
+      // long strings get their own block so that pages are not wasted.
+      auto ptr = static_cast<char*>(allocator_->Allocate(bytes, 1));
+      if (ptr != nullptr) { pool_size_in_bytes_ += bytes; }
+      return ptr;
+    }
+    if (static_cast<size_t>(page_tail_ - page_head_) < bytes) {
+      auto page = static_cast<char*>(allocator_->Allocate(page_size_in_bytes_, kDefaultAlignmentSize));
+      if (page == nullptr) { return nullptr; }
+      page_head_ = page;
+      page_tail_ = page + page_size_in_bytes_;
+    }
+    auto ptr = page_head_;
+    page_head_ += bytes;
+    pool_size_in_bytes_ += bytes;
+    return ptr;
+  }
+  A* allocator_;
+  const size_t page_size_in_bytes_;
+  HashMap<const char*, A> index_;
+  char* page_head_{nullptr};
+  char* page_tail_{nullptr};
+  size_t pool_size_in_bytes_{0};
+};
+// process wide string table for names shared by parsers, logs and gui. thread-safe, grows on demand and is never reset.
+// a hash collision between different strings or running out of the reserved range is a fatal error.
+const char* InternString(const std::string_view str);
+const char* InternString(const std::string_view str, const StrHash hash);
+const char* GetInternedString(const StrHash hash);
+}
+#endif
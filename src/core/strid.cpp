@@ -3,26 +3,25 @@
 #include <string>
 #include "../src_common.h"
 namespace illuminate {
-StrHash CalcStrHash(const char* const str, const StrHash prime) {
+StrHash CalcStrHash(const char* const str) {
   if (str == nullptr) { return 0U; }
-  StrHash hash = 0;
-  for (uint32_t i = 0; str[i] != 0; i++) {
-    hash = prime * hash + static_cast<StrHash>(str[i]);
-  }
-  spdlog::trace("SID {}:{}", str, hash);
-  return hash;
+  return strid_internal::HashStr(std::string_view(str, strlen(str)));
 }
 StrHash CombineHash(const StrHash& a, const StrHash& b) {
   // https://www.boost.org/doc/libs/1_55_0/doc/html/hash/reference.html#boost.hash_combine
   StrHash seed{a};
+#ifdef USE_64BIT_STR_HASH
+  seed ^= b + 0x9e3779b97f4a7c15ULL + (seed << 12) + (seed >> 4);
+#else
   seed ^= b + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+#endif
   return seed;
 }
 } // namespace illuminate
 #include "doctest/doctest.h"
 TEST_CASE("strhash") {
   using namespace illuminate;
-  auto hash = CalcStrHash("str", kStrHashPrime);
+  auto hash = CalcStrHash("str");
   CHECK_NE(hash, 0);
   auto a = CalcStrHash("a");
   switch (a) {
@@ -37,3 +36,128 @@ TEST_CASE("strhash") {
       break;
   }
 }
+TEST_CASE("strhash compile time and runtime") { // NOLINT
+  using namespace illuminate;
+  // lengths covering each branch of the hash (0, 1-3, 4-16, 17-47, 48+).
+  constexpr StrHash compile_time_hash[] = {
+    SID(""),
+    SID("a"),
+    SID("abc"),
+    SID("abcd"),
+    SID("0123456789abcdef"),
+    SID("0123456789abcdefg"),
+    SID("0123456789abcdef0123456789abcdef0123456789abcde"),
+    SID("0123456789abcdef0123456789abcdef0123456789abcdef"),
+    SID("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0"),
+  };
+  const char* const str[] = {
+    "",
+    "a",
+    "abc",
+    "abcd",
+    "0123456789abcdef",
+    "0123456789abcdefg",
+    "0123456789abcdef0123456789abcdef0123456789abcde",
+    "0123456789abcdef0123456789abcdef0123456789abcdef",
+    "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0",
+  };
+  static_assert(std::size(compile_time_hash) == std::size(str));
+  for (uint32_t i = 0; i < std::size(str); i++) {
+    CAPTURE(i);
+    CHECK_EQ(CalcStrHash(str[i]), compile_time_hash[i]);
+    CHECK_EQ(CalcStrHash(std::string_view(str[i])), compile_time_hash[i]);
+    for (uint32_t j = 0; j < i; j++) {
+      CHECK_NE(compile_time_hash[i], compile_time_hash[j]);
+    }
+  }
+  // string_view not null-terminated at its end.
+  CHECK_EQ(CalcStrHash(std::string_view("abcdef", 4)), SID("abcd"));
+  CHECK_EQ(CalcStrHash(static_cast<const char*>(nullptr)), 0);
+  CHECK_NE(SID("ab"), SID("ba"));
+  CHECK_NE(CombineHash(SID("a"), SID("b")), CombineHash(SID("b"), SID("a")));
+}
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <vector>
+#include <nlohmann/json.hpp>
+namespace {
+// previous StrHash implementation kept for comparison.
+uint32_t CalcPolynomialStrHash(const char* const str) {
+  uint32_t hash = 0;
+  for (uint32_t i = 0; str[i] != 0; i++) {
+    hash = 31 * hash + static_cast<uint32_t>(str[i]);
+  }
+  return hash;
+}
+void CollectJsonStrings(const nlohmann::json& j, std::set<std::string>* strings) {
+  if (j.is_string()) {
+    strings->insert(j.get<std::string>());
+    return;
+  }
+  if (j.is_object()) {
+    for (const auto& [key, val] : j.items()) {
+      strings->insert(key);
+      CollectJsonStrings(val, strings);
+    }
+    return;
+  }
+  if (j.is_array()) {
+    for (const auto& val : j) {
+      CollectJsonStrings(val, strings);
+    }
+  }
+}
+template <typename T, typename F>
+auto CountCollision(const std::vector<std::string>& strings, F&& f) {
+  std::set<T> hash_set;
+  for (const auto& str : strings) {
+    hash_set.insert(f(str));
+  }
+  return static_cast<uint32_t>(strings.size() - hash_set.size());
+}
+template <typename F>
+auto MeasureHashPerSec(const std::vector<std::string>& strings, const uint32_t loop_num, F&& f) {
+  uint64_t sum = 0;
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < loop_num; i++) {
+    for (const auto& str : strings) {
+      sum += f(str);
+    }
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+  const auto sec = std::chrono::duration<double>(end - start).count();
+  return std::make_pair(static_cast<double>(strings.size()) * loop_num / sec, sum);
+}
+} // namespace
+TEST_CASE("strhash benchmark and collision report" * doctest::skip()) { // NOLINT
+  using namespace illuminate;
+  std::set<std::string> string_set;
+  for (const auto& entry : std::filesystem::directory_iterator(".")) {
+    if (entry.path().extension() != ".json") { continue; }
+    std::ifstream file(entry.path());
+    nlohmann::json json;
+    file >> json;
+    CollectJsonStrings(json, &string_set);
+  }
+  // add synthetic names to see the trend on larger material/variation sets.
+  const auto json_string_num = static_cast<uint32_t>(string_set.size());
+  for (uint32_t i = 0; i < 200000; i++) {
+    string_set.insert("material_" + std::to_string(i) + "_variation_" + std::to_string(i % 7));
+  }
+  const std::vector<std::string> strings(string_set.begin(), string_set.end());
+  const auto string_num = static_cast<double>(strings.size());
+  spdlog::info("strhash collision report: {} strings from resource/*.json, {} in total (32bit ideal hash expects {:.2f} collisions)", json_string_num, strings.size(), string_num * (string_num - 1) / 2.0 / 4294967296.0);
+  spdlog::info("  polynomial(31) 32bit collision:{}", CountCollision<uint32_t>(strings, [](const std::string& s) { return CalcPolynomialStrHash(s.c_str()); }));
+  spdlog::info("  wyhash folded 32bit collision:{}", CountCollision<uint32_t>(strings, [](const std::string& s) { auto h = strid_internal::Hash64(s.data(), s.size()); return static_cast<uint32_t>(h ^ (h >> 32)); }));
+  spdlog::info("  wyhash 64bit collision:{}", CountCollision<uint64_t>(strings, [](const std::string& s) { return strid_internal::Hash64(s.data(), s.size()); }));
+  const uint32_t loop_num = 10;
+  const auto [polynomial, sum0] = MeasureHashPerSec(strings, loop_num, [](const std::string& s) { return CalcPolynomialStrHash(s.c_str()); });
+  const auto [calc_str_hash, sum1] = MeasureHashPerSec(strings, loop_num, [](const std::string& s) { return CalcStrHash(s.c_str()); });
+  const auto [calc_str_hash_view, sum2] = MeasureHashPerSec(strings, loop_num, [](const std::string& s) { return CalcStrHash(std::string_view(s)); });
+  spdlog::info("strhash benchmark (Mhash/sec) polynomial(31):{:.1f} CalcStrHash(const char*):{:.1f} CalcStrHash(std::string_view):{:.1f}", polynomial * 1e-6, calc_str_hash * 1e-6, calc_str_hash_view * 1e-6);
+  CHECK_NE(sum0, 0);
+  CHECK_NE(sum1, 0);
+  CHECK_NE(sum2, 0);
+}
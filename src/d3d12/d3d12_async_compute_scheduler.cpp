@@ -0,0 +1,340 @@
+#include "d3d12_async_compute_scheduler.h"
+#include <algorithm>
+#include "d3d12_json_parser.h"
+#include "d3d12_memory_allocators.h"
+#include "d3d12_render_graph_compiler.h"
+#include "d3d12_scene.h"
+#include "d3d12_src_common.h"
+#include "illuminate/util/string_table.h"
+namespace illuminate {
+namespace {
+static const uint32_t kInvalidIndex = ~0U;
+auto IsAsyncComputeState(const ResourceStateType state) {
+  switch (state) {
+    case ResourceStateType::kCbv:
+    case ResourceStateType::kSrvNonPs:
+    case ResourceStateType::kUav:
+    case ResourceStateType::kCopySrc:
+    case ResourceStateType::kCopyDst:
+    case ResourceStateType::kCommon:
+    case ResourceStateType::kGenericRead: {
+      return true;
+    }
+  }
+  return false;
+}
+auto GetFirstCommandQueueIndex(const RenderGraphConfig& graph, const D3D12_COMMAND_LIST_TYPE type) {
+  for (uint32_t i = 0; i < graph.command_queue_num; i++) {
+    if (graph.command_queue_type[i] == type) { return i; }
+  }
+  return kInvalidIndex;
+}
+// passes of a queue run in order, a predecessor on another queue adds fence latency. returns the frame time.
+auto SimulateTimeline(const RenderGraphConfig& graph, const uint32_t* render_pass_queue_index, const uint32_t* predecessor_offset, const uint32_t* predecessor_list,
+                      const float* render_pass_cost_msec, const float fence_latency_msec, float* start_msec, float* end_msec) {
+  auto queue_end_msec = AllocateAndFillArrayFrame(graph.command_queue_num, 0.0f);
+  float frame_time_msec = 0.0f;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    if (!graph.render_pass_list[i].enabled) {
+      start_msec[i] = 0.0f;
+      end_msec[i] = 0.0f;
+      continue;
+    }
+    const auto queue_index = render_pass_queue_index[i];
+    auto start = queue_end_msec[queue_index];
+    for (uint32_t j = predecessor_offset[i]; j < predecessor_offset[i + 1]; j++) {
+      const auto predecessor = predecessor_list[j];
+      if (!graph.render_pass_list[predecessor].enabled) { continue; }
+      const auto latency = (render_pass_queue_index[predecessor] == queue_index) ? 0.0f : fence_latency_msec;
+      start = std::max(start, end_msec[predecessor] + latency);
+    }
+    start_msec[i] = start;
+    end_msec[i] = start + render_pass_cost_msec[i];
+    queue_end_msec[queue_index] = end_msec[i];
+    frame_time_msec = std::max(frame_time_msec, end_msec[i]);
+  }
+  return frame_time_msec;
+}
+// earliest start with unlimited queues and no fence latency.
+auto CalcEarliestStart(const RenderGraphConfig& graph, const RenderPassDependency& dependency, const float* render_pass_cost_msec, float* earliest_start_msec) {
+  float critical_path_msec = 0.0f;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    earliest_start_msec[i] = 0.0f;
+    if (!graph.render_pass_list[i].enabled) { continue; }
+    for (uint32_t j = dependency.offset[i]; j < dependency.offset[i + 1]; j++) {
+      const auto predecessor = dependency.pass_index_list[j];
+      earliest_start_msec[i] = std::max(earliest_start_msec[i], earliest_start_msec[predecessor] + render_pass_cost_msec[predecessor]);
+    }
+    critical_path_msec = std::max(critical_path_msec, earliest_start_msec[i] + render_pass_cost_msec[i]);
+  }
+  return critical_path_msec;
+}
+auto CalcSlack(const RenderGraphConfig& graph, const RenderPassDependency& dependency, const float* render_pass_cost_msec) {
+  auto earliest_start_msec = AllocateArrayFrame<float>(graph.render_pass_num);
+  const auto critical_path_msec = CalcEarliestStart(graph, dependency, render_pass_cost_msec, earliest_start_msec);
+  auto latest_end_msec = AllocateAndFillArrayFrame(graph.render_pass_num, critical_path_msec);
+  auto slack_msec = AllocateAndFillArrayFrame(graph.render_pass_num, 0.0f);
+  for (uint32_t i = graph.render_pass_num; i > 0; i--) {
+    const auto pass_index = i - 1;
+    if (!graph.render_pass_list[pass_index].enabled) { continue; }
+    const auto latest_start_msec = latest_end_msec[pass_index] - render_pass_cost_msec[pass_index];
+    slack_msec[pass_index] = latest_start_msec - earliest_start_msec[pass_index];
+    for (uint32_t j = dependency.offset[pass_index]; j < dependency.offset[pass_index + 1]; j++) {
+      const auto predecessor = dependency.pass_index_list[j];
+      latest_end_msec[predecessor] = std::min(latest_end_msec[predecessor], latest_start_msec);
+    }
+  }
+  return slack_msec;
+}
+} // namespace
+float* GetRenderPassCostMsec(const GpuTimeDurations& gpu_time_durations, const RenderGraphConfig& graph, const MemoryType& memory_type) {
+  auto render_pass_cost_msec = AllocateArray<float>(memory_type, graph.render_pass_num);
+  FrameMemoryCheckpoint checkpoint;
+  auto pass_index_in_queue = AllocateAndFillArrayFrame(graph.command_queue_num, 0U);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto queue_index = graph.render_pass_list[i].command_queue_index;
+    const auto duration_index = pass_index_in_queue[queue_index] * kGpuTimestampQueryNumPerPass + 1;
+    pass_index_in_queue[queue_index]++;
+    render_pass_cost_msec[i] = (duration_index < gpu_time_durations.duration_num[queue_index]) ? gpu_time_durations.duration_msec[queue_index][duration_index] : 0.0f;
+  }
+  return render_pass_cost_msec;
+}
+float* GetRenderPassCostMsec(const RenderPassStaticCostModel& cost_model, const RenderGraphConfig& graph, const MemoryType& memory_type) {
+  auto render_pass_cost_msec = AllocateArray<float>(memory_type, graph.render_pass_num);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    auto cost = cost_model.pass_msec;
+    for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+      const auto state = render_pass.buffer_list[j].state;
+      switch (state) {
+        case ResourceStateType::kUav: {
+          cost += cost_model.buffer_read_msec + cost_model.buffer_write_msec;
+          break;
+        }
+        case ResourceStateType::kRtv:
+        case ResourceStateType::kDsvWrite:
+        case ResourceStateType::kCopyDst:
+        case ResourceStateType::kCommon: {
+          cost += cost_model.buffer_write_msec;
+          break;
+        }
+        default: {
+          cost += cost_model.buffer_read_msec;
+          break;
+        }
+      }
+    }
+    render_pass_cost_msec[i] = cost;
+  }
+  return render_pass_cost_msec;
+}
+float* ParseRenderPassCostJson(const nlohmann::json& j, const RenderGraphConfig& graph, const float default_cost_msec, const MemoryType& memory_type) {
+  auto render_pass_cost_msec = AllocateArray<float>(memory_type, graph.render_pass_num);
+  std::fill_n(render_pass_cost_msec, graph.render_pass_num, default_cost_msec);
+  for (const auto& [name, cost] : j.items()) {
+    const auto hash = CalcStrHash(name.c_str());
+    for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+      if (graph.render_pass_list[i].name != hash) { continue; }
+      render_pass_cost_msec[i] = cost.get<float>();
+    }
+  }
+  return render_pass_cost_msec;
+}
+nlohmann::json CreateRenderPassCostJson(const RenderGraphConfig& graph, const float* render_pass_cost_msec) {
+  auto j = nlohmann::json::object();
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto name = GetInternedString(graph.render_pass_list[i].name);
+    if (name == nullptr) { continue; }
+    j[name] = render_pass_cost_msec[i];
+  }
+  return j;
+}
+bool IsAsyncComputeEligible(const RenderPass& render_pass) {
+  if (render_pass.buffer_num == 0) { return false; }
+  for (uint32_t i = 0; i < render_pass.buffer_num; i++) {
+    if (!IsAsyncComputeState(render_pass.buffer_list[i].state)) { return false; }
+  }
+  return true;
+}
+RenderPassTimeline PredictRenderPassTimeline(const RenderGraphConfig& graph, const float* render_pass_cost_msec, const float fence_latency_msec, const MemoryType& memory_type) {
+  RenderPassTimeline timeline{
+    .start_msec = AllocateArray<float>(memory_type, graph.render_pass_num),
+    .end_msec = AllocateArray<float>(memory_type, graph.render_pass_num),
+  };
+  FrameMemoryCheckpoint checkpoint;
+  auto render_pass_queue_index = AllocateArrayFrame<uint32_t>(graph.render_pass_num);
+  auto wait_pass_offset = AllocateArrayFrame<uint32_t>(graph.render_pass_num + 1);
+  uint32_t wait_pass_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    wait_pass_num += graph.render_pass_list[i].wait_pass_num;
+  }
+  auto wait_pass_list = AllocateArrayFrame<uint32_t>(wait_pass_num);
+  wait_pass_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    render_pass_queue_index[i] = render_pass.command_queue_index;
+    wait_pass_offset[i] = wait_pass_num;
+    for (uint32_t j = 0; j < render_pass.wait_pass_num; j++) {
+      if (render_pass.signal_pass_index[j] >= i) { continue; } // unresolved
+      wait_pass_list[wait_pass_num] = render_pass.signal_pass_index[j];
+      wait_pass_num++;
+    }
+  }
+  wait_pass_offset[graph.render_pass_num] = wait_pass_num;
+  timeline.frame_time_msec = SimulateTimeline(graph, render_pass_queue_index, wait_pass_offset, wait_pass_list, render_pass_cost_msec, fence_latency_msec, timeline.start_msec, timeline.end_msec);
+  const auto dependency = CollectRenderPassDependency(graph, MemoryType::kFrame);
+  auto earliest_start_msec = AllocateArrayFrame<float>(graph.render_pass_num);
+  timeline.critical_path_msec = CalcEarliestStart(graph, dependency, render_pass_cost_msec, earliest_start_msec);
+  return timeline;
+}
+AsyncComputeSchedule ScheduleAsyncCompute(const float* render_pass_cost_msec, const StrHash* buffer_name_hash_list, const AsyncComputeSchedulerOption& option, const MemoryType& memory_type, RenderGraphConfig* graph) {
+  auto& r = *graph;
+  AsyncComputeSchedule schedule{};
+  {
+    FrameMemoryCheckpoint checkpoint;
+    const auto dependency = CollectRenderPassDependency(r, MemoryType::kFrame);
+    auto render_pass_queue_index = AllocateArrayFrame<uint32_t>(r.render_pass_num);
+    for (uint32_t i = 0; i < r.render_pass_num; i++) {
+      render_pass_queue_index[i] = r.render_pass_list[i].command_queue_index;
+    }
+    auto start_msec = AllocateArrayFrame<float>(r.render_pass_num);
+    auto end_msec = AllocateArrayFrame<float>(r.render_pass_num);
+    const auto simulate = [&]() {
+      return SimulateTimeline(r, render_pass_queue_index, dependency.offset, dependency.pass_index_list, render_pass_cost_msec, option.fence_latency_msec, start_msec, end_msec);
+    };
+    schedule.frame_time_msec_before = simulate();
+    const auto compute_queue_index = GetFirstCommandQueueIndex(r, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    if (compute_queue_index != kInvalidIndex) {
+      const auto slack_msec = CalcSlack(r, dependency, render_pass_cost_msec);
+      auto candidate_list = AllocateArrayFrame<uint32_t>(r.render_pass_num);
+      uint32_t candidate_num = 0;
+      for (uint32_t i = 0; i < r.render_pass_num; i++) {
+        const auto& render_pass = r.render_pass_list[i];
+        if (!render_pass.enabled || r.command_queue_type[render_pass.command_queue_index] != D3D12_COMMAND_LIST_TYPE_DIRECT) { continue; }
+        if (!IsAsyncComputeEligible(render_pass)) { continue; }
+        candidate_list[candidate_num] = i;
+        candidate_num++;
+      }
+      std::stable_sort(candidate_list, candidate_list + candidate_num, [slack_msec](const uint32_t a, const uint32_t b) { return slack_msec[a] > slack_msec[b]; });
+      auto frame_time_msec = schedule.frame_time_msec_before;
+      for (uint32_t i = 0; i < candidate_num; i++) {
+        const auto pass_index = candidate_list[i];
+        render_pass_queue_index[pass_index] = compute_queue_index;
+        const auto moved_frame_time_msec = simulate();
+        if (moved_frame_time_msec + option.min_gain_msec <= frame_time_msec) {
+          frame_time_msec = moved_frame_time_msec;
+          r.render_pass_list[pass_index].command_queue_index = compute_queue_index;
+          schedule.moved_pass_num++;
+          continue;
+        }
+        render_pass_queue_index[pass_index] = r.render_pass_list[pass_index].command_queue_index;
+      }
+    }
+  }
+  CompileRenderGraph(buffer_name_hash_list, memory_type, graph);
+  schedule.timeline = PredictRenderPassTimeline(r, render_pass_cost_msec, option.fence_latency_msec, memory_type);
+  return schedule;
+}
+}
+#include "doctest/doctest.h"
+#include <cmath>
+#include "d3d12_test_util.h"
+namespace {
+auto IsSameMsec(const float a, const float b) {
+  return std::abs(a - b) < 0.0001f;
+}
+} // namespace
+TEST_CASE("render pass cost sources") { // NOLINT
+  using namespace illuminate;
+  auto json = LoadTestJson("deferred.json");
+  RenderGraphConfig render_graph{};
+  LoadTestRenderGraph(json, &render_graph);
+  SUBCASE("gpu timestamps") {
+    uint32_t render_pass_num_per_queue[3]{};
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      render_pass_num_per_queue[render_graph.render_pass_list[i].command_queue_index]++;
+    }
+    auto gpu_time_durations = GetEmptyGpuTimeDurations(render_graph.command_queue_num, render_pass_num_per_queue, MemoryType::kFrame);
+    for (uint32_t i = 0; i < gpu_time_durations.command_queue_num; i++) {
+      for (uint32_t j = 0; j < gpu_time_durations.duration_num[i]; j++) {
+        gpu_time_durations.duration_msec[i][j] = static_cast<float>(i * 100 + j);
+      }
+    }
+    const auto cost = GetRenderPassCostMsec(gpu_time_durations, render_graph, MemoryType::kFrame);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("copy resource"))], 201.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("prez"))], 1.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("gbuffer"))], 3.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("linear depth"))], 101.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("screen space shadow"))], 103.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("imgui"))], 7.0f);
+  }
+  SUBCASE("static cost model") {
+    const RenderPassStaticCostModel cost_model{.pass_msec = 1.0f, .buffer_read_msec = 2.0f, .buffer_write_msec = 4.0f,};
+    const auto cost = GetRenderPassCostMsec(cost_model, render_graph, MemoryType::kFrame);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("copy resource"))], 1.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("linear depth"))], 1.0f + 2.0f * 2 + 2.0f + 4.0f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("output to swapchain"))], 1.0f + 2.0f + 4.0f);
+  }
+  SUBCASE("recorded timing file") {
+    const auto cost = ParseRenderPassCostJson(LoadTestJson("deferred_timing.json"), render_graph, 0.0f, MemoryType::kFrame);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("gbuffer"))], 1.2f);
+    CHECK_EQ(cost[FindRenderPassIndex(render_graph, SID("imgui"))], 0.05f);
+    const auto cost_json = CreateRenderPassCostJson(render_graph, cost);
+    const auto parsed_cost = ParseRenderPassCostJson(cost_json, render_graph, -1.0f, MemoryType::kFrame);
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      CHECK_EQ(parsed_cost[i], cost[i]);
+    }
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("async compute scheduler") { // NOLINT
+  using namespace illuminate;
+  const AsyncComputeSchedulerOption option{};
+  SUBCASE("authored deferred.json keeps its queues") {
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(LoadTestJson("deferred.json"), &render_graph).second;
+    const auto cost = ParseRenderPassCostJson(LoadTestJson("deferred_timing.json"), render_graph, 0.0f, MemoryType::kFrame);
+    const auto before = PredictRenderPassTimeline(render_graph, cost, option.fence_latency_msec, MemoryType::kFrame);
+    CHECK_UNARY(IsSameMsec(before.frame_time_msec, 2.77f));
+    const auto schedule = ScheduleAsyncCompute(cost, buffer_name_hash_list, option, MemoryType::kFrame, &render_graph);
+    CHECK_EQ(schedule.moved_pass_num, 0);
+    CHECK_UNARY(IsSameMsec(schedule.frame_time_msec_before, before.frame_time_msec));
+    CHECK_UNARY(IsSameMsec(schedule.timeline.frame_time_msec, before.frame_time_msec));
+  }
+  SUBCASE("compute passes authored on the graphics queue") {
+    auto json = LoadTestJson("deferred.json");
+    for (auto& pass : json.at("render_pass")) {
+      if (pass.at("command_queue") == "queue_compute") {
+        pass["command_queue"] = "queue_graphics";
+      }
+      pass.erase("wait_pass");
+    }
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph);
+    const auto cost = ParseRenderPassCostJson(LoadTestJson("deferred_timing.json"), render_graph, 0.0f, MemoryType::kFrame);
+    const auto before = PredictRenderPassTimeline(render_graph, cost, option.fence_latency_msec, MemoryType::kFrame);
+    CHECK_UNARY(IsSameMsec(before.frame_time_msec, 3.42f));
+    CHECK_UNARY(IsSameMsec(before.critical_path_msec, 2.62f));
+    const auto schedule = ScheduleAsyncCompute(cost, buffer_name_hash_list, option, MemoryType::kFrame, &render_graph);
+    CHECK_UNARY(IsSameMsec(schedule.frame_time_msec_before, before.frame_time_msec));
+    // lighting stays on the critical path, moving it would add a fence before output to swapchain.
+    CHECK_EQ(schedule.moved_pass_num, 2);
+    const auto linear_depth = FindRenderPassIndex(render_graph, SID("linear depth"));
+    const auto screen_space_shadow = FindRenderPassIndex(render_graph, SID("screen space shadow"));
+    const auto lighting = FindRenderPassIndex(render_graph, SID("lighting"));
+    CHECK_EQ(render_graph.command_queue_type[render_graph.render_pass_list[linear_depth].command_queue_index], D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    CHECK_EQ(render_graph.command_queue_type[render_graph.render_pass_list[screen_space_shadow].command_queue_index], D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    CHECK_EQ(render_graph.command_queue_type[render_graph.render_pass_list[lighting].command_queue_index], D3D12_COMMAND_LIST_TYPE_DIRECT);
+    REQUIRE_EQ(render_graph.render_pass_list[linear_depth].wait_pass_num, 1);
+    CHECK_EQ(render_graph.render_pass_list[linear_depth].signal_pass_index[0], FindRenderPassIndex(render_graph, SID("prez")));
+    REQUIRE_EQ(render_graph.render_pass_list[lighting].wait_pass_num, 1);
+    CHECK_EQ(render_graph.render_pass_list[lighting].signal_pass_index[0], screen_space_shadow);
+    CHECK_UNARY(IsSameMsec(schedule.timeline.frame_time_msec, 2.67f));
+    CHECK_UNARY(IsSameMsec(schedule.timeline.critical_path_msec, 2.62f));
+    CHECK_UNARY(IsSameMsec(schedule.timeline.start_msec[linear_depth], 0.47f));
+    CHECK_UNARY(IsSameMsec(schedule.timeline.end_msec[screen_space_shadow], 1.22f));
+    CHECK_UNARY(IsSameMsec(schedule.timeline.start_msec[lighting], 1.62f));
+  }
+  ClearAllAllocations();
+}
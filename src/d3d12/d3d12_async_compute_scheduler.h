@@ -0,0 +1,49 @@
+#ifndef ILLUMINATE_D3D12_ASYNC_COMPUTE_SCHEDULER_H
+#define ILLUMINATE_D3D12_ASYNC_COMPUTE_SCHEDULER_H
+#include "d3d12_gpu_timestamp_set.h"
+#include "d3d12_render_graph.h"
+#include "illuminate/core/strid.h"
+#include "illuminate/util/util_defines.h"
+#include <nlohmann/json.hpp>
+namespace illuminate {
+enum class MemoryType : uint8_t;
+/**
+ * offline scheduler moving passes from direct queues to the first compute queue when it shortens the predicted frame time.
+ * a pass is eligible when it has buffers and all of them are in cbv, srv non ps, uav, copy or generic read states,
+ * i.e. nothing but a dispatch (or copy) could implement it.
+ * pass costs come from recorded gpu timestamps, from a cost json ({"pass name": msec, ...}) or from a static cost model.
+ * eligible passes are tried in decreasing slack order of the critical path (passes off the critical path first),
+ * a move is kept when the predicted frame time decreases. predictions run passes of a queue in order,
+ * each starting after its queue predecessor and after its in-frame dependencies on other queues plus fence_latency_msec.
+ * waits are derived again by CompileRenderGraph() afterwards.
+ **/
+struct AsyncComputeSchedulerOption {
+  float fence_latency_msec{0.05f};
+  float min_gain_msec{0.001f};
+};
+struct RenderPassStaticCostModel {
+  float pass_msec{0.01f};
+  float buffer_read_msec{0.05f};
+  float buffer_write_msec{0.1f};
+};
+struct RenderPassTimeline {
+  float* start_msec{nullptr}; // per render pass, 0 for disabled passes.
+  float* end_msec{nullptr};
+  float frame_time_msec{0.0f};
+  float critical_path_msec{0.0f}; // frame time with a queue per pass and no fence latency, i.e. the lower bound.
+};
+struct AsyncComputeSchedule {
+  uint32_t moved_pass_num{0};
+  float frame_time_msec_before{0.0f};
+  RenderPassTimeline timeline{};
+};
+float* GetRenderPassCostMsec(const GpuTimeDurations& gpu_time_durations, const RenderGraphConfig& graph, const MemoryType& memory_type);
+float* GetRenderPassCostMsec(const RenderPassStaticCostModel& cost_model, const RenderGraphConfig& graph, const MemoryType& memory_type);
+float* ParseRenderPassCostJson(const nlohmann::json& j, const RenderGraphConfig& graph, const float default_cost_msec, const MemoryType& memory_type);
+nlohmann::json CreateRenderPassCostJson(const RenderGraphConfig& graph, const float* render_pass_cost_msec); // uses interned pass names.
+bool IsAsyncComputeEligible(const RenderPass& render_pass);
+// predicts using the graph's wait lists.
+RenderPassTimeline PredictRenderPassTimeline(const RenderGraphConfig& graph, const float* render_pass_cost_msec, const float fence_latency_msec, const MemoryType& memory_type);
+AsyncComputeSchedule ScheduleAsyncCompute(const float* render_pass_cost_msec, const StrHash* buffer_name_hash_list, const AsyncComputeSchedulerOption& option, const MemoryType& memory_type, RenderGraphConfig* graph);
+}
+#endif
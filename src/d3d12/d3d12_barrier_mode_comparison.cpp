@@ -0,0 +1,237 @@
+#include "d3d12_barrier_mode_comparison.h"
+#include <algorithm>
+#include "d3d12_gpu_buffer_allocator.h"
+#include "d3d12_memory_allocators.h"
+#include "d3d12_src_common.h"
+namespace illuminate {
+namespace {
+auto GetBarrierSyncNameList(const D3D12_BARRIER_SYNC sync) {
+  static const std::pair<D3D12_BARRIER_SYNC, const char*> kSyncNameList[] = {
+    {D3D12_BARRIER_SYNC_ALL,               "all"},
+    {D3D12_BARRIER_SYNC_DRAW,              "draw"},
+    {D3D12_BARRIER_SYNC_INDEX_INPUT,       "index_input"},
+    {D3D12_BARRIER_SYNC_VERTEX_SHADING,    "vertex_shading"},
+    {D3D12_BARRIER_SYNC_PIXEL_SHADING,     "pixel_shading"},
+    {D3D12_BARRIER_SYNC_DEPTH_STENCIL,     "depth_stencil"},
+    {D3D12_BARRIER_SYNC_RENDER_TARGET,     "render_target"},
+    {D3D12_BARRIER_SYNC_COMPUTE_SHADING,   "compute_shading"},
+    {D3D12_BARRIER_SYNC_RAYTRACING,        "raytracing"},
+    {D3D12_BARRIER_SYNC_COPY,              "copy"},
+    {D3D12_BARRIER_SYNC_RESOLVE,           "resolve"},
+    {D3D12_BARRIER_SYNC_EXECUTE_INDIRECT,  "execute_indirect"},
+    {D3D12_BARRIER_SYNC_ALL_SHADING,       "all_shading"},
+    {D3D12_BARRIER_SYNC_NON_PIXEL_SHADING, "non_pixel_shading"},
+    {D3D12_BARRIER_SYNC_SPLIT,             "split"},
+  };
+  auto names = nlohmann::json::array();
+  for (const auto& [bit, name] : kSyncNameList) {
+    if ((sync & bit) != 0) {
+      names.push_back(name);
+    }
+  }
+  if (names.empty()) {
+    names.push_back("none");
+  }
+  return names;
+}
+const char* GetBarrierLayoutName(const D3D12_BARRIER_LAYOUT layout) {
+  switch (layout) {
+    case D3D12_BARRIER_LAYOUT_UNDEFINED:           { return "undefined"; }
+    case D3D12_BARRIER_LAYOUT_COMMON:              { return "common"; }
+    case D3D12_BARRIER_LAYOUT_GENERIC_READ:        { return "generic_read"; }
+    case D3D12_BARRIER_LAYOUT_RENDER_TARGET:       { return "render_target"; }
+    case D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS:    { return "unordered_access"; }
+    case D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE: { return "depth_stencil_write"; }
+    case D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ:  { return "depth_stencil_read"; }
+    case D3D12_BARRIER_LAYOUT_SHADER_RESOURCE:     { return "shader_resource"; }
+    case D3D12_BARRIER_LAYOUT_COPY_SOURCE:         { return "copy_source"; }
+    case D3D12_BARRIER_LAYOUT_COPY_DEST:           { return "copy_dest"; }
+    case D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE:      { return "resolve_source"; }
+    case D3D12_BARRIER_LAYOUT_RESOLVE_DEST:        { return "resolve_dest"; }
+  }
+  return "unknown";
+}
+// buffer config index per buffer allocation as CreateBuffers() allocates them.
+auto GetBufferAllocationConfigIndexList(const RenderGraphConfig& graph) {
+  uint32_t buffer_allocation_num = 0;
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    buffer_allocation_num += GetBufferAllocationNum(graph.buffer_list[i], graph.frame_buffer_num);
+  }
+  auto config_index = AllocateArrayFrame<uint32_t>(buffer_allocation_num);
+  uint32_t buffer_allocation_index = 0;
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    const auto alloc_num = GetBufferAllocationNum(graph.buffer_list[i], graph.frame_buffer_num);
+    std::fill_n(&config_index[buffer_allocation_index], alloc_num, i);
+    buffer_allocation_index += alloc_num;
+  }
+  return std::make_pair(config_index, buffer_allocation_num);
+}
+EnhancedBarrierConfigList* ConvertRenderGraphBarrierTransitionsToEnhancedBarriersImpl(const RenderGraphConfig& graph, const BarrierTransitionInfo& barrier_transition, const MemoryType& memory_type) {
+  auto render_pass_command_queue_index = AllocateArrayFrame<uint32_t>(graph.render_pass_num);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    render_pass_command_queue_index[i] = graph.render_pass_list[i].command_queue_index;
+  }
+  const auto [config_index, buffer_allocation_num] = GetBufferAllocationConfigIndexList(graph);
+  auto texture_flag = AllocateArrayFrame<bool>(buffer_allocation_num);
+  for (uint32_t i = 0; i < buffer_allocation_num; i++) {
+    texture_flag[i] = graph.buffer_list[config_index[i]].dimension != D3D12_RESOURCE_DIMENSION_BUFFER;
+  }
+  return ConvertToEnhancedBarriers(graph.render_pass_num, barrier_transition.barrier_config_list, render_pass_command_queue_index, graph.command_queue_type,
+                                   buffer_allocation_num, texture_flag, memory_type);
+}
+} // namespace
+EnhancedBarrierConfigList* ConvertRenderGraphBarrierTransitionsToEnhancedBarriers(const RenderGraphConfig& graph, const BarrierTransitionInfo& barrier_transition, const MemoryType& memory_type) {
+  // the conversion is allocated after its inputs, which hence stay until the caller's frame memory is released when converted in it.
+  if (memory_type == MemoryType::kFrame) { return ConvertRenderGraphBarrierTransitionsToEnhancedBarriersImpl(graph, barrier_transition, memory_type); }
+  FrameMemoryCheckpoint checkpoint;
+  return ConvertRenderGraphBarrierTransitionsToEnhancedBarriersImpl(graph, barrier_transition, memory_type);
+}
+nlohmann::json CreateBarrierModeComparisonJson(const RenderGraphConfig& graph, const RenderGraphExportInfo& info, const EnhancedBarrierConfigList* enhanced_barrier_config_list) {
+  FrameMemoryCheckpoint checkpoint;
+  const auto config_index = GetBufferAllocationConfigIndexList(graph).first;
+  uint32_t legacy_barrier_num = 0;
+  uint32_t enhanced_barrier_num = 0;
+  uint32_t buffer_barrier_num = 0;
+  uint32_t texture_barrier_num = 0;
+  uint32_t layout_change_num = 0;
+  uint32_t split_barrier_num = 0;
+  auto sync_before_num = nlohmann::json::object();
+  auto sync_after_num = nlohmann::json::object();
+  auto passes = nlohmann::json::array();
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto pass_legacy_barrier_num = GetBarrierNum(info, i);
+    legacy_barrier_num += pass_legacy_barrier_num;
+    auto barriers = nlohmann::json::array();
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      for (uint32_t k = 0; k < enhanced_barrier_config_list[i][j].size; k++) {
+        const auto& barrier = enhanced_barrier_config_list[i][j].array[k];
+        const auto texture = barrier.type == D3D12_BARRIER_TYPE_TEXTURE;
+        (texture ? texture_barrier_num : buffer_barrier_num)++;
+        if (barrier.layout_before != barrier.layout_after) {
+          layout_change_num++;
+        }
+        if (barrier.sync_before == D3D12_BARRIER_SYNC_SPLIT || barrier.sync_after == D3D12_BARRIER_SYNC_SPLIT) {
+          split_barrier_num++;
+        }
+        auto sync_before = GetBarrierSyncNameList(barrier.sync_before);
+        auto sync_after = GetBarrierSyncNameList(barrier.sync_after);
+        for (const auto& name : sync_before) {
+          sync_before_num[name.get<std::string>()] = sync_before_num.value(name.get<std::string>(), 0U) + 1;
+        }
+        for (const auto& name : sync_after) {
+          sync_after_num[name.get<std::string>()] = sync_after_num.value(name.get<std::string>(), 0U) + 1;
+        }
+        nlohmann::json entry = {
+          {"buffer", GetBufferName(info, config_index[barrier.buffer_allocation_index])},
+          {"timing", j == 0 ? "before" : "after"},
+          {"type", texture ? "texture" : "buffer"},
+          {"sync_before", std::move(sync_before)},
+          {"sync_after", std::move(sync_after)},
+        };
+        if (texture) {
+          entry["layout_before"] = GetBarrierLayoutName(barrier.layout_before);
+          entry["layout_after"] = GetBarrierLayoutName(barrier.layout_after);
+        }
+        barriers.push_back(std::move(entry));
+      }
+    }
+    enhanced_barrier_num += GetUint32(barriers.size());
+    passes.push_back({
+        {"name", GetRenderPassName(graph, i)},
+        {"queue", GetCommandQueueTypeName(graph.command_queue_type[graph.render_pass_list[i].command_queue_index])},
+        {"legacy_barriers", pass_legacy_barrier_num},
+        {"enhanced_barriers", std::move(barriers)},
+      });
+  }
+  return {
+    {"legacy", {
+        {"barriers", legacy_barrier_num},
+        {"sync_before", {{"all", legacy_barrier_num}}},
+        {"sync_after", {{"all", legacy_barrier_num}}},
+      }},
+    {"enhanced", {
+        {"barriers", enhanced_barrier_num},
+        {"removed_read_only_transitions", legacy_barrier_num > enhanced_barrier_num ? legacy_barrier_num - enhanced_barrier_num : 0U},
+        {"buffer_barriers", buffer_barrier_num},
+        {"texture_barriers", texture_barrier_num},
+        {"layout_changes", layout_change_num},
+        {"split_barriers", split_barrier_num},
+        {"sync_before", std::move(sync_before_num)},
+        {"sync_after", std::move(sync_after_num)},
+      }},
+    {"passes", std::move(passes)},
+  };
+}
+bool ExportBarrierModeComparison(const char* const render_graph_json_path, const char* const material_json_path, const char* const dst_report_path) {
+  RenderGraphConfig graph{};
+  const char* const * buffer_name_list = nullptr;
+  if (!LoadRenderGraphForExport(render_graph_json_path, material_json_path, &graph, &buffer_name_list)) { return false; }
+  // same plan as ExportRenderGraph(), split with the default cost model.
+  const BarrierSplitCostModel split_cost_model{};
+  const auto barrier_transition = PlanRenderGraphBarrierTransitions(graph, &split_cost_model, MemoryType::kFrame);
+  RenderGraphExportInfo info{
+    .buffer_name_list = buffer_name_list,
+    .barrier_transition = &barrier_transition,
+  };
+  const auto enhanced_barrier_config_list = ConvertRenderGraphBarrierTransitionsToEnhancedBarriers(graph, barrier_transition, MemoryType::kFrame);
+  if (!WriteTextFile(dst_report_path, CreateBarrierModeComparisonJson(graph, info, enhanced_barrier_config_list).dump(2))) { return false; }
+  loginfo("compared barriers of {} into {}", render_graph_json_path, dst_report_path);
+  return true;
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+#include <filesystem>
+#include "d3d12_test_util.h"
+TEST_CASE("barrier mode comparison") { // NOLINT
+  using namespace illuminate;
+  RenderGraphConfig render_graph{};
+  const auto buffer_name_list = LoadTestRenderGraph(LoadTestJson("deferred.json"), &render_graph).first;
+  const BarrierSplitCostModel split_cost_model{};
+  const auto barrier_transition = PlanRenderGraphBarrierTransitions(render_graph, &split_cost_model, MemoryType::kFrame);
+  RenderGraphExportInfo info{
+    .buffer_name_list = buffer_name_list,
+    .barrier_transition = &barrier_transition,
+  };
+  SUBCASE("report") {
+    const auto enhanced_barrier_config_list = ConvertRenderGraphBarrierTransitionsToEnhancedBarriers(render_graph, barrier_transition, MemoryType::kFrame);
+    const auto report = CreateBarrierModeComparisonJson(render_graph, info, enhanced_barrier_config_list);
+    CHECK_EQ(report.dump(), CreateBarrierModeComparisonJson(render_graph, info, enhanced_barrier_config_list).dump());
+    const auto& legacy = report.at("legacy");
+    const auto& enhanced = report.at("enhanced");
+    const auto legacy_barrier_num = legacy.at("barriers").get<uint32_t>();
+    const auto enhanced_barrier_num = enhanced.at("barriers").get<uint32_t>();
+    CHECK_GT(enhanced_barrier_num, 0);
+    CHECK_LE(enhanced_barrier_num, legacy_barrier_num);
+    CHECK_EQ(enhanced.at("removed_read_only_transitions").get<uint32_t>(), legacy_barrier_num - enhanced_barrier_num);
+    CHECK_EQ(enhanced.at("buffer_barriers").get<uint32_t>() + enhanced.at("texture_barriers").get<uint32_t>(), enhanced_barrier_num);
+    CHECK_EQ(report.at("passes").size(), render_graph.render_pass_num);
+    // deferred.json changes a layout with each transition, enhanced barriers narrow their sync scopes.
+    CHECK_EQ(enhanced.at("layout_changes").get<uint32_t>(), legacy_barrier_num);
+    CHECK_UNARY_FALSE(enhanced.at("sync_before").contains("all"));
+    CHECK_UNARY_FALSE(enhanced.at("sync_after").contains("all"));
+    const auto prez_index = FindRenderPassIndex(render_graph, "prez");
+    REQUIRE_LT(prez_index, render_graph.render_pass_num);
+    const auto& prez = report.at("passes").at(prez_index);
+    CHECK_EQ(prez.at("name"), "prez");
+    REQUIRE_EQ(prez.at("enhanced_barriers").size(), 1);
+    CHECK_EQ(prez.at("enhanced_barriers").at(0).at("layout_before"), "depth_stencil_write");
+    CHECK_EQ(prez.at("enhanced_barriers").at(0).at("layout_after"), "depth_stencil_read");
+  }
+  SUBCASE("converted in scene memory") {
+    // frame memory used for the conversion is released on return.
+    const auto enhanced_barrier_config_list = ConvertRenderGraphBarrierTransitionsToEnhancedBarriers(render_graph, barrier_transition, MemoryType::kScene);
+    const auto report = CreateBarrierModeComparisonJson(render_graph, info, enhanced_barrier_config_list);
+    const auto enhanced_barrier_config_list_frame = ConvertRenderGraphBarrierTransitionsToEnhancedBarriers(render_graph, barrier_transition, MemoryType::kFrame);
+    CHECK_EQ(report.dump(), CreateBarrierModeComparisonJson(render_graph, info, enhanced_barrier_config_list_frame).dump());
+  }
+  SUBCASE("headless export") {
+    const auto report_path = (std::filesystem::temp_directory_path() / "barrier_mode_comparison_test.json").string();
+    CHECK_UNARY(ExportBarrierModeComparison("deferred.json", "material.json", report_path.c_str()));
+    nlohmann::json report;
+    CHECK_UNARY(LoadJsonFile(report_path.c_str(), &report));
+    CHECK_UNARY(report.contains("enhanced"));
+    CHECK_FALSE(ExportBarrierModeComparison("not_found.json", "material.json", report_path.c_str()));
+    std::filesystem::remove(report_path);
+  }
+  ClearAllAllocations();
+}
@@ -0,0 +1,20 @@
+#ifndef ILLUMINATE_D3D12_BARRIER_MODE_COMPARISON_H
+#define ILLUMINATE_D3D12_BARRIER_MODE_COMPARISON_H
+#include "d3d12_barriers.h"
+#include "d3d12_enhanced_barriers.h"
+#include "d3d12_render_graph.h"
+#include "d3d12_render_graph_export.h"
+#include "illuminate/d3d12/barrier_mode_comparison.h"
+#include <nlohmann/json.hpp>
+namespace illuminate {
+enum class MemoryType : uint8_t;
+// converts barriers planned by PlanRenderGraphBarrierTransitions() with buffer dimensions from the graph.
+EnhancedBarrierConfigList* ConvertRenderGraphBarrierTransitionsToEnhancedBarriers(const RenderGraphConfig& graph, const BarrierTransitionInfo& barrier_transition, const MemoryType& memory_type);
+/**
+ * compares legacy barriers (info.barrier_transition) with their enhanced barrier conversion, in total and per pass:
+ * barrier counts, removed read only transitions, buffer and texture barriers, layout changes and the stages each barrier syncs.
+ * legacy transitions sync all stages before and after them, split barriers count a barrier each for begin and end.
+ **/
+nlohmann::json CreateBarrierModeComparisonJson(const RenderGraphConfig& graph, const RenderGraphExportInfo& info, const EnhancedBarrierConfigList* enhanced_barrier_config_list);
+}
+#endif
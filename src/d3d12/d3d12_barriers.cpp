@@ -8,6 +8,9 @@ struct ResourceStateTransitionInfo {
   uint32_t timing{};
   ResourceStateTypeFlags::FlagType state_before{ResourceStateTypeFlags::kNone};
   ResourceStateTypeFlags::FlagType state_after{ResourceStateTypeFlags::kNone};
+  uint32_t prev_user_pass{~0U}; // last pass using the buffer before a transition at timing 0.
+  uint32_t split_begin_pass{~0U}; // BEGIN_ONLY is issued after split_begin_pass when valid, the transition itself is END_ONLY.
+  uint32_t subresource{D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES};
 };
 auto CollectStateTransitionInfo(const uint32_t render_pass_num,
                                 const uint32_t buffer_allocation_num,
@@ -65,6 +68,42 @@ auto IsStateValidForQueue(const D3D12_COMMAND_LIST_TYPE command_queue_type, cons
   }
   return false;
 }
+// returns the last graphics queue pass each non-graphics queue pass is synchronized with (render_pass_num if none) and the last graphics queue pass.
+auto GetLastSyncGraphicsQueuePass(const uint32_t render_pass_num, const uint32_t* render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
+                                  const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index) {
+  uint32_t graphics_queue_last_pass = 0;
+  auto last_sync_graphics_queue_pass = AllocateAndFillArrayFrame(render_pass_num, render_pass_num);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    if (command_queue_type[render_pass_command_queue_index[i]] == D3D12_COMMAND_LIST_TYPE_DIRECT) {
+      graphics_queue_last_pass = i;
+    } else if (i > 0) {
+      last_sync_graphics_queue_pass[i] = last_sync_graphics_queue_pass[i - 1];
+      for (uint32_t j = 0; j < wait_pass_num[i]; j++) {
+        // the latest one when waiting for multiple graphics passes.
+        if (command_queue_type[render_pass_command_queue_index[signal_pass_index[i][j]]] == D3D12_COMMAND_LIST_TYPE_DIRECT
+            && (last_sync_graphics_queue_pass[i] >= render_pass_num || last_sync_graphics_queue_pass[i] < signal_pass_index[i][j])) {
+          last_sync_graphics_queue_pass[i] = signal_pass_index[i][j];
+        }
+      }
+    }
+  }
+  return std::make_pair(last_sync_graphics_queue_pass, graphics_queue_last_pass);
+}
+// read states following the first read transition are merged into it, which is valid only while the buffer is not written after it.
+// returns the merged read states, or kNone when the buffer is written after its first read.
+auto GetMergedReadStateSinceFirstRead(const ArrayOf<ResourceStateTransitionInfo>& transition_list, const ResourceStateTypeFlags::FlagType mergeable_read_states) {
+  ResourceStateTypeFlags::FlagType merged_read_state = ResourceStateTypeFlags::kNone;
+  for (uint32_t i = 0; i < transition_list.size; i++) {
+    const auto state_after = transition_list.array[i].state_after;
+    if (merged_read_state == ResourceStateTypeFlags::kNone) {
+      merged_read_state = state_after & mergeable_read_states;
+      continue;
+    }
+    if ((state_after & ~mergeable_read_states) != 0) { return ResourceStateTypeFlags::kNone; }
+    merged_read_state |= state_after;
+  }
+  return merged_read_state;
+}
 auto GetResourceStateTransitionInfo(const uint32_t render_pass_num, const uint32_t *  render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
                                     const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index,
                                     const uint32_t buffer_allocation_num,
@@ -79,32 +118,24 @@ auto GetResourceStateTransitionInfo(const uint32_t render_pass_num, const uint32
     resource_state_traisition_info_list[i].size = 0;
     resource_state_traisition_info_list[i].array = AllocateArrayFrame<ResourceStateTransitionInfo>(max_transition_num[i]);
   }
-  uint32_t graphics_queue_last_pass = 0;
-  auto last_sync_graphics_queue_pass = AllocateAndFillArrayFrame(render_pass_num, render_pass_num);
+  const auto [last_sync_graphics_queue_pass, graphics_queue_last_pass] = GetLastSyncGraphicsQueuePass(render_pass_num, render_pass_command_queue_index, command_queue_type, wait_pass_num, signal_pass_index);
+  auto last_user_pass = AllocateAndFillArrayFrame(buffer_allocation_num, ~0U);
   // collect naive transitions
   for (uint32_t i = 0; i < render_pass_num; i++) {
-    if (command_queue_type[render_pass_command_queue_index[i]] == D3D12_COMMAND_LIST_TYPE_DIRECT) {
-      graphics_queue_last_pass = i;
-    } else if (i > 0) {
-      last_sync_graphics_queue_pass[i] = last_sync_graphics_queue_pass[i - 1];
-      for (uint32_t j = 0; j < wait_pass_num[i]; j++) {
-        if (command_queue_type[render_pass_command_queue_index[signal_pass_index[i][j]]] == D3D12_COMMAND_LIST_TYPE_DIRECT) {
-          last_sync_graphics_queue_pass[i] = signal_pass_index[i][j];
-          break;
-        }
-      }
-    }
     for (uint32_t j = 0; j < render_pass_buffer_num[i]; j++) {
       const auto& buffer_id = render_pass_buffer_allocation_index_list[i][j];
       if (buffer_id >= buffer_allocation_num) { continue; }
       const auto current_size = resource_state_traisition_info_list[buffer_id].size;
       const auto prev_state = (current_size == 0) ? initial_state[buffer_id] : resource_state_traisition_info_list[buffer_id].array[current_size - 1].state_after;
+      const auto prev_user_pass = last_user_pass[buffer_id];
+      last_user_pass[buffer_id] = i;
       if (prev_state == render_pass_resource_state_list[i][j]) { continue; }
       resource_state_traisition_info_list[buffer_id].size++;
       resource_state_traisition_info_list[buffer_id].array[current_size].pass         = i;
       resource_state_traisition_info_list[buffer_id].array[current_size].timing       = 0;
       resource_state_traisition_info_list[buffer_id].array[current_size].state_before = prev_state;
       resource_state_traisition_info_list[buffer_id].array[current_size].state_after  = render_pass_resource_state_list[i][j];
+      resource_state_traisition_info_list[buffer_id].array[current_size].prev_user_pass = (prev_user_pass == i) ? ~0U : prev_user_pass;
     }
   }
   for (uint32_t i = 0; i < buffer_allocation_num; i++) {
@@ -132,40 +163,44 @@ auto GetResourceStateTransitionInfo(const uint32_t render_pass_num, const uint32
         resource_state_traisition_info_list[i].array[0].timing       = 0;
         resource_state_traisition_info_list[i].array[0].state_before = initial_state[i];
         resource_state_traisition_info_list[i].array[0].state_after  = dsv_write_read;
+        resource_state_traisition_info_list[i].array[0].prev_user_pass = ~0U;
       } else {
         resource_state_traisition_info_list[i].size = 0;
       }
     } else if (merged_state[i] == generic_read_cbv) {
       // no state change needed
       resource_state_traisition_info_list[i].size = 0;
-    } else if (const auto state_after = merged_state[i] & mergeable_read_states; std::popcount(state_after) > 1) {
-      // merge all readable states
-      for (uint32_t j = 0; j < resource_state_traisition_info_list[i].size; j++) {
-        if ((state_after & resource_state_traisition_info_list[i].array[j].state_after) != 0) {
-          for (uint32_t k = j + 1; k < resource_state_traisition_info_list[i].size; k++) {
-            const auto following_pass = resource_state_traisition_info_list[i].array[k].pass;
-            if (command_queue_type[render_pass_command_queue_index[following_pass]] == D3D12_COMMAND_LIST_TYPE_DIRECT) { continue; }
-            if (resource_state_traisition_info_list[i].array[j].pass > last_sync_graphics_queue_pass[following_pass]) {
-              assert(last_sync_graphics_queue_pass[following_pass] < render_pass_num);
-              resource_state_traisition_info_list[i].array[j].pass = last_sync_graphics_queue_pass[following_pass];
-              resource_state_traisition_info_list[i].array[j].timing = 1;
-            }
-          }
-          if (const auto current_pass = resource_state_traisition_info_list[i].array[j].pass;
-              !IsStateValidForQueue(command_queue_type[render_pass_command_queue_index[current_pass]], state_after)) {
-            assert(last_sync_graphics_queue_pass[current_pass] < render_pass_num);
-            if (j > 0 && resource_state_traisition_info_list[i].array[j - 1].pass >= last_sync_graphics_queue_pass[current_pass]) {
-              continue;
-            }
-            resource_state_traisition_info_list[i].array[j].pass = last_sync_graphics_queue_pass[current_pass];
-            resource_state_traisition_info_list[i].array[j].timing = 1;
+    } else if (const auto state_after = GetMergedReadStateSinceFirstRead(resource_state_traisition_info_list[i], mergeable_read_states); std::popcount(state_after) > 1) {
+      // merge all readable states into the first read transition possible, on a graphics pass all following compute queue users are synchronized with if needed.
+      auto& transition_list = resource_state_traisition_info_list[i];
+      for (uint32_t j = 0; j < transition_list.size; j++) {
+        if ((transition_list.array[j].state_after & state_after) == 0) { continue; }
+        auto pass = transition_list.array[j].pass;
+        auto timing = transition_list.array[j].timing;
+        for (uint32_t k = j + 1; k < transition_list.size; k++) {
+          const auto following_pass = transition_list.array[k].pass;
+          if (command_queue_type[render_pass_command_queue_index[following_pass]] == D3D12_COMMAND_LIST_TYPE_DIRECT) { continue; }
+          if (pass > last_sync_graphics_queue_pass[following_pass]) {
+            pass = last_sync_graphics_queue_pass[following_pass];
+            timing = 1;
           }
-          resource_state_traisition_info_list[i].size = j + 1;
-          resource_state_traisition_info_list[i].array[j].state_after = state_after;
-          break;
         }
+        if (pass < render_pass_num && !IsStateValidForQueue(command_queue_type[render_pass_command_queue_index[pass]], state_after)) {
+          pass = last_sync_graphics_queue_pass[pass];
+          timing = 1;
+        }
+        // try the next read transition when no such pass follows the previous use and transition of the buffer.
+        const auto prev_user_pass = transition_list.array[j].prev_user_pass;
+        const auto after_prev_use = prev_user_pass >= render_pass_num || pass > prev_user_pass || (pass == prev_user_pass && timing == 1);
+        const auto after_prev_transition = j == 0 || pass > transition_list.array[j - 1].pass || (pass == transition_list.array[j - 1].pass && timing >= transition_list.array[j - 1].timing);
+        if (pass >= render_pass_num || !after_prev_use || !after_prev_transition) { continue; }
+        transition_list.array[j].pass = pass;
+        transition_list.array[j].timing = timing;
+        transition_list.array[j].state_after = state_after;
+        transition_list.size = j + 1;
+        break;
       }
-    } else if (last_sync_graphics_queue_pass[initial_user_pass[i]] >= render_pass_num && command_queue_type[render_pass_command_queue_index[initial_user_pass[i]]] != D3D12_COMMAND_LIST_TYPE_DIRECT && (merged_state[i] & GetGraphicsQueueOnlyStateFlags()) != 0) {
+    } else if (initial_user_pass[i] < render_pass_num && last_sync_graphics_queue_pass[initial_user_pass[i]] >= render_pass_num && command_queue_type[render_pass_command_queue_index[initial_user_pass[i]]] != D3D12_COMMAND_LIST_TYPE_DIRECT && (merged_state[i] & GetGraphicsQueueOnlyStateFlags()) != 0) {
       const auto index = resource_state_traisition_info_list[i].size;
       resource_state_traisition_info_list[i].size++;
       resource_state_traisition_info_list[i].array[index].pass         = graphics_queue_last_pass;
@@ -182,6 +217,16 @@ auto GetResourceStateTransitionInfo(const uint32_t render_pass_num, const uint32
       const auto queue = command_queue_type[render_pass_command_queue_index[transition.pass]];
       if (IsStateValidForQueue(queue, transition.state_before) && IsStateValidForQueue(queue, transition.state_after)) { continue; }
       assert(last_sync_graphics_queue_pass[transition.pass] < render_pass_num);
+      // the buffer may have been used after the graphics pass (e.g. on compute then copy queues),
+      // the transition follows the previous user pass then when its queue supports both states.
+      if (const auto prev_user_pass = transition.prev_user_pass;
+          prev_user_pass < transition.pass && prev_user_pass > last_sync_graphics_queue_pass[transition.pass]
+          && IsStateValidForQueue(command_queue_type[render_pass_command_queue_index[prev_user_pass]], transition.state_before)
+          && IsStateValidForQueue(command_queue_type[render_pass_command_queue_index[prev_user_pass]], transition.state_after)) {
+        transition.pass = prev_user_pass;
+        transition.timing = 1;
+        continue;
+      }
       transition.pass = last_sync_graphics_queue_pass[transition.pass];
       transition.timing = 1;
     }
@@ -201,47 +246,272 @@ auto GetResourceStateTransitionInfo(const uint32_t render_pass_num, const uint32
   }
   return resource_state_traisition_info_list;
 }
-auto ConvertStateTransitionsToBarrierPerPass(const uint32_t render_pass_num, const uint32_t buffer_allocation_num, const ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list, const MemoryType& memory_type) {
+// invalid ranges mark the whole resource and return false.
+bool MarkSubresourceRange(const SubresourceRange& range, const SubresourceLayout& layout, bool* in_range) {
+  const auto subresource_num = GetSubresourceNum(layout);
+  if (!IsSubresourceRangeValid(range, layout)) {
+    std::fill_n(in_range, subresource_num, true);
+    return false;
+  }
+  std::fill_n(in_range, subresource_num, false);
+  const auto mip_end   = (range.mip_num == 0)   ? layout.mip_num   : std::min<uint32_t>(range.mip_slice + range.mip_num, layout.mip_num);
+  const auto array_end = (range.array_num == 0) ? layout.array_num : std::min<uint32_t>(range.array_slice + range.array_num, layout.array_num);
+  const auto plane_end = (range.plane_num == 0) ? layout.plane_num : std::min<uint32_t>(range.plane_slice + range.plane_num, layout.plane_num);
+  for (uint32_t plane = range.plane_slice; plane < plane_end; plane++) {
+    for (uint32_t array = range.array_slice; array < array_end; array++) {
+      for (uint32_t mip = range.mip_slice; mip < mip_end; mip++) {
+        in_range[GetSubresourceIndex(mip, array, plane, layout)] = true;
+      }
+    }
+  }
+  return true;
+}
+void AddSubresourceStateTransitions(const uint32_t pass, const uint32_t timing, const ResourceStateTypeFlags::FlagType state_after,
+                                    const uint32_t subresource_num, const bool* in_range, const uint32_t* last_user_pass,
+                                    ResourceStateTypeFlags::FlagType* state, ArrayOf<ResourceStateTransitionInfo>* transition_list) {
+  auto get_prev_user_pass = [pass](const uint32_t prev_user_pass) { return (prev_user_pass == pass) ? ~0U : prev_user_pass; };
+  bool uniform = state[0] != state_after;
+  uint32_t prev_user_pass = ~0U;
+  for (uint32_t i = 0; i < subresource_num && uniform; i++) {
+    uniform = in_range[i] && state[i] == state[0];
+    if (last_user_pass[i] != ~0U && (prev_user_pass == ~0U || last_user_pass[i] > prev_user_pass)) {
+      prev_user_pass = last_user_pass[i];
+    }
+  }
+  if (uniform) {
+    auto& transition = transition_list->array[transition_list->size];
+    transition_list->size++;
+    transition.pass           = pass;
+    transition.timing         = timing;
+    transition.state_before   = state[0];
+    transition.state_after    = state_after;
+    transition.prev_user_pass = get_prev_user_pass(prev_user_pass);
+    std::fill_n(state, subresource_num, state_after);
+    return;
+  }
+  for (uint32_t i = 0; i < subresource_num; i++) {
+    if (!in_range[i] || state[i] == state_after) { continue; }
+    auto& transition = transition_list->array[transition_list->size];
+    transition_list->size++;
+    transition.pass           = pass;
+    transition.timing         = timing;
+    transition.state_before   = state[i];
+    transition.state_after    = state_after;
+    transition.prev_user_pass = get_prev_user_pass(last_user_pass[i]);
+    transition.subresource    = i;
+    state[i] = state_after;
+  }
+}
+auto GetMostCommonState(const uint32_t num, const ResourceStateTypeFlags::FlagType* state) {
+  auto retval = state[0];
+  uint32_t max_count = 0;
+  for (uint32_t i = 0; i < num; i++) {
+    const auto count = static_cast<uint32_t>(std::count(state, state + num, state[i]));
+    if (count > max_count) {
+      retval = state[i];
+      max_count = count;
+    }
+  }
+  return retval;
+}
+// replaces transitions of buffers used with partial subresource ranges with per subresource ones.
+void TrackSubresourceStateTransitions(const uint32_t render_pass_num, const uint32_t *  render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
+                                      const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index,
+                                      const uint32_t buffer_allocation_num,
+                                      const uint32_t* render_pass_buffer_num,
+                                      const uint32_t * const * render_pass_buffer_allocation_index_list,
+                                      const ResourceStateTypeFlags::FlagType* const * render_pass_resource_state_list,
+                                      const BarrierSubresourceInfo& subresource_info,
+                                      const ResourceStateTypeFlags::FlagType* initial_state,
+                                      const ResourceStateTypeFlags::FlagType* final_state,
+                                      ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list) {
+  auto use_num = AllocateAndFillArrayFrame(buffer_allocation_num, 0U);
+  auto tracked = AllocateAndFillArrayFrame(buffer_allocation_num, false);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    for (uint32_t j = 0; j < render_pass_buffer_num[i]; j++) {
+      const auto& buffer_id = render_pass_buffer_allocation_index_list[i][j];
+      if (buffer_id >= buffer_allocation_num) { continue; }
+      use_num[buffer_id]++;
+      const auto& range = subresource_info.render_pass_subresource_range_list[i][j];
+      const auto& layout = subresource_info.subresource_layout[buffer_id];
+      if (!IsSubresourceRangeValid(range, layout)) {
+        // transitioning the whole resource keeps the plan safe.
+        logerror("subresource range out of range, the whole resource is transitioned instead. pass:{} buffer:{} mip:{}+{}/{} array:{}+{}/{} plane:{}+{}/{}",
+                 i, buffer_id, range.mip_slice, range.mip_num, layout.mip_num, range.array_slice, range.array_num, layout.array_num, range.plane_slice, range.plane_num, layout.plane_num);
+        continue;
+      }
+      if (!IsSubresourceRangeWhole(range, layout)) {
+        tracked[buffer_id] = true;
+      }
+    }
+  }
+  const auto [last_sync_graphics_queue_pass, graphics_queue_last_pass] = GetLastSyncGraphicsQueuePass(render_pass_num, render_pass_command_queue_index, command_queue_type, wait_pass_num, signal_pass_index);
+  for (uint32_t i = 0; i < buffer_allocation_num; i++) {
+    if (!tracked[i]) { continue; }
+    const auto& layout = subresource_info.subresource_layout[i];
+    const auto subresource_num = GetSubresourceNum(layout);
+    auto state = AllocateAndFillArrayFrame(subresource_num, initial_state[i]);
+    auto last_user_pass = AllocateAndFillArrayFrame(subresource_num, ~0U);
+    auto in_range = AllocateArrayFrame<bool>(subresource_num);
+    auto& transition_list = resource_state_traisition_info_list[i];
+    transition_list.size = 0;
+    transition_list.array = AllocateArrayFrame<ResourceStateTransitionInfo>((use_num[i] + 1) * subresource_num);
+    uint32_t buffer_last_user_pass = 0;
+    for (uint32_t j = 0; j < render_pass_num; j++) {
+      for (uint32_t k = 0; k < render_pass_buffer_num[j]; k++) {
+        if (render_pass_buffer_allocation_index_list[j][k] != i) { continue; }
+        MarkSubresourceRange(subresource_info.render_pass_subresource_range_list[j][k], layout, in_range);
+        AddSubresourceStateTransitions(j, 0, render_pass_resource_state_list[j][k], subresource_num, in_range, last_user_pass, state, &transition_list);
+        for (uint32_t l = 0; l < subresource_num; l++) {
+          if (in_range[l]) {
+            last_user_pass[l] = j;
+          }
+        }
+        buffer_last_user_pass = j;
+      }
+    }
+    // back to a single state for state_at_frame_end.
+    std::fill_n(in_range, subresource_num, true);
+    if (final_state[i] != ResourceStateTypeFlags::kNone) {
+      AddSubresourceStateTransitions(graphics_queue_last_pass, 1, final_state[i], subresource_num, in_range, last_user_pass, state, &transition_list);
+    } else {
+      AddSubresourceStateTransitions(buffer_last_user_pass, 1, GetMostCommonState(subresource_num, state), subresource_num, in_range, last_user_pass, state, &transition_list);
+    }
+    // move state transition timing to valid queue
+    for (uint32_t j = 0; j < transition_list.size; j++) {
+      auto& transition = transition_list.array[j];
+      const auto queue = command_queue_type[render_pass_command_queue_index[transition.pass]];
+      if (queue == D3D12_COMMAND_LIST_TYPE_DIRECT) { continue; }
+      if (IsStateValidForQueue(queue, transition.state_before) && IsStateValidForQueue(queue, transition.state_after)) { continue; }
+      transition.pass = (last_sync_graphics_queue_pass[transition.pass] < render_pass_num) ? last_sync_graphics_queue_pass[transition.pass] : graphics_queue_last_pass;
+      transition.timing = 1;
+    }
+  }
+}
+constexpr auto GetWriteStateFlags() {
+  return ResourceStateTypeFlags::kUav | ResourceStateTypeFlags::kRtv | ResourceStateTypeFlags::kDsvWrite | ResourceStateTypeFlags::kCopyDst;
+}
+void ScheduleSplitBarriers(const uint32_t render_pass_num, const uint32_t* render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
+                           const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index,
+                           const uint32_t buffer_allocation_num, const BarrierSplitCostModel& cost_model,
+                           ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list) {
+  // pass_index_in_queue and signal_num_in_queue count passes (and signaling passes) preceding each pass on its queue.
+  auto is_signal_pass = AllocateAndFillArrayFrame(render_pass_num, false);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    for (uint32_t j = 0; j < wait_pass_num[i]; j++) {
+      if (signal_pass_index[i][j] < render_pass_num) {
+        is_signal_pass[signal_pass_index[i][j]] = true;
+      }
+    }
+  }
+  uint32_t queue_num = 0;
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    queue_num = std::max(queue_num, render_pass_command_queue_index[i] + 1);
+  }
+  auto pass_num_per_queue = AllocateAndFillArrayFrame(queue_num, 0U);
+  auto signal_num_per_queue = AllocateAndFillArrayFrame(queue_num, 0U);
+  auto pass_index_in_queue = AllocateArrayFrame<uint32_t>(render_pass_num);
+  auto signal_num_in_queue = AllocateArrayFrame<uint32_t>(render_pass_num);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    const auto queue_index = render_pass_command_queue_index[i];
+    pass_index_in_queue[i] = pass_num_per_queue[queue_index];
+    signal_num_in_queue[i] = signal_num_per_queue[queue_index];
+    pass_num_per_queue[queue_index]++;
+    if (is_signal_pass[i]) {
+      signal_num_per_queue[queue_index]++;
+    }
+  }
+  for (uint32_t i = 0; i < buffer_allocation_num; i++) {
+    for (uint32_t j = 0; j < resource_state_traisition_info_list[i].size; j++) {
+      auto& transition = resource_state_traisition_info_list[i].array[j];
+      if (transition.timing != 0 || transition.prev_user_pass >= transition.pass) { continue; }
+      const auto begin_pass = transition.prev_user_pass;
+      const auto queue_index = render_pass_command_queue_index[transition.pass];
+      if (render_pass_command_queue_index[begin_pass] != queue_index) { continue; }
+      // other transitions of the buffer (possibly moved to another queue) must not land between begin and end.
+      if (j > 0 && resource_state_traisition_info_list[i].array[j - 1].pass > begin_pass) { continue; }
+      if (j + 1 < resource_state_traisition_info_list[i].size && resource_state_traisition_info_list[i].array[j + 1].pass < transition.pass) { continue; }
+      if (!IsStateValidForQueue(command_queue_type[queue_index], transition.state_before) || !IsStateValidForQueue(command_queue_type[queue_index], transition.state_after)) { continue; }
+      // a signal after begin_pass submits the command list, split barriers must not span submissions.
+      if (signal_num_in_queue[transition.pass] != signal_num_in_queue[begin_pass]) { continue; }
+      const auto overlapped_pass_num = pass_index_in_queue[transition.pass] - pass_index_in_queue[begin_pass] - 1;
+      const auto min_overlapped_pass_num = (transition.state_before & GetWriteStateFlags()) != 0 ? cost_model.min_overlapped_pass_num_after_write : cost_model.min_overlapped_pass_num_after_read;
+      if (overlapped_pass_num < std::max(min_overlapped_pass_num, 1U)) { continue; }
+      transition.split_begin_pass = begin_pass;
+    }
+  }
+}
+auto AllocateBarrierConfigList(const uint32_t render_pass_num, const MemoryType& memory_type) {
+  auto barrier_config_list = AllocateArray<ArrayOf<BarrierConfig>*>(memory_type, render_pass_num);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    barrier_config_list[i] = AllocateArray<ArrayOf<BarrierConfig>>(memory_type, kBarrierExecutionTimingNum);
+  }
+  return barrier_config_list;
+}
+void ConvertStateTransitionsToBarrierPerPass(const uint32_t render_pass_num, const uint32_t buffer_allocation_num, const ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list, BarrierConfig* barrier_config_pool, ArrayOf<BarrierConfig>** barrier_config_list) {
   // count barrier num
-  auto barrier_num = AllocateArrayFrame<uint32_t*>(render_pass_num);
   for (uint32_t i = 0; i < render_pass_num; i++) {
-    barrier_num[i] = AllocateArray<uint32_t>(memory_type, kBarrierExecutionTimingNum);
     for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
-      barrier_num[i][j] = 0;
+      barrier_config_list[i][j].size = 0;
     }
   }
   for (uint32_t i = 0; i < buffer_allocation_num; i++) {
     for (uint32_t j = 0; j < resource_state_traisition_info_list[i].size; j++) {
       const auto& transition = resource_state_traisition_info_list[i].array[j];
-      barrier_num[transition.pass][transition.timing]++;
+      barrier_config_list[transition.pass][transition.timing].size++;
+      if (transition.split_begin_pass < render_pass_num) {
+        barrier_config_list[transition.split_begin_pass][1].size++;
+      }
     }
   }
-  // allocate all barriers
-  auto barrier_config_list = AllocateArray<ArrayOf<BarrierConfig>*>(memory_type, render_pass_num);
+  // assign barriers from pool
   for (uint32_t i = 0; i < render_pass_num; i++) {
-    barrier_config_list[i] = AllocateArray<ArrayOf<BarrierConfig>>(memory_type, kBarrierExecutionTimingNum);
     for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
-      barrier_config_list[i][j] = InitializeArray<BarrierConfig>(barrier_num[i][j], memory_type);
-      barrier_num[i][j] = 0; // reused for barrier index
+      barrier_config_list[i][j].array = barrier_config_pool;
+      barrier_config_pool += barrier_config_list[i][j].size;
+      barrier_config_list[i][j].size = 0; // reused for barrier index
     }
   }
   // fill barriers
   for (uint32_t i = 0; i < buffer_allocation_num; i++) {
     for (uint32_t j = 0; j < resource_state_traisition_info_list[i].size; j++) {
       const auto& transition = resource_state_traisition_info_list[i].array[j];
-      auto& dst_barrier = barrier_config_list[transition.pass][transition.timing].array[barrier_num[transition.pass][transition.timing]];
-      barrier_num[transition.pass][transition.timing]++;
+      const auto split = transition.split_begin_pass < render_pass_num;
+      if (split) {
+        auto& dst_barrier_list = barrier_config_list[transition.split_begin_pass][1];
+        auto& dst_barrier = dst_barrier_list.array[dst_barrier_list.size];
+        dst_barrier_list.size++;
+        dst_barrier.buffer_allocation_index = i;
+        dst_barrier.type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        dst_barrier.flag = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+        dst_barrier.state_before = ResourceStateTypeFlags::ConvertToD3d12ResourceState(transition.state_before);
+        dst_barrier.state_after  = ResourceStateTypeFlags::ConvertToD3d12ResourceState(transition.state_after);
+        dst_barrier.subresource  = transition.subresource;
+      }
+      auto& dst_barrier_list = barrier_config_list[transition.pass][transition.timing];
+      auto& dst_barrier = dst_barrier_list.array[dst_barrier_list.size];
+      dst_barrier_list.size++;
       dst_barrier.buffer_allocation_index = i;
       dst_barrier.type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-      dst_barrier.flag = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+      dst_barrier.flag = split ? D3D12_RESOURCE_BARRIER_FLAG_END_ONLY : D3D12_RESOURCE_BARRIER_FLAG_NONE;
       dst_barrier.state_before = ResourceStateTypeFlags::ConvertToD3d12ResourceState(transition.state_before);
       dst_barrier.state_after  = ResourceStateTypeFlags::ConvertToD3d12ResourceState(transition.state_after);
+      dst_barrier.subresource  = transition.subresource;
+    }
+  }
+}
+auto ConvertStateTransitionsToBarrierPerPass(const uint32_t render_pass_num, const uint32_t buffer_allocation_num, const ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list, const MemoryType& memory_type) {
+  uint32_t transition_num = 0;
+  for (uint32_t i = 0; i < buffer_allocation_num; i++) {
+    for (uint32_t j = 0; j < resource_state_traisition_info_list[i].size; j++) {
+      transition_num += (resource_state_traisition_info_list[i].array[j].split_begin_pass < render_pass_num) ? 2 : 1;
     }
   }
+  auto barrier_config_list = AllocateBarrierConfigList(render_pass_num, memory_type);
+  ConvertStateTransitionsToBarrierPerPass(render_pass_num, buffer_allocation_num, resource_state_traisition_info_list, AllocateArray<BarrierConfig>(memory_type, transition_num), barrier_config_list);
   return barrier_config_list;
 }
-auto GetStateAtFrameEnd(const uint32_t buffer_num, const ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list, const ResourceStateTypeFlags::FlagType* initial_state, const MemoryType memory_type) {
-  auto state_at_frame_end = AllocateArray<ResourceStateTypeFlags::FlagType>(memory_type, buffer_num);
+void GetStateAtFrameEnd(const uint32_t buffer_num, const ArrayOf<ResourceStateTransitionInfo>* resource_state_traisition_info_list, const ResourceStateTypeFlags::FlagType* initial_state, ResourceStateTypeFlags::FlagType* state_at_frame_end) {
   for (uint32_t i = 0; i < buffer_num; i++) {
     if (resource_state_traisition_info_list[i].size == 0) {
       state_at_frame_end[i] = initial_state[i];
@@ -249,7 +519,29 @@ auto GetStateAtFrameEnd(const uint32_t buffer_num, const ArrayOf<ResourceStateTr
     }
     state_at_frame_end[i] = resource_state_traisition_info_list[i].array[resource_state_traisition_info_list[i].size - 1].state_after;
   }
-  return state_at_frame_end;
+}
+BarrierTransitionInfo ConfigureBarrierTransitionsImpl(const uint32_t buffer_num, const uint32_t render_pass_num, const uint32_t* render_pass_buffer_num,
+                                                      const uint32_t* const * render_pass_buffer_allocation_index_list,
+                                                      const ResourceStateTypeFlags::FlagType* const * render_pass_resource_state_list,
+                                                      const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index,
+                                                      const uint32_t* const render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
+                                                      const ResourceStateTypeFlags::FlagType* initial_state, const ResourceStateTypeFlags::FlagType* final_state,
+                                                      const MemoryType& memory_type, const BarrierSplitCostModel* split_cost_model,
+                                                      const BarrierSubresourceInfo* subresource_info) {
+  // transitions are planned in frame memory, only the barriers actually emitted are allocated in memory_type.
+  auto resource_state_traisition_info = GetResourceStateTransitionInfo(render_pass_num, render_pass_command_queue_index, command_queue_type, wait_pass_num, signal_pass_index,
+                                                                       buffer_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list, initial_state, final_state);
+  if (subresource_info) {
+    TrackSubresourceStateTransitions(render_pass_num, render_pass_command_queue_index, command_queue_type, wait_pass_num, signal_pass_index,
+                                     buffer_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list, *subresource_info, initial_state, final_state, resource_state_traisition_info);
+  }
+  if (split_cost_model) {
+    ScheduleSplitBarriers(render_pass_num, render_pass_command_queue_index, command_queue_type, wait_pass_num, signal_pass_index, buffer_num, *split_cost_model, resource_state_traisition_info);
+  }
+  auto barrier_config_list = ConvertStateTransitionsToBarrierPerPass(render_pass_num, buffer_num, resource_state_traisition_info, memory_type);
+  auto state_at_frame_end = AllocateArray<ResourceStateTypeFlags::FlagType>(memory_type, buffer_num);
+  GetStateAtFrameEnd(buffer_num, resource_state_traisition_info, initial_state, state_at_frame_end);
+  return {barrier_config_list, state_at_frame_end};
 }
 } // namespace
 BarrierTransitionInfo ConfigureBarrierTransitions(const uint32_t buffer_num, const uint32_t render_pass_num, const uint32_t* render_pass_buffer_num,
@@ -258,15 +550,83 @@ BarrierTransitionInfo ConfigureBarrierTransitions(const uint32_t buffer_num, con
                                                   const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index,
                                                   const uint32_t* const render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
                                                   const ResourceStateTypeFlags::FlagType* initial_state, const ResourceStateTypeFlags::FlagType* final_state,
-                                                  const MemoryType& memory_type) {
-  auto resource_state_traisition_info = GetResourceStateTransitionInfo(render_pass_num, render_pass_command_queue_index, command_queue_type, wait_pass_num, signal_pass_index,
-                                                                       buffer_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list, initial_state, final_state);
-  auto barrier_config_list = ConvertStateTransitionsToBarrierPerPass(render_pass_num, buffer_num, resource_state_traisition_info, memory_type);
-  auto state_at_frame_end = GetStateAtFrameEnd(buffer_num, resource_state_traisition_info, initial_state, memory_type);
-  return {barrier_config_list, state_at_frame_end};
+                                                  const MemoryType& memory_type, const BarrierSplitCostModel* split_cost_model,
+                                                  const BarrierSubresourceInfo* subresource_info) {
+  if (memory_type == MemoryType::kFrame) {
+    return ConfigureBarrierTransitionsImpl(buffer_num, render_pass_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list,
+                                           wait_pass_num, signal_pass_index, render_pass_command_queue_index, command_queue_type, initial_state, final_state,
+                                           memory_type, split_cost_model, subresource_info);
+  }
+  FrameMemoryCheckpoint checkpoint;
+  return ConfigureBarrierTransitionsImpl(buffer_num, render_pass_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list,
+                                         wait_pass_num, signal_pass_index, render_pass_command_queue_index, command_queue_type, initial_state, final_state,
+                                         memory_type, split_cost_model, subresource_info);
+}
+uint64_t CalcBarrierTransitionCacheKey(const uint32_t render_pass_num, const bool* render_pass_enable_flag, const uint64_t allocation_variant,
+                                       const uint32_t buffer_num, const ResourceStateTypeFlags::FlagType* initial_state) {
+  auto key = CalcHash64(initial_state, sizeof(initial_state[0]) * buffer_num, allocation_variant);
+  for (uint32_t i = 0; i < render_pass_num; i += 64) {
+    uint64_t active_pass_mask = 0;
+    const auto pass_num = std::min(render_pass_num - i, 64U);
+    for (uint32_t j = 0; j < pass_num; j++) {
+      if (render_pass_enable_flag[i + j]) {
+        active_pass_mask |= 1ULL << j;
+      }
+    }
+    key = CalcHash64(&active_pass_mask, sizeof(active_pass_mask), key);
+  }
+  return key;
+}
+void BarrierTransitionCache::Init(const uint32_t buffer_num, const uint32_t render_pass_num, const uint32_t entry_num_max) {
+  buffer_num_ = buffer_num;
+  render_pass_num_ = render_pass_num;
+  entry_num_max_ = entry_num_max;
+  entries_.SetAllocator(&allocator_, entry_num_max);
+}
+void BarrierTransitionCache::Term() {
+  entries_ = {};
+  buffer_num_ = 0;
+  render_pass_num_ = 0;
+  entry_num_max_ = 0;
+}
+BarrierTransitionInfo BarrierTransitionCache::Find(const uint64_t key) const {
+  const auto entry = entries_.Get(GetMapKey(key));
+  if (entry == nullptr || entry->key != key) { return {nullptr, nullptr}; }
+  return entry->info;
+}
+BarrierTransitionInfo BarrierTransitionCache::Register(const uint64_t key, const BarrierTransitionInfo& info) {
+  if (entries_.GetSize() >= entry_num_max_) { return info; }
+  auto entry = entries_.Reserve(GetMapKey(key));
+  if (entry == nullptr || entry->info.barrier_config_list != nullptr) {
+    // slot taken by another key.
+    return info;
+  }
+  uint32_t barrier_num = 0;
+  for (uint32_t i = 0; i < render_pass_num_; i++) {
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      barrier_num += info.barrier_config_list[i][j].size;
+    }
+  }
+  auto barrier_config_list = AllocateBarrierConfigList(render_pass_num_, MemoryType::kScene);
+  auto barrier_config_pool = AllocateArrayScene<BarrierConfig>(barrier_num);
+  for (uint32_t i = 0; i < render_pass_num_; i++) {
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      const auto& src = info.barrier_config_list[i][j];
+      barrier_config_list[i][j].size = src.size;
+      barrier_config_list[i][j].array = barrier_config_pool;
+      std::copy(src.array, src.array + src.size, barrier_config_pool);
+      barrier_config_pool += src.size;
+    }
+  }
+  auto state_at_frame_end = AllocateArrayScene<ResourceStateTypeFlags::FlagType>(buffer_num_);
+  std::copy(info.state_at_frame_end, info.state_at_frame_end + buffer_num_, state_at_frame_end);
+  entry->key = key;
+  entry->info = {barrier_config_list, state_at_frame_end};
+  return entry->info;
 }
 } // namespace illuminate
 #include "doctest/doctest.h"
+#include "../util/test_util.h"
 TEST_CASE("resource state transition") {
   using namespace illuminate;
   D3D12_COMMAND_LIST_TYPE command_queue_type[] = {
@@ -845,3 +1205,1089 @@ TEST_CASE("fill barrier list") {
   CHECK_EQ(barrier_config_list[2][1].array[1].state_before, ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kSrvPs | ResourceStateTypeFlags::kSrvNonPs));
   CHECK_EQ(barrier_config_list[2][1].array[1].state_after,  ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kRtv));
 }
+TEST_CASE("barrier transition cache") {
+  using namespace illuminate;
+  D3D12_COMMAND_LIST_TYPE command_queue_type[] = {
+    D3D12_COMMAND_LIST_TYPE_DIRECT,
+  };
+  uint32_t render_pass_command_queue_index[] = {0,0,};
+  uint32_t wait_pass_num[] = {0,0,};
+  uint32_t* signal_pass_index[] = {nullptr,nullptr,};
+  uint32_t render_pass_buffer_num[] = {1,2,};
+  uint32_t render_pass_buffer_allocation_index_list_0[] = {0,};
+  uint32_t render_pass_buffer_allocation_index_list_1[] = {0,1,};
+  uint32_t* render_pass_buffer_allocation_index_list[] = {
+    render_pass_buffer_allocation_index_list_0,
+    render_pass_buffer_allocation_index_list_1,
+  };
+  ResourceStateTypeFlags::FlagType render_pass_resource_state_list_0[] = {ResourceStateTypeFlags::kRtv,};
+  ResourceStateTypeFlags::FlagType render_pass_resource_state_list_1[] = {ResourceStateTypeFlags::kSrvPs, ResourceStateTypeFlags::kRtv,};
+  ResourceStateTypeFlags::FlagType* render_pass_resource_state_list[] = {
+    render_pass_resource_state_list_0,
+    render_pass_resource_state_list_1,
+  };
+  ResourceStateTypeFlags::FlagType initial_state[] = {ResourceStateTypeFlags::kRtv, ResourceStateTypeFlags::kSrvPs,};
+  ResourceStateTypeFlags::FlagType final_state[] = {ResourceStateTypeFlags::kNone, ResourceStateTypeFlags::kNone,};
+  const auto render_pass_num = countof(render_pass_buffer_num);
+  const auto buffer_num = countof(initial_state);
+  bool render_pass_enable_flag[] = {true,true,};
+  const auto key = CalcBarrierTransitionCacheKey(render_pass_num, render_pass_enable_flag, 0, buffer_num, initial_state);
+  CHECK_EQ(CalcBarrierTransitionCacheKey(render_pass_num, render_pass_enable_flag, 0, buffer_num, initial_state), key);
+  CHECK_NE(CalcBarrierTransitionCacheKey(render_pass_num, render_pass_enable_flag, 1, buffer_num, initial_state), key);
+  render_pass_enable_flag[1] = false;
+  CHECK_NE(CalcBarrierTransitionCacheKey(render_pass_num, render_pass_enable_flag, 0, buffer_num, initial_state), key);
+  render_pass_enable_flag[1] = true;
+  initial_state[1] = ResourceStateTypeFlags::kRtv;
+  CHECK_NE(CalcBarrierTransitionCacheKey(render_pass_num, render_pass_enable_flag, 0, buffer_num, initial_state), key);
+  initial_state[1] = ResourceStateTypeFlags::kSrvPs;
+  static_assert(!std::is_copy_constructible_v<BarrierTransitionCache> && !std::is_move_constructible_v<BarrierTransitionCache>);
+  static_assert(!std::is_copy_assignable_v<BarrierTransitionCache> && !std::is_move_assignable_v<BarrierTransitionCache>);
+  BarrierTransitionCache cache;
+  cache.Init(buffer_num, render_pass_num, 1);
+  CHECK_EQ(cache.Find(key).barrier_config_list, nullptr);
+  CHECK_EQ(cache.Find(key).state_at_frame_end, nullptr);
+  const auto configured = ConfigureBarrierTransitions(buffer_num, render_pass_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list,
+                                                      wait_pass_num, signal_pass_index, render_pass_command_queue_index, command_queue_type,
+                                                      initial_state, final_state, MemoryType::kFrame);
+  const auto cached = cache.Register(key, configured);
+  CHECK_NE(cached.barrier_config_list, configured.barrier_config_list);
+  CHECK_EQ(cache.GetEntryNum(), 1);
+  ResetAllocation(MemoryType::kFrame);
+  const auto found = cache.Find(key);
+  CHECK_EQ(found.barrier_config_list, cached.barrier_config_list);
+  CHECK_EQ(found.state_at_frame_end, cached.state_at_frame_end);
+  CHECK_EQ(found.barrier_config_list[0][0].size, 0);
+  CHECK_EQ(found.barrier_config_list[0][1].size, 0);
+  CHECK_EQ(found.barrier_config_list[1][0].size, 2);
+  CHECK_EQ(found.barrier_config_list[1][0].array[0].buffer_allocation_index, 0);
+  CHECK_EQ(found.barrier_config_list[1][0].array[0].state_before, ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kRtv));
+  CHECK_EQ(found.barrier_config_list[1][0].array[0].state_after,  ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kSrvPs));
+  CHECK_EQ(found.barrier_config_list[1][0].array[1].buffer_allocation_index, 1);
+  CHECK_EQ(found.barrier_config_list[1][0].array[1].state_before, ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kSrvPs));
+  CHECK_EQ(found.barrier_config_list[1][0].array[1].state_after,  ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kRtv));
+  CHECK_EQ(found.barrier_config_list[1][1].size, 0);
+  CHECK_EQ(found.state_at_frame_end[0], ResourceStateTypeFlags::kSrvPs);
+  CHECK_EQ(found.state_at_frame_end[1], ResourceStateTypeFlags::kRtv);
+  {
+    // plans beyond entry_num_max are returned as is.
+    const auto key_full = CalcBarrierTransitionCacheKey(render_pass_num, render_pass_enable_flag, 1, buffer_num, initial_state);
+    const auto configured_full = ConfigureBarrierTransitions(buffer_num, render_pass_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list,
+                                                             wait_pass_num, signal_pass_index, render_pass_command_queue_index, command_queue_type,
+                                                             initial_state, final_state, MemoryType::kFrame);
+    CHECK_EQ(cache.Register(key_full, configured_full).barrier_config_list, configured_full.barrier_config_list);
+    CHECK_EQ(cache.Find(key_full).barrier_config_list, nullptr);
+    CHECK_EQ(cache.GetEntryNum(), 1);
+  }
+  cache.Term();
+  CHECK_EQ(cache.GetEntryNum(), 0);
+  ClearAllAllocations();
+}
+namespace {
+using namespace illuminate;
+struct BarrierTestGraph {
+  uint32_t render_pass_num{};
+  uint32_t buffer_num{};
+  uint32_t* render_pass_buffer_num{};
+  uint32_t** render_pass_buffer_allocation_index_list{};
+  ResourceStateTypeFlags::FlagType** render_pass_resource_state_list{};
+  uint32_t* wait_pass_num{};
+  uint32_t** signal_pass_index{};
+  uint32_t* render_pass_command_queue_index{};
+  ResourceStateTypeFlags::FlagType* initial_state{};
+  ResourceStateTypeFlags::FlagType* final_state{};
+  SubresourceLayout* subresource_layout{}; // nullptr to track buffers as a whole.
+  SubresourceRange** render_pass_subresource_range_list{};
+};
+// buffer 0/1 are a pingpong pair written as rtv and read as srv by graphics passes, flipped per pass.
+// every gap_interval-th pass writes buffer 2 instead (on queue 1 with waits from and to the neighbouring passes when use_compute_queue).
+auto CreatePingPongBarrierTestGraph(const uint32_t render_pass_num, const uint32_t gap_interval, const bool use_compute_queue) {
+  BarrierTestGraph graph{};
+  graph.render_pass_num = render_pass_num;
+  graph.buffer_num = 3;
+  graph.render_pass_buffer_num = AllocateArrayFrame<uint32_t>(render_pass_num);
+  graph.render_pass_buffer_allocation_index_list = AllocateArrayFrame<uint32_t*>(render_pass_num);
+  graph.render_pass_resource_state_list = AllocateArrayFrame<ResourceStateTypeFlags::FlagType*>(render_pass_num);
+  graph.wait_pass_num = AllocateAndFillArrayFrame(render_pass_num, 0U);
+  graph.signal_pass_index = AllocateArrayFrame<uint32_t*>(render_pass_num);
+  graph.render_pass_command_queue_index = AllocateAndFillArrayFrame(render_pass_num, 0U);
+  uint32_t write_index = 0;
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    graph.render_pass_buffer_allocation_index_list[i] = AllocateArrayFrame<uint32_t>(2);
+    graph.render_pass_resource_state_list[i] = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(2);
+    graph.signal_pass_index[i] = AllocateArrayFrame<uint32_t>(1);
+    if (i % gap_interval == gap_interval - 1) {
+      graph.render_pass_buffer_num[i] = 1;
+      graph.render_pass_buffer_allocation_index_list[i][0] = 2;
+      graph.render_pass_resource_state_list[i][0] = ResourceStateTypeFlags::kUav;
+      if (use_compute_queue && i > 0) {
+        graph.render_pass_command_queue_index[i] = 1;
+        graph.wait_pass_num[i] = 1;
+        graph.signal_pass_index[i][0] = i - 1;
+      }
+      continue;
+    }
+    if (use_compute_queue && i > 0 && graph.render_pass_command_queue_index[i - 1] == 1) {
+      graph.wait_pass_num[i] = 1;
+      graph.signal_pass_index[i][0] = i - 1;
+    }
+    graph.render_pass_buffer_num[i] = 2;
+    graph.render_pass_buffer_allocation_index_list[i][0] = write_index;
+    graph.render_pass_resource_state_list[i][0] = ResourceStateTypeFlags::kRtv;
+    graph.render_pass_buffer_allocation_index_list[i][1] = 1 - write_index;
+    graph.render_pass_resource_state_list[i][1] = ResourceStateTypeFlags::kSrvPs;
+    write_index = 1 - write_index;
+  }
+  graph.initial_state = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(graph.buffer_num);
+  graph.initial_state[0] = ResourceStateTypeFlags::kRtv;
+  graph.initial_state[1] = ResourceStateTypeFlags::kSrvPs;
+  graph.initial_state[2] = ResourceStateTypeFlags::kUav;
+  graph.final_state = AllocateAndFillArrayFrame(graph.buffer_num, static_cast<ResourceStateTypeFlags::FlagType>(ResourceStateTypeFlags::kNone));
+  return graph;
+}
+auto ConfigureBarrierTransitions(const BarrierTestGraph& graph, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const BarrierSplitCostModel* split_cost_model) {
+  const BarrierSubresourceInfo subresource_info{graph.subresource_layout, graph.render_pass_subresource_range_list};
+  return ConfigureBarrierTransitions(graph.buffer_num, graph.render_pass_num, graph.render_pass_buffer_num, graph.render_pass_buffer_allocation_index_list, graph.render_pass_resource_state_list,
+                                     graph.wait_pass_num, graph.signal_pass_index, graph.render_pass_command_queue_index, command_queue_type,
+                                     graph.initial_state, graph.final_state, MemoryType::kFrame, split_cost_model,
+                                     graph.subresource_layout ? &subresource_info : nullptr);
+}
+auto CreateSubresourceBarrierTestGraph(const uint32_t render_pass_num, const uint32_t buffer_num, const SubresourceLayout& layout) {
+  // all passes on queue 0, up to 2 buffer uses per pass (see AddBarrierTestBufferUse).
+  BarrierTestGraph graph{};
+  graph.render_pass_num = render_pass_num;
+  graph.buffer_num = buffer_num;
+  graph.render_pass_buffer_num = AllocateAndFillArrayFrame(render_pass_num, 0U);
+  graph.render_pass_buffer_allocation_index_list = AllocateArrayFrame<uint32_t*>(render_pass_num);
+  graph.render_pass_resource_state_list = AllocateArrayFrame<ResourceStateTypeFlags::FlagType*>(render_pass_num);
+  graph.render_pass_subresource_range_list = AllocateArrayFrame<SubresourceRange*>(render_pass_num);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    graph.render_pass_buffer_allocation_index_list[i] = AllocateArrayFrame<uint32_t>(2);
+    graph.render_pass_resource_state_list[i] = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(2);
+    graph.render_pass_subresource_range_list[i] = AllocateArrayFrame<SubresourceRange>(2);
+  }
+  graph.wait_pass_num = AllocateAndFillArrayFrame(render_pass_num, 0U);
+  graph.signal_pass_index = AllocateAndFillArrayFrame(render_pass_num, (uint32_t*)nullptr);
+  graph.render_pass_command_queue_index = AllocateAndFillArrayFrame(render_pass_num, 0U);
+  graph.initial_state = AllocateAndFillArrayFrame(buffer_num, static_cast<ResourceStateTypeFlags::FlagType>(ResourceStateTypeFlags::kCommon));
+  graph.final_state = AllocateAndFillArrayFrame(buffer_num, static_cast<ResourceStateTypeFlags::FlagType>(ResourceStateTypeFlags::kNone));
+  graph.subresource_layout = AllocateAndFillArrayFrame(buffer_num, layout);
+  return graph;
+}
+void AddBarrierTestBufferUse(const uint32_t pass, const uint32_t buffer, const ResourceStateTypeFlags::FlagType state, const SubresourceRange& range, BarrierTestGraph* graph) {
+  const auto index = graph->render_pass_buffer_num[pass];
+  assert(index < 2);
+  graph->render_pass_buffer_num[pass]++;
+  graph->render_pass_buffer_allocation_index_list[pass][index] = buffer;
+  graph->render_pass_resource_state_list[pass][index] = state;
+  graph->render_pass_subresource_range_list[pass][index] = range;
+}
+// passes are appended with AddBarrierTestPass(), up to 2 buffer uses and 2 waits per pass, all buffers start in kCommon.
+auto CreateBarrierTestGraph(const uint32_t max_render_pass_num, const uint32_t buffer_num) {
+  BarrierTestGraph graph{};
+  graph.buffer_num = buffer_num;
+  graph.render_pass_buffer_num = AllocateAndFillArrayFrame(max_render_pass_num, 0U);
+  graph.render_pass_buffer_allocation_index_list = AllocateArrayFrame<uint32_t*>(max_render_pass_num);
+  graph.render_pass_resource_state_list = AllocateArrayFrame<ResourceStateTypeFlags::FlagType*>(max_render_pass_num);
+  graph.wait_pass_num = AllocateAndFillArrayFrame(max_render_pass_num, 0U);
+  graph.signal_pass_index = AllocateArrayFrame<uint32_t*>(max_render_pass_num);
+  graph.render_pass_command_queue_index = AllocateAndFillArrayFrame(max_render_pass_num, 0U);
+  for (uint32_t i = 0; i < max_render_pass_num; i++) {
+    graph.render_pass_buffer_allocation_index_list[i] = AllocateArrayFrame<uint32_t>(2);
+    graph.render_pass_resource_state_list[i] = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(2);
+    graph.signal_pass_index[i] = AllocateArrayFrame<uint32_t>(2);
+  }
+  graph.initial_state = AllocateAndFillArrayFrame(buffer_num, static_cast<ResourceStateTypeFlags::FlagType>(ResourceStateTypeFlags::kCommon));
+  graph.final_state = AllocateAndFillArrayFrame(buffer_num, static_cast<ResourceStateTypeFlags::FlagType>(ResourceStateTypeFlags::kNone));
+  return graph;
+}
+// uses are {buffer, state} pairs.
+void AddBarrierTestPass(const uint32_t queue_index, const std::initializer_list<std::pair<uint32_t, ResourceStateTypeFlags::FlagType>>& uses,
+                        const std::initializer_list<uint32_t>& wait_pass, BarrierTestGraph* graph) {
+  const auto pass = graph->render_pass_num;
+  graph->render_pass_num++;
+  graph->render_pass_command_queue_index[pass] = queue_index;
+  assert(uses.size() <= 2 && wait_pass.size() <= 2);
+  for (const auto& [buffer, state] : uses) {
+    const auto index = graph->render_pass_buffer_num[pass];
+    graph->render_pass_buffer_allocation_index_list[pass][index] = buffer;
+    graph->render_pass_resource_state_list[pass][index] = state;
+    graph->render_pass_buffer_num[pass]++;
+  }
+  for (const auto signal_pass : wait_pass) {
+    graph->signal_pass_index[pass][graph->wait_pass_num[pass]] = signal_pass;
+    graph->wait_pass_num[pass]++;
+  }
+}
+auto CountBarrierNum(const uint32_t render_pass_num, const BarrierConfigList* barrier_config_list) {
+  uint32_t barrier_num = 0;
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      barrier_num += barrier_config_list[i][j].size;
+    }
+  }
+  return barrier_num;
+}
+// walks barriers in pass order per subresource, checks state_before of each barrier and buffer states at each use,
+// and that each BEGIN_ONLY is closed by a matching END_ONLY on the same queue before the subresource is used again.
+// returns the number of split pairs.
+auto CheckBarrierConsistency(const BarrierTestGraph& graph, const BarrierConfigList* barrier_config_list) {
+  auto subresource_num = AllocateAndFillArrayFrame(graph.buffer_num, 1U);
+  auto subresource_offset = AllocateArrayFrame<uint32_t>(graph.buffer_num);
+  uint32_t total_subresource_num = 0;
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    if (graph.subresource_layout) {
+      subresource_num[i] = GetSubresourceNum(graph.subresource_layout[i]);
+    }
+    subresource_offset[i] = total_subresource_num;
+    total_subresource_num += subresource_num[i];
+  }
+  auto state = AllocateArrayFrame<D3D12_RESOURCE_STATES>(total_subresource_num);
+  auto pending = AllocateAndFillArrayFrame(total_subresource_num, (const BarrierConfig*)nullptr);
+  auto pending_queue = AllocateArrayFrame<uint32_t>(total_subresource_num);
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    std::fill_n(&state[subresource_offset[i]], subresource_num[i], ResourceStateTypeFlags::ConvertToD3d12ResourceState(graph.initial_state[i]));
+  }
+  auto in_range = AllocateArrayFrame<bool>(total_subresource_num);
+  auto mark_barrier_range = [&](const BarrierConfig& barrier) {
+    std::fill_n(in_range, total_subresource_num, false);
+    const auto offset = subresource_offset[barrier.buffer_allocation_index];
+    if (barrier.subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) {
+      std::fill_n(&in_range[offset], subresource_num[barrier.buffer_allocation_index], true);
+      return;
+    }
+    REQUIRE_LT(barrier.subresource, subresource_num[barrier.buffer_allocation_index]);
+    in_range[offset + barrier.subresource] = true;
+  };
+  uint32_t split_num = 0;
+  auto execute_barriers = [&](const uint32_t pass, const ArrayOf<BarrierConfig>& barriers) {
+    for (uint32_t i = 0; i < barriers.size; i++) {
+      const auto& barrier = barriers.array[i];
+      mark_barrier_range(barrier);
+      if (barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+        split_num++;
+      }
+      for (uint32_t j = 0; j < total_subresource_num; j++) {
+        if (!in_range[j]) { continue; }
+        if (barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+          REQUIRE_NE(pending[j], nullptr);
+          CHECK_EQ(pending[j]->state_before, barrier.state_before);
+          CHECK_EQ(pending[j]->state_after, barrier.state_after);
+          CHECK_EQ(pending[j]->subresource, barrier.subresource);
+          CHECK_EQ(pending_queue[j], graph.render_pass_command_queue_index[pass]);
+          pending[j] = nullptr;
+          state[j] = barrier.state_after;
+          continue;
+        }
+        CHECK_EQ(pending[j], nullptr);
+        CHECK_EQ(state[j], barrier.state_before);
+        if (barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+          pending[j] = &barrier;
+          pending_queue[j] = graph.render_pass_command_queue_index[pass];
+          continue;
+        }
+        state[j] = barrier.state_after;
+      }
+    }
+  };
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    execute_barriers(i, barrier_config_list[i][0]);
+    for (uint32_t j = 0; j < graph.render_pass_buffer_num[i]; j++) {
+      const auto buffer = graph.render_pass_buffer_allocation_index_list[i][j];
+      const auto offset = subresource_offset[buffer];
+      std::fill_n(in_range, total_subresource_num, false);
+      if (graph.subresource_layout) {
+        CHECK_UNARY(MarkSubresourceRange(graph.render_pass_subresource_range_list[i][j], graph.subresource_layout[buffer], &in_range[offset]));
+      } else {
+        in_range[offset] = true;
+      }
+      const auto use_state = ResourceStateTypeFlags::ConvertToD3d12ResourceState(graph.render_pass_resource_state_list[i][j]);
+      for (uint32_t k = offset; k < offset + subresource_num[buffer]; k++) {
+        if (!in_range[k]) { continue; }
+        CHECK_EQ(pending[k], nullptr);
+        CHECK_EQ(state[k] & use_state, use_state);
+      }
+    }
+    execute_barriers(i, barrier_config_list[i][1]);
+  }
+  for (uint32_t i = 0; i < total_subresource_num; i++) {
+    CHECK_EQ(pending[i], nullptr);
+  }
+  // subresources end up in a single state.
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    for (uint32_t j = 1; j < subresource_num[i]; j++) {
+      CHECK_EQ(state[subresource_offset[i] + j], state[subresource_offset[i]]);
+    }
+  }
+  return split_num;
+}
+} // namespace
+TEST_CASE("split barriers") { // NOLINT
+  using namespace illuminate;
+  const D3D12_COMMAND_LIST_TYPE command_queue_type[] = {
+    D3D12_COMMAND_LIST_TYPE_DIRECT,
+    D3D12_COMMAND_LIST_TYPE_COMPUTE,
+  };
+  const BarrierSplitCostModel split_cost_model{};
+  SUBCASE("pingpong on a single queue") {
+    for (const uint32_t gap_interval : {2U, 3U, 5U}) {
+      const auto graph = CreatePingPongBarrierTestGraph(32, gap_interval, false);
+      const auto unsplit = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+      CHECK_EQ(CheckBarrierConsistency(graph, unsplit.barrier_config_list), 0);
+      const auto split = ConfigureBarrierTransitions(graph, command_queue_type, &split_cost_model);
+      CHECK_GT(CheckBarrierConsistency(graph, split.barrier_config_list), 0);
+      for (uint32_t i = 0; i < graph.buffer_num; i++) {
+        CHECK_EQ(split.state_at_frame_end[i], unsplit.state_at_frame_end[i]);
+      }
+    }
+    // rtv->srv transitions overlap a single pass, srv->rtv ones need two by default.
+    auto graph = CreatePingPongBarrierTestGraph(32, 3, false);
+    auto split = ConfigureBarrierTransitions(graph, command_queue_type, &split_cost_model);
+    for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+      for (uint32_t j = 0; j < split.barrier_config_list[i][1].size; j++) {
+        const auto& barrier = split.barrier_config_list[i][1].array[j];
+        CHECK_EQ(barrier.flag, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+        CHECK_EQ(barrier.state_before, ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kRtv));
+      }
+    }
+    const BarrierSplitCostModel split_read_cost_model{.min_overlapped_pass_num_after_write = 1, .min_overlapped_pass_num_after_read = 1,};
+    split = ConfigureBarrierTransitions(graph, command_queue_type, &split_read_cost_model);
+    const auto split_num_with_read = CheckBarrierConsistency(graph, split.barrier_config_list);
+    split = ConfigureBarrierTransitions(graph, command_queue_type, &split_cost_model);
+    CHECK_GT(split_num_with_read, CheckBarrierConsistency(graph, split.barrier_config_list));
+    const BarrierSplitCostModel no_split_cost_model{.min_overlapped_pass_num_after_write = ~0U, .min_overlapped_pass_num_after_read = ~0U,};
+    split = ConfigureBarrierTransitions(graph, command_queue_type, &no_split_cost_model);
+    CHECK_EQ(CheckBarrierConsistency(graph, split.barrier_config_list), 0);
+  }
+  SUBCASE("pingpong with signals in between") {
+    // graphics passes before compute passes signal, i.e. submit command lists, which split barriers must not span.
+    const auto graph = CreatePingPongBarrierTestGraph(32, 3, true);
+    const auto split = ConfigureBarrierTransitions(graph, command_queue_type, &split_cost_model);
+    CHECK_EQ(CheckBarrierConsistency(graph, split.barrier_config_list), 0);
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("subresource barriers") { // NOLINT
+  using namespace illuminate;
+  const D3D12_COMMAND_LIST_TYPE command_queue_type[] = {
+    D3D12_COMMAND_LIST_TYPE_DIRECT,
+  };
+  const auto srv = ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kSrvPs);
+  const auto rtv = ResourceStateTypeFlags::ConvertToD3d12ResourceState(ResourceStateTypeFlags::kRtv);
+  // pass i reads mip i-read_distance and writes mip i, the whole chain is read by the last pass if any.
+  const uint16_t mip_num = 12;
+  auto create_downsample_chain_graph = [](const bool read_whole_chain, const uint16_t read_distance = 1) {
+    auto graph = CreateSubresourceBarrierTestGraph(read_whole_chain ? mip_num + 1 : mip_num, 1, {.mip_num = mip_num,});
+    for (uint16_t i = 0; i < mip_num; i++) {
+      if (i >= read_distance) {
+        AddBarrierTestBufferUse(i, 0, ResourceStateTypeFlags::kSrvPs, {.mip_slice = static_cast<uint16_t>(i - read_distance), .mip_num = 1,}, &graph);
+      }
+      AddBarrierTestBufferUse(i, 0, ResourceStateTypeFlags::kRtv, {.mip_slice = i, .mip_num = 1,}, &graph);
+    }
+    if (read_whole_chain) {
+      AddBarrierTestBufferUse(mip_num, 0, ResourceStateTypeFlags::kSrvPs, {}, &graph);
+    }
+    return graph;
+  };
+  SUBCASE("downsample chain") {
+    auto graph = create_downsample_chain_graph(true);
+    graph.initial_state[0] = ResourceStateTypeFlags::kRtv;
+    auto result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    CHECK_EQ(CountBarrierNum(graph.render_pass_num, result.barrier_config_list), mip_num);
+    CHECK_EQ(result.barrier_config_list[0][0].size, 0);
+    for (uint32_t i = 1; i <= mip_num; i++) {
+      CAPTURE(i);
+      REQUIRE_EQ(result.barrier_config_list[i][0].size, 1);
+      CHECK_EQ(result.barrier_config_list[i][0].array[0].subresource, i - 1);
+      CHECK_EQ(result.barrier_config_list[i][0].array[0].state_before, rtv);
+      CHECK_EQ(result.barrier_config_list[i][0].array[0].state_after, srv);
+    }
+    CHECK_EQ(result.state_at_frame_end[0], ResourceStateTypeFlags::kSrvPs);
+    // following frames start with the whole chain in srv.
+    graph.initial_state[0] = result.state_at_frame_end[0];
+    result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    CHECK_EQ(CountBarrierNum(graph.render_pass_num, result.barrier_config_list), mip_num * 2);
+    CHECK_EQ(result.barrier_config_list[0][0].size, 1);
+    for (uint32_t i = 1; i < mip_num; i++) {
+      CHECK_EQ(result.barrier_config_list[i][0].size, 2);
+    }
+    CHECK_EQ(result.state_at_frame_end[0], ResourceStateTypeFlags::kSrvPs);
+    // mips read right after being written leave no pass to overlap, read them two passes later to split.
+    const BarrierSplitCostModel split_cost_model{};
+    result = ConfigureBarrierTransitions(graph, command_queue_type, &split_cost_model);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    graph = create_downsample_chain_graph(true, 2);
+    graph.initial_state[0] = ResourceStateTypeFlags::kRtv;
+    result = ConfigureBarrierTransitions(graph, command_queue_type, &split_cost_model);
+    CHECK_UNARY(CheckBarrierConsistency(graph, result.barrier_config_list));
+  }
+  SUBCASE("downsample chain back to a single state at frame end") {
+    auto graph = create_downsample_chain_graph(false);
+    graph.initial_state[0] = ResourceStateTypeFlags::kSrvPs;
+    auto result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    // only the last mip is left in rtv.
+    REQUIRE_EQ(result.barrier_config_list[mip_num - 1][1].size, 1);
+    CHECK_EQ(result.barrier_config_list[mip_num - 1][1].array[0].subresource, mip_num - 1);
+    CHECK_EQ(result.barrier_config_list[mip_num - 1][1].array[0].state_after, srv);
+    CHECK_EQ(result.state_at_frame_end[0], ResourceStateTypeFlags::kSrvPs);
+    graph = create_downsample_chain_graph(true);
+    graph.initial_state[0] = ResourceStateTypeFlags::kSrvPs;
+    graph.final_state[0] = ResourceStateTypeFlags::kRtv;
+    result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    REQUIRE_EQ(result.barrier_config_list[mip_num][1].size, 1);
+    CHECK_EQ(result.barrier_config_list[mip_num][1].array[0].subresource, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    CHECK_EQ(result.barrier_config_list[mip_num][1].array[0].state_before, srv);
+    CHECK_EQ(result.barrier_config_list[mip_num][1].array[0].state_after, rtv);
+    CHECK_EQ(result.state_at_frame_end[0], ResourceStateTypeFlags::kRtv);
+  }
+  SUBCASE("cubemap faces") {
+    const SubresourceLayout layout{.array_num = 6,};
+    auto graph = CreateSubresourceBarrierTestGraph(7, 1, layout);
+    graph.initial_state[0] = ResourceStateTypeFlags::kSrvPs;
+    for (uint16_t i = 0; i < 6; i++) {
+      AddBarrierTestBufferUse(i, 0, ResourceStateTypeFlags::kRtv, {.array_slice = i, .array_num = 1,}, &graph);
+    }
+    AddBarrierTestBufferUse(6, 0, ResourceStateTypeFlags::kSrvPs, {}, &graph);
+    const auto result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    for (uint32_t i = 0; i < 6; i++) {
+      REQUIRE_EQ(result.barrier_config_list[i][0].size, 1);
+      CHECK_EQ(result.barrier_config_list[i][0].array[0].subresource, GetSubresourceIndex(0, i, 0, layout));
+    }
+    // all faces are in rtv, collapsed to a single barrier.
+    REQUIRE_EQ(result.barrier_config_list[6][0].size, 1);
+    CHECK_EQ(result.barrier_config_list[6][0].array[0].subresource, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    CHECK_EQ(result.barrier_config_list[6][0].array[0].state_before, rtv);
+    CHECK_EQ(result.barrier_config_list[6][0].array[0].state_after, srv);
+  }
+  SUBCASE("depth stencil planes") {
+    const SubresourceLayout layout{.plane_num = 2,};
+    auto graph = CreateSubresourceBarrierTestGraph(2, 1, layout);
+    graph.initial_state[0] = ResourceStateTypeFlags::kDsvWrite;
+    AddBarrierTestBufferUse(0, 0, ResourceStateTypeFlags::kSrvPs, {.plane_slice = 1, .plane_num = 1,}, &graph);
+    AddBarrierTestBufferUse(1, 0, ResourceStateTypeFlags::kDsvWrite, {}, &graph);
+    const auto result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(CheckBarrierConsistency(graph, result.barrier_config_list), 0);
+    REQUIRE_EQ(result.barrier_config_list[0][0].size, 1);
+    CHECK_EQ(result.barrier_config_list[0][0].array[0].subresource, 1);
+    REQUIRE_EQ(result.barrier_config_list[1][0].size, 1);
+    CHECK_EQ(result.barrier_config_list[1][0].array[0].subresource, 1);
+    CHECK_EQ(result.state_at_frame_end[0], ResourceStateTypeFlags::kDsvWrite);
+  }
+  SUBCASE("out of range subresource ranges transition the whole resource") {
+    const SubresourceLayout layout{.mip_num = 4,};
+    CHECK_UNARY(IsSubresourceRangeValid({.mip_slice = 3, .mip_num = 1,}, layout));
+    CHECK_UNARY_FALSE(IsSubresourceRangeValid({.mip_slice = 4,}, layout));
+    CHECK_UNARY_FALSE(IsSubresourceRangeValid({.mip_slice = 2, .mip_num = 3,}, layout));
+    CHECK_UNARY_FALSE(IsSubresourceRangeValid({.array_slice = 1,}, layout));
+    CHECK_UNARY_FALSE(IsSubresourceRangeValid({.plane_num = 2,}, layout));
+    auto graph = CreateSubresourceBarrierTestGraph(2, 1, layout);
+    graph.initial_state[0] = ResourceStateTypeFlags::kRtv;
+    AddBarrierTestBufferUse(0, 0, ResourceStateTypeFlags::kRtv, {.mip_slice = 0, .mip_num = 1,}, &graph);
+    AddBarrierTestBufferUse(1, 0, ResourceStateTypeFlags::kSrvPs, {.mip_slice = 3, .mip_num = 2,}, &graph);
+    const auto result = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CHECK_EQ(result.barrier_config_list[0][0].size, 0);
+    REQUIRE_EQ(result.barrier_config_list[1][0].size, 1);
+    CHECK_EQ(result.barrier_config_list[1][0].array[0].subresource, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    CHECK_EQ(result.barrier_config_list[1][0].array[0].state_before, rtv);
+    CHECK_EQ(result.barrier_config_list[1][0].array[0].state_after, srv);
+    CHECK_EQ(result.state_at_frame_end[0], ResourceStateTypeFlags::kSrvPs);
+  }
+  SUBCASE("whole ranges are tracked per buffer") {
+    const D3D12_COMMAND_LIST_TYPE command_queue_type_with_compute[] = {
+      D3D12_COMMAND_LIST_TYPE_DIRECT,
+      D3D12_COMMAND_LIST_TYPE_COMPUTE,
+    };
+    auto graph = CreatePingPongBarrierTestGraph(16, 3, true);
+    const auto expected = ConfigureBarrierTransitions(graph, command_queue_type_with_compute, nullptr);
+    graph.subresource_layout = AllocateAndFillArrayFrame(graph.buffer_num, SubresourceLayout{.mip_num = 4,});
+    graph.render_pass_subresource_range_list = AllocateArrayFrame<SubresourceRange*>(graph.render_pass_num);
+    for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+      graph.render_pass_subresource_range_list[i] = AllocateAndFillArrayFrame(graph.render_pass_buffer_num[i], SubresourceRange{});
+    }
+    const auto result = ConfigureBarrierTransitions(graph, command_queue_type_with_compute, nullptr);
+    for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+      for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+        REQUIRE_EQ(result.barrier_config_list[i][j].size, expected.barrier_config_list[i][j].size);
+        for (uint32_t k = 0; k < result.barrier_config_list[i][j].size; k++) {
+          CHECK_EQ(result.barrier_config_list[i][j].array[k].buffer_allocation_index, expected.barrier_config_list[i][j].array[k].buffer_allocation_index);
+          CHECK_EQ(result.barrier_config_list[i][j].array[k].state_before, expected.barrier_config_list[i][j].array[k].state_before);
+          CHECK_EQ(result.barrier_config_list[i][j].array[k].state_after, expected.barrier_config_list[i][j].array[k].state_after);
+          CHECK_EQ(result.barrier_config_list[i][j].array[k].subresource, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+        }
+      }
+    }
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("barrier planner regressions") { // NOLINT
+  using namespace illuminate;
+  const D3D12_COMMAND_LIST_TYPE command_queue_type[] = {
+    D3D12_COMMAND_LIST_TYPE_DIRECT,
+    D3D12_COMMAND_LIST_TYPE_COMPUTE,
+    D3D12_COMMAND_LIST_TYPE_COPY,
+  };
+  SUBCASE("unused buffer with final_state") {
+    // initial_user_pass of buffer 0 is render_pass_num, which must not index per pass arrays.
+    auto graph = CreateBarrierTestGraph(1, 2);
+    graph.initial_state[0] = ResourceStateTypeFlags::kRtv;
+    graph.final_state[0] = ResourceStateTypeFlags::kSrvPs;
+    graph.initial_state[1] = ResourceStateTypeFlags::kRtv;
+    AddBarrierTestPass(0, {{1, ResourceStateTypeFlags::kRtv}}, {}, &graph);
+    const auto plan = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CheckBarrierConsistency(graph, plan.barrier_config_list);
+    CHECK_EQ(plan.barrier_config_list[0][0].size, 0);
+    REQUIRE_EQ(plan.barrier_config_list[0][1].size, 1);
+    CHECK_EQ(plan.barrier_config_list[0][1].array[0].buffer_allocation_index, 0);
+    CHECK_EQ(plan.barrier_config_list[0][1].array[0].state_before, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK_EQ(plan.barrier_config_list[0][1].array[0].state_after, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK_EQ(plan.state_at_frame_end[0], ResourceStateTypeFlags::kSrvPs);
+  }
+  SUBCASE("waiting for multiple graphics passes") {
+    // the transition from a graphics only state is moved after pass 1, the latest graphics pass pass 2 waits for, not the first one listed.
+    auto graph = CreateBarrierTestGraph(4, 2);
+    graph.initial_state[0] = ResourceStateTypeFlags::kSrvPs;
+    graph.initial_state[1] = ResourceStateTypeFlags::kRtv;
+    AddBarrierTestPass(0, {{1, ResourceStateTypeFlags::kRtv}}, {}, &graph);
+    AddBarrierTestPass(0, {{1, ResourceStateTypeFlags::kSrvPs}}, {}, &graph);
+    AddBarrierTestPass(1, {{0, ResourceStateTypeFlags::kUav}}, {0, 1}, &graph);
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kSrvPs}}, {2}, &graph);
+    const auto plan = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CheckBarrierConsistency(graph, plan.barrier_config_list);
+    CHECK_EQ(plan.barrier_config_list[0][1].size, 0);
+    REQUIRE_EQ(plan.barrier_config_list[1][1].size, 1);
+    CHECK_EQ(plan.barrier_config_list[1][1].array[0].buffer_allocation_index, 0);
+    CHECK_EQ(plan.barrier_config_list[1][1].array[0].state_before, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK_EQ(plan.barrier_config_list[1][1].array[0].state_after, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    CHECK_EQ(plan.barrier_config_list[2][0].size, 0);
+  }
+  SUBCASE("read states are not merged over later writes") {
+    auto graph = CreateBarrierTestGraph(4, 1);
+    graph.initial_state[0] = ResourceStateTypeFlags::kRtv;
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kRtv}}, {}, &graph);
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kSrvPs}}, {}, &graph);
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kRtv}}, {}, &graph);
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kSrvNonPs}}, {}, &graph);
+    const auto plan = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CheckBarrierConsistency(graph, plan.barrier_config_list);
+    CHECK_EQ(CountBarrierNum(graph.render_pass_num, plan.barrier_config_list), 3);
+    REQUIRE_EQ(plan.barrier_config_list[2][0].size, 1);
+    CHECK_EQ(plan.barrier_config_list[2][0].array[0].state_after, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK_EQ(plan.state_at_frame_end[0], ResourceStateTypeFlags::kSrvNonPs);
+  }
+  SUBCASE("merged read states follow the previous use") {
+    // moving the first read to pass 0, the graphics pass the compute queue synchronized with, would precede the uav use in pass 1.
+    // the read states are merged into the next read transition instead.
+    auto graph = CreateBarrierTestGraph(4, 1);
+    graph.initial_state[0] = ResourceStateTypeFlags::kUav;
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kUav}}, {}, &graph);
+    AddBarrierTestPass(1, {{0, ResourceStateTypeFlags::kUav}}, {0}, &graph);
+    AddBarrierTestPass(1, {{0, ResourceStateTypeFlags::kSrvNonPs}}, {}, &graph);
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kSrvPs}}, {2}, &graph);
+    const auto plan = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CheckBarrierConsistency(graph, plan.barrier_config_list);
+    CHECK_EQ(plan.barrier_config_list[0][1].size, 0);
+    REQUIRE_EQ(plan.barrier_config_list[2][0].size, 1);
+    CHECK_EQ(plan.barrier_config_list[2][0].array[0].state_before, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    CHECK_EQ(plan.barrier_config_list[2][0].array[0].state_after, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    REQUIRE_EQ(plan.barrier_config_list[3][0].size, 1);
+    CHECK_EQ(plan.barrier_config_list[3][0].array[0].state_after, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK_EQ(plan.state_at_frame_end[0], ResourceStateTypeFlags::kSrvNonPs | ResourceStateTypeFlags::kSrvPs);
+  }
+  SUBCASE("copy queue transitions follow a preceding compute queue use") {
+    // uav is invalid on the copy queue, the transition is recorded after the compute pass instead of pass 0.
+    auto graph = CreateBarrierTestGraph(4, 1);
+    graph.initial_state[0] = ResourceStateTypeFlags::kUav;
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kUav}}, {}, &graph);
+    AddBarrierTestPass(1, {{0, ResourceStateTypeFlags::kUav}}, {0}, &graph);
+    AddBarrierTestPass(2, {{0, ResourceStateTypeFlags::kCopySrc}}, {1}, &graph);
+    AddBarrierTestPass(0, {{0, ResourceStateTypeFlags::kUav}}, {2}, &graph);
+    const auto plan = ConfigureBarrierTransitions(graph, command_queue_type, nullptr);
+    CheckBarrierConsistency(graph, plan.barrier_config_list);
+    CHECK_EQ(plan.barrier_config_list[0][1].size, 0);
+    REQUIRE_EQ(plan.barrier_config_list[1][1].size, 1);
+    CHECK_EQ(plan.barrier_config_list[1][1].array[0].state_before, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    CHECK_EQ(plan.barrier_config_list[1][1].array[0].state_after, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    REQUIRE_EQ(plan.barrier_config_list[3][0].size, 1);
+    CHECK_EQ(plan.barrier_config_list[3][0].array[0].state_after, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+  }
+  ClearAllAllocations();
+}
+namespace {
+using namespace illuminate;
+// random barrier planner inputs kept in fixed size arrays so that failing cases can be copied and shrunk.
+// valid graphs start and end on the direct queue (queue 0) and passes wait for the previous pass when it is on another queue,
+// so that transitions invalid on compute and copy queues have a synchronized graphics pass to move to
+// and transitions to final_state on the last graphics pass follow all uses.
+struct FuzzBarrierGraph {
+  static constexpr uint32_t kRenderPassNumMax = 24;
+  static constexpr uint32_t kBufferNumMax = 6;
+  static constexpr uint32_t kBufferNumPerPassMax = 3;
+  static constexpr uint32_t kWaitPassNumMax = 2;
+  uint32_t render_pass_num{0};
+  uint32_t buffer_num{0};
+  uint32_t command_queue_num{1};
+  uint32_t render_pass_buffer_num[kRenderPassNumMax]{};
+  uint32_t render_pass_buffer[kRenderPassNumMax][kBufferNumPerPassMax]{};
+  ResourceStateTypeFlags::FlagType render_pass_state[kRenderPassNumMax][kBufferNumPerPassMax]{};
+  uint32_t render_pass_command_queue_index[kRenderPassNumMax]{};
+  uint32_t wait_pass_num[kRenderPassNumMax]{};
+  uint32_t signal_pass_index[kRenderPassNumMax][kWaitPassNumMax]{};
+  ResourceStateTypeFlags::FlagType initial_state[kBufferNumMax]{};
+  ResourceStateTypeFlags::FlagType final_state[kBufferNumMax]{};
+  bool split{false};
+  BarrierSplitCostModel split_cost_model{};
+};
+// queue index i has type kFuzzCommandQueueType[i].
+const D3D12_COMMAND_LIST_TYPE kFuzzCommandQueueType[] = {
+  D3D12_COMMAND_LIST_TYPE_DIRECT,
+  D3D12_COMMAND_LIST_TYPE_COMPUTE,
+  D3D12_COMMAND_LIST_TYPE_COPY,
+};
+const ResourceStateTypeFlags::FlagType kFuzzDirectQueueState[] = {
+  ResourceStateTypeFlags::kRtv, ResourceStateTypeFlags::kSrvPs, ResourceStateTypeFlags::kSrvNonPs, ResourceStateTypeFlags::kUav,
+  ResourceStateTypeFlags::kCbv, ResourceStateTypeFlags::kCopySrc, ResourceStateTypeFlags::kCopyDst,
+};
+const ResourceStateTypeFlags::FlagType kFuzzComputeQueueState[] = {
+  ResourceStateTypeFlags::kSrvNonPs, ResourceStateTypeFlags::kUav, ResourceStateTypeFlags::kCbv,
+};
+const ResourceStateTypeFlags::FlagType kFuzzCopyQueueState[] = {
+  ResourceStateTypeFlags::kCopySrc, ResourceStateTypeFlags::kCopyDst,
+};
+auto IsWaitingForPass(const FuzzBarrierGraph& graph, const uint32_t pass, const uint32_t signal_pass) {
+  for (uint32_t i = 0; i < graph.wait_pass_num[pass]; i++) {
+    if (graph.signal_pass_index[pass][i] == signal_pass) { return true; }
+  }
+  return false;
+}
+// restores validity after shrinking steps.
+void FixupFuzzBarrierGraph(FuzzBarrierGraph* graph) {
+  if (graph->render_pass_num == 0) { return; }
+  graph->render_pass_command_queue_index[0] = 0;
+  graph->render_pass_command_queue_index[graph->render_pass_num - 1] = 0;
+  graph->wait_pass_num[0] = 0;
+  for (uint32_t i = 1; i < graph->render_pass_num; i++) {
+    if (graph->render_pass_command_queue_index[i] == graph->render_pass_command_queue_index[i - 1] || IsWaitingForPass(*graph, i, i - 1)) { continue; }
+    if (graph->wait_pass_num[i] == FuzzBarrierGraph::kWaitPassNumMax) {
+      graph->wait_pass_num[i]--;
+    }
+    graph->signal_pass_index[i][graph->wait_pass_num[i]] = i - 1;
+    graph->wait_pass_num[i]++;
+  }
+}
+auto CreateRandomFuzzBarrierGraph(const uint32_t seed) {
+  Lcg lcg(seed);
+  const auto pick_state = [&lcg](const D3D12_COMMAND_LIST_TYPE type) {
+    switch (type) {
+      case D3D12_COMMAND_LIST_TYPE_COMPUTE: return kFuzzComputeQueueState[lcg.Next(countof(kFuzzComputeQueueState))];
+      case D3D12_COMMAND_LIST_TYPE_COPY:    return kFuzzCopyQueueState[lcg.Next(countof(kFuzzCopyQueueState))];
+      default:                              return kFuzzDirectQueueState[lcg.Next(countof(kFuzzDirectQueueState))];
+    }
+  };
+  FuzzBarrierGraph graph{};
+  graph.render_pass_num = 1 + lcg.Next(FuzzBarrierGraph::kRenderPassNumMax);
+  graph.buffer_num = 1 + lcg.Next(FuzzBarrierGraph::kBufferNumMax);
+  graph.command_queue_num = 1 + lcg.Next(countof(kFuzzCommandQueueType));
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    graph.initial_state[i] = pick_state(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    graph.final_state[i] = (lcg.Next(4) == 0) ? pick_state(D3D12_COMMAND_LIST_TYPE_DIRECT) : ResourceStateTypeFlags::kNone;
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto queue_index = (i == 0) ? 0 : lcg.Next(graph.command_queue_num);
+    graph.render_pass_command_queue_index[i] = queue_index;
+    graph.render_pass_buffer_num[i] = lcg.Next(std::min(graph.buffer_num, FuzzBarrierGraph::kBufferNumPerPassMax) + 1);
+    auto buffer = lcg.Next(graph.buffer_num);
+    const auto stride = 1 + lcg.Next(graph.buffer_num);
+    for (uint32_t j = 0; j < graph.render_pass_buffer_num[i]; j++) {
+      // distinct while stride is coprime with buffer_num, duplicates are dropped otherwise.
+      bool used = false;
+      for (uint32_t k = 0; k < j; k++) {
+        used |= (graph.render_pass_buffer[i][k] == buffer);
+      }
+      if (used) {
+        graph.render_pass_buffer_num[i] = j;
+        break;
+      }
+      graph.render_pass_buffer[i][j] = buffer;
+      graph.render_pass_state[i][j] = pick_state(kFuzzCommandQueueType[queue_index]);
+      buffer = (buffer + stride) % graph.buffer_num;
+    }
+    if (i > 0 && lcg.Next(4) == 0) {
+      const auto signal_pass = lcg.Next(i);
+      if (graph.render_pass_command_queue_index[signal_pass] != queue_index) {
+        graph.signal_pass_index[i][0] = signal_pass;
+        graph.wait_pass_num[i] = 1;
+      }
+    }
+  }
+  FixupFuzzBarrierGraph(&graph);
+  graph.split = (lcg.Next(2) == 0);
+  graph.split_cost_model.min_overlapped_pass_num_after_write = lcg.Next(3);
+  graph.split_cost_model.min_overlapped_pass_num_after_read = lcg.Next(3);
+  return graph;
+}
+auto CreateBarrierTestGraph(const FuzzBarrierGraph& src) {
+  BarrierTestGraph graph{};
+  graph.render_pass_num = src.render_pass_num;
+  graph.buffer_num = src.buffer_num;
+  graph.render_pass_buffer_num = AllocateAndFillArrayFrame(src.render_pass_num, 0U);
+  graph.render_pass_buffer_allocation_index_list = AllocateArrayFrame<uint32_t*>(src.render_pass_num);
+  graph.render_pass_resource_state_list = AllocateArrayFrame<ResourceStateTypeFlags::FlagType*>(src.render_pass_num);
+  graph.wait_pass_num = AllocateArrayFrame<uint32_t>(src.render_pass_num);
+  graph.signal_pass_index = AllocateArrayFrame<uint32_t*>(src.render_pass_num);
+  graph.render_pass_command_queue_index = AllocateArrayFrame<uint32_t>(src.render_pass_num);
+  for (uint32_t i = 0; i < src.render_pass_num; i++) {
+    graph.render_pass_buffer_num[i] = src.render_pass_buffer_num[i];
+    graph.render_pass_buffer_allocation_index_list[i] = AllocateArrayFrame<uint32_t>(FuzzBarrierGraph::kBufferNumPerPassMax);
+    graph.render_pass_resource_state_list[i] = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(FuzzBarrierGraph::kBufferNumPerPassMax);
+    std::copy_n(src.render_pass_buffer[i], src.render_pass_buffer_num[i], graph.render_pass_buffer_allocation_index_list[i]);
+    std::copy_n(src.render_pass_state[i], src.render_pass_buffer_num[i], graph.render_pass_resource_state_list[i]);
+    graph.wait_pass_num[i] = src.wait_pass_num[i];
+    graph.signal_pass_index[i] = AllocateArrayFrame<uint32_t>(FuzzBarrierGraph::kWaitPassNumMax);
+    std::copy_n(src.signal_pass_index[i], src.wait_pass_num[i], graph.signal_pass_index[i]);
+    graph.render_pass_command_queue_index[i] = src.render_pass_command_queue_index[i];
+  }
+  graph.initial_state = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(src.buffer_num);
+  graph.final_state = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(src.buffer_num);
+  std::copy_n(src.initial_state, src.buffer_num, graph.initial_state);
+  std::copy_n(src.final_state, src.buffer_num, graph.final_state);
+  return graph;
+}
+enum class BarrierPlanViolation : uint8_t {
+  kNone,
+  kStateBeforeMismatch,   // state_before differs from the simulated state.
+  kIncompatibleUseState,  // a buffer is not in a state containing its declared use.
+  kRedundantTransition,   // no-op transition, or a transition of a buffer not used since its previous transition.
+  kInvalidStateForQueue,  // graphics-only states on compute queues, states other than copy ones on copy queues.
+  kUnmatchedSplitBarrier, // BEGIN_ONLY without a matching END_ONLY on the same queue before the next use or barrier.
+  kFrameEndStateMismatch, // simulated state at frame end differs from state_at_frame_end or does not contain final_state.
+  kWorseThanOracle,       // differs in frame end states from or has more transitions than ConfigureBarrierTransitions().
+};
+const char* GetBarrierPlanViolationName(const BarrierPlanViolation violation) {
+  switch (violation) {
+    case BarrierPlanViolation::kNone:                   return "none";
+    case BarrierPlanViolation::kStateBeforeMismatch:    return "state before mismatch";
+    case BarrierPlanViolation::kIncompatibleUseState:   return "incompatible use state";
+    case BarrierPlanViolation::kRedundantTransition:    return "redundant transition";
+    case BarrierPlanViolation::kInvalidStateForQueue:   return "invalid state for queue";
+    case BarrierPlanViolation::kUnmatchedSplitBarrier:  return "unmatched split barrier";
+    case BarrierPlanViolation::kFrameEndStateMismatch:  return "frame end state mismatch";
+    case BarrierPlanViolation::kWorseThanOracle:        return "worse than oracle";
+  }
+  return "";
+}
+struct BarrierPlanValidationResult {
+  BarrierPlanViolation violation{BarrierPlanViolation::kNone};
+  uint32_t pass{0}; // render_pass_num for frame end.
+  uint32_t buffer{0};
+};
+// written against D3D12 rules rather than IsStateValidForQueue() to keep the reference independent from the planner.
+auto IsD3d12StateValidForQueue(const D3D12_COMMAND_LIST_TYPE command_queue_type, const D3D12_RESOURCE_STATES state) {
+  switch (command_queue_type) {
+    case D3D12_COMMAND_LIST_TYPE_COMPUTE: {
+      return (state & (D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE | D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)) == 0;
+    }
+    case D3D12_COMMAND_LIST_TYPE_COPY: {
+      return (state & ~(D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_COPY_SOURCE)) == 0;
+    }
+    default: {
+      return true;
+    }
+  }
+}
+auto CountTransitionNum(const uint32_t render_pass_num, const BarrierConfigList* barrier_config_list) {
+  uint32_t transition_num = 0;
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      for (uint32_t k = 0; k < barrier_config_list[i][j].size; k++) {
+        if (barrier_config_list[i][j].array[k].flag != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+          transition_num++;
+        }
+      }
+    }
+  }
+  return transition_num;
+}
+// reference state simulator: replays barriers and buffer uses in pass order (a valid serialization of all queues)
+// and returns the first violation found. buffers are tracked as a whole.
+auto ValidateBarrierPlan(const BarrierTestGraph& graph, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const BarrierTransitionInfo& plan) {
+  auto state = AllocateArrayFrame<D3D12_RESOURCE_STATES>(graph.buffer_num);
+  auto pending = AllocateAndFillArrayFrame(graph.buffer_num, (const BarrierConfig*)nullptr);
+  auto pending_queue = AllocateArrayFrame<uint32_t>(graph.buffer_num);
+  auto used_since_transition = AllocateAndFillArrayFrame(graph.buffer_num, true);
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    state[i] = ResourceStateTypeFlags::ConvertToD3d12ResourceState(graph.initial_state[i]);
+  }
+  auto execute_barriers = [&](const uint32_t pass, const ArrayOf<BarrierConfig>& barriers) {
+    const auto queue = graph.render_pass_command_queue_index[pass];
+    for (uint32_t i = 0; i < barriers.size; i++) {
+      const auto& barrier = barriers.array[i];
+      const auto buffer = barrier.buffer_allocation_index;
+      if (!IsD3d12StateValidForQueue(command_queue_type[queue], barrier.state_before) || !IsD3d12StateValidForQueue(command_queue_type[queue], barrier.state_after)) {
+        return BarrierPlanValidationResult{BarrierPlanViolation::kInvalidStateForQueue, pass, buffer};
+      }
+      if (barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+        if (pending[buffer] == nullptr || pending_queue[buffer] != queue || pending[buffer]->state_before != barrier.state_before || pending[buffer]->state_after != barrier.state_after) {
+          return BarrierPlanValidationResult{BarrierPlanViolation::kUnmatchedSplitBarrier, pass, buffer};
+        }
+        pending[buffer] = nullptr;
+        state[buffer] = barrier.state_after;
+        used_since_transition[buffer] = false;
+        continue;
+      }
+      if (pending[buffer] != nullptr) {
+        return BarrierPlanValidationResult{BarrierPlanViolation::kUnmatchedSplitBarrier, pass, buffer};
+      }
+      if (state[buffer] != barrier.state_before) {
+        return BarrierPlanValidationResult{BarrierPlanViolation::kStateBeforeMismatch, pass, buffer};
+      }
+      if (barrier.state_before == barrier.state_after || !used_since_transition[buffer]) {
+        return BarrierPlanValidationResult{BarrierPlanViolation::kRedundantTransition, pass, buffer};
+      }
+      if (barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+        pending[buffer] = &barrier;
+        pending_queue[buffer] = queue;
+        continue;
+      }
+      state[buffer] = barrier.state_after;
+      used_since_transition[buffer] = false;
+    }
+    return BarrierPlanValidationResult{};
+  };
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    if (const auto result = execute_barriers(i, plan.barrier_config_list[i][0]); result.violation != BarrierPlanViolation::kNone) { return result; }
+    for (uint32_t j = 0; j < graph.render_pass_buffer_num[i]; j++) {
+      const auto buffer = graph.render_pass_buffer_allocation_index_list[i][j];
+      const auto use_state = ResourceStateTypeFlags::ConvertToD3d12ResourceState(graph.render_pass_resource_state_list[i][j]);
+      if (pending[buffer] != nullptr) {
+        return BarrierPlanValidationResult{BarrierPlanViolation::kUnmatchedSplitBarrier, i, buffer};
+      }
+      if ((state[buffer] & use_state) != use_state) {
+        return BarrierPlanValidationResult{BarrierPlanViolation::kIncompatibleUseState, i, buffer};
+      }
+      used_since_transition[buffer] = true;
+    }
+    if (const auto result = execute_barriers(i, plan.barrier_config_list[i][1]); result.violation != BarrierPlanViolation::kNone) { return result; }
+  }
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    if (pending[i] != nullptr) {
+      return BarrierPlanValidationResult{BarrierPlanViolation::kUnmatchedSplitBarrier, graph.render_pass_num, i};
+    }
+    if (state[i] != ResourceStateTypeFlags::ConvertToD3d12ResourceState(plan.state_at_frame_end[i])
+        || (plan.state_at_frame_end[i] & graph.final_state[i]) != graph.final_state[i]) {
+      return BarrierPlanValidationResult{BarrierPlanViolation::kFrameEndStateMismatch, graph.render_pass_num, i};
+    }
+  }
+  return BarrierPlanValidationResult{};
+}
+using BarrierPlanner = BarrierTransitionInfo (*)(const BarrierTestGraph& graph, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const BarrierSplitCostModel* split_cost_model);
+BarrierTransitionInfo ConfigureBarrierTransitionsForFuzzing(const BarrierTestGraph& graph, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const BarrierSplitCostModel* split_cost_model) {
+  return ConfigureBarrierTransitions(graph, command_queue_type, split_cost_model);
+}
+// planners are checked against the reference simulator, candidate planners (e.g. caches or fast paths) also against ConfigureBarrierTransitions() as an oracle.
+// ConfigureBarrierTransitions() itself is checked against the simulator only, comparing it with itself would always pass.
+auto CheckBarrierPlanner(const FuzzBarrierGraph& fuzz_graph, BarrierPlanner planner) {
+  const auto graph = CreateBarrierTestGraph(fuzz_graph);
+  const auto split_cost_model = fuzz_graph.split ? &fuzz_graph.split_cost_model : nullptr;
+  const auto plan = planner(graph, kFuzzCommandQueueType, split_cost_model);
+  if (const auto result = ValidateBarrierPlan(graph, kFuzzCommandQueueType, plan); result.violation != BarrierPlanViolation::kNone) {
+    return result;
+  }
+  if (planner == ConfigureBarrierTransitionsForFuzzing) { return BarrierPlanValidationResult{}; }
+  const auto oracle = ConfigureBarrierTransitions(graph, kFuzzCommandQueueType, split_cost_model);
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    if (plan.state_at_frame_end[i] != oracle.state_at_frame_end[i]) {
+      return BarrierPlanValidationResult{BarrierPlanViolation::kWorseThanOracle, graph.render_pass_num, i};
+    }
+  }
+  if (CountTransitionNum(graph.render_pass_num, plan.barrier_config_list) > CountTransitionNum(graph.render_pass_num, oracle.barrier_config_list)) {
+    return BarrierPlanValidationResult{BarrierPlanViolation::kWorseThanOracle, graph.render_pass_num, 0};
+  }
+  return BarrierPlanValidationResult{};
+}
+auto IsFailingFuzzBarrierGraph(const FuzzBarrierGraph& graph, BarrierPlanner planner) {
+  FrameMemoryCheckpoint checkpoint;
+  return CheckBarrierPlanner(graph, planner).violation != BarrierPlanViolation::kNone;
+}
+auto RemoveFuzzBarrierGraphPass(const FuzzBarrierGraph& src, const uint32_t pass) {
+  auto graph = src;
+  graph.render_pass_num--;
+  for (uint32_t i = pass; i < graph.render_pass_num; i++) {
+    graph.render_pass_buffer_num[i] = src.render_pass_buffer_num[i + 1];
+    std::copy_n(src.render_pass_buffer[i + 1], FuzzBarrierGraph::kBufferNumPerPassMax, graph.render_pass_buffer[i]);
+    std::copy_n(src.render_pass_state[i + 1], FuzzBarrierGraph::kBufferNumPerPassMax, graph.render_pass_state[i]);
+    graph.render_pass_command_queue_index[i] = src.render_pass_command_queue_index[i + 1];
+    graph.wait_pass_num[i] = src.wait_pass_num[i + 1];
+    std::copy_n(src.signal_pass_index[i + 1], FuzzBarrierGraph::kWaitPassNumMax, graph.signal_pass_index[i]);
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    uint32_t wait_pass_num = 0;
+    for (uint32_t j = 0; j < graph.wait_pass_num[i]; j++) {
+      const auto signal_pass = graph.signal_pass_index[i][j];
+      if (signal_pass == pass) { continue; }
+      graph.signal_pass_index[i][wait_pass_num] = (signal_pass > pass) ? signal_pass - 1 : signal_pass;
+      wait_pass_num++;
+    }
+    graph.wait_pass_num[i] = wait_pass_num;
+  }
+  FixupFuzzBarrierGraph(&graph);
+  return graph;
+}
+auto RemoveFuzzBarrierGraphBufferUse(const FuzzBarrierGraph& src, const uint32_t pass, const uint32_t index) {
+  auto graph = src;
+  graph.render_pass_buffer_num[pass]--;
+  for (uint32_t i = index; i < graph.render_pass_buffer_num[pass]; i++) {
+    graph.render_pass_buffer[pass][i] = src.render_pass_buffer[pass][i + 1];
+    graph.render_pass_state[pass][i] = src.render_pass_state[pass][i + 1];
+  }
+  return graph;
+}
+auto RemoveFuzzBarrierGraphBuffer(const FuzzBarrierGraph& src, const uint32_t buffer) {
+  auto graph = src;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    for (uint32_t j = graph.render_pass_buffer_num[i]; j > 0; j--) {
+      if (graph.render_pass_buffer[i][j - 1] == buffer) {
+        graph = RemoveFuzzBarrierGraphBufferUse(graph, i, j - 1);
+      } else if (graph.render_pass_buffer[i][j - 1] > buffer) {
+        graph.render_pass_buffer[i][j - 1]--;
+      }
+    }
+  }
+  graph.buffer_num--;
+  for (uint32_t i = buffer; i < graph.buffer_num; i++) {
+    graph.initial_state[i] = src.initial_state[i + 1];
+    graph.final_state[i] = src.final_state[i + 1];
+  }
+  return graph;
+}
+// greedily applies the first shrinking step that keeps the graph failing until none does.
+auto ShrinkFuzzBarrierGraph(const FuzzBarrierGraph& failing_graph, BarrierPlanner planner) {
+  auto graph = failing_graph;
+  const auto try_step = [&graph, planner](const FuzzBarrierGraph& candidate) {
+    if (!IsFailingFuzzBarrierGraph(candidate, planner)) { return false; }
+    graph = candidate;
+    return true;
+  };
+  bool shrunk = true;
+  while (shrunk) {
+    shrunk = false;
+    for (uint32_t i = graph.render_pass_num; i > 0 && !shrunk && graph.render_pass_num > 1; i--) {
+      shrunk = try_step(RemoveFuzzBarrierGraphPass(graph, i - 1));
+    }
+    for (uint32_t i = graph.buffer_num; i > 0 && !shrunk && graph.buffer_num > 1; i--) {
+      shrunk = try_step(RemoveFuzzBarrierGraphBuffer(graph, i - 1));
+    }
+    for (uint32_t i = 0; i < graph.render_pass_num && !shrunk; i++) {
+      for (uint32_t j = graph.render_pass_buffer_num[i]; j > 0 && !shrunk; j--) {
+        shrunk = try_step(RemoveFuzzBarrierGraphBufferUse(graph, i, j - 1));
+      }
+    }
+    for (uint32_t i = 0; i < graph.render_pass_num && !shrunk; i++) {
+      if (graph.render_pass_command_queue_index[i] == 0) { continue; }
+      // direct queues accept all states.
+      auto candidate = graph;
+      candidate.render_pass_command_queue_index[i] = 0;
+      FixupFuzzBarrierGraph(&candidate);
+      shrunk = try_step(candidate);
+    }
+    for (uint32_t i = 0; i < graph.render_pass_num && !shrunk; i++) {
+      if (graph.wait_pass_num[i] == 0) { continue; }
+      auto candidate = graph;
+      candidate.wait_pass_num[i] = 0;
+      FixupFuzzBarrierGraph(&candidate);
+      shrunk = (candidate.wait_pass_num[i] < graph.wait_pass_num[i]) && try_step(candidate);
+    }
+    for (uint32_t i = 0; i < graph.buffer_num && !shrunk; i++) {
+      if (graph.final_state[i] == ResourceStateTypeFlags::kNone) { continue; }
+      auto candidate = graph;
+      candidate.final_state[i] = ResourceStateTypeFlags::kNone;
+      shrunk = try_step(candidate);
+    }
+    if (!shrunk && graph.split) {
+      auto candidate = graph;
+      candidate.split = false;
+      shrunk = try_step(candidate);
+    }
+  }
+  return graph;
+}
+void LogFuzzBarrierGraph(const FuzzBarrierGraph& graph) {
+  logerror("render_pass_num:{} buffer_num:{} split:{} ({},{})", graph.render_pass_num, graph.buffer_num, graph.split,
+           graph.split_cost_model.min_overlapped_pass_num_after_write, graph.split_cost_model.min_overlapped_pass_num_after_read);
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    logerror("  buffer {} initial:{:#x} final:{:#x}", i, graph.initial_state[i], graph.final_state[i]);
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    logerror("  pass {} queue:{}", i, graph.render_pass_command_queue_index[i]);
+    for (uint32_t j = 0; j < graph.wait_pass_num[i]; j++) {
+      logerror("    wait pass {}", graph.signal_pass_index[i][j]);
+    }
+    for (uint32_t j = 0; j < graph.render_pass_buffer_num[i]; j++) {
+      logerror("    buffer {} state:{:#x}", graph.render_pass_buffer[i][j], graph.render_pass_state[i][j]);
+    }
+  }
+}
+// runs planner on random graphs and returns the shrunk first failing one with its violation, or a graph without passes.
+auto FuzzBarrierPlanner(BarrierPlanner planner, const uint32_t seed, const uint32_t iteration_num) {
+  for (uint32_t i = 0; i < iteration_num; i++) {
+    const auto graph = CreateRandomFuzzBarrierGraph(seed + i);
+    if (!IsFailingFuzzBarrierGraph(graph, planner)) { continue; }
+    const auto shrunk_graph = ShrinkFuzzBarrierGraph(graph, planner);
+    FrameMemoryCheckpoint checkpoint;
+    const auto result = CheckBarrierPlanner(shrunk_graph, planner);
+    logerror("barrier plan violation: {} pass:{} buffer:{} seed:{}", GetBarrierPlanViolationName(result.violation), result.pass, result.buffer, seed + i);
+    LogFuzzBarrierGraph(shrunk_graph);
+    return std::make_pair(shrunk_graph, result);
+  }
+  return std::make_pair(FuzzBarrierGraph{}, BarrierPlanValidationResult{});
+}
+BarrierTransitionInfo ConfigureCachedBarrierTransitionsForFuzzing(const BarrierTestGraph& graph, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const BarrierSplitCostModel* split_cost_model) {
+  BarrierTransitionCache cache;
+  cache.Init(graph.buffer_num, graph.render_pass_num, 1);
+  cache.Register(1, ConfigureBarrierTransitions(graph, command_queue_type, split_cost_model));
+  const auto info = cache.Find(1);
+  cache.Term();
+  return info;
+}
+// drops transitions into uav, i.e. a broken fast path for the fuzzer to catch.
+BarrierTransitionInfo ConfigureBarrierTransitionsWithoutUavTransitions(const BarrierTestGraph& graph, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const BarrierSplitCostModel* split_cost_model) {
+  const auto info = ConfigureBarrierTransitions(graph, command_queue_type, split_cost_model);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      auto& barriers = info.barrier_config_list[i][j];
+      barriers.size = static_cast<uint32_t>(std::remove_if(barriers.array, barriers.array + barriers.size, [](const BarrierConfig& barrier) {
+        return barrier.state_after == D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+      }) - barriers.array);
+    }
+  }
+  return info;
+}
+} // namespace
+TEST_CASE("barrier planner fuzzing") { // NOLINT
+  using namespace illuminate;
+  const uint32_t seed = 1;
+  const uint32_t iteration_num = 2000;
+  SUBCASE("ConfigureBarrierTransitions") {
+    const auto [graph, result] = FuzzBarrierPlanner(ConfigureBarrierTransitionsForFuzzing, seed, iteration_num);
+    CHECK_EQ(result.violation, BarrierPlanViolation::kNone);
+  }
+  SUBCASE("BarrierTransitionCache") {
+    const auto [graph, result] = FuzzBarrierPlanner(ConfigureCachedBarrierTransitionsForFuzzing, seed, iteration_num);
+    CHECK_EQ(result.violation, BarrierPlanViolation::kNone);
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("barrier planner fuzzing shrinks failing graphs") { // NOLINT
+  using namespace illuminate;
+  const auto [graph, result] = FuzzBarrierPlanner(ConfigureBarrierTransitionsWithoutUavTransitions, 1, 2000);
+  CHECK_NE(result.violation, BarrierPlanViolation::kNone);
+  // a single pass using a single buffer as uav suffices.
+  CHECK_EQ(graph.render_pass_num, 1);
+  CHECK_EQ(graph.buffer_num, 1);
+  CHECK_EQ(graph.render_pass_buffer_num[0], 1);
+  CHECK_EQ(graph.render_pass_state[0][0], ResourceStateTypeFlags::kUav);
+  ClearAllAllocations();
+}
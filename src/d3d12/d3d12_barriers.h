@@ -1,15 +1,17 @@
 #ifndef ILLUMINATE_D3D12_BARRIES_H
 #define ILLUMINATE_D3D12_BARRIES_H
+#include "illuminate/util/hash_map.h"
 #include "illuminate/util/util_defines.h"
 #include "d3d12_header_common.h"
+#include "d3d12_memory_allocators.h"
 namespace illuminate {
-enum class MemoryType : uint8_t;
 struct BarrierConfig {
   uint32_t buffer_allocation_index{};
   D3D12_RESOURCE_BARRIER_TYPE type{};
   D3D12_RESOURCE_BARRIER_FLAGS flag{}; // split begin/end/none
   D3D12_RESOURCE_STATES state_before{};
   D3D12_RESOURCE_STATES state_after{};
+  uint32_t subresource{D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES};
 };
 static const uint32_t kBarrierExecutionTimingNum = 2;
 // retval: barrier_config_list[pass_index][timing(0/1)]
@@ -18,12 +20,70 @@ struct BarrierTransitionInfo {
   const BarrierConfigList * barrier_config_list;
   const ResourceStateTypeFlags::FlagType* state_at_frame_end;
 };
+/**
+ * transitions right before a pass can be split into BEGIN_ONLY after the buffer's previous use and END_ONLY before the pass,
+ * when both passes are on the same queue and no signal (i.e. command list submission) lies in between.
+ * splitting pays off when enough passes on the queue overlap the transition, transitions out of write states (cache flushes) sooner than others.
+ **/
+struct BarrierSplitCostModel {
+  uint32_t min_overlapped_pass_num_after_write{1};
+  uint32_t min_overlapped_pass_num_after_read{2};
+};
+/**
+ * buffers bound with partial subresource ranges (e.g. per mip in downsample chains) are tracked per subresource,
+ * other buffers as a whole. transitions covering all subresources in a single state are issued with ALL_SUBRESOURCES,
+ * others per subresource. subresources are transitioned back to a single state by the end of a frame (the state most of them are in,
+ * or final_state), so that state_at_frame_end stays per buffer.
+ **/
+struct BarrierSubresourceInfo {
+  const SubresourceLayout* subresource_layout{nullptr}; // per buffer
+  const SubresourceRange* const * render_pass_subresource_range_list{nullptr}; // same layout as render_pass_buffer_allocation_index_list
+};
 BarrierTransitionInfo ConfigureBarrierTransitions(const uint32_t buffer_num, const uint32_t render_pass_num, const uint32_t* render_pass_buffer_num,
                                                   const uint32_t* const * render_pass_buffer_allocation_index_list,
                                                   const ResourceStateTypeFlags::FlagType* const * render_pass_resource_state_list,
                                                   const uint32_t* wait_pass_num, const uint32_t* const * signal_pass_index,
                                                   const uint32_t* const render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
                                                   const ResourceStateTypeFlags::FlagType* initial_state, const ResourceStateTypeFlags::FlagType* final_state,
-                                                  const MemoryType& memory_type);
+                                                  const MemoryType& memory_type, const BarrierSplitCostModel* split_cost_model = nullptr,
+                                                  const BarrierSubresourceInfo* subresource_info = nullptr);
+/**
+ * barrier plans only change with the active passes, the pingpong and frame buffered allocations bound to them and the buffer states at frame start,
+ * while the render graph config is fixed over the lifetime of a cache.
+ * allocation_variant identifies the bound allocations (e.g. pingpong parity and frame buffer index) and must include any other allocation override.
+ * the split cost model and the subresource info must not change either.
+ **/
+uint64_t CalcBarrierTransitionCacheKey(const uint32_t render_pass_num, const bool* render_pass_enable_flag, const uint64_t allocation_variant,
+                                       const uint32_t buffer_num, const ResourceStateTypeFlags::FlagType* initial_state);
+// keeps barrier plans in scene memory so that ConfigureBarrierTransitions() runs only when the key changes.
+// plans are never evicted since scene memory cannot be freed per plan, plans beyond entry_num_max are not cached (ConfigureBarrierTransitions() runs on every miss).
+// entry_num_max is meant to cover all pass enable and allocation variants of a render graph, re-Init() after Term() when they change.
+// not copyable nor movable, entries_ refers to allocator_.
+class BarrierTransitionCache {
+ public:
+  BarrierTransitionCache() = default;
+  BarrierTransitionCache(const BarrierTransitionCache&) = delete;
+  BarrierTransitionCache(BarrierTransitionCache&&) = delete;
+  BarrierTransitionCache& operator=(const BarrierTransitionCache&) = delete;
+  BarrierTransitionCache& operator=(BarrierTransitionCache&&) = delete;
+  void Init(const uint32_t buffer_num, const uint32_t render_pass_num, const uint32_t entry_num_max);
+  void Term();
+  // returns {nullptr, nullptr} on a miss.
+  BarrierTransitionInfo Find(const uint64_t key) const;
+  // copies info to scene memory and returns the copy, or info itself when it could not be cached.
+  BarrierTransitionInfo Register(const uint64_t key, const BarrierTransitionInfo& info);
+  constexpr auto GetEntryNum() const { return entries_.GetSize(); }
+ private:
+  struct Entry {
+    uint64_t key{};
+    BarrierTransitionInfo info{};
+  };
+  static constexpr StrHash GetMapKey(const uint64_t key) { return static_cast<StrHash>(key ^ (key >> 32)); }
+  MemoryTypeAllocator allocator_{MemoryType::kScene};
+  HashMap<Entry, MemoryTypeAllocator> entries_;
+  uint32_t buffer_num_{0};
+  uint32_t render_pass_num_{0};
+  uint32_t entry_num_max_{0};
+};
 }
 #endif
@@ -0,0 +1,518 @@
+#include "d3d12_buffer_aliasing.h"
+#include <algorithm>
+#include "d3d12_gpu_buffer_allocator.h"
+#include "d3d12_memory_allocators.h"
+#include "d3d12_render_graph_compiler.h"
+#include "d3d12_scene.h"
+#include "d3d12_src_common.h"
+namespace illuminate {
+namespace {
+static const uint32_t kInvalidIndex = ~0U;
+// kUav may read previous contents (IsResourceStateReading()), so buffers first used as uav are not transient.
+constexpr auto IsResourceStateOverwriting(const ResourceStateType state) {
+  switch (state) {
+    case ResourceStateType::kRtv:
+    case ResourceStateType::kDsvWrite:
+    case ResourceStateType::kCopyDst: {
+      return true;
+    }
+  }
+  return false;
+}
+struct BufferAllocationUsage {
+  uint32_t config_index{kInvalidIndex};
+  uint32_t frame_buffer_index{kInvalidIndex}; // kInvalidIndex for allocations used in every frame.
+  bool transient{false};
+  uint32_t* first_pass_per_queue{nullptr};
+  uint32_t* last_pass_per_queue{nullptr};
+};
+auto CollectBufferAllocationUsage(const RenderGraphConfig& render_graph, const bool* render_pass_enable_flag, const uint32_t buffer_allocation_num, BufferLifetime* lifetime) {
+  const auto queue_num = render_graph.command_queue_num;
+  auto usage = AllocateArrayFrame<BufferAllocationUsage>(buffer_allocation_num);
+  auto buffer_allocation_index_base = AllocateArrayFrame<uint32_t>(render_graph.buffer_num);
+  uint32_t buffer_allocation_index = 0;
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    const auto& config = render_graph.buffer_list[i];
+    buffer_allocation_index_base[i] = buffer_allocation_index;
+    const auto alloc_num = GetBufferAllocationNum(config, render_graph.frame_buffer_num);
+    for (uint32_t j = 0; j < alloc_num; j++) {
+      auto& u = usage[buffer_allocation_index + j];
+      u.config_index = i;
+      u.frame_buffer_index = (config.frame_buffered && !config.pingpong) ? j : kInvalidIndex;
+      u.transient = config.heap_type == D3D12_HEAP_TYPE_DEFAULT && !config.descriptor_only;
+      u.first_pass_per_queue = AllocateAndFillArrayFrame(queue_num, kInvalidIndex);
+      u.last_pass_per_queue = AllocateAndFillArrayFrame(queue_num, kInvalidIndex);
+    }
+    buffer_allocation_index += alloc_num;
+  }
+  assert(buffer_allocation_index == buffer_allocation_num);
+  auto write_to_sub = AllocateArrayFrame<bool*>(render_graph.buffer_num);
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    write_to_sub[i] = AllocateArrayFrame<bool>(render_graph.render_pass_num);
+  }
+  ConfigurePingPongBufferWriteToSubList(render_graph.render_pass_num, render_graph.render_pass_list, render_pass_enable_flag, render_graph.buffer_num, write_to_sub);
+  // write_to_sub is per frame, halves keep their roles across frames only when a buffer is flipped an even number of times per frame.
+  auto flip_num = AllocateAndFillArrayFrame(render_graph.buffer_num, 0U);
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    if (!render_pass_enable_flag[i]) { continue; }
+    const auto& render_pass = render_graph.render_pass_list[i];
+    for (uint32_t j = 0; j < render_pass.flip_pingpong_num; j++) {
+      if (render_pass.flip_pingpong_index_list[j] >= render_graph.buffer_num) { continue; }
+      flip_num[render_pass.flip_pingpong_index_list[j]]++;
+    }
+  }
+  // frame buffered copies are only bound in their own frames.
+  for (uint32_t frame_index = 0; frame_index < render_graph.frame_buffer_num; frame_index++) {
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      if (!render_pass_enable_flag[i]) { continue; }
+      const auto& render_pass = render_graph.render_pass_list[i];
+      for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+        const auto& buffer = render_pass.buffer_list[j];
+        if (IsSceneBuffer(buffer.buffer_index) || buffer.buffer_index >= render_graph.buffer_num) { continue; }
+        const auto& config = render_graph.buffer_list[buffer.buffer_index];
+        if (!config.frame_buffered && frame_index > 0) { continue; }
+        const auto local_index = GetBufferLocalIndex(config, buffer.state, write_to_sub[buffer.buffer_index][i], frame_index);
+        const auto index = buffer_allocation_index_base[buffer.buffer_index] + local_index;
+        auto& u = usage[index];
+        if (lifetime[index].first_pass == kInvalidIndex) {
+          lifetime[index].first_pass = i;
+        }
+        if (lifetime[index].first_pass == i && !IsResourceStateOverwriting(buffer.state)) {
+          // read before written in a frame, i.e. contents are carried over frames.
+          u.transient = false;
+        }
+        lifetime[index].last_pass = i;
+        const auto queue_index = render_pass.command_queue_index;
+        if (u.first_pass_per_queue[queue_index] == kInvalidIndex) {
+          u.first_pass_per_queue[queue_index] = i;
+        }
+        u.last_pass_per_queue[queue_index] = i;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < buffer_allocation_num; i++) {
+    if (lifetime[i].first_pass == kInvalidIndex) {
+      usage[i].transient = false;
+    }
+    if (render_graph.buffer_list[usage[i].config_index].pingpong && flip_num[usage[i].config_index] % 2 != 0) {
+      // the half read first in a frame holds what the other half held in the previous frame.
+      usage[i].transient = false;
+    }
+  }
+  return usage;
+}
+// true if every use of a in a frame finishes before any use of b in the same frame, and every use of b before any use of a in the next frame.
+auto IsUseOrdered(const BufferAllocationUsage& a, const BufferAllocationUsage& b, const uint32_t queue_num, const uint32_t* known_pass, const bool frames_serialized) {
+  if (a.frame_buffer_index != b.frame_buffer_index && a.frame_buffer_index != kInvalidIndex && b.frame_buffer_index != kInvalidIndex) {
+    return false;
+  }
+  for (uint32_t qb = 0; qb < queue_num; qb++) {
+    const auto first_pass_b = b.first_pass_per_queue[qb];
+    if (first_pass_b == kInvalidIndex) { continue; }
+    for (uint32_t qa = 0; qa < queue_num; qa++) {
+      const auto last_pass_a = a.last_pass_per_queue[qa];
+      if (last_pass_a == kInvalidIndex) { continue; }
+      if (qa == qb) {
+        if (last_pass_a >= first_pass_b) { return false; }
+        continue;
+      }
+      if (known_pass[first_pass_b * queue_num + qa] < last_pass_a + 1) { return false; }
+    }
+  }
+  // the same frame buffered copy is reused only after the cpu waited for its previous frame.
+  if (frames_serialized || (a.frame_buffer_index != kInvalidIndex && b.frame_buffer_index != kInvalidIndex)) { return true; }
+  // any pass on qb known finished in the next frame implies all passes on qb in the current frame finished.
+  for (uint32_t qa = 0; qa < queue_num; qa++) {
+    const auto first_pass_a = a.first_pass_per_queue[qa];
+    if (first_pass_a == kInvalidIndex) { continue; }
+    for (uint32_t qb = 0; qb < queue_num; qb++) {
+      if (qa == qb || b.last_pass_per_queue[qb] == kInvalidIndex) { continue; }
+      if (known_pass[first_pass_a * queue_num + qb] == 0) { return false; }
+    }
+  }
+  return true;
+}
+struct PlacedRange {
+  uint64_t begin{};
+  uint64_t end{};
+};
+// greedy colouring of the interference graph of lifetimes where colours are byte ranges, largest buffers first.
+auto FindLowestAvailableOffset(PlacedRange* occupied_list, const uint32_t occupied_num, const uint64_t size_in_bytes, const uint64_t alignment) {
+  std::sort(occupied_list, occupied_list + occupied_num, [](const PlacedRange& a, const PlacedRange& b) { return a.begin < b.begin; });
+  uint64_t offset = 0;
+  for (uint32_t i = 0; i < occupied_num; i++) {
+    if (offset + size_in_bytes <= occupied_list[i].begin) { break; }
+    offset = std::max(offset, AlignAddress(occupied_list[i].end, alignment));
+  }
+  return offset;
+}
+} // namespace anonymous
+uint64_t GetBufferPlacementAlignment(const BufferConfig& config) {
+  if (config.dimension != D3D12_RESOURCE_DIMENSION_BUFFER && config.sample_count > 1) {
+    return D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+  }
+  return D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+}
+uint64_t EstimateBufferSizeInBytes(const BufferConfig& config, const MainBufferSize& main_buffer_size) {
+  if (config.descriptor_only) { return 0; }
+  uint64_t size_in_bytes = 0;
+  if (config.dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+    size_in_bytes = static_cast<uint64_t>(config.width);
+  } else {
+    const uint64_t width = GetPhysicalWidth(main_buffer_size, config.size_type, config.width);
+    const uint64_t height = GetPhysicalHeight(main_buffer_size, config.size_type, config.height);
+    uint64_t pixel_num = 0;
+    for (uint32_t i = 0; i < std::max<uint32_t>(config.miplevels, 1); i++) {
+      pixel_num += std::max<uint64_t>(width >> i, 1) * std::max<uint64_t>(height >> i, 1);
+    }
+    size_in_bytes = pixel_num * GetDxgiFormatPerPixelSizeInBytes(config.format) * std::max<uint32_t>(config.depth_or_array_size, 1) * std::max<uint32_t>(config.sample_count, 1);
+  }
+  return AlignAddress(size_in_bytes, GetBufferPlacementAlignment(config));
+}
+BufferAliasingHeapCategory GetBufferAliasingHeapCategory(const BufferConfig& config) {
+  if (config.dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+    return BufferAliasingHeapCategory::kBuffer;
+  }
+  if ((config.descriptor_type_flags & (kDescriptorTypeFlagRtv | kDescriptorTypeFlagDsv)) != 0) {
+    return BufferAliasingHeapCategory::kRtDsTexture;
+  }
+  return BufferAliasingHeapCategory::kNonRtDsTexture;
+}
+BufferAliasingPlan PlanBufferAliasing(const RenderGraphConfig& render_graph, const bool* render_pass_enable_flag, const MainBufferSize& main_buffer_size,
+                                      const BufferAliasingOption& option, const MemoryType& memory_type) {
+  BufferAliasingPlan plan{};
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    plan.buffer_allocation_num += GetBufferAllocationNum(render_graph.buffer_list[i], render_graph.frame_buffer_num);
+  }
+  plan.size_in_bytes = AllocateArray<uint64_t>(memory_type, plan.buffer_allocation_num);
+  plan.lifetime = AllocateArray<BufferLifetime>(memory_type, plan.buffer_allocation_num);
+  plan.heap_index = AllocateArray<uint32_t>(memory_type, plan.buffer_allocation_num);
+  std::fill_n(plan.heap_index, plan.buffer_allocation_num, kInvalidIndex);
+  plan.heap_offset = AllocateArray<uint64_t>(memory_type, plan.buffer_allocation_num);
+  std::fill_n(plan.heap_offset, plan.buffer_allocation_num, 0);
+  plan.heap_category = AllocateArray<BufferAliasingHeapCategory>(memory_type, kBufferAliasingHeapCategoryNum);
+  plan.heap_size_in_bytes = AllocateArray<uint64_t>(memory_type, kBufferAliasingHeapCategoryNum);
+  std::fill_n(plan.heap_size_in_bytes, kBufferAliasingHeapCategoryNum, 0);
+  plan.aliasing_barrier_list = AllocateArray<AliasingBarrierConfig>(memory_type, plan.buffer_allocation_num);
+  FrameMemoryCheckpoint checkpoint;
+  const auto queue_num = render_graph.command_queue_num;
+  const auto usage = CollectBufferAllocationUsage(render_graph, render_pass_enable_flag, plan.buffer_allocation_num, plan.lifetime);
+  const auto known_pass = CollectKnownFinishedPass(render_graph, render_pass_enable_flag, MemoryType::kFrame);
+  auto alignment = AllocateArrayFrame<uint64_t>(plan.buffer_allocation_num);
+  auto category = AllocateArrayFrame<BufferAliasingHeapCategory>(plan.buffer_allocation_num);
+  auto sorted_list = AllocateArrayFrame<uint32_t>(plan.buffer_allocation_num);
+  uint32_t transient_num = 0;
+  for (uint32_t i = 0; i < plan.buffer_allocation_num; i++) {
+    const auto& config = render_graph.buffer_list[usage[i].config_index];
+    plan.size_in_bytes[i] = EstimateBufferSizeInBytes(config, main_buffer_size);
+    alignment[i] = GetBufferPlacementAlignment(config);
+    category[i] = option.mixed_heap_categories ? BufferAliasingHeapCategory::kMixed : GetBufferAliasingHeapCategory(config);
+    if (!usage[i].transient) { continue; }
+    sorted_list[transient_num] = i;
+    transient_num++;
+    plan.transient_size_in_bytes += plan.size_in_bytes[i];
+  }
+  std::sort(sorted_list, sorted_list + transient_num, [&plan](const uint32_t a, const uint32_t b) {
+    if (plan.size_in_bytes[a] != plan.size_in_bytes[b]) { return plan.size_in_bytes[a] > plan.size_in_bytes[b]; }
+    if (plan.lifetime[a].first_pass != plan.lifetime[b].first_pass) { return plan.lifetime[a].first_pass < plan.lifetime[b].first_pass; }
+    return a < b;
+  });
+  // ordered[a * num + b]: uses of a (transient index) come before uses of b.
+  auto ordered = AllocateArrayFrame<bool>(transient_num * transient_num);
+  for (uint32_t a = 0; a < transient_num; a++) {
+    for (uint32_t b = 0; b < transient_num; b++) {
+      ordered[a * transient_num + b] = a != b && IsUseOrdered(usage[sorted_list[a]], usage[sorted_list[b]], queue_num, known_pass, option.frames_serialized);
+    }
+  }
+  auto heap_index_per_category = AllocateAndFillArrayFrame(kBufferAliasingHeapCategoryNum, kInvalidIndex);
+  auto occupied_list = AllocateArrayFrame<PlacedRange>(transient_num);
+  for (uint32_t x = 0; x < transient_num; x++) {
+    const auto index = sorted_list[x];
+    const auto category_index = static_cast<uint32_t>(category[index]);
+    if (heap_index_per_category[category_index] == kInvalidIndex) {
+      heap_index_per_category[category_index] = plan.heap_num;
+      plan.heap_category[plan.heap_num] = category[index];
+      plan.heap_num++;
+    }
+    const auto heap_index = heap_index_per_category[category_index];
+    uint32_t occupied_num = 0;
+    for (uint32_t y = 0; y < x; y++) {
+      const auto placed_index = sorted_list[y];
+      if (plan.heap_index[placed_index] != heap_index) { continue; }
+      if (ordered[x * transient_num + y] || ordered[y * transient_num + x]) { continue; }
+      occupied_list[occupied_num] = {plan.heap_offset[placed_index], plan.heap_offset[placed_index] + plan.size_in_bytes[placed_index]};
+      occupied_num++;
+    }
+    plan.heap_index[index] = heap_index;
+    plan.heap_offset[index] = FindLowestAvailableOffset(occupied_list, occupied_num, plan.size_in_bytes[index], alignment[index]);
+    plan.heap_size_in_bytes[heap_index] = std::max(plan.heap_size_in_bytes[heap_index], plan.heap_offset[index] + plan.size_in_bytes[index]);
+  }
+  for (uint32_t i = 0; i < plan.heap_num; i++) {
+    plan.aliased_size_in_bytes += plan.heap_size_in_bytes[i];
+  }
+  // buffers sharing memory are all ordered one way or the other, the barrier names the preceding buffer when it is unique,
+  // preferring buffers used earlier in the same frame over those used in the previous frame.
+  for (uint32_t x = 0; x < transient_num; x++) {
+    const auto index = sorted_list[x];
+    const auto begin = plan.heap_offset[index];
+    const auto end = begin + plan.size_in_bytes[index];
+    uint32_t overlapped_num = 0, overlapped_index = kInvalidIndex;
+    uint32_t preceding_num = 0, preceding_index = kInvalidIndex;
+    for (uint32_t y = 0; y < transient_num; y++) {
+      const auto other_index = sorted_list[y];
+      if (x == y || plan.heap_index[other_index] != plan.heap_index[index]) { continue; }
+      if (plan.heap_offset[other_index] >= end || plan.heap_offset[other_index] + plan.size_in_bytes[other_index] <= begin) { continue; }
+      overlapped_num++;
+      overlapped_index = other_index;
+      if (plan.lifetime[other_index].last_pass < plan.lifetime[index].first_pass && ordered[y * transient_num + x]) {
+        preceding_num++;
+        preceding_index = other_index;
+      }
+    }
+    if (overlapped_num == 0) { continue; }
+    auto& barrier = plan.aliasing_barrier_list[plan.aliasing_barrier_num];
+    barrier.render_pass_index = plan.lifetime[index].first_pass;
+    if (preceding_num > 0) {
+      barrier.buffer_allocation_index_before = (preceding_num == 1) ? preceding_index : kInvalidIndex;
+    } else {
+      barrier.buffer_allocation_index_before = (overlapped_num == 1) ? overlapped_index : kInvalidIndex;
+    }
+    barrier.buffer_allocation_index_after = index;
+    plan.aliasing_barrier_num++;
+  }
+  std::sort(plan.aliasing_barrier_list, plan.aliasing_barrier_list + plan.aliasing_barrier_num, [](const AliasingBarrierConfig& a, const AliasingBarrierConfig& b) {
+    if (a.render_pass_index != b.render_pass_index) { return a.render_pass_index < b.render_pass_index; }
+    return a.buffer_allocation_index_after < b.buffer_allocation_index_after;
+  });
+  return plan;
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+#include "d3d12_test_util.h"
+namespace {
+using namespace illuminate;
+auto GetTestRenderPassEnableFlag(const RenderGraphConfig& render_graph) {
+  return AllocateAndFillArrayFrame(render_graph.render_pass_num, true);
+}
+} // namespace
+TEST_CASE("buffer size estimation for aliasing") { // NOLINT
+  using namespace illuminate;
+  const MainBufferSize main_buffer_size{.swapchain = {1920, 1080}, .primarybuffer = {1920, 1080},};
+  auto config = CreateTestBufferConfig(0, DXGI_FORMAT_R8G8B8A8_UNORM, kDescriptorTypeFlagRtv);
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 256 * 256 * 4);
+  CHECK_EQ(GetBufferAliasingHeapCategory(config), BufferAliasingHeapCategory::kRtDsTexture);
+  config.miplevels = 9;
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 6 * 65536); // 349524 bytes aligned
+  config.miplevels = 1;
+  config.sample_count = 4;
+  CHECK_EQ(GetBufferPlacementAlignment(config), 4 * 1024 * 1024);
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 4 * 1024 * 1024);
+  config = CreateTestBufferConfig(0, DXGI_FORMAT_R8_UNORM, kDescriptorTypeFlagUav);
+  config.width = 100.0f;
+  config.height = 100.0f;
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 65536);
+  CHECK_EQ(GetBufferAliasingHeapCategory(config), BufferAliasingHeapCategory::kNonRtDsTexture);
+  config.size_type = BufferSizeRelativeness::kPrimaryBufferRelative;
+  config.width = 1.0f;
+  config.height = 1.0f;
+  config.format = DXGI_FORMAT_R32_FLOAT;
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 127 * 65536); // 8294400 bytes aligned
+  config.dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+  config.width = 100.0f;
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 65536);
+  CHECK_EQ(GetBufferAliasingHeapCategory(config), BufferAliasingHeapCategory::kBuffer);
+  config.descriptor_only = true;
+  CHECK_EQ(EstimateBufferSizeInBytes(config, main_buffer_size), 0);
+  ClearAllAllocations();
+}
+TEST_CASE("buffer aliasing plan") { // NOLINT
+  using namespace illuminate;
+  const MainBufferSize main_buffer_size{};
+  const uint64_t size = 256 * 256 * 4;
+  SUBCASE("single queue") {
+    // buffer 0 [0,1], buffer 1 [1,2], buffer 2 [2,3], buffer 3 is read before written.
+    auto render_graph = CreateTestRenderGraph(1, 4, 4);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kRtv}, {3, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[0]);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kSrvPs}, {1, 0, ResourceStateType::kRtv}, {3, 0, ResourceStateType::kRtv}}, {}, &render_graph.render_pass_list[1]);
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kSrvPs}, {2, 0, ResourceStateType::kRtv}}, {}, &render_graph.render_pass_list[2]);
+    SetTestRenderPass(0, {{2, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[3]);
+    const auto plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {}, MemoryType::kFrame);
+    CHECK_EQ(plan.buffer_allocation_num, 4);
+    CHECK_EQ(plan.lifetime[0].first_pass, 0);
+    CHECK_EQ(plan.lifetime[0].last_pass, 1);
+    CHECK_EQ(plan.lifetime[1].first_pass, 1);
+    CHECK_EQ(plan.lifetime[1].last_pass, 2);
+    CHECK_EQ(plan.lifetime[2].first_pass, 2);
+    CHECK_EQ(plan.lifetime[2].last_pass, 3);
+    CHECK_EQ(plan.heap_index[3], ~0U);
+    CHECK_EQ(plan.heap_num, 1);
+    CHECK_EQ(plan.heap_category[0], BufferAliasingHeapCategory::kRtDsTexture);
+    CHECK_EQ(plan.heap_index[0], 0);
+    CHECK_EQ(plan.heap_index[1], 0);
+    CHECK_EQ(plan.heap_index[2], 0);
+    CHECK_EQ(plan.heap_offset[0], plan.heap_offset[2]);
+    CHECK_NE(plan.heap_offset[0], plan.heap_offset[1]);
+    CHECK_EQ(plan.heap_size_in_bytes[0], size * 2);
+    CHECK_EQ(plan.transient_size_in_bytes, size * 3);
+    CHECK_EQ(plan.aliased_size_in_bytes, size * 2);
+    REQUIRE_EQ(plan.aliasing_barrier_num, 2);
+    // buffer 0 follows buffer 2 of the previous frame.
+    CHECK_EQ(plan.aliasing_barrier_list[0].render_pass_index, 0);
+    CHECK_EQ(plan.aliasing_barrier_list[0].buffer_allocation_index_before, 2);
+    CHECK_EQ(plan.aliasing_barrier_list[0].buffer_allocation_index_after, 0);
+    CHECK_EQ(plan.aliasing_barrier_list[1].render_pass_index, 2);
+    CHECK_EQ(plan.aliasing_barrier_list[1].buffer_allocation_index_before, 0);
+    CHECK_EQ(plan.aliasing_barrier_list[1].buffer_allocation_index_after, 2);
+  }
+  SUBCASE("multiple queues") {
+    // buffer 0 is used in pass 0 (queue 0) and pass 1 (queue 1), buffer 1 in pass 2 (queue 1) and pass 3 (queue 0).
+    auto render_graph = CreateTestRenderGraph(2, 4, 2);
+    render_graph.buffer_list[1] = CreateTestBufferConfig(1, DXGI_FORMAT_R8G8B8A8_UNORM, kDescriptorTypeFlagSrv | kDescriptorTypeFlagUav);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kRtv}}, {}, &render_graph.render_pass_list[0]);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[1]);
+    SetTestRenderPass(1, {{1, 0, ResourceStateType::kCopyDst}}, {}, &render_graph.render_pass_list[2]);
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[3]);
+    render_graph.render_pass_list[1].command_queue_index = 1;
+    // different heap categories share memory only with mixed heap categories.
+    auto plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {.frames_serialized = true,}, MemoryType::kFrame);
+    CHECK_EQ(plan.heap_num, 2);
+    CHECK_EQ(plan.aliasing_barrier_num, 0);
+    SetTestRenderPass(1, {{0, 0, ResourceStateType::kSrvNonPs}}, {0}, &render_graph.render_pass_list[1]);
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kSrvPs}}, {2}, &render_graph.render_pass_list[3]);
+    plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {.frames_serialized = true, .mixed_heap_categories = true,}, MemoryType::kFrame);
+    CHECK_EQ(plan.heap_num, 1);
+    CHECK_EQ(plan.heap_category[0], BufferAliasingHeapCategory::kMixed);
+    CHECK_EQ(plan.aliased_size_in_bytes, size);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[1]);
+    render_graph.render_pass_list[1].command_queue_index = 1;
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[3]);
+    render_graph.buffer_list[1].descriptor_type_flags = kDescriptorTypeFlagSrv | kDescriptorTypeFlagRtv;
+    // no sync between queues.
+    plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {.frames_serialized = true,}, MemoryType::kFrame);
+    CHECK_EQ(plan.heap_num, 1);
+    CHECK_EQ(plan.aliased_size_in_bytes, size * 2);
+    // pass 1 waits for pass 0 and pass 3 waits for pass 2.
+    SetTestRenderPass(1, {{0, 0, ResourceStateType::kSrvNonPs}}, {0}, &render_graph.render_pass_list[1]);
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kSrvPs}}, {2}, &render_graph.render_pass_list[3]);
+    plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {.frames_serialized = true,}, MemoryType::kFrame);
+    CHECK_EQ(plan.aliased_size_in_bytes, size);
+    CHECK_EQ(plan.heap_offset[0], plan.heap_offset[1]);
+    // pass 0 of the next frame may overlap pass 2 of the current frame.
+    plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {}, MemoryType::kFrame);
+    CHECK_EQ(plan.aliased_size_in_bytes, size * 2);
+    // unless pass 0 waits for a pass on queue 1.
+    render_graph.render_pass_num = 5;
+    auto render_pass_list = AllocateArrayFrame<RenderPass>(render_graph.render_pass_num);
+    std::copy_n(render_graph.render_pass_list, 4, &render_pass_list[1]);
+    render_graph.render_pass_list = render_pass_list;
+    SetTestRenderPass(1, {}, {}, &render_graph.render_pass_list[0]);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kRtv}}, {0}, &render_graph.render_pass_list[1]);
+    render_graph.render_pass_list[2].signal_pass_index[0] = 1;
+    render_graph.render_pass_list[4].signal_pass_index[0] = 3;
+    plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {}, MemoryType::kFrame);
+    CHECK_EQ(plan.aliased_size_in_bytes, size);
+    // disabled passes do not signal.
+    auto render_pass_enable_flag = GetTestRenderPassEnableFlag(render_graph);
+    render_pass_enable_flag[0] = false;
+    plan = PlanBufferAliasing(render_graph, render_pass_enable_flag, main_buffer_size, {}, MemoryType::kFrame);
+    CHECK_EQ(plan.aliased_size_in_bytes, size * 2);
+  }
+  SUBCASE("pingpong and frame buffered") {
+    // buffer 0: pingpong written in pass 0 and 1, flipped after pass 0 and 1. buffer 1 and 2: frame buffered.
+    auto render_graph = CreateTestRenderGraph(1, 4, 3);
+    render_graph.buffer_list[0].pingpong = true;
+    render_graph.buffer_list[1].frame_buffered = true;
+    render_graph.buffer_list[2].frame_buffered = true;
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kRtv}, {1, 0, ResourceStateType::kRtv}}, {}, &render_graph.render_pass_list[0]);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kSrvPs}, {0, 0, ResourceStateType::kRtv}, {1, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[1]);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kSrvPs}, {2, 0, ResourceStateType::kRtv}}, {}, &render_graph.render_pass_list[2]);
+    SetTestRenderPass(0, {{2, 0, ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[3]);
+    uint32_t flip_pingpong_index_list[] = {0};
+    render_graph.render_pass_list[0].flip_pingpong_num = 1;
+    render_graph.render_pass_list[0].flip_pingpong_index_list = flip_pingpong_index_list;
+    render_graph.render_pass_list[1].flip_pingpong_num = 1;
+    render_graph.render_pass_list[1].flip_pingpong_index_list = flip_pingpong_index_list;
+    const auto plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {}, MemoryType::kFrame);
+    // allocations: 0,1 pingpong main/sub, 2,3 buffer 1 frame 0/1, 4,5 buffer 2 frame 0/1
+    CHECK_EQ(plan.buffer_allocation_num, 6);
+    CHECK_EQ(plan.lifetime[0].first_pass, 0);
+    CHECK_EQ(plan.lifetime[0].last_pass, 1);
+    CHECK_EQ(plan.lifetime[1].first_pass, 1);
+    CHECK_EQ(plan.lifetime[1].last_pass, 2);
+    for (uint32_t i = 2; i < 4; i++) {
+      CHECK_EQ(plan.lifetime[i].first_pass, 0);
+      CHECK_EQ(plan.lifetime[i].last_pass, 1);
+      CHECK_EQ(plan.lifetime[i + 2].first_pass, 2);
+      CHECK_EQ(plan.lifetime[i + 2].last_pass, 3);
+    }
+    for (uint32_t i = 0; i < plan.buffer_allocation_num; i++) {
+      CHECK_EQ(plan.heap_index[i], 0);
+    }
+    // frame buffered copies of different frames never share memory.
+    CHECK_NE(plan.heap_offset[2], plan.heap_offset[3]);
+    CHECK_NE(plan.heap_offset[2], plan.heap_offset[5]);
+    CHECK_NE(plan.heap_offset[3], plan.heap_offset[4]);
+    CHECK_NE(plan.heap_offset[4], plan.heap_offset[5]);
+    CHECK_NE(plan.heap_offset[0], plan.heap_offset[1]);
+    CHECK_EQ(plan.transient_size_in_bytes, size * 6);
+    CHECK_EQ(plan.aliased_size_in_bytes, size * 4);
+    // flipped once per frame, halves swap roles in the next frame.
+    render_graph.render_pass_list[1].flip_pingpong_num = 0;
+    const auto plan_odd_flip = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {}, MemoryType::kFrame);
+    CHECK_EQ(plan_odd_flip.heap_index[0], ~0U);
+    CHECK_EQ(plan_odd_flip.heap_index[1], ~0U);
+    CHECK_EQ(plan_odd_flip.transient_size_in_bytes, size * 4);
+  }
+  SUBCASE("uav first use") {
+    // buffer 0 [0,1] and buffer 1 [2,3] are first used as uav, which may accumulate into contents of the previous frame.
+    auto render_graph = CreateTestRenderGraph(1, 4, 2);
+    for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+      render_graph.buffer_list[i] = CreateTestBufferConfig(i, DXGI_FORMAT_R8G8B8A8_UNORM, kDescriptorTypeFlagSrv | kDescriptorTypeFlagUav);
+    }
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kUav}}, {}, &render_graph.render_pass_list[0]);
+    SetTestRenderPass(0, {{0, 0, ResourceStateType::kSrvNonPs}}, {}, &render_graph.render_pass_list[1]);
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kUav}}, {}, &render_graph.render_pass_list[2]);
+    SetTestRenderPass(0, {{1, 0, ResourceStateType::kSrvNonPs}}, {}, &render_graph.render_pass_list[3]);
+    auto plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {.frames_serialized = true,}, MemoryType::kFrame);
+    CHECK_EQ(plan.heap_index[0], ~0U);
+    CHECK_EQ(plan.heap_index[1], ~0U);
+    CHECK_EQ(plan.heap_num, 0);
+    CHECK_EQ(plan.transient_size_in_bytes, 0);
+    CHECK_EQ(plan.aliasing_barrier_num, 0);
+    // fully overwritten by copy instead.
+    render_graph.render_pass_list[0].buffer_list[0].state = ResourceStateType::kCopyDst;
+    render_graph.render_pass_list[2].buffer_list[0].state = ResourceStateType::kCopyDst;
+    plan = PlanBufferAliasing(render_graph, GetTestRenderPassEnableFlag(render_graph), main_buffer_size, {.frames_serialized = true,}, MemoryType::kFrame);
+    CHECK_EQ(plan.heap_num, 1);
+    CHECK_EQ(plan.heap_offset[0], plan.heap_offset[1]);
+    CHECK_EQ(plan.aliased_size_in_bytes, size);
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("buffer aliasing report for deferred.json" * doctest::skip()) { // NOLINT
+  using namespace illuminate;
+  RenderGraphConfig render_graph{};
+  LoadTestRenderGraph(LoadTestJson("deferred.json"), &render_graph);
+  auto render_pass_enable_flag = AllocateArrayFrame<bool>(render_graph.render_pass_num);
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    render_pass_enable_flag[i] = render_graph.render_pass_list[i].enabled;
+  }
+  const Size2d resolution_list[] = {{1920, 1080}, {2560, 1440}, {3840, 2160},};
+  for (const auto& resolution : resolution_list) {
+    const MainBufferSize main_buffer_size{.swapchain = resolution, .primarybuffer = resolution,};
+    for (uint32_t i = 0; i < 4; i++) {
+      const BufferAliasingOption option{.frames_serialized = (i & 1) != 0, .mixed_heap_categories = (i & 2) != 0,};
+      const auto plan = PlanBufferAliasing(render_graph, render_pass_enable_flag, main_buffer_size, option, MemoryType::kFrame);
+      CHECK_LE(plan.aliased_size_in_bytes, plan.transient_size_in_bytes);
+      if (option.frames_serialized && option.mixed_heap_categories) {
+        // dsv and primary buffer share memory.
+        CHECK_LT(plan.aliased_size_in_bytes, plan.transient_size_in_bytes);
+      }
+      spdlog::info("deferred.json {}x{} frames {} heap tier {}: transient {:.2f}MiB aliased {:.2f}MiB saved {:.2f}MiB heaps:{} aliasing barriers:{}",
+                   resolution.width, resolution.height, option.frames_serialized ? "serialized" : "overlapped", option.mixed_heap_categories ? 2 : 1,
+                   static_cast<double>(plan.transient_size_in_bytes) / (1024.0 * 1024.0), static_cast<double>(plan.aliased_size_in_bytes) / (1024.0 * 1024.0),
+                   static_cast<double>(plan.transient_size_in_bytes - plan.aliased_size_in_bytes) / (1024.0 * 1024.0), plan.heap_num, plan.aliasing_barrier_num);
+    }
+  }
+  ClearAllAllocations();
+}
@@ -0,0 +1,57 @@
+#ifndef ILLUMINATE_D3D12_BUFFER_ALIASING_H
+#define ILLUMINATE_D3D12_BUFFER_ALIASING_H
+#include "d3d12_header_common.h"
+#include "d3d12_render_graph.h"
+#include "illuminate/util/util_defines.h"
+namespace illuminate {
+enum class MemoryType : uint8_t;
+/**
+ * cpu-side plan for placing transient buffers in shared heaps, no gpu object is touched.
+ * buffer allocation indices follow CreateBuffers(), i.e. pingpong and frame buffered copies are planned individually.
+ * a buffer is transient when it lives in a default heap and its first use in a frame overwrites it (rtv, dsv write or copy dst),
+ * pingpong halves only when enabled passes flip the buffer an even number of times per frame,
+ * the first pass using it must then fully initialize it (clear, discard or full overwrite) after the aliasing barrier.
+ * two buffers may share memory only when every use of one is ordered before every use of the other on the gpu,
+ * by queue order or by the graph's wait passes (transitively). frames are assumed to overlap on the gpu unless frames_serialized is set,
+ * in which case the next frame's passes must be ordered after the current frame's by other means (e.g. a queue wait at frame start).
+ * heaps are split by BufferAliasingHeapCategory as D3D12_RESOURCE_HEAP_TIER_1 requires, unless mixed_heap_categories is set (tier 2).
+ * frame buffered copies with different indices never share memory since they belong to frames in flight.
+ * sizes are estimated from GetDxgiFormatPerPixelSizeInBytes() (no padding nor tiling) and placement alignment rules.
+ * plans are made for the given enabled passes, a different set (or a debug view reading other buffers) needs a new plan.
+ **/
+enum class BufferAliasingHeapCategory : uint8_t { kBuffer = 0, kRtDsTexture, kNonRtDsTexture, kMixed, };
+static const uint32_t kBufferAliasingHeapCategoryNum = 4;
+struct BufferAliasingOption {
+  bool frames_serialized{false};
+  bool mixed_heap_categories{false};
+};
+struct BufferLifetime {
+  uint32_t first_pass{~0U}; // render pass list index, ~0U for buffers not used by any enabled pass.
+  uint32_t last_pass{~0U};
+};
+struct AliasingBarrierConfig {
+  uint32_t render_pass_index{};
+  uint32_t buffer_allocation_index_before{}; // ~0U when several buffers preceded it in the range (i.e. pResourceBefore = nullptr).
+  uint32_t buffer_allocation_index_after{};
+};
+struct BufferAliasingPlan {
+  uint32_t buffer_allocation_num{0};
+  uint64_t* size_in_bytes{nullptr}; // estimated and aligned, 0 for descriptor only buffers.
+  BufferLifetime* lifetime{nullptr};
+  uint32_t* heap_index{nullptr}; // ~0U for buffers not placed in aliasing heaps.
+  uint64_t* heap_offset{nullptr};
+  uint32_t heap_num{0};
+  BufferAliasingHeapCategory* heap_category{nullptr};
+  uint64_t* heap_size_in_bytes{nullptr};
+  uint32_t aliasing_barrier_num{0};
+  AliasingBarrierConfig* aliasing_barrier_list{nullptr}; // sorted by render pass index.
+  uint64_t transient_size_in_bytes{0}; // sum of transient buffer sizes, i.e. memory used without aliasing.
+  uint64_t aliased_size_in_bytes{0}; // sum of heap sizes.
+};
+uint64_t EstimateBufferSizeInBytes(const BufferConfig& config, const MainBufferSize& main_buffer_size);
+uint64_t GetBufferPlacementAlignment(const BufferConfig& config);
+BufferAliasingHeapCategory GetBufferAliasingHeapCategory(const BufferConfig& config);
+BufferAliasingPlan PlanBufferAliasing(const RenderGraphConfig& render_graph, const bool* render_pass_enable_flag, const MainBufferSize& main_buffer_size,
+                                      const BufferAliasingOption& option, const MemoryType& memory_type);
+}
+#endif
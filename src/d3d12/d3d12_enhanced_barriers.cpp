@@ -0,0 +1,329 @@
+#include "d3d12_enhanced_barriers.h"
+#include <algorithm>
+#include "d3d12_memory_allocators.h"
+#include "d3d12_src_common.h"
+namespace illuminate {
+namespace {
+constexpr auto IsAccessReadOnly(const D3D12_BARRIER_ACCESS access) {
+  // ACCESS_COMMON allows any access the layout supports, including writes.
+  if (access == D3D12_BARRIER_ACCESS_COMMON) { return false; }
+  const auto write_access = D3D12_BARRIER_ACCESS_RENDER_TARGET | D3D12_BARRIER_ACCESS_UNORDERED_ACCESS | D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE
+      | D3D12_BARRIER_ACCESS_STREAM_OUTPUT | D3D12_BARRIER_ACCESS_COPY_DEST | D3D12_BARRIER_ACCESS_RESOLVE_DEST;
+  return (access & write_access) == 0;
+}
+} // namespace
+EnhancedBarrierScope GetEnhancedBarrierScope(const D3D12_RESOURCE_STATES state, const D3D12_COMMAND_LIST_TYPE command_queue_type) {
+  if (state == D3D12_RESOURCE_STATE_COMMON) {
+    return {D3D12_BARRIER_SYNC_ALL, D3D12_BARRIER_ACCESS_COMMON, D3D12_BARRIER_LAYOUT_COMMON};
+  }
+  const auto compute_queue = (command_queue_type == D3D12_COMMAND_LIST_TYPE_COMPUTE);
+  const auto all_shading = compute_queue ? D3D12_BARRIER_SYNC_COMPUTE_SHADING : D3D12_BARRIER_SYNC_ALL_SHADING;
+  const auto non_pixel_shading = compute_queue ? D3D12_BARRIER_SYNC_COMPUTE_SHADING : D3D12_BARRIER_SYNC_NON_PIXEL_SHADING;
+  EnhancedBarrierScope scope{D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_ACCESS_COMMON, D3D12_BARRIER_LAYOUT_GENERIC_READ};
+  const auto add = [&scope, state](const D3D12_RESOURCE_STATES state_bit, const D3D12_BARRIER_SYNC sync, const D3D12_BARRIER_ACCESS access) {
+    if ((state & state_bit) == 0) { return; }
+    scope.sync |= sync;
+    scope.access |= access;
+  };
+  add(D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, all_shading, compute_queue ? D3D12_BARRIER_ACCESS_CONSTANT_BUFFER : (D3D12_BARRIER_ACCESS_VERTEX_BUFFER | D3D12_BARRIER_ACCESS_CONSTANT_BUFFER));
+  add(D3D12_RESOURCE_STATE_INDEX_BUFFER, D3D12_BARRIER_SYNC_INDEX_INPUT, D3D12_BARRIER_ACCESS_INDEX_BUFFER);
+  add(D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_BARRIER_SYNC_RENDER_TARGET, D3D12_BARRIER_ACCESS_RENDER_TARGET);
+  add(D3D12_RESOURCE_STATE_UNORDERED_ACCESS, all_shading, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  add(D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE);
+  add(D3D12_RESOURCE_STATE_DEPTH_READ, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ);
+  add(D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, non_pixel_shading, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  add(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  add(D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT);
+  add(D3D12_RESOURCE_STATE_COPY_DEST, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST);
+  add(D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE);
+  add(D3D12_RESOURCE_STATE_RESOLVE_DEST, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_DEST);
+  add(D3D12_RESOURCE_STATE_RESOLVE_SOURCE, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_SOURCE);
+  // write states take a single layout, read only states share one when they can.
+  if (state & D3D12_RESOURCE_STATE_RENDER_TARGET) {
+    scope.layout = D3D12_BARRIER_LAYOUT_RENDER_TARGET;
+  } else if (state & D3D12_RESOURCE_STATE_DEPTH_WRITE) {
+    scope.layout = D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE;
+  } else if (state & D3D12_RESOURCE_STATE_UNORDERED_ACCESS) {
+    scope.layout = D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS;
+  } else if (state & D3D12_RESOURCE_STATE_COPY_DEST) {
+    scope.layout = D3D12_BARRIER_LAYOUT_COPY_DEST;
+  } else if (state & D3D12_RESOURCE_STATE_RESOLVE_DEST) {
+    scope.layout = D3D12_BARRIER_LAYOUT_RESOLVE_DEST;
+  } else if (state & D3D12_RESOURCE_STATE_DEPTH_READ) {
+    scope.layout = D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ;
+  } else if (scope.access == D3D12_BARRIER_ACCESS_SHADER_RESOURCE) {
+    scope.layout = D3D12_BARRIER_LAYOUT_SHADER_RESOURCE;
+  } else if (scope.access == D3D12_BARRIER_ACCESS_COPY_SOURCE) {
+    scope.layout = D3D12_BARRIER_LAYOUT_COPY_SOURCE;
+  } else if (scope.access == D3D12_BARRIER_ACCESS_RESOLVE_SOURCE) {
+    scope.layout = D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE;
+  }
+  return scope;
+}
+EnhancedBarrierConfigList* ConvertToEnhancedBarriers(const uint32_t render_pass_num, const BarrierConfigList* barrier_config_list,
+                                                     const uint32_t* render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
+                                                     const uint32_t buffer_allocation_num, const bool* texture_flag, const MemoryType& memory_type) {
+  // retvals are allocated up front so that the temporaries below can be released even when memory_type is kFrame.
+  auto enhanced_barrier_config_list = AllocateArray<ArrayOf<EnhancedBarrierConfig>*>(memory_type, render_pass_num);
+  uint32_t barrier_num = 0;
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    enhanced_barrier_config_list[i] = AllocateArray<ArrayOf<EnhancedBarrierConfig>>(memory_type, kBarrierExecutionTimingNum);
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      barrier_num += barrier_config_list[i][j].size;
+    }
+  }
+  auto barrier_config_pool = AllocateArray<EnhancedBarrierConfig>(memory_type, barrier_num);
+  FrameMemoryCheckpoint checkpoint;
+  uint32_t queue_num = 0;
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    queue_num = std::max(queue_num, render_pass_command_queue_index[i] + 1);
+  }
+  // accesses of removed read only transitions per buffer and queue ([buffer * queue_num + queue_index]),
+  // waited for by the next barrier of the buffer on the same queue. other queues' reads are ordered by fences and dropped.
+  auto pending_sync = AllocateAndFillArrayFrame(buffer_allocation_num * queue_num, D3D12_BARRIER_SYNC_NONE);
+  auto pending_access = AllocateAndFillArrayFrame(buffer_allocation_num * queue_num, D3D12_BARRIER_ACCESS_COMMON);
+  // END_ONLY barriers repeat the accesses of their BEGIN_ONLY barriers.
+  auto split_sync = AllocateAndFillArrayFrame(buffer_allocation_num, D3D12_BARRIER_SYNC_NONE);
+  auto split_access = AllocateAndFillArrayFrame(buffer_allocation_num, D3D12_BARRIER_ACCESS_COMMON);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    const auto queue_index = render_pass_command_queue_index[i];
+    const auto queue = command_queue_type[queue_index];
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      auto& dst_barrier_list = enhanced_barrier_config_list[i][j];
+      dst_barrier_list.array = barrier_config_pool;
+      dst_barrier_list.size = 0;
+      for (uint32_t k = 0; k < barrier_config_list[i][j].size; k++) {
+        const auto& src_barrier = barrier_config_list[i][j].array[k];
+        const auto buffer = src_barrier.buffer_allocation_index;
+        const auto before = GetEnhancedBarrierScope(src_barrier.state_before, queue);
+        const auto after  = GetEnhancedBarrierScope(src_barrier.state_after, queue);
+        const auto texture = texture_flag[buffer];
+        if (IsAccessReadOnly(before.access) && IsAccessReadOnly(after.access) && (!texture || before.layout == after.layout)) {
+          if (src_barrier.flag != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+            pending_sync[buffer * queue_num + queue_index] |= before.sync;
+            pending_access[buffer * queue_num + queue_index] |= before.access;
+          }
+          continue;
+        }
+        auto sync_before = before.sync;
+        auto access_before = before.access;
+        if (access_before != D3D12_BARRIER_ACCESS_COMMON) {
+          sync_before |= pending_sync[buffer * queue_num + queue_index];
+          access_before |= pending_access[buffer * queue_num + queue_index];
+        }
+        if (src_barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+          sync_before = split_sync[buffer];
+          access_before = split_access[buffer];
+        }
+        auto& dst_barrier = dst_barrier_list.array[dst_barrier_list.size];
+        dst_barrier_list.size++;
+        dst_barrier.buffer_allocation_index = buffer;
+        dst_barrier.type = texture ? D3D12_BARRIER_TYPE_TEXTURE : D3D12_BARRIER_TYPE_BUFFER;
+        dst_barrier.sync_before = (src_barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) ? D3D12_BARRIER_SYNC_SPLIT : sync_before;
+        dst_barrier.sync_after = (src_barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) ? D3D12_BARRIER_SYNC_SPLIT : after.sync;
+        dst_barrier.access_before = access_before;
+        dst_barrier.access_after = after.access;
+        dst_barrier.layout_before = texture ? before.layout : D3D12_BARRIER_LAYOUT_UNDEFINED;
+        dst_barrier.layout_after = texture ? after.layout : D3D12_BARRIER_LAYOUT_UNDEFINED;
+        dst_barrier.subresource = src_barrier.subresource;
+        if (src_barrier.flag == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+          split_sync[buffer] = sync_before;
+          split_access[buffer] = access_before;
+        }
+        std::fill_n(&pending_sync[buffer * queue_num], queue_num, D3D12_BARRIER_SYNC_NONE);
+        std::fill_n(&pending_access[buffer * queue_num], queue_num, D3D12_BARRIER_ACCESS_COMMON);
+      }
+      barrier_config_pool += dst_barrier_list.size;
+    }
+  }
+  return enhanced_barrier_config_list;
+}
+uint32_t FillEnhancedBarrierGroups(const uint32_t barrier_num, const EnhancedBarrierConfig* barrier_config_list, ID3D12Resource** resource,
+                                   D3D12_BUFFER_BARRIER* buffer_barriers, D3D12_TEXTURE_BARRIER* texture_barriers, D3D12_BARRIER_GROUP* barrier_groups) {
+  uint32_t buffer_barrier_num = 0;
+  uint32_t texture_barrier_num = 0;
+  for (uint32_t i = 0; i < barrier_num; i++) {
+    const auto& config = barrier_config_list[i];
+    if (config.type == D3D12_BARRIER_TYPE_TEXTURE) {
+      auto& barrier = texture_barriers[texture_barrier_num];
+      texture_barrier_num++;
+      barrier.SyncBefore   = config.sync_before;
+      barrier.SyncAfter    = config.sync_after;
+      barrier.AccessBefore = config.access_before;
+      barrier.AccessAfter  = config.access_after;
+      barrier.LayoutBefore = config.layout_before;
+      barrier.LayoutAfter  = config.layout_after;
+      barrier.pResource    = resource[i];
+      // a subresource index (or all subresources) when NumMipLevels is 0.
+      barrier.Subresources = {.IndexOrFirstMipLevel = config.subresource, .NumMipLevels = 0, .FirstArraySlice = 0, .NumArraySlices = 0, .FirstPlane = 0, .NumPlanes = 0,};
+      barrier.Flags        = D3D12_TEXTURE_BARRIER_FLAG_NONE;
+      continue;
+    }
+    auto& barrier = buffer_barriers[buffer_barrier_num];
+    buffer_barrier_num++;
+    barrier.SyncBefore   = config.sync_before;
+    barrier.SyncAfter    = config.sync_after;
+    barrier.AccessBefore = config.access_before;
+    barrier.AccessAfter  = config.access_after;
+    barrier.pResource    = resource[i];
+    barrier.Offset       = 0;
+    barrier.Size         = UINT64_MAX;
+  }
+  uint32_t group_num = 0;
+  if (buffer_barrier_num > 0) {
+    barrier_groups[group_num].Type = D3D12_BARRIER_TYPE_BUFFER;
+    barrier_groups[group_num].NumBarriers = buffer_barrier_num;
+    barrier_groups[group_num].pBufferBarriers = buffer_barriers;
+    group_num++;
+  }
+  if (texture_barrier_num > 0) {
+    barrier_groups[group_num].Type = D3D12_BARRIER_TYPE_TEXTURE;
+    barrier_groups[group_num].NumBarriers = texture_barrier_num;
+    barrier_groups[group_num].pTextureBarriers = texture_barriers;
+    group_num++;
+  }
+  return group_num;
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+#include "d3d12_test_util.h"
+TEST_CASE("enhanced barrier scope") { // NOLINT
+  using namespace illuminate;
+  auto scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_COMMAND_LIST_TYPE_DIRECT);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_NON_PIXEL_SHADING);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_COMPUTE_SHADING);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_COMPUTE_SHADING);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_COMMAND_LIST_TYPE_DIRECT);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_ALL_SHADING);
+  // srv states share a layout.
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_COMMAND_LIST_TYPE_DIRECT);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_PIXEL_SHADING | D3D12_BARRIER_SYNC_NON_PIXEL_SHADING);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_COMMAND_LIST_TYPE_DIRECT);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_DEPTH_STENCIL | D3D12_BARRIER_SYNC_PIXEL_SHADING);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ | D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_COMMAND_LIST_TYPE_DIRECT);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_RENDER_TARGET);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_RENDER_TARGET);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_COMMAND_LIST_TYPE_COPY);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_COPY);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_COPY_SOURCE);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_COPY_SOURCE);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_COMMAND_LIST_TYPE_DIRECT);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_GENERIC_READ);
+  scope = GetEnhancedBarrierScope(D3D12_RESOURCE_STATE_COMMON, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+  CHECK_EQ(scope.sync, D3D12_BARRIER_SYNC_ALL);
+  CHECK_EQ(scope.access, D3D12_BARRIER_ACCESS_COMMON);
+  CHECK_EQ(scope.layout, D3D12_BARRIER_LAYOUT_COMMON);
+  ClearAllAllocations();
+}
+TEST_CASE("convert to enhanced barriers") { // NOLINT
+  using namespace illuminate;
+  // 0:direct, 1:compute, 2:direct, 3:compute, 4:direct
+  const uint32_t render_pass_command_queue_index[] = {0, 1, 0, 1, 0,};
+  const D3D12_COMMAND_LIST_TYPE command_queue_type[] = {D3D12_COMMAND_LIST_TYPE_DIRECT, D3D12_COMMAND_LIST_TYPE_COMPUTE,};
+  const auto render_pass_num = countof(render_pass_command_queue_index);
+  // 0:texture, 1:buffer, 2:texture
+  const bool texture_flag[] = {true, false, true,};
+  const auto srv_all = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+  const TestBarrier barriers[] = {
+    {0, 1, 0, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,},
+    {0, 1, 1, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,},
+    {1, 1, 2, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,},
+    {2, 0, 0, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, srv_all,},
+    {2, 0, 1, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, srv_all,},
+    {2, 0, 2, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,},
+    {2, 1, 0, srv_all, D3D12_RESOURCE_STATE_COPY_SOURCE,},
+    {2, 1, 1, srv_all, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY,},
+    {2, 1, 2, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,},
+    {3, 0, 2, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS,},
+    {4, 0, 1, srv_all, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY,},
+  };
+  const auto barrier_config_list = CreateTestBarrierConfigList(render_pass_num, countof(barriers), barriers);
+  const auto enhanced = ConvertToEnhancedBarriers(render_pass_num, barrier_config_list, render_pass_command_queue_index, command_queue_type, countof(texture_flag), texture_flag, MemoryType::kFrame);
+  SUBCASE("layout changes") {
+    REQUIRE_EQ(enhanced[0][1].size, 2);
+    const auto& texture = enhanced[0][1].array[0];
+    CHECK_EQ(texture.type, D3D12_BARRIER_TYPE_TEXTURE);
+    CHECK_EQ(texture.sync_before, D3D12_BARRIER_SYNC_RENDER_TARGET);
+    CHECK_EQ(texture.sync_after, D3D12_BARRIER_SYNC_NON_PIXEL_SHADING);
+    CHECK_EQ(texture.access_before, D3D12_BARRIER_ACCESS_RENDER_TARGET);
+    CHECK_EQ(texture.access_after, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+    CHECK_EQ(texture.layout_before, D3D12_BARRIER_LAYOUT_RENDER_TARGET);
+    CHECK_EQ(texture.layout_after, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+    // buffers have no layout.
+    const auto& buffer = enhanced[0][1].array[1];
+    CHECK_EQ(buffer.type, D3D12_BARRIER_TYPE_BUFFER);
+    CHECK_EQ(buffer.sync_before, D3D12_BARRIER_SYNC_ALL_SHADING);
+    CHECK_EQ(buffer.access_before, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+    CHECK_EQ(buffer.layout_before, D3D12_BARRIER_LAYOUT_UNDEFINED);
+    CHECK_EQ(buffer.layout_after, D3D12_BARRIER_LAYOUT_UNDEFINED);
+  }
+  SUBCASE("compute queue sync scopes") {
+    REQUIRE_EQ(enhanced[1][1].size, 1);
+    CHECK_EQ(enhanced[1][1].array[0].sync_before, D3D12_BARRIER_SYNC_COMPUTE_SHADING);
+    CHECK_EQ(enhanced[1][1].array[0].sync_after, D3D12_BARRIER_SYNC_COMPUTE_SHADING);
+  }
+  SUBCASE("read only transitions are removed") {
+    CHECK_EQ(enhanced[2][0].size, 0);
+    CHECK_EQ(enhanced[4][1].size, 0);
+    REQUIRE_EQ(enhanced[2][1].size, 2);
+    // removed transitions' reads are waited for.
+    const auto& texture = enhanced[2][1].array[0];
+    CHECK_EQ(texture.buffer_allocation_index, 0);
+    CHECK_EQ(texture.sync_before, D3D12_BARRIER_SYNC_PIXEL_SHADING | D3D12_BARRIER_SYNC_NON_PIXEL_SHADING);
+    CHECK_EQ(texture.sync_after, D3D12_BARRIER_SYNC_COPY);
+    CHECK_EQ(texture.layout_before, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+    CHECK_EQ(texture.layout_after, D3D12_BARRIER_LAYOUT_COPY_SOURCE);
+  }
+  SUBCASE("split barriers") {
+    const auto& begin = enhanced[2][1].array[1];
+    CHECK_EQ(begin.buffer_allocation_index, 1);
+    CHECK_EQ(begin.sync_before, D3D12_BARRIER_SYNC_PIXEL_SHADING | D3D12_BARRIER_SYNC_NON_PIXEL_SHADING);
+    CHECK_EQ(begin.sync_after, D3D12_BARRIER_SYNC_SPLIT);
+    REQUIRE_EQ(enhanced[4][0].size, 1);
+    const auto& end = enhanced[4][0].array[0];
+    CHECK_EQ(end.buffer_allocation_index, 1);
+    CHECK_EQ(end.sync_before, D3D12_BARRIER_SYNC_SPLIT);
+    CHECK_EQ(end.sync_after, D3D12_BARRIER_SYNC_ALL_SHADING);
+    CHECK_EQ(end.access_before, begin.access_before);
+    CHECK_EQ(end.access_after, begin.access_after);
+  }
+  SUBCASE("other queues' syncs are dropped") {
+    // shader reads on the direct queue (removed transition in pass 2) are ordered by a fence.
+    REQUIRE_EQ(enhanced[3][0].size, 1);
+    const auto& texture = enhanced[3][0].array[0];
+    CHECK_EQ(texture.sync_before, D3D12_BARRIER_SYNC_COMPUTE_SHADING);
+    CHECK_EQ(texture.access_before, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+    CHECK_EQ(texture.layout_before, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+    CHECK_EQ(texture.layout_after, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS);
+  }
+  SUBCASE("barrier groups") {
+    ID3D12Resource* resource[] = {nullptr, nullptr,};
+    D3D12_BUFFER_BARRIER buffer_barriers[2]{};
+    D3D12_TEXTURE_BARRIER texture_barriers[2]{};
+    D3D12_BARRIER_GROUP barrier_groups[2]{};
+    CHECK_EQ(FillEnhancedBarrierGroups(enhanced[0][1].size, enhanced[0][1].array, resource, buffer_barriers, texture_barriers, barrier_groups), 2);
+    CHECK_EQ(barrier_groups[0].Type, D3D12_BARRIER_TYPE_BUFFER);
+    CHECK_EQ(barrier_groups[0].NumBarriers, 1);
+    CHECK_EQ(barrier_groups[0].pBufferBarriers, buffer_barriers);
+    CHECK_EQ(buffer_barriers[0].Size, UINT64_MAX);
+    CHECK_EQ(barrier_groups[1].Type, D3D12_BARRIER_TYPE_TEXTURE);
+    CHECK_EQ(barrier_groups[1].NumBarriers, 1);
+    CHECK_EQ(texture_barriers[0].LayoutAfter, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE);
+    CHECK_EQ(texture_barriers[0].Subresources.IndexOrFirstMipLevel, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    CHECK_EQ(texture_barriers[0].Subresources.NumMipLevels, 0);
+    CHECK_EQ(FillEnhancedBarrierGroups(0, nullptr, resource, buffer_barriers, texture_barriers, barrier_groups), 0);
+  }
+  ClearAllAllocations();
+}
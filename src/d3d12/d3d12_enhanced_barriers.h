@@ -0,0 +1,48 @@
+#ifndef ILLUMINATE_D3D12_ENHANCED_BARRIERS_H
+#define ILLUMINATE_D3D12_ENHANCED_BARRIERS_H
+#include "d3d12_barriers.h"
+#include "d3d12_header_common.h"
+#include "illuminate/util/util_defines.h"
+namespace illuminate {
+enum class MemoryType : uint8_t;
+/**
+ * converts barrier plans made in the legacy resource state model to enhanced barriers (D3D12_BARRIER_SYNC/ACCESS/LAYOUT), no gpu object is touched.
+ * sync scopes follow the states and the queue a barrier is recorded on (e.g. srv and uav on compute queues sync compute shading only),
+ * buffers have no layout, textures get a layout per state (srv states share SHADER_RESOURCE).
+ * transitions between read only accesses in the same layout need no barrier and are removed,
+ * the next barrier of the buffer on the same queue then waits for their reads as well, reads on other queues are ordered by fences and dropped.
+ * split transitions become SYNC_SPLIT begin/end pairs.
+ **/
+struct EnhancedBarrierConfig {
+  uint32_t buffer_allocation_index{};
+  D3D12_BARRIER_TYPE type{}; // buffer or texture
+  D3D12_BARRIER_SYNC sync_before{};
+  D3D12_BARRIER_SYNC sync_after{};
+  D3D12_BARRIER_ACCESS access_before{};
+  D3D12_BARRIER_ACCESS access_after{};
+  D3D12_BARRIER_LAYOUT layout_before{D3D12_BARRIER_LAYOUT_UNDEFINED}; // UNDEFINED for buffers
+  D3D12_BARRIER_LAYOUT layout_after{D3D12_BARRIER_LAYOUT_UNDEFINED};
+  uint32_t subresource{D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES};
+};
+// retval: enhanced_barrier_config_list[pass_index][timing(0/1)], same as BarrierConfigList.
+using EnhancedBarrierConfigList = ArrayOf<EnhancedBarrierConfig>*;
+struct EnhancedBarrierScope {
+  D3D12_BARRIER_SYNC sync{};
+  D3D12_BARRIER_ACCESS access{};
+  D3D12_BARRIER_LAYOUT layout{};
+};
+// layouts depend on the state only so that layout_after of a barrier matches layout_before of the next one on any queue.
+EnhancedBarrierScope GetEnhancedBarrierScope(const D3D12_RESOURCE_STATES state, const D3D12_COMMAND_LIST_TYPE command_queue_type);
+// texture_flag is per buffer allocation, false for buffers.
+EnhancedBarrierConfigList* ConvertToEnhancedBarriers(const uint32_t render_pass_num, const BarrierConfigList* barrier_config_list,
+                                                     const uint32_t* render_pass_command_queue_index, const D3D12_COMMAND_LIST_TYPE* command_queue_type,
+                                                     const uint32_t buffer_allocation_num, const bool* texture_flag, const MemoryType& memory_type);
+/**
+ * fills barrier groups for ID3D12GraphicsCommandList7::Barrier() with buffer barriers first and texture barriers next.
+ * buffer_barriers and texture_barriers need barrier_num elements each, resource[i] belongs to barrier_config_list[i].
+ * returns the number of groups filled (0-2).
+ **/
+uint32_t FillEnhancedBarrierGroups(const uint32_t barrier_num, const EnhancedBarrierConfig* barrier_config_list, ID3D12Resource** resource,
+                                   D3D12_BUFFER_BARRIER* buffer_barriers, D3D12_TEXTURE_BARRIER* texture_barriers, D3D12_BARRIER_GROUP* barrier_groups);
+}
+#endif
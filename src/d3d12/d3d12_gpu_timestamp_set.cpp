@@ -6,7 +6,6 @@
 // https://github.com/microsoft/DirectX-Graphics-Samples/blob/master/Samples/UWP/D3D12xGPU/src/GPUTimer.cpp
 namespace illuminate {
 namespace {
-static const uint32_t kGpuTimestampQueryNumPerPass = 2;
 static const uint32_t kGpuTimestampDstResourceRingBufferNum = 5;
 auto CreateTimestampQueryHeaps(const uint32_t command_queue_num, const D3D12_COMMAND_LIST_TYPE* command_queue_type, const uint32_t* render_pass_num_per_queue, D3d12Device* device) {
   auto timestamp_query_heaps = AllocateArraySystem<ID3D12QueryHeap*>(command_queue_num);
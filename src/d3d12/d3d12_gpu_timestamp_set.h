@@ -17,6 +17,8 @@ void ReleaseGpuTimestampSet(const uint32_t command_queue_num, GpuTimestampSet* g
 void StartGpuTimestamp(const uint32_t * const render_pass_index_per_queue, const uint32_t* const render_pass_queue_index, const uint32_t render_pass_index, GpuTimestampSet* gpu_timestamp_set, D3d12CommandList* command_list);
 void EndGpuTimestamp(const uint32_t * const render_pass_index_per_queue, const uint32_t* const render_pass_queue_index, const uint32_t render_pass_index, GpuTimestampSet* gpu_timestamp_set, D3d12CommandList* command_list);
 void OutputGpuTimestampToCpuVisibleBuffer(const uint32_t * const render_pass_num_per_queue, const uint32_t* const render_pass_queue_index, const uint32_t render_pass_index, GpuTimestampSet* gpu_timestamp_set, D3d12CommandList* command_list);
+// duration_msec[queue][pass_index_in_queue * kGpuTimestampQueryNumPerPass] is the gap before the pass, the next one is the pass itself.
+static const uint32_t kGpuTimestampQueryNumPerPass = 2;
 struct GpuTimeDurations {
   uint32_t command_queue_num{};
   float total_time_msec{};
@@ -55,12 +55,35 @@ D3D12_RESOURCE_FLAGS GetD3d12ResourceFlags(const DescriptorTypeFlag descriptor_t
 }
 uint32_t GetDxgiFormatPerPixelSizeInBytes(const DXGI_FORMAT format) {
   switch (format) {
+    case DXGI_FORMAT_R32G32B32A32_FLOAT: return 16;
     case DXGI_FORMAT_R32G32B32_FLOAT: return 12;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R32G32_FLOAT: return 8;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_SNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_R32_TYPELESS:
+    case DXGI_FORMAT_D32_FLOAT:
+    case DXGI_FORMAT_R32_FLOAT:
+    case DXGI_FORMAT_R32_UINT:
+    case DXGI_FORMAT_D24_UNORM_S8_UINT:
+    case DXGI_FORMAT_R24_UNORM_X8_TYPELESS: return 4;
+    case DXGI_FORMAT_R16_UINT: return 2;
+    case DXGI_FORMAT_R8_UNORM: return 1;
   }
   logerror("GetDxgiFormatPerPixelSizeInBytes not implemented yet. {}", format);
   assert(false && "GetDxgiFormatPerPixelSizeInBytes");
   return 0;
 }
+uint32_t GetDxgiFormatPlaneNum(const DXGI_FORMAT format) {
+  switch (format) {
+    case DXGI_FORMAT_D24_UNORM_S8_UINT:
+    case DXGI_FORMAT_R24G8_TYPELESS:
+    case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+    case DXGI_FORMAT_R32G8X24_TYPELESS: return 2;
+  }
+  return 1;
+}
 uint32_t GetVertexBufferTypeNum(const uint32_t vertex_buffer_type_flags) {
   auto num = vertex_buffer_type_flags;
   uint32_t count = 0;
@@ -173,6 +173,39 @@ struct MainBufferFormat {
 uint32_t GetPhysicalWidth(const MainBufferSize& buffer_size, const BufferSizeRelativeness& relativeness, const float scale);
 uint32_t GetPhysicalHeight(const MainBufferSize& buffer_size, const BufferSizeRelativeness& relativeness, const float scale);
 uint32_t GetDxgiFormatPerPixelSizeInBytes(const DXGI_FORMAT);
+uint32_t GetDxgiFormatPlaneNum(const DXGI_FORMAT);
+// mip, array slice and plane ranges of a resource, *_num = 0 covers the rest of the resource.
+struct SubresourceRange {
+  uint16_t mip_slice{0};
+  uint16_t mip_num{0};
+  uint16_t array_slice{0};
+  uint16_t array_num{0};
+  uint8_t plane_slice{0};
+  uint8_t plane_num{0};
+};
+struct SubresourceLayout {
+  uint16_t mip_num{1};
+  uint16_t array_num{1};
+  uint8_t plane_num{1};
+};
+constexpr uint32_t GetSubresourceNum(const SubresourceLayout& layout) {
+  return static_cast<uint32_t>(layout.mip_num) * layout.array_num * layout.plane_num;
+}
+// same as D3D12CalcSubresource()
+constexpr uint32_t GetSubresourceIndex(const uint32_t mip, const uint32_t array, const uint32_t plane, const SubresourceLayout& layout) {
+  return mip + array * layout.mip_num + plane * layout.mip_num * layout.array_num;
+}
+// ranges reaching beyond the resource are invalid, *_num = 0 is always within range as long as the slice is.
+constexpr auto IsSubresourceRangeValid(const SubresourceRange& range, const SubresourceLayout& layout) {
+  return range.mip_slice < layout.mip_num && range.mip_slice + range.mip_num <= layout.mip_num
+      && range.array_slice < layout.array_num && range.array_slice + range.array_num <= layout.array_num
+      && range.plane_slice < layout.plane_num && range.plane_slice + range.plane_num <= layout.plane_num;
+}
+constexpr auto IsSubresourceRangeWhole(const SubresourceRange& range, const SubresourceLayout& layout) {
+  return range.mip_slice == 0 && (range.mip_num == 0 || range.mip_num >= layout.mip_num)
+      && range.array_slice == 0 && (range.array_num == 0 || range.array_num >= layout.array_num)
+      && range.plane_slice == 0 && (range.plane_num == 0 || range.plane_num >= layout.plane_num);
+}
 enum class PingPongBufferType : uint8_t { kMain = 0, kSub, };
 enum VertexBufferType : uint8_t {
   kVertexBufferTypePosition = 0,
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include "gfxminimath/gfxminimath.h"
 #include "imgui.h"
@@ -11,15 +13,19 @@
 #include "d3d12_dxgi_core.h"
 #include "d3d12_gpu_buffer_allocator.h"
 #include "d3d12_gpu_timestamp_set.h"
+#include "d3d12_render_graph_compiler.h"
+#include "d3d12_render_graph_hazards.h"
 #include "d3d12_render_graph_json_parser.h"
 #include "d3d12_resource_transfer.h"
 #include "d3d12_scene.h"
 #include "d3d12_shader_compiler.h"
 #include "d3d12_swapchain.h"
+#include "d3d12_test_util.h"
 #include "d3d12_texture_util.h"
 #include "d3d12_view_util.h"
 #include "d3d12_win32_window.h"
 #include "illuminate/math/math.h"
+#include "illuminate/util/string_table.h"
 #include "illuminate/util/util_functions.h"
 #include "render_pass/d3d12_render_pass_common.h"
 #include "render_pass/d3d12_render_pass_copy_resource.h"
@@ -38,12 +44,7 @@ static const uint32_t kInvalidIndex = ~0U;
 static const uint32_t kExtraDescriptorHandleNumCbvSrvUav = 1; // imgui font
 static const uint32_t kImguiGpuHandleIndex = 0;
 static const uint32_t kSceneGpuHandleIndex = 1;
-auto GetTestJson(const char* const filename) {
-  std::ifstream file(filename);
-  nlohmann::json json;
-  file >> json;
-  return json;
-}
+static const uint32_t kBarrierTransitionCacheEntryNum = 64;
 auto PrepareRenderPassFunctions(const uint32_t render_pass_num, const RenderPass* render_pass_list) {
   RenderPassFunctionList funcs{};
   funcs.init = AllocateArraySystem<RenderPassFuncInit>(render_pass_num);
@@ -99,6 +100,8 @@ auto GetIndexOffsetList(const RenderPass& render_pass) {
 }
 auto PrepareGpuHandlesViewList(D3d12Device* device, const uint32_t buffer_num, const ResourceStateType* resource_state_list, const uint32_t offset_num, const uint32_t* index_offset_list, const D3D12_CPU_DESCRIPTOR_HANDLE* cpu_handle_list, DescriptorGpu* const descriptor_gpu, const D3D12_CPU_DESCRIPTOR_HANDLE& texture_list_cpu_handle, const D3D12_GPU_DESCRIPTOR_HANDLE& texture_list_gpu_handle) {
   if (buffer_num == 0) { return (D3D12_GPU_DESCRIPTOR_HANDLE*)nullptr; }
+  auto gpu_handle_list = AllocateArrayFrame<D3D12_GPU_DESCRIPTOR_HANDLE>(offset_num);
+  FrameMemoryCheckpoint checkpoint;
   auto desc_num_list = AllocateAndFillArrayFrame(offset_num, 0U);
   auto copy_src_cpu_handles = AllocateArrayFrame<D3D12_CPU_DESCRIPTOR_HANDLE*>(offset_num);
   for (uint32_t i = 0; i < offset_num; i++) {
@@ -110,7 +113,6 @@ auto PrepareGpuHandlesViewList(D3d12Device* device, const uint32_t buffer_num, c
     copy_src_cpu_handles[offset_index][desc_num_list[offset_index]].ptr = cpu_handle_list[i].ptr;
     desc_num_list[offset_index]++;
   }
-  auto gpu_handle_list = AllocateArrayFrame<D3D12_GPU_DESCRIPTOR_HANDLE>(offset_num);
   for (uint32_t i = 0; i < offset_num; i++) {
     if (desc_num_list[i] == 0) { continue; }
     if (copy_src_cpu_handles[i][0].ptr == texture_list_cpu_handle.ptr) {
@@ -202,7 +204,7 @@ void ExecuteBarrier(D3d12CommandList* command_list, const uint32_t barrier_num,
     barrier.Flags = config.flag;
     switch (barrier.Type) {
       case D3D12_RESOURCE_BARRIER_TYPE_TRANSITION: {
-        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barrier.Transition.Subresource = config.subresource;
         barrier.Transition.pResource   = resource[i];
         barrier.Transition.StateBefore = config.state_before;
         barrier.Transition.StateAfter  = config.state_after;
@@ -554,6 +556,64 @@ auto UpdateBufferFinalState(const uint32_t render_pass_num, const BarrierConfigL
     }
   }
 }
+auto GetBufferSubresourceLayout(const BufferConfig& buffer_config) {
+  SubresourceLayout layout{};
+  if (buffer_config.descriptor_only || buffer_config.dimension == D3D12_RESOURCE_DIMENSION_BUFFER) { return layout; }
+  layout.mip_num = std::max<uint16_t>(buffer_config.miplevels, 1);
+  layout.array_num = (buffer_config.dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D) ? 1 : std::max<uint16_t>(buffer_config.depth_or_array_size, 1);
+  layout.plane_num = static_cast<uint8_t>(GetDxgiFormatPlaneNum(buffer_config.format));
+  return layout;
+}
+// returns nullptr when no pass binds a partial subresource range, i.e. when buffers can be tracked as a whole.
+auto GatherBufferSubresourceLayout(const RenderGraphConfig& render_graph, const BufferList& buffer_list, const MemoryType& memory_type) {
+  bool partial_range_found = false;
+  for (uint32_t i = 0; i < render_graph.render_pass_num && !partial_range_found; i++) {
+    const auto& render_pass = render_graph.render_pass_list[i];
+    for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+      if (IsSceneBuffer(render_pass.buffer_list[j].buffer_index)) { continue; }
+      if (!IsSubresourceRangeWhole(render_pass.buffer_list[j].subresource_range, GetBufferSubresourceLayout(render_graph.buffer_list[render_pass.buffer_list[j].buffer_index]))) {
+        partial_range_found = true;
+        break;
+      }
+    }
+  }
+  if (!partial_range_found) { return static_cast<SubresourceLayout*>(nullptr); }
+  auto subresource_layout = AllocateArray<SubresourceLayout>(memory_type, buffer_list.buffer_allocation_num);
+  for (uint32_t i = 0; i < buffer_list.buffer_allocation_num; i++) {
+    subresource_layout[i] = GetBufferSubresourceLayout(render_graph.buffer_list[buffer_list.buffer_config_index[i]]);
+  }
+  return subresource_layout;
+}
+auto ConfigureBarrierTransitionsPerFrame(const RenderGraphConfig& render_graph, const uint32_t buffer_allocation_num,
+                                         const uint32_t* const* render_pass_buffer_allocation_index_list, const ResourceStateType* const* render_pass_buffer_state_list,
+                                         const ResourceStateTypeFlags::FlagType* initial_state, const ResourceStateTypeFlags::FlagType* final_state,
+                                         const BarrierSplitCostModel* split_cost_model, const SubresourceLayout* buffer_subresource_layout) {
+  auto render_pass_buffer_num_list = GetRenderPassBufferNumList(render_graph.render_pass_num, render_graph.render_pass_list, MemoryType::kFrame);
+  BarrierSubresourceInfo subresource_info{buffer_subresource_layout, nullptr};
+  if (buffer_subresource_layout) {
+    auto render_pass_subresource_range_list = AllocateArrayFrame<const SubresourceRange*>(render_graph.render_pass_num);
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      auto range_list = AllocateArrayFrame<SubresourceRange>(render_graph.render_pass_list[i].buffer_num);
+      for (uint32_t j = 0; j < render_graph.render_pass_list[i].buffer_num; j++) {
+        range_list[j] = render_graph.render_pass_list[i].buffer_list[j].subresource_range;
+      }
+      render_pass_subresource_range_list[i] = range_list;
+    }
+    subresource_info.render_pass_subresource_range_list = render_pass_subresource_range_list;
+  }
+  auto render_pass_buffer_state_list_for_barrier = ConvertToResourceStateTypeFlags(render_graph.render_pass_num, render_pass_buffer_num_list, render_pass_buffer_state_list);
+  auto [render_pass_wait_pass_num, render_pass_signal_pass_index, render_pass_command_queue_index] = GatherRenderPassSyncInfoForBarriers(render_graph.render_pass_num, render_graph.render_pass_list);
+  return ConfigureBarrierTransitions(buffer_allocation_num, render_graph.render_pass_num,
+                                     render_pass_buffer_num_list, render_pass_buffer_allocation_index_list, render_pass_buffer_state_list_for_barrier,
+                                     render_pass_wait_pass_num, render_pass_signal_pass_index, render_pass_command_queue_index, render_graph.command_queue_type,
+                                     initial_state, final_state,
+                                     MemoryType::kFrame, split_cost_model, buffer_subresource_layout ? &subresource_info : nullptr);
+}
+auto GetBarrierAllocationVariant(const uint32_t frame_index, const bool debug_buffer_view_enabled, const int32_t debug_buffer_selected_index) {
+  // pingpong buffers bound to each pass follow render_pass_enable_flag, which the cache key contains already.
+  const uint64_t debug_buffer_view = debug_buffer_view_enabled ? static_cast<uint64_t>(debug_buffer_selected_index) + 1 : 0;
+  return (debug_buffer_view << 32) | frame_index;
+}
 auto GatherBufferInitialState(const uint32_t buffer_allocation_num, const BufferConfig* buffer_config_list, const BufferList& buffer_list) {
   auto buffer_initial_state = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(buffer_allocation_num);
   for (uint32_t i = 0; i < buffer_allocation_num; i++) {
@@ -614,11 +674,118 @@ auto CreateCBufferSrcData(const ArrayOf<CBuffer>& cbuffer_list, const uint32_t*
   }
   return cbuffer_src_data;
 }
+// allocation indices only, for testing barriers without a device.
+auto CreateBufferListWithoutResources(const RenderGraphConfig& render_graph) {
+  BufferList buffer_list{};
+  buffer_list.buffer_allocation_index = AllocateArraySystem<uint32_t*>(render_graph.buffer_num);
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    buffer_list.buffer_allocation_num += GetBufferAllocationNum(render_graph.buffer_list[i], render_graph.frame_buffer_num);
+  }
+  buffer_list.buffer_config_index = AllocateArraySystem<uint32_t>(buffer_list.buffer_allocation_num);
+  uint32_t buffer_allocation_index = 0;
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    const auto alloc_num = GetBufferAllocationNum(render_graph.buffer_list[i], render_graph.frame_buffer_num);
+    buffer_list.buffer_allocation_index[i] = AllocateArraySystem<uint32_t>(alloc_num);
+    for (uint32_t j = 0; j < alloc_num; j++) {
+      buffer_list.buffer_allocation_index[i][j] = buffer_allocation_index;
+      buffer_list.buffer_config_index[buffer_allocation_index] = i;
+      buffer_allocation_index++;
+    }
+  }
+  return buffer_list;
+}
+auto ParseDeferredRenderGraphForBarriers() {
+  RenderGraphConfig render_graph{};
+  LoadTestRenderGraph(LoadTestJson("deferred.json"), &render_graph);
+  return render_graph;
+}
+// runs the per-frame barrier setup of the integration test main loop without a device.
+// returns a hash of all barriers configured and the time spent on barrier configuration.
+auto RunBarrierSetupFrames(const RenderGraphConfig& render_graph, const BufferList& buffer_list, const uint32_t frame_num, bool* render_pass_enable_flag, const BarrierSplitCostModel* split_cost_model, BarrierTransitionCache* barrier_transition_cache) {
+  auto write_to_sub = AllocateArraySystem<bool*>(render_graph.buffer_num);
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    write_to_sub[i] = AllocateArraySystem<bool>(render_graph.render_pass_num);
+  }
+  auto prev_buffer_final_state = GatherBufferInitialState(buffer_list.buffer_allocation_num, render_graph.buffer_list, buffer_list);
+  const auto buffer_subresource_layout = GatherBufferSubresourceLayout(render_graph, buffer_list, MemoryType::kSystem);
+  auto prev_buffer_final_state_system = AllocateArraySystem<ResourceStateTypeFlags::FlagType>(buffer_list.buffer_allocation_num);
+  memcpy(prev_buffer_final_state_system, prev_buffer_final_state, sizeof(ResourceStateTypeFlags::FlagType) * buffer_list.buffer_allocation_num);
+  auto buffer_final_state = AllocateAndFillArraySystem(buffer_list.buffer_allocation_num, ResourceStateTypeFlags::kNone);
+  uint64_t barrier_hash = 0;
+  double barrier_microsec = 0.0;
+  for (uint32_t i = 0; i < frame_num; i++) {
+    ResetAllocation(MemoryType::kFrame);
+    const auto frame_index = i % render_graph.frame_buffer_num;
+    ConfigurePingPongBufferWriteToSubList(render_graph.render_pass_num, render_graph.render_pass_list, render_pass_enable_flag, render_graph.buffer_num, write_to_sub);
+    auto [render_pass_buffer_allocation_index_list, render_pass_buffer_state_list] = ConfigureRenderPassBufferAllocationIndex(render_graph.render_pass_num, render_graph.render_pass_list, buffer_list, write_to_sub, render_graph.buffer_list, frame_index);
+    const auto start = std::chrono::high_resolution_clock::now();
+    BarrierTransitionInfo barrier_transition{};
+    if (barrier_transition_cache == nullptr) {
+      barrier_transition = ConfigureBarrierTransitionsPerFrame(render_graph, buffer_list.buffer_allocation_num, render_pass_buffer_allocation_index_list, render_pass_buffer_state_list, prev_buffer_final_state_system, buffer_final_state, split_cost_model, buffer_subresource_layout);
+    } else {
+      const auto key = CalcBarrierTransitionCacheKey(render_graph.render_pass_num, render_pass_enable_flag, GetBarrierAllocationVariant(frame_index, false, 0), buffer_list.buffer_allocation_num, prev_buffer_final_state_system);
+      barrier_transition = barrier_transition_cache->Find(key);
+      if (barrier_transition.barrier_config_list == nullptr) {
+        barrier_transition = barrier_transition_cache->Register(key, ConfigureBarrierTransitionsPerFrame(render_graph, buffer_list.buffer_allocation_num, render_pass_buffer_allocation_index_list, render_pass_buffer_state_list, prev_buffer_final_state_system, buffer_final_state, split_cost_model, buffer_subresource_layout));
+      }
+    }
+    memcpy(prev_buffer_final_state_system, barrier_transition.state_at_frame_end, sizeof(ResourceStateTypeFlags::FlagType) * buffer_list.buffer_allocation_num);
+    barrier_microsec += std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+    for (uint32_t j = 0; j < render_graph.render_pass_num; j++) {
+      for (uint32_t k = 0; k < kBarrierExecutionTimingNum; k++) {
+        const auto& barriers = barrier_transition.barrier_config_list[j][k];
+        barrier_hash = CalcHash64(&barriers.size, sizeof(barriers.size), barrier_hash);
+        barrier_hash = CalcHash64(barriers.array, sizeof(barriers.array[0]) * barriers.size, barrier_hash);
+      }
+    }
+  }
+  return std::make_pair(barrier_hash, barrier_microsec);
+}
+auto GetFrameMemoryAllocationCount() {
+  uint64_t allocation_count = 0;
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  const auto call_site_list = GetMemoryAllocationCallSiteStatsList();
+  const auto call_site_num = GetMemoryAllocationCallSiteStatsNum();
+  for (uint32_t i = 0; i < call_site_num; i++) {
+    if (call_site_list[i].memory_type == MemoryType::kFrame) {
+      allocation_count += call_site_list[i].allocation_count;
+    }
+  }
+#endif
+  return allocation_count;
+}
+struct BarrierPlannerBenchmarkResult {
+  double nanosec_per_pass{0.0};
+  uint64_t frame_allocation_num_per_call{0}; // 0 without USE_MEMORY_ALLOCATION_TELEMETRY.
+  size_t frame_peak_bytes{0}; // frame arena high-water mark, frame memory is handed out to threads in chunks so small usages are rounded up.
+};
+// frame memory is reset before each call of f(), inputs of f() must not live in frame memory.
+template <typename F>
+auto MeasureBarrierPlannerFunction(const uint32_t render_pass_num, const uint32_t loop_num, F&& f) {
+  BarrierPlannerBenchmarkResult result{};
+  ResetAllocation(MemoryType::kFrame);
+  ResetMemoryUsagePeak(MemoryType::kFrame);
+  const auto allocation_count = GetFrameMemoryAllocationCount();
+  f();
+  result.frame_allocation_num_per_call = GetFrameMemoryAllocationCount() - allocation_count;
+  result.frame_peak_bytes = GetMemoryUsage(MemoryType::kFrame).peak_bytes;
+  const auto microsec = MeasureTimePerOp<std::micro>(loop_num, [&]() {
+    for (uint32_t i = 0; i < loop_num; i++) {
+      ResetAllocation(MemoryType::kFrame);
+      f();
+    }
+  });
+  result.nanosec_per_pass = microsec * 1000.0 / render_pass_num;
+  return result;
+}
 } // namespace anonymous
 } // namespace illuminate
 #include "doctest/doctest.h"
 TEST_CASE("d3d12 integration test") { // NOLINT
   using namespace illuminate; // NOLINT
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  ClearMemoryAllocationTelemetry();
+#endif
   DxgiCore dxgi_core;
   CHECK_UNARY(dxgi_core.Init()); // NOLINT
   Device device;
@@ -644,30 +811,36 @@ TEST_CASE("d3d12 integration test") { // NOLINT
   uint32_t render_pass_buffer_index_primary_input{};
   const char** render_pass_name{nullptr};
   auto frame_loop_num = kFrameLoopNum;
-  auto material_pack = BuildMaterialList(device.Get(), GetTestJson("material.json"));
+  auto material_pack = BuildMaterialList(device.Get(), LoadTestJson("material.json"));
   void*** cbv_ptr_list{nullptr}; // [buffer_config_index][frame_index]
   ResourceStateTypeFlags::FlagType* prev_buffer_final_state{nullptr};
+  SubresourceLayout* buffer_subresource_layout{nullptr};
   uint32_t* cbuffer_writable_size{nullptr};
   void** cbuffer_src_data{nullptr};
   const char* const * buffer_name_list{};
   {
     nlohmann::json json;
     SUBCASE("deferred.json") {
-      json = GetTestJson("deferred.json");
+      json = LoadTestJson("deferred.json");
       frame_loop_num = 10000;
     }
     SUBCASE("forward.json") {
-      json = GetTestJson("forward.json");
+      json = LoadTestJson("forward.json");
     }
     SUBCASE("config.json") {
-      json = GetTestJson("config.json");
+      json = LoadTestJson("config.json");
     }
+    CHECK_EQ(ValidateRenderGraphJson(json, material_pack.material_list.material_num, material_pack.config.material_hash_list, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size, 0);
     auto [buffer_name_list_tmp, buffer_name_hash_list] = ParseRenderGraphJson(json,
                                                                           material_pack.material_list.material_num,
                                                                           material_pack.config.material_hash_list,
                                                                           material_pack.config.rtv_format_list,
                                                                           material_pack.config.dsv_format,
                                                                           &render_graph);
+#ifndef NDEBUG
+    CHECK_EQ(DetectRenderGraphHazards(render_graph, MemoryType::kFrame).size, 0);
+#endif
+    CHECK_EQ(CompileRenderGraph(buffer_name_hash_list, MemoryType::kSystem, &render_graph).culled_pass_num, 0);
     render_pass_function_list = PrepareRenderPassFunctions(render_graph.render_pass_num, render_graph.render_pass_list);
     CHECK_UNARY(command_list_set.Init(device.Get(),
                                       render_graph.command_queue_num,
@@ -711,7 +884,12 @@ TEST_CASE("d3d12 integration test") { // NOLINT
       }
     }
 #endif
-    buffer_name_list = CopyStringList(MemoryType::kSystem, render_graph.buffer_num, buffer_name_list_tmp);
+    {
+      // names are interned by the parser, only the frame allocated list needs a copy.
+      auto buffer_name_list_system = AllocateArraySystem<const char*>(render_graph.buffer_num);
+      memcpy(buffer_name_list_system, buffer_name_list_tmp, sizeof(const char*) * render_graph.buffer_num);
+      buffer_name_list = buffer_name_list_system;
+    }
     PrintNames(render_graph.buffer_num, buffer_name_list);
     FillCBufferParamSizeInBytes(&render_graph.cbuffer_list);
     cbuffer_writable_size = GetCBufferSrcWritableSize(render_graph.cbuffer_list);
@@ -719,6 +897,7 @@ TEST_CASE("d3d12 integration test") { // NOLINT
     FillCbvBufferCreationSize(render_graph.cbuffer_list, cbuffer_writable_size, render_graph.buffer_list);
     buffer_list = CreateBuffers(render_graph.buffer_num, render_graph.buffer_list, main_buffer_size, render_graph.frame_buffer_num, buffer_allocator);
     prev_buffer_final_state = GatherBufferInitialState(buffer_list.buffer_allocation_num, render_graph.buffer_list, buffer_list);
+    buffer_subresource_layout = GatherBufferSubresourceLayout(render_graph, buffer_list, MemoryType::kScene);
     cbv_ptr_list = PrepareCbvPointers(render_graph.buffer_list, render_graph.cbuffer_list, cbuffer_writable_size, render_graph.frame_buffer_num, &buffer_list);
     CHECK_UNARY(descriptor_cpu.Init(device.Get(), buffer_list.buffer_allocation_num, render_graph.descriptor_handle_num_per_type));
     CHECK_UNARY(command_queue_signals.Init(device.Get(), render_graph.command_queue_num, command_list_set.GetCommandQueueList()));
@@ -767,8 +946,7 @@ TEST_CASE("d3d12 integration test") { // NOLINT
         .render_pass_list = render_graph.render_pass_list,
       };
       render_pass_vars[i] = RenderPassInit(&render_pass_function_list, &render_pass_func_args_init, i);
-      auto pass_name = GetStringView(render_pass_list_json[i], ("name"));
-      render_pass_name[i] = CreateString(pass_name, MemoryType::kSystem);
+      render_pass_name[i] = GetInternedString(render_graph.render_pass_list[i].name);
       if (render_graph.render_pass_list[i].name == SID("output to swapchain")) {
         render_pass_index_output_to_swapchain = i;
         for (uint32_t j = 0; j < render_graph.render_pass_list[i].buffer_num; j++) {
@@ -825,6 +1003,12 @@ TEST_CASE("d3d12 integration test") { // NOLINT
   auto gpu_time_durations_average = GetEmptyGpuTimeDurations(render_graph.command_queue_num, render_pass_num_per_queue, MemoryType::kSystem);
   bool debug_buffer_view_enabled = false;
   int32_t debug_buffer_selected_index = 0;
+  // buffer final states are fixed (all but the swapchain are left as is), so that barrier plans can be cached.
+  auto buffer_final_state = AllocateAndFillArraySystem(buffer_list.buffer_allocation_num, ResourceStateTypeFlags::kNone);
+  buffer_final_state[swapchain_buffer_allocation_index] = ResourceStateTypeFlags::kPresent;
+  // split barriers are not used on the gpu yet, begin/end pairs recorded in different command lists are untested.
+  BarrierTransitionCache barrier_transition_cache;
+  barrier_transition_cache.Init(buffer_list.buffer_allocation_num, render_graph.render_pass_num, kBarrierTransitionCacheEntryNum);
   for (uint32_t i = 0; i < frame_loop_num; i++) {
     if (!window.ProcessMessage()) { break; }
     ResetAllocation(MemoryType::kFrame);
@@ -864,17 +1048,14 @@ TEST_CASE("d3d12 integration test") { // NOLINT
       args_per_pass[j].gpu_handles_sampler = PrepareGpuHandlesSamplerList(device.Get(), render_pass, &descriptor_cpu, &descriptor_gpu, scene_gpu_handles_sampler);
     }
     // setup barriers
-    auto render_pass_buffer_num_list = GetRenderPassBufferNumList(render_graph.render_pass_num, render_graph.render_pass_list, MemoryType::kFrame);
-    auto render_pass_buffer_state_list_for_barrier = ConvertToResourceStateTypeFlags(render_graph.render_pass_num, render_pass_buffer_num_list, render_pass_buffer_state_list);
-    auto buffer_final_state = AllocateAndFillArrayFrame(buffer_list.buffer_allocation_num, ResourceStateTypeFlags::kNone);
     prev_buffer_final_state[swapchain_buffer_allocation_index] = ResourceStateTypeFlags::kPresent;
-    buffer_final_state[swapchain_buffer_allocation_index]      = ResourceStateTypeFlags::kPresent;
-    auto [render_pass_wait_pass_num, render_pass_signal_pass_index, render_pass_command_queue_index] = GatherRenderPassSyncInfoForBarriers(render_graph.render_pass_num, render_graph.render_pass_list);
-    const auto [barrier_config_list, state_at_frame_end] = ConfigureBarrierTransitions(buffer_list.buffer_allocation_num, render_graph.render_pass_num,
-                                                                                       render_pass_buffer_num_list, render_pass_buffer_allocation_index_list, render_pass_buffer_state_list_for_barrier,
-                                                                                       render_pass_wait_pass_num, render_pass_signal_pass_index, render_pass_command_queue_index, render_graph.command_queue_type,
-                                                                                       prev_buffer_final_state, buffer_final_state,
-                                                                                       MemoryType::kFrame);
+    const auto barrier_transition_key = CalcBarrierTransitionCacheKey(render_graph.render_pass_num, render_pass_enable_flag, GetBarrierAllocationVariant(frame_index, debug_buffer_view_enabled, debug_buffer_selected_index),
+                                                                      buffer_list.buffer_allocation_num, prev_buffer_final_state);
+    auto barrier_transition = barrier_transition_cache.Find(barrier_transition_key);
+    if (barrier_transition.barrier_config_list == nullptr) {
+      barrier_transition = barrier_transition_cache.Register(barrier_transition_key, ConfigureBarrierTransitionsPerFrame(render_graph, buffer_list.buffer_allocation_num, render_pass_buffer_allocation_index_list, render_pass_buffer_state_list, prev_buffer_final_state, buffer_final_state, nullptr, buffer_subresource_layout));
+    }
+    const auto& [barrier_config_list, state_at_frame_end] = barrier_transition;
     memcpy(prev_buffer_final_state, state_at_frame_end, sizeof(ResourceStateTypeFlags::FlagType) * buffer_list.buffer_allocation_num);
     auto barrier_resource_list = PrepareBarrierResourceList(render_graph.render_pass_num, barrier_config_list, buffer_list, MemoryType::kFrame);
     {
@@ -884,7 +1065,7 @@ TEST_CASE("d3d12 integration test") { // NOLINT
       ImGui::NewFrame();
       UpdateCameraFromUserInput(main_buffer_size.swapchain, dynamic_data.camera_pos, dynamic_data.camera_focus, prev_mouse_pos);
     }
-    auto serialized_render_pass_index = GetAllQueueSeirializedRenderPassIndexInQueueArrayForm(render_graph.command_queue_num, render_pass_num_per_queue, render_graph.render_pass_num, render_pass_command_queue_index);
+    auto serialized_render_pass_index = GetAllQueueSeirializedRenderPassIndexInQueueArrayForm(render_graph.command_queue_num, render_pass_num_per_queue, render_graph.render_pass_num, render_pass_queue_index);
     auto current_frame_cbv_ptr_list = AllocateArrayFrame<void*>(render_graph.cbuffer_list.size);
     for (uint32_t k = 0; k < render_graph.cbuffer_list.size; k++) {
       const auto cbuffer_index = render_graph.cbuffer_list.array[k].buffer_index;
@@ -914,7 +1095,7 @@ TEST_CASE("d3d12 integration test") { // NOLINT
       for (uint32_t l = 0; l < render_pass.wait_pass_num; l++) {
         CHECK_UNARY(command_queue_signals.RegisterWaitOnCommandQueue(render_pass.signal_queue_index[l], render_pass_queue_index[k], render_pass_signal[render_pass.signal_pass_index[l]]));
       }
-      if (barrier_config_list[0][k].size == 0 && barrier_config_list[1][k].size == 0 && !IsRenderPassRenderNeeded(&render_pass_function_list, &args_common, &args_per_pass[k])) { continue; }
+      if (barrier_config_list[k][0].size == 0 && barrier_config_list[k][1].size == 0 && !IsRenderPassRenderNeeded(&render_pass_function_list, &args_common, &args_per_pass[k])) { continue; }
       auto command_list = prev_command_list[render_pass_queue_index[k]];
       if (command_list == nullptr) {
         command_list = command_list_set.GetCommandList(device.Get(), render_pass_queue_index[k]); // TODO decide command list reuse policy for multi-thread
@@ -955,6 +1136,7 @@ TEST_CASE("d3d12 integration test") { // NOLINT
     swapchain.Present();
   }
   command_queue_signals.WaitAll(device.Get());
+  barrier_transition_cache.Term();
   TermImgui();
   ClearResourceTransfer(render_graph.frame_buffer_num, &resource_transfer);
   ReleaseSceneData(&scene_data);
@@ -975,5 +1157,181 @@ TEST_CASE("d3d12 integration test") { // NOLINT
   extra_descriptor_heap_cbv_srv_uav->Release();
   device.Term();
   dxgi_core.Term();
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  LogMemoryAllocationTelemetry(16);
+  const auto telemetry_dir = std::filesystem::temp_directory_path();
+  WriteMemoryAllocationTelemetryCsv((telemetry_dir / "memory_allocation_telemetry_frames.csv").string().c_str(), (telemetry_dir / "memory_allocation_telemetry_call_sites.csv").string().c_str());
+  WriteMemoryAllocationTelemetryJson((telemetry_dir / "memory_allocation_telemetry.json").string().c_str());
+#endif
   ClearAllAllocations();
 }
+TEST_CASE("cached barrier transitions match per-frame configuration") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const BarrierSplitCostModel barrier_split_cost_model{};
+  RenderGraphConfig render_graph{};
+  SUBCASE("deferred.json") {
+    render_graph = ParseDeferredRenderGraphForBarriers();
+  }
+  SUBCASE("random") {
+    render_graph = CreateRandomRenderGraph(64, 24, 12, 12, 1);
+  }
+  const auto buffer_list = CreateBufferListWithoutResources(render_graph);
+  auto render_pass_enable_flag = AllocateArraySystem<bool>(render_graph.render_pass_num);
+  const uint32_t frame_num = 8;
+  uint64_t barrier_hash[2][2]{}; // [cache used][enable flag toggled]
+  for (uint32_t i = 0; i < 2; i++) {
+    BarrierTransitionCache barrier_transition_cache;
+    barrier_transition_cache.Init(buffer_list.buffer_allocation_num, render_graph.render_pass_num, 16);
+    for (uint32_t j = 0; j < 2; j++) {
+      for (uint32_t k = 0; k < render_graph.render_pass_num; k++) {
+        render_pass_enable_flag[k] = render_graph.render_pass_list[k].enabled;
+      }
+      if (j == 1) {
+        // flips pingpong buffers bound to the passes that follow.
+        for (uint32_t k = 0; k < render_graph.render_pass_num; k++) {
+          if (render_graph.render_pass_list[k].flip_pingpong_num > 0) {
+            render_pass_enable_flag[k] = !render_pass_enable_flag[k];
+            break;
+          }
+        }
+      }
+      barrier_hash[i][j] = RunBarrierSetupFrames(render_graph, buffer_list, frame_num, render_pass_enable_flag, &barrier_split_cost_model, i == 0 ? nullptr : &barrier_transition_cache).first;
+    }
+    if (i == 1) {
+      // frame start states settle after the first frame of each frame buffer index.
+      CHECK_GE(barrier_transition_cache.GetEntryNum(), render_graph.frame_buffer_num);
+      CHECK_LE(barrier_transition_cache.GetEntryNum(), render_graph.frame_buffer_num * 4);
+    }
+    barrier_transition_cache.Term();
+  }
+  CHECK_EQ(barrier_hash[1][0], barrier_hash[0][0]);
+  CHECK_EQ(barrier_hash[1][1], barrier_hash[0][1]);
+  ClearAllAllocations();
+}
+TEST_CASE("barrier transition cache benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const BarrierSplitCostModel barrier_split_cost_model{};
+  const uint32_t frame_num = 1000;
+  spdlog::info("barrier setup per frame (us)");
+  for (uint32_t i = 0; i < 2; i++) {
+    const auto render_graph = (i == 0) ? ParseDeferredRenderGraphForBarriers() : CreateRandomRenderGraph(500, 250, 12, 12, 1);
+    const auto buffer_list = CreateBufferListWithoutResources(render_graph);
+    auto render_pass_enable_flag = AllocateArraySystem<bool>(render_graph.render_pass_num);
+    for (uint32_t j = 0; j < render_graph.render_pass_num; j++) {
+      render_pass_enable_flag[j] = render_graph.render_pass_list[j].enabled;
+    }
+    std::pair<uint64_t, double> result[2]{};
+    const auto uncached = MeasureTimePerOp<std::micro>(frame_num, [&]() { result[0] = RunBarrierSetupFrames(render_graph, buffer_list, frame_num, render_pass_enable_flag, &barrier_split_cost_model, nullptr); });
+    BarrierTransitionCache barrier_transition_cache;
+    barrier_transition_cache.Init(buffer_list.buffer_allocation_num, render_graph.render_pass_num, 16);
+    const auto cached = MeasureTimePerOp<std::micro>(frame_num, [&]() { result[1] = RunBarrierSetupFrames(render_graph, buffer_list, frame_num, render_pass_enable_flag, &barrier_split_cost_model, &barrier_transition_cache); });
+    spdlog::info("  {:<13} passes:{:>3} frame uncached:{:.2f} cached:{:.2f} barriers uncached:{:.2f} cached:{:.2f} cached plans:{}", i == 0 ? "deferred.json" : "random", render_graph.render_pass_num,
+                 uncached, cached, result[0].second / frame_num, result[1].second / frame_num, barrier_transition_cache.GetEntryNum());
+    CHECK_EQ(result[1].first, result[0].first);
+    barrier_transition_cache.Term();
+    ClearAllAllocations();
+  }
+}
+TEST_CASE("random render graph for barriers") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const BarrierSplitCostModel barrier_split_cost_model{};
+  const uint32_t seed = 12345;
+  uint64_t barrier_hash[2]{};
+  for (uint32_t i = 0; i < 2; i++) {
+    const auto render_graph = CreateRandomRenderGraph(200, 64, 25, 25, seed);
+    CHECK_EQ(DetectRenderGraphHazards(render_graph, MemoryType::kFrame).size, 0);
+    const auto buffer_list = CreateBufferListWithoutResources(render_graph);
+    auto render_pass_enable_flag = AllocateAndFillArraySystem(render_graph.render_pass_num, true);
+    barrier_hash[i] = RunBarrierSetupFrames(render_graph, buffer_list, 4, render_pass_enable_flag, &barrier_split_cost_model, nullptr).first;
+  }
+  CHECK_EQ(barrier_hash[1], barrier_hash[0]);
+  ClearAllAllocations();
+}
+// run with --no-skip -tc="barrier planner scaling benchmark", results are written to barrier_planner_benchmark.json in the temp directory as well.
+TEST_CASE("barrier planner scaling benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const BarrierSplitCostModel barrier_split_cost_model{};
+  const uint32_t render_pass_num_list[]{10, 100, 1000, 5000,};
+  const uint32_t buffer_mix_list[][2]{{0, 0}, {25, 0}, {0, 25}, {25, 25},}; // {pingpong %, frame buffered %}
+  const uint32_t seed = 1;
+  const char* const function_name_list[]{"ConfigurePingPongBufferWriteToSubList", "ConfigureRenderPassBufferAllocationIndex", "ConfigureBarrierTransitions",};
+  nlohmann::json json;
+  json["seed"] = seed;
+  json["command_queue_num"] = 3;
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  ClearMemoryAllocationTelemetry();
+#endif
+  spdlog::info("barrier planner ns/pass allocations/call frame peak bytes");
+  for (const auto render_pass_num : render_pass_num_list) {
+    for (const auto& buffer_mix : buffer_mix_list) {
+      const auto buffer_num = std::max(8U, render_pass_num / 2);
+      const auto render_graph = CreateRandomRenderGraph(render_pass_num, buffer_num, buffer_mix[0], buffer_mix[1], seed);
+      const auto buffer_list = CreateBufferListWithoutResources(render_graph);
+      auto render_pass_enable_flag = AllocateAndFillArraySystem(render_graph.render_pass_num, true);
+      auto write_to_sub = AllocateArraySystem<bool*>(render_graph.buffer_num);
+      for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+        write_to_sub[i] = AllocateArraySystem<bool>(render_graph.render_pass_num);
+      }
+      auto initial_state = AllocateArraySystem<ResourceStateTypeFlags::FlagType>(buffer_list.buffer_allocation_num);
+      for (uint32_t i = 0; i < buffer_list.buffer_allocation_num; i++) {
+        initial_state[i] = ResourceStateTypeFlags::GetResourceStateTypeFlag(render_graph.buffer_list[buffer_list.buffer_config_index[i]].initial_state);
+      }
+      auto final_state = AllocateAndFillArraySystem(buffer_list.buffer_allocation_num, ResourceStateTypeFlags::kNone);
+      const auto loop_num = std::max(1U, 20000 / render_pass_num);
+      BarrierPlannerBenchmarkResult result[3]{};
+      result[0] = MeasureBarrierPlannerFunction(render_pass_num, loop_num, [&]() {
+        ConfigurePingPongBufferWriteToSubList(render_graph.render_pass_num, render_graph.render_pass_list, render_pass_enable_flag, render_graph.buffer_num, write_to_sub);
+      });
+      result[1] = MeasureBarrierPlannerFunction(render_pass_num, loop_num, [&]() {
+        ConfigureRenderPassBufferAllocationIndex(render_graph.render_pass_num, render_graph.render_pass_list, buffer_list, write_to_sub, render_graph.buffer_list, 0);
+      });
+      auto render_pass_buffer_allocation_index_list = AllocateArraySystem<uint32_t*>(render_pass_num);
+      auto render_pass_buffer_state_list = AllocateArraySystem<ResourceStateType*>(render_pass_num);
+      {
+        const auto [allocation_index_list, state_list] = ConfigureRenderPassBufferAllocationIndex(render_graph.render_pass_num, render_graph.render_pass_list, buffer_list, write_to_sub, render_graph.buffer_list, 0);
+        for (uint32_t i = 0; i < render_pass_num; i++) {
+          const auto buffer_num_in_pass = render_graph.render_pass_list[i].buffer_num;
+          render_pass_buffer_allocation_index_list[i] = AllocateArraySystem<uint32_t>(buffer_num_in_pass);
+          render_pass_buffer_state_list[i] = AllocateArraySystem<ResourceStateType>(buffer_num_in_pass);
+          memcpy(render_pass_buffer_allocation_index_list[i], allocation_index_list[i], sizeof(uint32_t) * buffer_num_in_pass);
+          memcpy(render_pass_buffer_state_list[i], state_list[i], sizeof(ResourceStateType) * buffer_num_in_pass);
+        }
+      }
+      uint32_t barrier_num = 0;
+      result[2] = MeasureBarrierPlannerFunction(render_pass_num, loop_num, [&]() {
+        const auto barrier_transition = ConfigureBarrierTransitionsPerFrame(render_graph, buffer_list.buffer_allocation_num, render_pass_buffer_allocation_index_list, render_pass_buffer_state_list, initial_state, final_state, &barrier_split_cost_model, nullptr);
+        barrier_num = 0;
+        for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+          for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+            barrier_num += barrier_transition.barrier_config_list[i][j].size;
+          }
+        }
+      });
+      nlohmann::json json_result;
+      json_result["render_pass_num"] = render_pass_num;
+      json_result["buffer_num"] = buffer_num;
+      json_result["buffer_allocation_num"] = buffer_list.buffer_allocation_num;
+      json_result["pingpong_percent"] = buffer_mix[0];
+      json_result["frame_buffered_percent"] = buffer_mix[1];
+      json_result["loop_num"] = loop_num;
+      json_result["barrier_num"] = barrier_num;
+      for (uint32_t i = 0; i < 3; i++) {
+        auto& json_function = json_result["functions"][function_name_list[i]];
+        json_function["ns_per_pass"] = result[i].nanosec_per_pass;
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+        json_function["allocations_per_call"] = result[i].frame_allocation_num_per_call;
+#else
+        json_function["allocations_per_call"] = nullptr;
+#endif
+        json_function["frame_peak_bytes"] = result[i].frame_peak_bytes;
+        spdlog::info("  passes:{:>4} pingpong:{:>2}% frame buffered:{:>2}% {:<40} {:>10.1f} {:>6} {:>10}", render_pass_num, buffer_mix[0], buffer_mix[1], function_name_list[i],
+                     result[i].nanosec_per_pass, result[i].frame_allocation_num_per_call, result[i].frame_peak_bytes);
+      }
+      json["results"].push_back(json_result);
+      ClearAllAllocations();
+    }
+  }
+  std::ofstream file(std::filesystem::temp_directory_path() / "barrier_planner_benchmark.json");
+  CHECK_UNARY(file);
+  file << json.dump(2);
+}
@@ -1,4 +1,6 @@
 #include "d3d12_json_parser.h"
+#include <fstream>
+#include "illuminate/util/perfect_hash.h"
 namespace illuminate {
 uint32_t FindIndex(const nlohmann::json& j, const char* const name, const uint32_t num, StrHash* list) {
   if (!j.contains(name)) {
@@ -21,43 +23,27 @@ uint32_t FindIndex(const nlohmann::json& j, const char* const entity_name, const
   assert(false&& "FindIndex not found (2)");
   return ~0U;
 }
+constexpr auto kDxgiFormatTable = CreatePerfectHashTable<DXGI_FORMAT>({
+    {"UNKNOWN", DXGI_FORMAT_UNKNOWN},
+    {"R16G16B16A16_FLOAT", DXGI_FORMAT_R16G16B16A16_FLOAT},
+    {"B8G8R8A8_UNORM", DXGI_FORMAT_B8G8R8A8_UNORM},
+    {"R8G8B8A8_UNORM", DXGI_FORMAT_R8G8B8A8_UNORM},
+    {"R8G8B8A8_SNORM", DXGI_FORMAT_R8G8B8A8_SNORM},
+    {"D24_UNORM_S8_UINT", DXGI_FORMAT_D24_UNORM_S8_UINT},
+    {"R32G32B32_FLOAT", DXGI_FORMAT_R32G32B32_FLOAT},
+    {"R32G32_FLOAT", DXGI_FORMAT_R32G32_FLOAT},
+    {"R32G32B32A32_FLOAT", DXGI_FORMAT_R32G32B32A32_FLOAT},
+    {"R32_UINT", DXGI_FORMAT_R32_UINT},
+    {"R32_FLOAT", DXGI_FORMAT_R32_FLOAT},
+    {"R8_UNORM", DXGI_FORMAT_R8_UNORM},
+  });
+bool IsDxgiFormatName(const std::string_view& str) {
+  return kDxgiFormatTable.Contains(str);
+}
 DXGI_FORMAT GetDxgiFormat(const nlohmann::json& j) {
   auto format_str = GetStringView(j);
-  if (format_str.compare("UNKNOWN") == 0) {
-    return DXGI_FORMAT_UNKNOWN;
-  }
-  if (format_str.compare("R16G16B16A16_FLOAT") == 0) {
-    return DXGI_FORMAT_R16G16B16A16_FLOAT;
-  }
-  if (format_str.compare("B8G8R8A8_UNORM") == 0) {
-    return DXGI_FORMAT_B8G8R8A8_UNORM;
-  }
-  if (format_str.compare("R8G8B8A8_UNORM") == 0) {
-    return DXGI_FORMAT_R8G8B8A8_UNORM;
-  }
-  if (format_str.compare("R8G8B8A8_SNORM") == 0) {
-    return DXGI_FORMAT_R8G8B8A8_SNORM;
-  }
-  if (format_str.compare("D24_UNORM_S8_UINT") == 0) {
-    return DXGI_FORMAT_D24_UNORM_S8_UINT;
-  }
-  if (format_str.compare("R32G32B32_FLOAT") == 0) {
-    return DXGI_FORMAT_R32G32B32_FLOAT;
-  }
-  if (format_str.compare("R32G32_FLOAT") == 0) {
-    return DXGI_FORMAT_R32G32_FLOAT;
-  }
-  if (format_str.compare("R32G32B32A32_FLOAT") == 0) {
-    return DXGI_FORMAT_R32G32B32A32_FLOAT;
-  }
-  if (format_str.compare("R32_UINT") == 0) {
-    return DXGI_FORMAT_R32_UINT;
-  }
-  if (format_str.compare("R32_FLOAT") == 0) {
-    return DXGI_FORMAT_R32_FLOAT;
-  }
-  if (format_str.compare("R8_UNORM") == 0) {
-    return DXGI_FORMAT_R8_UNORM;
+  if (auto format = kDxgiFormatTable.Find(format_str); format != nullptr) {
+    return *format;
   }
   logerror("invalid format specified. {}", format_str.data());
   assert(false && "invalid format specified");
@@ -70,43 +56,31 @@ DXGI_FORMAT GetDxgiFormat(const nlohmann::json& j, const char* const entity_name
   }
   return GetDxgiFormat(j.at(entity_name));
 }
+constexpr auto kResourceStateTypeTable = CreatePerfectHashTable<ResourceStateType>({
+    {"cbv", ResourceStateType::kCbv},
+    {"srv_ps", ResourceStateType::kSrvPs},
+    {"srv_non_ps", ResourceStateType::kSrvNonPs},
+    {"uav", ResourceStateType::kUav},
+    {"rtv", ResourceStateType::kRtv},
+    {"dsv_write", ResourceStateType::kDsvWrite},
+    {"dsv_read", ResourceStateType::kDsvRead},
+    {"copy_source", ResourceStateType::kCopySrc},
+    {"copy_dest", ResourceStateType::kCopyDst},
+    {"common", ResourceStateType::kCommon},
+    {"present", ResourceStateType::kPresent},
+    {"generic_read", ResourceStateType::kGenericRead},
+  });
+bool IsResourceStateTypeName(const std::string_view& str) {
+  return kResourceStateTypeTable.Contains(str);
+}
+const char* GetResourceStateTypeName(const ResourceStateType state) {
+  const auto name = kResourceStateTypeTable.FindKey(state);
+  return name != nullptr ? name->data() : "unknown";
+}
 ResourceStateType GetResourceStateType(const nlohmann::json& j) {
   auto str = GetStringView(j);
-  if (str.compare("cbv") == 0) {
-    return ResourceStateType::kCbv;
-  }
-  if (str.compare("srv_ps") == 0) {
-    return ResourceStateType::kSrvPs;
-  }
-  if (str.compare("srv_non_ps") == 0) {
-    return ResourceStateType::kSrvNonPs;
-  }
-  if (str.compare("uav") == 0) {
-    return ResourceStateType::kUav;
-  }
-  if (str.compare("rtv") == 0) {
-    return ResourceStateType::kRtv;
-  }
-  if (str.compare("dsv_write") == 0) {
-    return ResourceStateType::kDsvWrite;
-  }
-  if (str.compare("dsv_read") == 0) {
-    return ResourceStateType::kDsvRead;
-  }
-  if (str.compare("copy_source") == 0) {
-    return ResourceStateType::kCopySrc;
-  }
-  if (str.compare("copy_dest") == 0) {
-    return ResourceStateType::kCopyDst;
-  }
-  if (str.compare("common") == 0) {
-    return ResourceStateType::kCommon;
-  }
-  if (str.compare("present") == 0) {
-    return ResourceStateType::kPresent;
-  }
-  if (str.compare("generic_read") == 0) {
-    return ResourceStateType::kGenericRead;
+  if (auto type = kResourceStateTypeTable.Find(str); type != nullptr) {
+    return *type;
   }
   logerror("invalid ResourceStateType {}", str);
   assert(false && "invalid ResourceStateType");
@@ -118,24 +92,20 @@ ResourceStateType GetResourceStateType(const nlohmann::json& j, const char* cons
   }
   return GetResourceStateType(j.at(name));
 }
+constexpr auto kDescriptorTypeTable = CreatePerfectHashTable<DescriptorType>({
+    {"cbv", DescriptorType::kCbv},
+    {"srv", DescriptorType::kSrv},
+    {"uav", DescriptorType::kUav},
+    {"sampler", DescriptorType::kSampler},
+    {"rtv", DescriptorType::kRtv},
+    {"dsv", DescriptorType::kDsv},
+  });
+bool IsDescriptorTypeName(const std::string_view& str) {
+  return kDescriptorTypeTable.Contains(str);
+}
 DescriptorType GetDescriptorType(const std::string_view& str) {
-  if (str.compare("cbv") == 0) {
-    return DescriptorType::kCbv;
-  }
-  if (str.compare("srv") == 0) {
-    return DescriptorType::kSrv;
-  }
-  if (str.compare("uav") == 0) {
-    return DescriptorType::kUav;
-  }
-  if (str.compare("sampler") == 0) {
-    return DescriptorType::kSampler;
-  }
-  if (str.compare("rtv") == 0) {
-    return DescriptorType::kRtv;
-  }
-  if (str.compare("dsv") == 0) {
-    return DescriptorType::kDsv;
+  if (auto type = kDescriptorTypeTable.Find(str); type != nullptr) {
+    return *type;
   }
   logerror("invalid DescriptorType {}", str);
   assert(false && "invalid DescriptorType");
@@ -160,4 +130,17 @@ uint32_t CreateJsonStrHashList(const nlohmann::json& json, const char* const nam
 const char* CreateString(const nlohmann::json& json, const MemoryType memory_type) {
   return CreateString(GetStringView(json).data(), memory_type);
 }
+bool LoadJsonFile(const char* const path, nlohmann::json* json) {
+  std::ifstream file(path);
+  if (!file) {
+    logerror("failed to open {}", path);
+    return false;
+  }
+  *json = nlohmann::json::parse(file, nullptr, false);
+  if (json->is_discarded()) {
+    logerror("failed to parse {}", path);
+    return false;
+  }
+  return true;
+}
 }
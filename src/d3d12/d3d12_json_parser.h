@@ -12,11 +12,11 @@ inline auto GetStringView(const nlohmann::json& j, const char* const name) {
   return j.at(name).get<std::string_view>();
 }
 inline auto CalcEntityStrHash(const nlohmann::json& j) {
-  return CalcStrHash(GetStringView(j).data());
+  return CalcStrHash(GetStringView(j));
 }
 inline auto CalcEntityStrHash(const nlohmann::json& j, const char* const name) {
   if (!j.contains(name)) { return StrHash{}; }
-  return CalcStrHash(GetStringView(j, name).data());
+  return CalcStrHash(GetStringView(j, name));
 }
 inline auto GetNum(const nlohmann::json& j, const char* const name, const uint32_t default_val) {
   return j.contains(name) ? j.at(name).get<uint32_t>() : default_val;
@@ -36,11 +36,19 @@ uint32_t FindIndex(const nlohmann::json& j, const char* const entity_name, const
 D3D12_RESOURCE_STATES GetD3d12ResourceState(const nlohmann::json& j, const char* const entity_name);
 DXGI_FORMAT GetDxgiFormat(const nlohmann::json& j, const char* const entity_name);
 DXGI_FORMAT GetDxgiFormat(const nlohmann::json& j);
+// Is*Name() check names without logging or asserting, for validation.
+bool IsDxgiFormatName(const std::string_view& str);
+bool IsResourceStateTypeName(const std::string_view& str);
+bool IsDescriptorTypeName(const std::string_view& str);
 ResourceStateType GetResourceStateType(const nlohmann::json& j);
 ResourceStateType GetResourceStateType(const nlohmann::json& j, const char* const name, const ResourceStateType default_val);
+// the name json files use for the state.
+const char* GetResourceStateTypeName(const ResourceStateType state);
 DescriptorType GetDescriptorType(const nlohmann::json& j);
 DescriptorType GetDescriptorType(const nlohmann::json& j, const char* const name);
 uint32_t CreateJsonStrHashList(const nlohmann::json& json, const char* const name, StrHash** hash_list_ptr, const MemoryType memory_type);
 const char* CreateString(const nlohmann::json& json, const MemoryType memory_type);
+// returns false with an error log if the file cannot be opened or parsed.
+bool LoadJsonFile(const char* const path, nlohmann::json* json);
 }
 #endif
@@ -1,14 +1,240 @@
 #include "d3d12_memory_allocators.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include "d3d12_src_common.h"
+#include "illuminate/memory/tlsf_allocator.h"
+#include "illuminate/memory/virtual_memory.h"
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+#include <fstream>
+#include <vector>
+#include "illuminate/util/hash_map.h"
+#endif
 namespace illuminate {
 namespace {
-static const uint32_t system_memory_buffer_size_in_bytes = 32 * 1024 * 1024;
-static std::byte system_memory_buffer[system_memory_buffer_size_in_bytes];
-static const uint32_t scene_frame_buffer_size_in_bytes = 32 * 1024 * 1024;
-static std::byte scene_frame_memory_buffer[scene_frame_buffer_size_in_bytes];
-static LinearAllocator system_memory_allocator(system_memory_buffer, system_memory_buffer_size_in_bytes);
-static DoubleEndedLinearAllocator scene_frame_memory_allocator(scene_frame_memory_buffer, scene_frame_buffer_size_in_bytes);
+// arenas reserve a large virtual address range and commit pages on demand so that they can grow without relocation.
+static const uint32_t system_memory_reserved_size_in_bytes = 1024U * 1024 * 1024;
+static const uint32_t scene_frame_memory_reserved_size_in_bytes = 2048U * 1024 * 1024;
+static const uint32_t scene_heap_memory_reserved_size_in_bytes = 256U * 1024 * 1024;
+static const size_t memory_commit_granularity_in_bytes = 2 * 1024 * 1024;
+static LinearAllocator system_memory_allocator(ReserveVirtualMemory(system_memory_reserved_size_in_bytes), system_memory_reserved_size_in_bytes);
+static DoubleEndedLinearAllocator scene_frame_memory_allocator(ReserveVirtualMemory(scene_frame_memory_reserved_size_in_bytes), scene_frame_memory_reserved_size_in_bytes);
+static std::byte* const scene_heap_memory_buffer = ReserveVirtualMemory(scene_heap_memory_reserved_size_in_bytes);
+static const uint32_t memory_type_num = kMemoryTypeNum;
+struct CommittedMemory {
+  std::atomic<size_t> size_in_bytes{0};
+  std::mutex mutex;
+};
+static CommittedMemory committed_memory[memory_type_num];
+static std::atomic<size_t> memory_usage_peak[memory_type_num]{};
+constexpr auto GetMemoryTypeIndex(const MemoryType type) {
+  return static_cast<uint32_t>(type);
 }
+size_t GetSceneHeapUsedSize();
+auto GetUsedMemorySize(const MemoryType type) {
+  switch (type) {
+    case MemoryType::kSystem: return system_memory_allocator.GetOffset();
+    case MemoryType::kScene:  return scene_frame_memory_allocator.GetOffsetLower();
+    case MemoryType::kFrame:  return scene_frame_memory_allocator.GetOffsetHigher();
+    case MemoryType::kSceneHeap: return GetSceneHeapUsedSize();
+  }
+  return size_t{0};
+}
+// system and scene memory grow from the head of their ranges, frame memory grows from the tail.
+std::byte* GetCommitRangeHead(const MemoryType type, const size_t prev_committed_size, const size_t new_committed_size) {
+  switch (type) {
+    case MemoryType::kSystem: return system_memory_allocator.GetBuffer() + prev_committed_size;
+    case MemoryType::kScene:  return scene_frame_memory_allocator.GetBuffer() + prev_committed_size;
+    case MemoryType::kFrame:  return scene_frame_memory_allocator.GetBuffer() + scene_frame_memory_allocator.GetBufferSizeInByte() - new_committed_size;
+    case MemoryType::kSceneHeap: return scene_heap_memory_buffer + prev_committed_size;
+  }
+  return nullptr;
+}
+bool CommitMemory(const MemoryType type, const size_t used_size_in_bytes) {
+  auto& committed = committed_memory[GetMemoryTypeIndex(type)];
+  if (used_size_in_bytes <= committed.size_in_bytes.load(std::memory_order_acquire)) { return true; }
+  std::lock_guard<std::mutex> lock(committed.mutex);
+  const auto prev_committed_size = committed.size_in_bytes.load(std::memory_order_relaxed);
+  if (used_size_in_bytes <= prev_committed_size) { return true; }
+  const auto new_committed_size = AlignAddress(used_size_in_bytes, memory_commit_granularity_in_bytes);
+  if (!CommitVirtualMemory(GetCommitRangeHead(type, prev_committed_size, new_committed_size), new_committed_size - prev_committed_size)) {
+    logerror("failed to commit memory. type:{} size:{}", GetMemoryTypeIndex(type), new_committed_size);
+    return false;
+  }
+  committed.size_in_bytes.store(new_committed_size, std::memory_order_release);
+  return true;
+}
+// the scene heap starts with a single commit granule and its tlsf pool grows with the committed range.
+std::byte* CommitSceneHeapMemory() {
+  if (!CommitMemory(MemoryType::kSceneHeap, memory_commit_granularity_in_bytes)) {
+    assert(false && "failed to commit scene heap memory");
+    return nullptr;
+  }
+  return scene_heap_memory_buffer;
+}
+struct SceneHeap {
+  std::mutex mutex;
+  TlsfAllocator allocator{CommitSceneHeapMemory(), memory_commit_granularity_in_bytes};
+};
+// commits enough memory for the request on top of the current pool, including the block header and alignment padding.
+bool GrowSceneHeap(SceneHeap* heap, const size_t bytes, const size_t alignment_in_bytes) {
+  const auto grow_size = bytes + alignment_in_bytes + sizeof(size_t) * 8;
+  const auto new_size = heap->allocator.GetBufferSizeInByte() + grow_size;
+  if (new_size > scene_heap_memory_reserved_size_in_bytes) { return false; }
+  if (!CommitMemory(MemoryType::kSceneHeap, new_size)) { return false; }
+  const auto committed_size = committed_memory[GetMemoryTypeIndex(MemoryType::kSceneHeap)].size_in_bytes.load(std::memory_order_acquire);
+  return heap->allocator.Grow(committed_size);
+}
+static std::atomic<SceneHeap*> scene_heap{nullptr};
+SceneHeap* GetSceneHeap() {
+  static SceneHeap heap;
+  scene_heap.store(&heap, std::memory_order_release);
+  return &heap;
+}
+size_t GetReservedMemorySize(const MemoryType type) {
+  switch (type) {
+    case MemoryType::kSystem:    return system_memory_allocator.GetBufferSizeInByte();
+    case MemoryType::kScene:     return scene_frame_memory_allocator.GetBufferSizeInByte();
+    case MemoryType::kFrame:     return scene_frame_memory_allocator.GetBufferSizeInByte();
+    case MemoryType::kSceneHeap: return scene_heap_memory_reserved_size_in_bytes;
+  }
+  return size_t{0};
+}
+size_t GetSceneHeapUsedSize() {
+  auto heap = scene_heap.load(std::memory_order_acquire);
+  if (heap == nullptr) { return 0; }
+  std::lock_guard<std::mutex> lock(heap->mutex);
+  return heap->allocator.GetUsedSizeInBytes();
+}
+void UpdateMemoryUsagePeak(const MemoryType type) {
+  const auto used_size = GetUsedMemorySize(type);
+  auto& peak = memory_usage_peak[GetMemoryTypeIndex(type)];
+  auto prev_peak = peak.load(std::memory_order_relaxed);
+  while (prev_peak < used_size && !peak.compare_exchange_weak(prev_peak, used_size, std::memory_order_relaxed)) {}
+}
+// frame memory is handed out to each thread in chunks so that AllocateFrame can be called from multiple threads.
+// chunks are carved from the higher end of scene_frame_memory_allocator with an atomic bump and become stale when the frame epoch changes.
+static const uint32_t frame_memory_chunk_size_in_bytes = 64 * 1024;
+static const uint32_t frame_memory_chunk_alignment_in_bytes = 64;
+static const uint32_t frame_memory_chunk_bypass_size_in_bytes = frame_memory_chunk_size_in_bytes / 4;
+// shared_offset_begin/end hold the latest run of contiguous chunks and bypass blocks this thread took from scene_frame_memory_allocator,
+// which FrameMemoryCheckpoint can return while no other thread has allocated after them.
+struct FrameMemoryChunk {
+  std::uintptr_t head{0};
+  std::uintptr_t tail{0};
+  uint32_t epoch{~0U};
+  uint32_t shared_epoch{~0U};
+  size_t shared_offset_begin{0};
+  size_t shared_offset_end{0};
+};
+static std::atomic<uint32_t> frame_memory_epoch{0};
+static thread_local FrameMemoryChunk frame_memory_chunk{};
+void* AllocateFrameMemoryShared(FrameMemoryChunk* chunk, const uint32_t epoch, const size_t bytes, const size_t alignment_in_bytes) {
+  size_t offset_before = 0;
+  auto addr = scene_frame_memory_allocator.AllocateHigher(bytes, alignment_in_bytes, &offset_before);
+  if (addr == nullptr) { return nullptr; }
+  if (chunk->shared_epoch != epoch || chunk->shared_offset_end != offset_before) {
+    chunk->shared_epoch = epoch;
+    chunk->shared_offset_begin = offset_before;
+  }
+  chunk->shared_offset_end = scene_frame_memory_allocator.GetOffsetHigherAt(addr);
+  return addr;
+}
+#ifdef USE_MEMORY_POISONING
+void PoisonMemory(const std::uintptr_t head, const std::uintptr_t tail) {
+  if (head >= tail) { return; }
+  memset(reinterpret_cast<void*>(head), 0xdd, tail - head);
+}
+#endif
+void* AllocateFromFrameMemoryChunk(FrameMemoryChunk* chunk, const size_t bytes, const size_t alignment_in_bytes) {
+  if (chunk->tail - chunk->head < bytes) { return nullptr; }
+  auto addr_aligned = AlignAddressWithoutOffset(chunk->tail - bytes, alignment_in_bytes);
+  if (addr_aligned < chunk->head) { return nullptr; }
+  chunk->tail = addr_aligned;
+  return reinterpret_cast<void*>(addr_aligned);
+}
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+// telemetry uses its own buffer and std::vector so that recording never allocates from the arenas being measured.
+static const uint32_t telemetry_call_site_num_max = 4096;
+static const uint32_t telemetry_buffer_size_in_bytes = 256 * 1024;
+struct MemoryAllocationTelemetry {
+  std::mutex mutex;
+  std::byte buffer[telemetry_buffer_size_in_bytes]{};
+  LinearAllocator allocator{buffer, telemetry_buffer_size_in_bytes};
+  HashMap<uint32_t, LinearAllocator> call_site_index{&allocator, telemetry_call_site_num_max};
+  std::vector<MemoryAllocationCallSiteStats> call_site_list;
+  std::vector<MemoryAllocationFrameStats> frame_list;
+  MemoryAllocationFrameStats current_frame{};
+};
+auto GetMemoryAllocationTelemetry() {
+  static MemoryAllocationTelemetry telemetry;
+  return &telemetry;
+}
+auto GetCallSiteHash(const AllocationCallSite& call_site, const MemoryType type) {
+  const auto file = reinterpret_cast<std::uintptr_t>(call_site.file_name());
+  const auto file_hash = static_cast<StrHash>(file ^ (static_cast<uint64_t>(file) >> 32));
+  return CombineHash(CombineHash(file_hash, call_site.line()), CombineHash(call_site.column(), GetMemoryTypeIndex(type)));
+}
+bool IsSameCallSite(const MemoryAllocationCallSiteStats& stats, const AllocationCallSite& call_site, const MemoryType type) {
+  return stats.line == call_site.line() && stats.memory_type == type && strcmp(stats.file_name, call_site.file_name()) == 0 && strcmp(stats.function_name, call_site.function_name()) == 0;
+}
+MemoryAllocationCallSiteStats* FindOrAddCallSite(MemoryAllocationTelemetry* telemetry, const AllocationCallSite& call_site, const MemoryType type) {
+  // probe subsequent keys on hash collision.
+  for (auto key = GetCallSiteHash(call_site, type); ; key++) {
+    if (auto index = telemetry->call_site_index.Get(key); index != nullptr) {
+      if (IsSameCallSite(telemetry->call_site_list[*index], call_site, type)) { return &telemetry->call_site_list[*index]; }
+      continue;
+    }
+    if (telemetry->call_site_list.size() >= telemetry_call_site_num_max) { return nullptr; }
+    if (!telemetry->call_site_index.InsertCopy(key, static_cast<uint32_t>(telemetry->call_site_list.size()))) { return nullptr; }
+    telemetry->call_site_list.push_back({
+        .file_name = call_site.file_name(),
+        .function_name = call_site.function_name(),
+        .line = call_site.line(),
+        .memory_type = type,
+      });
+    return &telemetry->call_site_list.back();
+  }
+}
+void RecordAllocation(const MemoryType type, const size_t bytes, const AllocationCallSite& call_site) {
+  auto telemetry = GetMemoryAllocationTelemetry();
+  std::lock_guard<std::mutex> lock(telemetry->mutex);
+  const auto type_index = GetMemoryTypeIndex(type);
+  telemetry->current_frame.allocation_count[type_index]++;
+  telemetry->current_frame.allocated_bytes[type_index] += bytes;
+  auto stats = FindOrAddCallSite(telemetry, call_site, type);
+  if (stats == nullptr) { return; }
+  stats->allocation_count++;
+  stats->allocated_bytes += bytes;
+  stats->allocated_bytes_in_current_frame += bytes;
+}
+void RecordFrameEnd() {
+  auto telemetry = GetMemoryAllocationTelemetry();
+  std::lock_guard<std::mutex> lock(telemetry->mutex);
+  auto& frame = telemetry->current_frame;
+  for (uint32_t i = 0; i < memory_type_num; i++) {
+    frame.used_bytes[i] = GetUsedMemorySize(static_cast<MemoryType>(i));
+  }
+  telemetry->frame_list.push_back(frame);
+  frame = {.frame_index = frame.frame_index + 1,};
+  for (auto& stats : telemetry->call_site_list) {
+    stats.max_allocated_bytes_per_frame = std::max(stats.max_allocated_bytes_per_frame, stats.allocated_bytes_in_current_frame);
+    stats.allocated_bytes_in_current_frame = 0;
+  }
+}
+const char* GetMemoryTypeName(const MemoryType type) {
+  switch (type) {
+    case MemoryType::kSystem: return "system";
+    case MemoryType::kScene:  return "scene";
+    case MemoryType::kFrame:  return "frame";
+    case MemoryType::kSceneHeap: return "scene_heap";
+  }
+  return "";
+}
+#endif
+} // namespace
 void ResetAllocation(const MemoryType type) {
+  UpdateMemoryUsagePeak(type);
   switch (type) {
     case MemoryType::kSystem: {
       system_memory_allocator.Reset();
@@ -19,7 +245,19 @@ void ResetAllocation(const MemoryType type) {
       break;
     }
     case MemoryType::kFrame: {
+      // must not be called while other threads are allocating frame memory.
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+      RecordFrameEnd();
+#endif
       scene_frame_memory_allocator.ResetHigher();
+      frame_memory_epoch.fetch_add(1, std::memory_order_release);
+      break;
+    }
+    case MemoryType::kSceneHeap: {
+      if (auto heap = scene_heap.load(std::memory_order_acquire); heap != nullptr) {
+        std::lock_guard<std::mutex> lock(heap->mutex);
+        heap->allocator.Reset();
+      }
       break;
     }
   }
@@ -28,24 +266,251 @@ void ClearAllAllocations() {
   ResetAllocation(MemoryType::kSystem);
   ResetAllocation(MemoryType::kScene);
   ResetAllocation(MemoryType::kFrame);
+  ResetAllocation(MemoryType::kSceneHeap);
+}
+MemoryUsage GetMemoryUsage(const MemoryType type) {
+  UpdateMemoryUsagePeak(type);
+  return {
+    .used_bytes = GetUsedMemorySize(type),
+    .peak_bytes = memory_usage_peak[GetMemoryTypeIndex(type)].load(std::memory_order_relaxed),
+    .committed_bytes = committed_memory[GetMemoryTypeIndex(type)].size_in_bytes.load(std::memory_order_relaxed),
+    .reserved_bytes = GetReservedMemorySize(type),
+  };
+}
+void ResetMemoryUsagePeak(const MemoryType type) {
+  memory_usage_peak[GetMemoryTypeIndex(type)].store(GetUsedMemorySize(type), std::memory_order_relaxed);
+}
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+uint32_t GetMemoryAllocationCallSiteStatsNum() {
+  return static_cast<uint32_t>(GetMemoryAllocationTelemetry()->call_site_list.size());
+}
+const MemoryAllocationCallSiteStats* GetMemoryAllocationCallSiteStatsList() {
+  return GetMemoryAllocationTelemetry()->call_site_list.data();
+}
+uint32_t GetMemoryAllocationFrameStatsNum() {
+  return static_cast<uint32_t>(GetMemoryAllocationTelemetry()->frame_list.size());
+}
+const MemoryAllocationFrameStats* GetMemoryAllocationFrameStatsList() {
+  return GetMemoryAllocationTelemetry()->frame_list.data();
+}
+void ClearMemoryAllocationTelemetry() {
+  auto telemetry = GetMemoryAllocationTelemetry();
+  std::lock_guard<std::mutex> lock(telemetry->mutex);
+  telemetry->allocator.Reset();
+  telemetry->call_site_index.SetAllocator(&telemetry->allocator, telemetry_call_site_num_max);
+  telemetry->call_site_list.clear();
+  telemetry->frame_list.clear();
+  telemetry->current_frame = {};
+}
+void LogMemoryAllocationTelemetry(const uint32_t call_site_num) {
+  auto telemetry = GetMemoryAllocationTelemetry();
+  std::lock_guard<std::mutex> lock(telemetry->mutex);
+  size_t used_bytes_max[memory_type_num]{};
+  for (const auto& frame : telemetry->frame_list) {
+    for (uint32_t i = 0; i < memory_type_num; i++) {
+      used_bytes_max[i] = std::max(used_bytes_max[i], frame.used_bytes[i]);
+    }
+  }
+  loginfo("memory allocation telemetry frames:{} max used bytes system:{} scene:{} frame:{} scene_heap:{}", telemetry->frame_list.size(), used_bytes_max[0], used_bytes_max[1], used_bytes_max[2], used_bytes_max[3]);
+  std::vector<const MemoryAllocationCallSiteStats*> sorted_list;
+  for (const auto& stats : telemetry->call_site_list) {
+    sorted_list.push_back(&stats);
+  }
+  std::sort(sorted_list.begin(), sorted_list.end(), [](const auto* a, const auto* b) { return a->max_allocated_bytes_per_frame > b->max_allocated_bytes_per_frame; });
+  for (uint32_t i = 0; i < call_site_num && i < sorted_list.size(); i++) {
+    const auto& stats = *sorted_list[i];
+    loginfo("  {} max bytes/frame:{} bytes:{} count:{} {}({}) {}", GetMemoryTypeName(stats.memory_type), stats.max_allocated_bytes_per_frame, stats.allocated_bytes, stats.allocation_count, stats.file_name, stats.line, stats.function_name);
+  }
+}
+bool WriteMemoryAllocationTelemetryCsv(const char* const frame_stats_path, const char* const call_site_stats_path) {
+  auto telemetry = GetMemoryAllocationTelemetry();
+  std::lock_guard<std::mutex> lock(telemetry->mutex);
+  std::ofstream frame_stats_file(frame_stats_path);
+  if (!frame_stats_file) {
+    logerror("failed to open {}", frame_stats_path);
+    return false;
+  }
+  frame_stats_file << "frame";
+  for (uint32_t i = 0; i < memory_type_num; i++) {
+    const auto name = GetMemoryTypeName(static_cast<MemoryType>(i));
+    frame_stats_file << ',' << name << "_count," << name << "_bytes," << name << "_used_bytes";
+  }
+  frame_stats_file << '\n';
+  for (const auto& frame : telemetry->frame_list) {
+    frame_stats_file << frame.frame_index;
+    for (uint32_t i = 0; i < memory_type_num; i++) {
+      frame_stats_file << ',' << frame.allocation_count[i] << ',' << frame.allocated_bytes[i] << ',' << frame.used_bytes[i];
+    }
+    frame_stats_file << '\n';
+  }
+  std::ofstream call_site_stats_file(call_site_stats_path);
+  if (!call_site_stats_file) {
+    logerror("failed to open {}", call_site_stats_path);
+    return false;
+  }
+  call_site_stats_file << "memory_type,file,line,function,count,bytes,max_bytes_per_frame\n";
+  for (const auto& stats : telemetry->call_site_list) {
+    // function names contain commas in template argument lists.
+    call_site_stats_file << GetMemoryTypeName(stats.memory_type) << ",\"" << stats.file_name << "\"," << stats.line << ",\"" << stats.function_name << "\"," << stats.allocation_count << ',' << stats.allocated_bytes << ',' << stats.max_allocated_bytes_per_frame << '\n';
+  }
+  return true;
+}
+bool WriteMemoryAllocationTelemetryJson(const char* const path) {
+  auto telemetry = GetMemoryAllocationTelemetry();
+  std::lock_guard<std::mutex> lock(telemetry->mutex);
+  auto json = nlohmann::json::object();
+  auto& frames = json["frames"] = nlohmann::json::array();
+  for (const auto& frame : telemetry->frame_list) {
+    auto& frame_json = frames.emplace_back(nlohmann::json::object());
+    frame_json["frame"] = frame.frame_index;
+    for (uint32_t i = 0; i < memory_type_num; i++) {
+      frame_json[GetMemoryTypeName(static_cast<MemoryType>(i))] = {
+        {"count", frame.allocation_count[i]},
+        {"bytes", frame.allocated_bytes[i]},
+        {"used_bytes", frame.used_bytes[i]},
+      };
+    }
+  }
+  auto& call_sites = json["call_sites"] = nlohmann::json::array();
+  for (const auto& stats : telemetry->call_site_list) {
+    call_sites.push_back({
+        {"memory_type", GetMemoryTypeName(stats.memory_type)},
+        {"file", stats.file_name},
+        {"line", stats.line},
+        {"function", stats.function_name},
+        {"count", stats.allocation_count},
+        {"bytes", stats.allocated_bytes},
+        {"max_bytes_per_frame", stats.max_allocated_bytes_per_frame},
+      });
+  }
+  std::ofstream file(path);
+  if (!file) {
+    logerror("failed to open {}", path);
+    return false;
+  }
+  file << json.dump(2);
+  return true;
 }
-void* AllocateSystem(const size_t bytes, const size_t alignment_in_bytes) {
+#endif
+void* AllocateSystem(const size_t bytes, const size_t alignment_in_bytes, [[maybe_unused]] const AllocationCallSite& call_site) {
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  RecordAllocation(MemoryType::kSystem, bytes, call_site);
+#endif
   auto addr = system_memory_allocator.Allocate(bytes, alignment_in_bytes);
   assert(addr != nullptr);
+  if (!CommitMemory(MemoryType::kSystem, system_memory_allocator.GetOffset())) {
+    assert(false && "failed to commit system memory");
+    return nullptr;
+  }
   return addr;
 }
-void* AllocateScene(const size_t bytes, const size_t alignment_in_bytes) {
+void* AllocateScene(const size_t bytes, const size_t alignment_in_bytes, [[maybe_unused]] const AllocationCallSite& call_site) {
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  RecordAllocation(MemoryType::kScene, bytes, call_site);
+#endif
   auto addr = scene_frame_memory_allocator.AllocateLower(bytes, alignment_in_bytes);
   assert(addr != nullptr);
+  if (!CommitMemory(MemoryType::kScene, scene_frame_memory_allocator.GetOffsetLower())) {
+    assert(false && "failed to commit scene memory");
+    return nullptr;
+  }
   return addr;
 }
-void* AllocateFrame(const size_t bytes, const size_t alignment_in_bytes) {
-  auto addr = scene_frame_memory_allocator.AllocateHigher(bytes, alignment_in_bytes);
+void* AllocateFrame(const size_t bytes, const size_t alignment_in_bytes, [[maybe_unused]] const AllocationCallSite& call_site) {
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  RecordAllocation(MemoryType::kFrame, bytes, call_site);
+#endif
+  auto chunk = &frame_memory_chunk;
+  const auto epoch = frame_memory_epoch.load(std::memory_order_acquire);
+  if (chunk->epoch == epoch) {
+    auto addr = AllocateFromFrameMemoryChunk(chunk, bytes, alignment_in_bytes);
+    if (addr != nullptr) { return addr; }
+  }
+  if (bytes + alignment_in_bytes > frame_memory_chunk_bypass_size_in_bytes) {
+    auto addr = AllocateFrameMemoryShared(chunk, epoch, bytes, alignment_in_bytes);
+    assert(addr != nullptr);
+    if (!CommitMemory(MemoryType::kFrame, scene_frame_memory_allocator.GetOffsetHigher())) {
+      assert(false && "failed to commit frame memory");
+      return nullptr;
+    }
+    return addr;
+  }
+  auto chunk_head = AllocateFrameMemoryShared(chunk, epoch, frame_memory_chunk_size_in_bytes, frame_memory_chunk_alignment_in_bytes);
+  assert(chunk_head != nullptr);
+  if (!CommitMemory(MemoryType::kFrame, scene_frame_memory_allocator.GetOffsetHigher())) {
+    assert(false && "failed to commit frame memory");
+    return nullptr;
+  }
+  chunk->head = reinterpret_cast<std::uintptr_t>(chunk_head);
+  chunk->tail = chunk->head + frame_memory_chunk_size_in_bytes;
+  chunk->epoch = epoch;
+  return AllocateFromFrameMemoryChunk(chunk, bytes, alignment_in_bytes);
+}
+FrameMemoryCheckpoint::FrameMemoryCheckpoint()
+    : chunk_head_(frame_memory_chunk.head)
+    , chunk_tail_(frame_memory_chunk.tail)
+    , chunk_epoch_(frame_memory_chunk.epoch)
+    , epoch_(frame_memory_epoch.load(std::memory_order_acquire))
+    , offset_higher_(scene_frame_memory_allocator.GetOffsetHigher())
+{}
+FrameMemoryCheckpoint::~FrameMemoryCheckpoint() {
+  // nothing to release when frame memory has been reset within the scope.
+  if (epoch_ != frame_memory_epoch.load(std::memory_order_acquire)) { return; }
+  auto chunk = &frame_memory_chunk;
+  if (chunk->shared_epoch == epoch_ && chunk->shared_offset_end > offset_higher_) {
+    // memory taken before the checkpoint or by other threads in between must stay.
+    const auto marker = std::max(chunk->shared_offset_begin, offset_higher_);
+    UpdateMemoryUsagePeak(MemoryType::kFrame);
+    if (scene_frame_memory_allocator.ResetHigherToMarker(marker, chunk->shared_offset_end)) {
+#ifdef USE_MEMORY_POISONING
+      const auto buffer_tail = reinterpret_cast<std::uintptr_t>(scene_frame_memory_allocator.GetBuffer()) + scene_frame_memory_allocator.GetBufferSizeInByte();
+      PoisonMemory(buffer_tail - chunk->shared_offset_end, buffer_tail - marker);
+#endif
+      chunk->shared_offset_end = marker;
+    }
+#ifdef USE_MEMORY_POISONING
+    else if (chunk->epoch == epoch_ && chunk->head != chunk_head_) {
+      // chunk taken within the scope is abandoned until the frame end.
+      PoisonMemory(chunk->tail, chunk->head + frame_memory_chunk_size_in_bytes);
+    }
+#endif
+  }
+#ifdef USE_MEMORY_POISONING
+  if (chunk_epoch_ == epoch_) {
+    PoisonMemory((chunk->epoch == chunk_epoch_ && chunk->head == chunk_head_) ? chunk->tail : chunk_head_, chunk_tail_);
+  }
+#endif
+  // chunks allocate downwards, so anything below chunk_tail_ in the chunk at the checkpoint was allocated within the scope.
+  chunk->head = chunk_head_;
+  chunk->tail = chunk_tail_;
+  chunk->epoch = chunk_epoch_;
+}
+void* AllocateSceneHeap(const size_t bytes, const size_t alignment_in_bytes, [[maybe_unused]] const AllocationCallSite& call_site) {
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+  RecordAllocation(MemoryType::kSceneHeap, bytes, call_site);
+#endif
+  auto heap = GetSceneHeap();
+  std::lock_guard<std::mutex> lock(heap->mutex);
+  auto addr = heap->allocator.Allocate(bytes, alignment_in_bytes);
+  if (addr == nullptr && GrowSceneHeap(heap, bytes, alignment_in_bytes)) {
+    addr = heap->allocator.Allocate(bytes, alignment_in_bytes);
+  }
   assert(addr != nullptr);
   return addr;
 }
+void FreeSceneHeap(void* ptr) {
+  if (ptr == nullptr) { return; }
+  auto heap = GetSceneHeap();
+  std::lock_guard<std::mutex> lock(heap->mutex);
+  heap->allocator.Free(ptr);
+}
 } // namespace illuminate
 #include "doctest/doctest.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
 TEST_CASE("d3d12 memory allocation") { // NOLINT
   using namespace illuminate;
   auto i = AllocateSystem<uint32_t>();
@@ -94,3 +559,318 @@ TEST_CASE("d3d12 memory allocation") { // NOLINT
   CHECK_EQ(*n, 5);
   CHECK_EQ(*o, 10);
 }
+TEST_CASE("d3d12 memory allocation beyond initially committed size") { // NOLINT
+  using namespace illuminate; // NOLINT
+  ResetAllocation(MemoryType::kScene);
+  ResetAllocation(MemoryType::kFrame);
+  const uint32_t allocation_size = 48 * 1024 * 1024;
+  const uint32_t allocation_num = 3;
+  std::byte* scene_ptr[allocation_num]{};
+  for (uint32_t i = 0; i < allocation_num; i++) {
+    scene_ptr[i] = AllocateArrayScene<std::byte>(allocation_size);
+    scene_ptr[i][0] = std::byte{1};
+    scene_ptr[i][allocation_size - 1] = std::byte{2};
+  }
+  auto frame_ptr = AllocateArrayFrame<std::byte>(allocation_size);
+  frame_ptr[0] = std::byte{3};
+  frame_ptr[allocation_size - 1] = std::byte{4};
+  for (uint32_t i = 0; i < allocation_num; i++) {
+    CHECK_EQ(scene_ptr[i][0], std::byte{1});
+    CHECK_EQ(scene_ptr[i][allocation_size - 1], std::byte{2});
+  }
+  CHECK_EQ(frame_ptr[0], std::byte{3});
+  CHECK_EQ(frame_ptr[allocation_size - 1], std::byte{4});
+  auto scene_usage = GetMemoryUsage(MemoryType::kScene);
+  CHECK_GE(scene_usage.used_bytes, allocation_size * allocation_num);
+  CHECK_GE(scene_usage.peak_bytes, scene_usage.used_bytes);
+  CHECK_GE(scene_usage.committed_bytes, scene_usage.used_bytes);
+  CHECK_GT(scene_usage.reserved_bytes, scene_usage.committed_bytes);
+  auto frame_usage = GetMemoryUsage(MemoryType::kFrame);
+  CHECK_GE(frame_usage.used_bytes, allocation_size);
+  CHECK_GE(frame_usage.committed_bytes, frame_usage.used_bytes);
+  ResetAllocation(MemoryType::kScene);
+  ResetAllocation(MemoryType::kFrame);
+  scene_usage = GetMemoryUsage(MemoryType::kScene);
+  CHECK_EQ(scene_usage.used_bytes, 0);
+  CHECK_GE(scene_usage.peak_bytes, allocation_size * allocation_num);
+  CHECK_GE(scene_usage.committed_bytes, allocation_size * allocation_num);
+  frame_usage = GetMemoryUsage(MemoryType::kFrame);
+  CHECK_EQ(frame_usage.used_bytes, 0);
+  CHECK_GE(frame_usage.peak_bytes, allocation_size);
+  // committed pages are reused after reset.
+  auto ptr = AllocateArrayScene<std::byte>(allocation_size);
+  CHECK_EQ(ptr, scene_ptr[0]);
+  CHECK_EQ(GetMemoryUsage(MemoryType::kScene).committed_bytes, scene_usage.committed_bytes);
+  ResetAllocation(MemoryType::kScene);
+}
+TEST_CASE("d3d12 frame memory allocation from multiple threads") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t thread_num = 8;
+  const uint32_t allocation_num = 2048;
+  struct AllocationInfo {
+    uint32_t* ptr{nullptr};
+    uint32_t len{0};
+  };
+  ResetAllocation(MemoryType::kFrame);
+  for (uint32_t loop = 0; loop < 3; loop++) {
+    std::vector<AllocationInfo> allocation_info_list(thread_num * allocation_num);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_num; t++) {
+      threads.emplace_back([t, &allocation_info_list]() {
+        for (uint32_t i = 0; i < allocation_num; i++) {
+          const auto index = t * allocation_num + i;
+          // mix in allocations larger than a chunk to exercise the bypass path.
+          const auto len = (i % 512 == 511) ? 8192 : 1 + (i * 7 + t) % 64;
+          auto ptr = AllocateArrayFrame<uint32_t>(len, (i % 3 == 0) ? 16 : kDefaultAlignmentSize);
+          std::fill(ptr, ptr + len, index);
+          allocation_info_list[index] = {ptr, len};
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (uint32_t i = 0; i < thread_num * allocation_num; i++) {
+      const auto& info = allocation_info_list[i];
+      CHECK_EQ(std::count(info.ptr, info.ptr + info.len, i), info.len);
+    }
+    std::sort(allocation_info_list.begin(), allocation_info_list.end(), [](const AllocationInfo& a, const AllocationInfo& b) { return a.ptr < b.ptr; });
+    for (uint32_t i = 1; i < thread_num * allocation_num; i++) {
+      CHECK_LE(allocation_info_list[i - 1].ptr + allocation_info_list[i - 1].len, allocation_info_list[i].ptr);
+    }
+    ResetAllocation(MemoryType::kFrame);
+  }
+  // main thread is still able to allocate after other threads have gone.
+  auto ptr = AllocateFrame<uint32_t>();
+  *ptr = 5;
+  CHECK_EQ(*ptr, 5);
+  ResetAllocation(MemoryType::kFrame);
+}
+TEST_CASE("d3d12 frame memory checkpoint") { // NOLINT
+  using namespace illuminate; // NOLINT
+  ResetAllocation(MemoryType::kFrame);
+  auto persistent = AllocateArrayFrame<uint32_t>(16);
+  std::fill(persistent, persistent + 16, 1);
+  const auto used_bytes = GetMemoryUsage(MemoryType::kFrame).used_bytes;
+  const uint32_t large_len = 256 * 1024;
+  uint32_t* temporal = nullptr;
+  {
+    FrameMemoryCheckpoint checkpoint;
+    temporal = AllocateArrayFrame<uint32_t>(16);
+    std::fill(temporal, temporal + 16, 2);
+    {
+      FrameMemoryCheckpoint inner_checkpoint;
+      auto temporal_large = AllocateArrayFrame<uint32_t>(large_len);
+      std::fill(temporal_large, temporal_large + large_len, 3);
+      CHECK_GE(GetMemoryUsage(MemoryType::kFrame).used_bytes, used_bytes + sizeof(uint32_t) * large_len);
+    }
+    CHECK_EQ(GetMemoryUsage(MemoryType::kFrame).used_bytes, used_bytes);
+    CHECK_EQ(std::count(temporal, temporal + 16, 2), 16);
+    // small allocations exhausting the current chunk.
+    for (uint32_t i = 0; i < 64; i++) {
+      std::fill_n(AllocateArrayFrame<uint32_t>(1024), 1024, 4);
+    }
+    CHECK_GT(GetMemoryUsage(MemoryType::kFrame).used_bytes, used_bytes);
+  }
+  CHECK_EQ(GetMemoryUsage(MemoryType::kFrame).used_bytes, used_bytes);
+  CHECK_GE(GetMemoryUsage(MemoryType::kFrame).peak_bytes, used_bytes + sizeof(uint32_t) * large_len);
+  ResetMemoryUsagePeak(MemoryType::kFrame);
+  CHECK_EQ(GetMemoryUsage(MemoryType::kFrame).peak_bytes, used_bytes);
+  CHECK_EQ(std::count(persistent, persistent + 16, 1), 16);
+#ifdef USE_MEMORY_POISONING
+  CHECK_EQ(temporal[0], 0xddddddddU);
+#endif
+  // released memory is reused.
+  CHECK_EQ(AllocateArrayFrame<uint32_t>(16), temporal);
+  {
+    // memory other threads allocated on top is kept.
+    FrameMemoryCheckpoint checkpoint;
+    AllocateArrayFrame<uint32_t>(large_len);
+    std::thread([]() { std::fill_n(AllocateArrayFrame<uint32_t>(large_len), large_len, 5); }).join();
+  }
+  CHECK_GE(GetMemoryUsage(MemoryType::kFrame).used_bytes, used_bytes + sizeof(uint32_t) * large_len * 2);
+  {
+    // memory other threads allocated beneath is kept.
+    FrameMemoryCheckpoint checkpoint;
+    const auto prev_used_bytes = GetMemoryUsage(MemoryType::kFrame).used_bytes;
+    uint32_t* other_thread_ptr = nullptr;
+    std::thread([&other_thread_ptr]() { other_thread_ptr = AllocateArrayFrame<uint32_t>(large_len); std::fill_n(other_thread_ptr, large_len, 6); }).join();
+    const auto other_thread_used_bytes = GetMemoryUsage(MemoryType::kFrame).used_bytes;
+    CHECK_GT(other_thread_used_bytes, prev_used_bytes);
+    AllocateArrayFrame<uint32_t>(large_len);
+    CHECK_GT(GetMemoryUsage(MemoryType::kFrame).used_bytes, other_thread_used_bytes);
+    FrameMemoryCheckpoint inner_checkpoint;
+    AllocateArrayFrame<uint32_t>(large_len);
+    {
+      FrameMemoryCheckpoint innermost_checkpoint;
+    }
+    CHECK_EQ(std::count(other_thread_ptr, other_thread_ptr + large_len, 6), large_len);
+  }
+  CHECK_GE(GetMemoryUsage(MemoryType::kFrame).used_bytes, used_bytes + sizeof(uint32_t) * large_len * 3);
+  {
+    // checkpoints across ResetAllocation() are ignored.
+    FrameMemoryCheckpoint checkpoint;
+    ResetAllocation(MemoryType::kFrame);
+    AllocateArrayFrame<uint32_t>(large_len);
+  }
+  CHECK_GE(GetMemoryUsage(MemoryType::kFrame).used_bytes, sizeof(uint32_t) * large_len);
+  ResetAllocation(MemoryType::kFrame);
+}
+TEST_CASE("d3d12 scene heap memory allocation") { // NOLINT
+  using namespace illuminate; // NOLINT
+  ResetAllocation(MemoryType::kSceneHeap);
+  CHECK_EQ(GetMemoryUsage(MemoryType::kSceneHeap).used_bytes, 0);
+  auto a = AllocateArraySceneHeap<uint32_t>(16);
+  auto b = AllocateArray<uint64_t>(MemoryType::kSceneHeap, 1024);
+  auto c = AllocateArraySceneHeap<uint32_t>(16, 256);
+  CHECK_NE(a, nullptr);
+  CHECK_NE(b, nullptr);
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(c) % 256, 0);
+  std::fill(a, a + 16, 1);
+  std::fill(b, b + 1024, 2);
+  std::fill(c, c + 16, 3);
+  auto usage = GetMemoryUsage(MemoryType::kSceneHeap);
+  CHECK_GE(usage.used_bytes, sizeof(uint32_t) * 32 + sizeof(uint64_t) * 1024);
+  CHECK_GE(usage.committed_bytes, usage.used_bytes);
+  CHECK_GE(usage.reserved_bytes, usage.committed_bytes);
+  // blocks are released individually and reused.
+  FreeSceneHeap(b);
+  CHECK_EQ(std::count(a, a + 16, 1), 16);
+  CHECK_EQ(std::count(c, c + 16, 3), 16);
+  auto d = AllocateArraySceneHeap<uint64_t>(1024);
+  CHECK_EQ(d, b);
+  FreeSceneHeap(a);
+  FreeSceneHeap(c);
+  FreeSceneHeap(d);
+  CHECK_EQ(GetMemoryUsage(MemoryType::kSceneHeap).used_bytes, 0);
+  CHECK_GE(GetMemoryUsage(MemoryType::kSceneHeap).peak_bytes, usage.used_bytes);
+  AllocateArraySceneHeap<uint32_t>(16);
+  ResetAllocation(MemoryType::kSceneHeap);
+  CHECK_EQ(GetMemoryUsage(MemoryType::kSceneHeap).used_bytes, 0);
+}
+TEST_CASE("d3d12 scene heap memory is committed on demand") { // NOLINT
+  using namespace illuminate; // NOLINT
+  ResetAllocation(MemoryType::kSceneHeap);
+  const size_t granularity = 2 * 1024 * 1024;
+  const auto initial_usage = GetMemoryUsage(MemoryType::kSceneHeap);
+  CHECK_LT(initial_usage.committed_bytes, initial_usage.reserved_bytes);
+  const uint32_t len = 1024 * 1024;
+  const uint32_t num = 12;
+  uint32_t* ptr_list[num]{};
+  for (uint32_t i = 0; i < num; i++) {
+    ptr_list[i] = AllocateArraySceneHeap<uint32_t>(len);
+    CHECK_NE(ptr_list[i], nullptr);
+    std::fill(ptr_list[i], ptr_list[i] + len, i);
+    const auto usage = GetMemoryUsage(MemoryType::kSceneHeap);
+    CAPTURE(i);
+    CHECK_GE(usage.committed_bytes, usage.used_bytes);
+    // committed size follows usage within a couple of granules instead of covering the whole reservation.
+    CHECK_LE(usage.committed_bytes, AlignAddress(std::max(usage.used_bytes, initial_usage.committed_bytes), granularity) + granularity * 2);
+  }
+  for (uint32_t i = 0; i < num; i++) {
+    CHECK_EQ(std::count(ptr_list[i], ptr_list[i] + len, i), len);
+  }
+  CHECK_LT(GetMemoryUsage(MemoryType::kSceneHeap).committed_bytes, initial_usage.reserved_bytes);
+  // blocks freed across commit boundaries are merged and reused.
+  for (uint32_t i = 0; i < num; i++) {
+    FreeSceneHeap(ptr_list[i]);
+  }
+  CHECK_EQ(GetMemoryUsage(MemoryType::kSceneHeap).used_bytes, 0);
+  const auto committed_bytes = GetMemoryUsage(MemoryType::kSceneHeap).committed_bytes;
+  auto large = AllocateArraySceneHeap<uint32_t>(len * (num - 1));
+  CHECK_NE(large, nullptr);
+  CHECK_EQ(GetMemoryUsage(MemoryType::kSceneHeap).committed_bytes, committed_bytes);
+  FreeSceneHeap(large);
+  ResetAllocation(MemoryType::kSceneHeap);
+}
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+TEST_CASE("d3d12 memory allocation telemetry") { // NOLINT
+  using namespace illuminate; // NOLINT
+  ResetAllocation(MemoryType::kFrame);
+  ClearMemoryAllocationTelemetry();
+  const auto find_call_site = [](const uint32_t line, const MemoryType type) -> const MemoryAllocationCallSiteStats* {
+    for (uint32_t i = 0; i < GetMemoryAllocationCallSiteStatsNum(); i++) {
+      const auto& stats = GetMemoryAllocationCallSiteStatsList()[i];
+      if (stats.line == line && stats.memory_type == type) { return &stats; }
+    }
+    return nullptr;
+  };
+  const uint32_t frame_num = 3;
+  uint32_t frame_allocation_line = 0;
+  uint32_t scene_allocation_line = 0;
+  for (uint32_t i = 0; i < frame_num; i++) {
+    for (uint32_t j = 0; j <= i; j++) {
+      frame_allocation_line = std::source_location::current().line() + 1;
+      AllocateArrayFrame<uint32_t>(16);
+    }
+    if (i == 0) {
+      scene_allocation_line = std::source_location::current().line() + 1;
+      AllocateArray<uint64_t>(MemoryType::kScene, 4);
+    }
+    ResetAllocation(MemoryType::kFrame);
+  }
+  CHECK_EQ(GetMemoryAllocationFrameStatsNum(), frame_num);
+  const auto frame_stats = GetMemoryAllocationFrameStatsList();
+  for (uint32_t i = 0; i < frame_num; i++) {
+    CAPTURE(i);
+    CHECK_EQ(frame_stats[i].frame_index, i);
+    CHECK_EQ(frame_stats[i].allocation_count[static_cast<uint32_t>(MemoryType::kFrame)], i + 1);
+    CHECK_EQ(frame_stats[i].allocated_bytes[static_cast<uint32_t>(MemoryType::kFrame)], sizeof(uint32_t) * 16 * (i + 1));
+    CHECK_GE(frame_stats[i].used_bytes[static_cast<uint32_t>(MemoryType::kFrame)], sizeof(uint32_t) * 16 * (i + 1));
+    CHECK_EQ(frame_stats[i].allocation_count[static_cast<uint32_t>(MemoryType::kScene)], i == 0 ? 1 : 0);
+  }
+  // call sites are recorded where the templates are called, not inside the allocator.
+  auto frame_call_site = find_call_site(frame_allocation_line, MemoryType::kFrame);
+  REQUIRE_NE(frame_call_site, nullptr);
+  CHECK_EQ(frame_call_site->allocation_count, 6);
+  CHECK_EQ(frame_call_site->allocated_bytes, sizeof(uint32_t) * 16 * 6);
+  CHECK_EQ(frame_call_site->max_allocated_bytes_per_frame, sizeof(uint32_t) * 16 * 3);
+  CHECK_EQ(frame_call_site->allocated_bytes_in_current_frame, 0);
+  auto scene_call_site = find_call_site(scene_allocation_line, MemoryType::kScene);
+  REQUIRE_NE(scene_call_site, nullptr);
+  CHECK_EQ(scene_call_site->allocation_count, 1);
+  CHECK_EQ(scene_call_site->allocated_bytes, sizeof(uint64_t) * 4);
+  CHECK_NE(strstr(scene_call_site->file_name, "d3d12_memory_allocators.cpp"), nullptr);
+  const auto json_path = (std::filesystem::temp_directory_path() / "memory_allocation_telemetry_test.json").string();
+  const auto frame_stats_path = (std::filesystem::temp_directory_path() / "memory_allocation_telemetry_test_frames.csv").string();
+  const auto call_site_stats_path = (std::filesystem::temp_directory_path() / "memory_allocation_telemetry_test_call_sites.csv").string();
+  CHECK_UNARY(WriteMemoryAllocationTelemetryJson(json_path.c_str()));
+  CHECK_UNARY(WriteMemoryAllocationTelemetryCsv(frame_stats_path.c_str(), call_site_stats_path.c_str()));
+  std::filesystem::remove(json_path);
+  std::filesystem::remove(frame_stats_path);
+  std::filesystem::remove(call_site_stats_path);
+  ResetAllocation(MemoryType::kScene);
+  ClearMemoryAllocationTelemetry();
+  CHECK_EQ(GetMemoryAllocationCallSiteStatsNum(), 0);
+  CHECK_EQ(GetMemoryAllocationFrameStatsNum(), 0);
+}
+#endif
+TEST_CASE("d3d12 frame memory allocation benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t allocation_num_per_thread = 32 * 1024;
+  const uint32_t allocation_size = 16;
+  const uint32_t loop_num = 16;
+  for (const uint32_t thread_num : {1U, 2U, 4U, 8U, 16U}) {
+    double duration_msec = 0.0;
+    for (uint32_t loop = 0; loop < loop_num; loop++) {
+      ResetAllocation(MemoryType::kFrame);
+      std::vector<std::thread> threads;
+      const auto start = std::chrono::high_resolution_clock::now();
+      for (uint32_t t = 0; t < thread_num; t++) {
+        threads.emplace_back([]() {
+          for (uint32_t i = 0; i < allocation_num_per_thread; i++) {
+            auto ptr = AllocateArrayFrame<std::byte>(allocation_size);
+            ptr[0] = std::byte{1};
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      duration_msec += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    const auto allocation_num = static_cast<double>(allocation_num_per_thread) * thread_num * loop_num;
+    spdlog::info("frame memory allocation threads:{} total:{:.2f}ms {:.2f}ns/allocation {:.2f}M allocations/sec", thread_num, duration_msec, duration_msec * 1000000.0 / allocation_num, allocation_num / duration_msec / 1000.0);
+  }
+  ResetAllocation(MemoryType::kFrame);
+}
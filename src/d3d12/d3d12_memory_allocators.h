@@ -2,74 +2,160 @@
 #define ILLUMINATE_D3D12_MEMORY_ALLOCATOR_H
 #include "illuminate/memory/memory_allocation.h"
 #include "illuminate/util/util_defines.h"
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+#include <source_location>
+#endif
 namespace illuminate {
-enum class MemoryType : uint8_t { kSystem, kScene, kFrame, };
-void* AllocateSystem(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize);
-void* AllocateScene(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize);
-void* AllocateFrame(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize);
-inline auto Allocate(const MemoryType type, const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
+// kSceneHeap is a general purpose heap for scene data released piecemeal with FreeSceneHeap(). its memory is committed in chunks as usage grows.
+enum class MemoryType : uint8_t { kSystem, kScene, kFrame, kSceneHeap, };
+static const uint32_t kMemoryTypeNum = 4;
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+using AllocationCallSite = std::source_location;
+#else
+// empty placeholder so that call sites compile out along with the telemetry.
+struct AllocationCallSite {
+  static constexpr AllocationCallSite current() { return {}; }
+};
+#endif
+void* AllocateSystem(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current());
+void* AllocateScene(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current());
+void* AllocateFrame(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current());
+void* AllocateSceneHeap(const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current());
+void FreeSceneHeap(void* ptr);
+inline auto Allocate(const MemoryType type, const size_t bytes, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
   switch (type) {
-    case MemoryType::kSystem: return AllocateSystem(bytes, alignment_in_bytes);
-    case MemoryType::kScene:  return AllocateScene(bytes, alignment_in_bytes);
-    case MemoryType::kFrame:  return AllocateFrame(bytes, alignment_in_bytes);
+    case MemoryType::kSystem: return AllocateSystem(bytes, alignment_in_bytes, call_site);
+    case MemoryType::kScene:  return AllocateScene(bytes, alignment_in_bytes, call_site);
+    case MemoryType::kFrame:  return AllocateFrame(bytes, alignment_in_bytes, call_site);
+    case MemoryType::kSceneHeap: return AllocateSceneHeap(bytes, alignment_in_bytes, call_site);
   }
   return (void*)nullptr;
 }
 template <typename T>
-auto AllocateSystem(const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(AllocateSystem(sizeof(T), alignment_in_bytes)) T;
+auto AllocateSystem(const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateSystem(sizeof(T), alignment_in_bytes, call_site)) T;
+}
+template <typename T>
+auto AllocateArraySystem(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateSystem(sizeof(T) * len, alignment_in_bytes, call_site)) T[len];
 }
 template <typename T>
-auto AllocateArraySystem(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(AllocateSystem(sizeof(T) * len, alignment_in_bytes)) T[len];
+auto AllocateScene(const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateScene(sizeof(T), alignment_in_bytes, call_site)) T;
 }
 template <typename T>
-auto AllocateScene(const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(AllocateScene(sizeof(T), alignment_in_bytes)) T;
+auto AllocateArrayScene(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateScene(sizeof(T) * len, alignment_in_bytes, call_site)) T[len];
 }
 template <typename T>
-auto AllocateArrayScene(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(AllocateScene(sizeof(T) * len, alignment_in_bytes)) T[len];
+auto AllocateFrame(const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateFrame(sizeof(T), alignment_in_bytes, call_site)) T;
 }
 template <typename T>
-auto AllocateFrame(const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(AllocateFrame(sizeof(T), alignment_in_bytes)) T;
+auto AllocateArrayFrame(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateFrame(sizeof(T) * len, alignment_in_bytes, call_site)) T[len];
 }
 template <typename T>
-auto AllocateArrayFrame(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(AllocateFrame(sizeof(T) * len, alignment_in_bytes)) T[len];
+auto AllocateSceneHeap(const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateSceneHeap(sizeof(T), alignment_in_bytes, call_site)) T;
 }
 template <typename T>
-auto Allocate(const MemoryType type, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(Allocate(type, sizeof(T), alignment_in_bytes)) T;
+auto AllocateArraySceneHeap(const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(AllocateSceneHeap(sizeof(T) * len, alignment_in_bytes, call_site)) T[len];
 }
 template <typename T>
-auto AllocateArray(const MemoryType type, const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  return new(Allocate(type, sizeof(T) * len, alignment_in_bytes)) T[len];
+auto Allocate(const MemoryType type, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(Allocate(type, sizeof(T), alignment_in_bytes, call_site)) T;
 }
 template <typename T>
-auto AllocateAndFillArraySystem(const uint32_t len, const T& fill_value, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  auto ptr = AllocateArraySystem<T>(len, alignment_in_bytes);
+auto AllocateArray(const MemoryType type, const uint32_t len, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return new(Allocate(type, sizeof(T) * len, alignment_in_bytes, call_site)) T[len];
+}
+template <typename T>
+auto AllocateAndFillArraySystem(const uint32_t len, const T& fill_value, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  auto ptr = AllocateArraySystem<T>(len, alignment_in_bytes, call_site);
   std::fill(ptr, ptr + len, fill_value);
   return ptr;
 }
 template <typename T>
-auto AllocateAndFillArrayScene(const uint32_t len, const T& fill_value, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  auto ptr = AllocateArrayScene<T>(len, alignment_in_bytes);
+auto AllocateAndFillArrayScene(const uint32_t len, const T& fill_value, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  auto ptr = AllocateArrayScene<T>(len, alignment_in_bytes, call_site);
   std::fill(ptr, ptr + len, fill_value);
   return ptr;
 }
 template <typename T>
-auto AllocateAndFillArrayFrame(const uint32_t len, const T& fill_value, const size_t alignment_in_bytes = kDefaultAlignmentSize) {
-  auto ptr = AllocateArrayFrame<T>(len, alignment_in_bytes);
+auto AllocateAndFillArrayFrame(const uint32_t len, const T& fill_value, const size_t alignment_in_bytes = kDefaultAlignmentSize, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  auto ptr = AllocateArrayFrame<T>(len, alignment_in_bytes, call_site);
   std::fill(ptr, ptr + len, fill_value);
   return ptr;
 }
 template <typename T>
-auto InitializeArray(const uint32_t size, const MemoryType& memoty_type) {
-  return CreateArray(size, AllocateArray<T>(memoty_type, size));
+auto InitializeArray(const uint32_t size, const MemoryType& memoty_type, const AllocationCallSite& call_site = AllocationCallSite::current()) {
+  return CreateArray(size, AllocateArray<T>(memoty_type, size, kDefaultAlignmentSize, call_site));
 }
+// exposes a memory type as an allocator for containers such as HashMap. allocations live as long as the memory type does.
+class MemoryTypeAllocator {
+ public:
+  explicit MemoryTypeAllocator(const MemoryType memory_type) : memory_type_(memory_type) {}
+  void* Allocate(const size_t bytes, const size_t alignment_in_bytes) { return illuminate::Allocate(memory_type_, bytes, alignment_in_bytes); }
+ private:
+  MemoryType memory_type_;
+};
 void ResetAllocation(const MemoryType type);
 void ClearAllAllocations();
+// releases frame memory allocated by the current thread within the scope, so that large temporaries need not live until the frame end.
+// checkpoints must be nested on the thread that created them, and values allocated within the scope must not escape it.
+// memory other threads allocated on top of this thread's is never released, the overlapping part is then kept until the frame end.
+// released ranges are filled with 0xdd when USE_MEMORY_POISONING is defined.
+class FrameMemoryCheckpoint {
+ public:
+  FrameMemoryCheckpoint();
+  ~FrameMemoryCheckpoint();
+  FrameMemoryCheckpoint(const FrameMemoryCheckpoint&) = delete;
+  FrameMemoryCheckpoint& operator=(const FrameMemoryCheckpoint&) = delete;
+ private:
+  std::uintptr_t chunk_head_{0};
+  std::uintptr_t chunk_tail_{0};
+  uint32_t chunk_epoch_{0};
+  uint32_t epoch_{0};
+  size_t offset_higher_{0};
+};
+struct MemoryUsage {
+  size_t used_bytes{0};
+  size_t peak_bytes{0};
+  size_t committed_bytes{0};
+  size_t reserved_bytes{0}; // scene and frame memory share the same reserved range.
+};
+MemoryUsage GetMemoryUsage(const MemoryType type);
+// restarts peak_bytes from the current usage, e.g. to measure the peak of a single call.
+void ResetMemoryUsagePeak(const MemoryType type);
+#ifdef USE_MEMORY_ALLOCATION_TELEMETRY
+// allocation telemetry is recorded per call site and per frame (a frame ends at ResetAllocation(MemoryType::kFrame)).
+// lists returned below must not be accessed while other threads are allocating.
+struct MemoryAllocationCallSiteStats {
+  const char* file_name{nullptr};
+  const char* function_name{nullptr};
+  uint32_t line{0};
+  MemoryType memory_type{MemoryType::kSystem};
+  uint64_t allocation_count{0};
+  uint64_t allocated_bytes{0};
+  uint64_t allocated_bytes_in_current_frame{0};
+  uint64_t max_allocated_bytes_per_frame{0};
+};
+struct MemoryAllocationFrameStats {
+  uint64_t frame_index{0};
+  uint64_t allocation_count[kMemoryTypeNum]{}; // indexed by MemoryType
+  uint64_t allocated_bytes[kMemoryTypeNum]{};
+  size_t used_bytes[kMemoryTypeNum]{}; // arena usage at the end of the frame, i.e. frame arena high-water mark.
+};
+uint32_t GetMemoryAllocationCallSiteStatsNum();
+const MemoryAllocationCallSiteStats* GetMemoryAllocationCallSiteStatsList();
+uint32_t GetMemoryAllocationFrameStatsNum();
+const MemoryAllocationFrameStats* GetMemoryAllocationFrameStatsList();
+void ClearMemoryAllocationTelemetry();
+void LogMemoryAllocationTelemetry(const uint32_t call_site_num);
+bool WriteMemoryAllocationTelemetryCsv(const char* const frame_stats_path, const char* const call_site_stats_path);
+bool WriteMemoryAllocationTelemetryJson(const char* const path);
+#endif
 }
 #endif
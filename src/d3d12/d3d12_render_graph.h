@@ -35,6 +35,7 @@ struct RenderPassBuffer {
   uint32_t buffer_index{~0U};
   uint32_t index_offset{0U};
   ResourceStateType state{};
+  SubresourceRange subresource_range{};
 };
 struct RenderPass {
   StrHash name{};
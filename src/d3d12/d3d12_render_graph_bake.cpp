@@ -0,0 +1,691 @@
+#include "d3d12_render_graph_bake.h"
+#include <fstream>
+#include "d3d12_json_parser.h"
+#include "d3d12_render_graph_json_parser.h"
+#include "d3d12_shader_compiler.h"
+#include "illuminate/util/string_table.h"
+namespace illuminate {
+namespace {
+static const uint32_t kBakedRenderGraphMagic = 0x47524c49; // "ILRG"
+struct BakedRenderGraphHeader {
+  uint32_t magic{kBakedRenderGraphMagic};
+  uint32_t version{kBakedRenderGraphVersion};
+  uint32_t size_in_bytes{0};
+  uint32_t str_hash_size{sizeof(StrHash)};
+  uint32_t render_graph_config_size{sizeof(RenderGraphConfig)};
+  uint32_t render_pass_size{sizeof(RenderPass)};
+  uint32_t render_pass_buffer_size{sizeof(RenderPassBuffer)};
+  uint32_t buffer_config_size{sizeof(BufferConfig)};
+  uint32_t cbuffer_param_size{sizeof(CBufferParam)};
+  uint32_t cbuffer_size{sizeof(CBuffer)};
+  uint32_t sampler_desc_size{sizeof(D3D12_SAMPLER_DESC)};
+  uint32_t graph_offset{0};
+  uint32_t buffer_name_list_offset{0};
+  uint32_t buffer_name_hash_list_offset{0};
+  uint32_t render_pass_name_list_offset{0};
+  uint32_t relocation_list_offset{0};
+  uint32_t relocation_num{0};
+};
+struct BlobWriter {
+  std::byte* blob{nullptr}; // nullptr while measuring the blob size.
+  uint32_t size_in_bytes{0};
+  uint32_t* relocation_list{nullptr};
+  uint32_t relocation_num{0};
+};
+auto Reserve(BlobWriter* writer, const size_t bytes, const size_t alignment_in_bytes) {
+  const auto offset = AlignAddress(static_cast<size_t>(writer->size_in_bytes), alignment_in_bytes);
+  writer->size_in_bytes = static_cast<uint32_t>(offset + bytes);
+  return static_cast<uint32_t>(offset);
+}
+template <typename T>
+auto WriteArray(BlobWriter* writer, const T* src, const uint32_t num) {
+  if (src == nullptr || num == 0) { return 0U; }
+  const auto offset = Reserve(writer, sizeof(T) * num, alignof(T));
+  if (writer->blob) {
+    memcpy(writer->blob + offset, src, sizeof(T) * num);
+  }
+  return offset;
+}
+auto WriteString(BlobWriter* writer, const char* const str) {
+  if (str == nullptr) { return 0U; }
+  return WriteArray(writer, str, static_cast<uint32_t>(strlen(str) + 1));
+}
+// offset 0 is the header and never pointed to, so it stands for nullptr.
+void WritePointer(BlobWriter* writer, const size_t slot_offset, const uint32_t target_offset) {
+  if (writer->blob) {
+    *reinterpret_cast<std::uintptr_t*>(writer->blob + slot_offset) = target_offset;
+  }
+  if (target_offset == 0) { return; }
+  if (writer->blob) {
+    writer->relocation_list[writer->relocation_num] = static_cast<uint32_t>(slot_offset);
+  }
+  writer->relocation_num++;
+}
+template <typename F>
+auto WriteStringList(BlobWriter* writer, const uint32_t num, F&& get_string) {
+  if (num == 0) { return 0U; }
+  const auto offset = Reserve(writer, sizeof(std::uintptr_t) * num, alignof(std::uintptr_t));
+  for (uint32_t i = 0; i < num; i++) {
+    WritePointer(writer, offset + sizeof(std::uintptr_t) * i, WriteString(writer, get_string(i)));
+  }
+  return offset;
+}
+auto SerializeRenderGraph(const RenderGraphConfig& graph, const char* const * buffer_name_list, const StrHash* buffer_name_hash_list, BlobWriter* writer) {
+  const auto header_offset = Reserve(writer, sizeof(BakedRenderGraphHeader), alignof(BakedRenderGraphHeader));
+  BakedRenderGraphHeader header{};
+  const auto graph_offset = WriteArray(writer, &graph, 1);
+  header.graph_offset = graph_offset;
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, window_title), WriteString(writer, graph.window_title));
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, command_queue_name), WriteArray(writer, graph.command_queue_name, graph.command_queue_num));
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, command_queue_type), WriteArray(writer, graph.command_queue_type, graph.command_queue_num));
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, command_queue_priority), WriteArray(writer, graph.command_queue_priority, graph.command_queue_num));
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, command_list_num_per_queue), WriteArray(writer, graph.command_list_num_per_queue, graph.command_queue_num));
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, buffer_list), WriteArray(writer, graph.buffer_list, graph.buffer_num));
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, sampler_list), WriteArray(writer, graph.sampler_list, graph.sampler_num));
+  const auto render_pass_list_offset = WriteArray(writer, graph.render_pass_list, graph.render_pass_num);
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, render_pass_list), render_pass_list_offset);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& pass = graph.render_pass_list[i];
+    const auto pass_offset = render_pass_list_offset + sizeof(RenderPass) * i;
+    WritePointer(writer, pass_offset + offsetof(RenderPass, buffer_list), WriteArray(writer, pass.buffer_list, pass.buffer_num));
+    WritePointer(writer, pass_offset + offsetof(RenderPass, signal_queue_index), WriteArray(writer, pass.signal_queue_index, pass.wait_pass_num));
+    WritePointer(writer, pass_offset + offsetof(RenderPass, signal_pass_index), WriteArray(writer, pass.signal_pass_index, pass.wait_pass_num));
+    WritePointer(writer, pass_offset + offsetof(RenderPass, sampler_index_list), WriteArray(writer, pass.sampler_index_list, pass.sampler_num));
+    WritePointer(writer, pass_offset + offsetof(RenderPass, flip_pingpong_index_list), WriteArray(writer, pass.flip_pingpong_index_list, pass.flip_pingpong_num));
+  }
+  const auto cbuffer_list_offset = WriteArray(writer, graph.cbuffer_list.array, graph.cbuffer_list.size);
+  WritePointer(writer, graph_offset + offsetof(RenderGraphConfig, cbuffer_list) + offsetof(ArrayOf<CBuffer>, array), cbuffer_list_offset);
+  for (uint32_t i = 0; i < graph.cbuffer_list.size; i++) {
+    const auto& params = graph.cbuffer_list.array[i].params;
+    const auto params_offset = WriteArray(writer, params.array, params.size);
+    WritePointer(writer, cbuffer_list_offset + sizeof(CBuffer) * i + offsetof(CBuffer, params) + offsetof(ArrayOf<CBufferParam>, array), params_offset);
+    for (uint32_t p = 0; p < params.size; p++) {
+      WritePointer(writer, params_offset + sizeof(CBufferParam) * p + offsetof(CBufferParam, name), WriteString(writer, params.array[p].name));
+    }
+  }
+  header.buffer_name_hash_list_offset = WriteArray(writer, buffer_name_hash_list, graph.buffer_num);
+  header.buffer_name_list_offset = WriteStringList(writer, graph.buffer_num, [buffer_name_list](const uint32_t i) { return buffer_name_list[i]; });
+  // pass names are only held by the string table.
+  header.render_pass_name_list_offset = WriteStringList(writer, graph.render_pass_num, [&graph](const uint32_t i) { return GetInternedString(graph.render_pass_list[i].name); });
+  header.relocation_list_offset = Reserve(writer, sizeof(uint32_t) * writer->relocation_num, alignof(uint32_t));
+  header.relocation_num = writer->relocation_num;
+  header.size_in_bytes = writer->size_in_bytes;
+  if (writer->blob) {
+    memcpy(writer->blob + header_offset, &header, sizeof(header));
+  }
+  return header;
+}
+template <typename T>
+constexpr auto IsBakedRenderGraphArrayValid(const size_t offset, const size_t num, const size_t size_in_bytes) {
+  return offset % alignof(T) == 0 && offset <= size_in_bytes && sizeof(T) * num <= size_in_bytes - offset;
+}
+auto IsBakedRenderGraphHeaderValid(const BakedRenderGraphHeader& header, const size_t size_in_bytes) {
+  const BakedRenderGraphHeader expected{};
+  if (header.magic != expected.magic) {
+    logerror("not a baked render graph");
+    return false;
+  }
+  if (header.version != expected.version) {
+    logerror("baked render graph version mismatch {} (expected {})", header.version, expected.version);
+    return false;
+  }
+  if (header.str_hash_size != expected.str_hash_size
+      || header.render_graph_config_size != expected.render_graph_config_size
+      || header.render_pass_size != expected.render_pass_size
+      || header.render_pass_buffer_size != expected.render_pass_buffer_size
+      || header.buffer_config_size != expected.buffer_config_size
+      || header.cbuffer_param_size != expected.cbuffer_param_size
+      || header.cbuffer_size != expected.cbuffer_size
+      || header.sampler_desc_size != expected.sampler_desc_size) {
+    logerror("baked render graph layout mismatch, rebake with the current build");
+    return false;
+  }
+  if (header.size_in_bytes != size_in_bytes) {
+    logerror("baked render graph size mismatch {} {}", header.size_in_bytes, size_in_bytes);
+    return false;
+  }
+  if (header.graph_offset == 0
+      || !IsBakedRenderGraphArrayValid<RenderGraphConfig>(header.graph_offset, 1, size_in_bytes)
+      || !IsBakedRenderGraphArrayValid<uint32_t>(header.relocation_list_offset, header.relocation_num, size_in_bytes)) {
+    logerror("baked render graph offset out of range graph:{} relocation:{}x{} size:{}", header.graph_offset, header.relocation_list_offset, header.relocation_num, size_in_bytes);
+    return false;
+  }
+  return true;
+}
+// name lists are optional (offset 0) when the graph has no buffers or passes.
+auto IsBakedRenderGraphNameListValid(const BakedRenderGraphHeader& header, const RenderGraphConfig& graph, const size_t size_in_bytes) {
+  const auto buffer_num = static_cast<size_t>(graph.buffer_num);
+  const auto render_pass_num = static_cast<size_t>(graph.render_pass_num);
+  if ((buffer_num > 0 && (header.buffer_name_list_offset == 0 || header.buffer_name_hash_list_offset == 0))
+      || (render_pass_num > 0 && header.render_pass_name_list_offset == 0)
+      || !IsBakedRenderGraphArrayValid<std::uintptr_t>(header.buffer_name_list_offset, buffer_num, size_in_bytes)
+      || !IsBakedRenderGraphArrayValid<StrHash>(header.buffer_name_hash_list_offset, buffer_num, size_in_bytes)
+      || !IsBakedRenderGraphArrayValid<std::uintptr_t>(header.render_pass_name_list_offset, render_pass_num, size_in_bytes)) {
+    logerror("baked render graph name list out of range buffer:{} hash:{} pass:{} size:{}", header.buffer_name_list_offset, header.buffer_name_hash_list_offset, header.render_pass_name_list_offset, size_in_bytes);
+    return false;
+  }
+  return true;
+}
+// every relocated slot must lie in the blob and point back into it before any of them is patched.
+auto IsBakedRenderGraphRelocationValid(const std::byte* blob, const BakedRenderGraphHeader& header, const size_t size_in_bytes) {
+  const auto relocation_list = reinterpret_cast<const uint32_t*>(blob + header.relocation_list_offset);
+  for (uint32_t i = 0; i < header.relocation_num; i++) {
+    const auto slot_offset = relocation_list[i];
+    if (!IsBakedRenderGraphArrayValid<std::uintptr_t>(slot_offset, 1, size_in_bytes)) {
+      logerror("baked render graph relocation slot out of range {} {} size:{}", i, slot_offset, size_in_bytes);
+      return false;
+    }
+    const auto target_offset = *reinterpret_cast<const std::uintptr_t*>(blob + slot_offset);
+    if (target_offset < sizeof(BakedRenderGraphHeader) || target_offset >= size_in_bytes) {
+      logerror("baked render graph relocation target out of range {} {} size:{}", i, target_offset, size_in_bytes);
+      return false;
+    }
+  }
+  return true;
+}
+// pointer slots are read before patching, i.e. while they hold offsets from the blob head (0 for nullptr).
+struct BakedPointerValidator {
+  const std::byte* blob{nullptr};
+  size_t size_in_bytes{0};
+  const bool* relocated{nullptr}; // per std::uintptr_t slot
+  uint32_t pointer_num{0};        // non-null slots visited
+};
+auto GetBakedPointerOffset(const BakedPointerValidator& validator, const size_t slot_offset) {
+  return *reinterpret_cast<const std::uintptr_t*>(validator.blob + slot_offset);
+}
+auto IsBakedPointerSlotValid(const size_t slot_offset, BakedPointerValidator* validator) {
+  if (GetBakedPointerOffset(*validator, slot_offset) == 0) { return true; }
+  validator->pointer_num++;
+  return validator->relocated[slot_offset / sizeof(std::uintptr_t)];
+}
+// arrays with elements must not be null and must fit in the blob.
+template <typename T>
+auto IsBakedArrayValid(const size_t slot_offset, const size_t num, BakedPointerValidator* validator) {
+  if (!IsBakedPointerSlotValid(slot_offset, validator)) { return false; }
+  const auto target_offset = GetBakedPointerOffset(*validator, slot_offset);
+  if (target_offset == 0) { return num == 0; }
+  return IsBakedRenderGraphArrayValid<T>(target_offset, num, validator->size_in_bytes);
+}
+auto IsBakedStringValid(const size_t slot_offset, BakedPointerValidator* validator) {
+  if (!IsBakedPointerSlotValid(slot_offset, validator)) { return false; }
+  const auto target_offset = GetBakedPointerOffset(*validator, slot_offset);
+  if (target_offset == 0) { return true; }
+  return memchr(validator->blob + target_offset, 0, validator->size_in_bytes - target_offset) != nullptr;
+}
+// every pointer slot in the graph and the name lists must be null or relocated, arrays must fit in the blob with the counts stored next to them,
+// and no other slot may be relocated (e.g. a count, which would be patched after this check).
+auto IsBakedRenderGraphLayoutValid(const std::byte* blob, const BakedRenderGraphHeader& header, const size_t size_in_bytes) {
+  FrameMemoryCheckpoint checkpoint;
+  auto relocated = AllocateAndFillArrayFrame(size_in_bytes / sizeof(std::uintptr_t), false);
+  const auto relocation_list = reinterpret_cast<const uint32_t*>(blob + header.relocation_list_offset);
+  for (uint32_t i = 0; i < header.relocation_num; i++) {
+    auto& slot = relocated[relocation_list[i] / sizeof(std::uintptr_t)];
+    if (slot) {
+      logerror("baked render graph relocation duplicated {} {}", i, relocation_list[i]);
+      return false;
+    }
+    slot = true;
+  }
+  BakedPointerValidator validator{
+    .blob = blob,
+    .size_in_bytes = size_in_bytes,
+    .relocated = relocated,
+  };
+  const auto graph_offset = static_cast<size_t>(header.graph_offset);
+  const auto& graph = *reinterpret_cast<const RenderGraphConfig*>(blob + graph_offset);
+  const auto cbuffer_list_slot_offset = graph_offset + offsetof(RenderGraphConfig, cbuffer_list) + offsetof(ArrayOf<CBuffer>, array);
+  if (!IsBakedStringValid(graph_offset + offsetof(RenderGraphConfig, window_title), &validator)
+      || !IsBakedArrayValid<StrHash>(graph_offset + offsetof(RenderGraphConfig, command_queue_name), graph.command_queue_num, &validator)
+      || !IsBakedArrayValid<D3D12_COMMAND_LIST_TYPE>(graph_offset + offsetof(RenderGraphConfig, command_queue_type), graph.command_queue_num, &validator)
+      || !IsBakedArrayValid<D3D12_COMMAND_QUEUE_PRIORITY>(graph_offset + offsetof(RenderGraphConfig, command_queue_priority), graph.command_queue_num, &validator)
+      || !IsBakedArrayValid<uint32_t>(graph_offset + offsetof(RenderGraphConfig, command_list_num_per_queue), graph.command_queue_num, &validator)
+      || !IsBakedArrayValid<BufferConfig>(graph_offset + offsetof(RenderGraphConfig, buffer_list), graph.buffer_num, &validator)
+      || !IsBakedArrayValid<D3D12_SAMPLER_DESC>(graph_offset + offsetof(RenderGraphConfig, sampler_list), graph.sampler_num, &validator)
+      || !IsBakedArrayValid<RenderPass>(graph_offset + offsetof(RenderGraphConfig, render_pass_list), graph.render_pass_num, &validator)
+      || !IsBakedArrayValid<CBuffer>(cbuffer_list_slot_offset, graph.cbuffer_list.size, &validator)) {
+    logerror("baked render graph arrays out of range buffer:{} pass:{} sampler:{} cbuffer:{} size:{}", graph.buffer_num, graph.render_pass_num, graph.sampler_num, graph.cbuffer_list.size, size_in_bytes);
+    return false;
+  }
+  const auto render_pass_list_offset = GetBakedPointerOffset(validator, graph_offset + offsetof(RenderGraphConfig, render_pass_list));
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto pass_offset = render_pass_list_offset + sizeof(RenderPass) * i;
+    const auto& pass = *reinterpret_cast<const RenderPass*>(blob + pass_offset);
+    if (!IsBakedArrayValid<RenderPassBuffer>(pass_offset + offsetof(RenderPass, buffer_list), pass.buffer_num, &validator)
+        || !IsBakedArrayValid<uint32_t>(pass_offset + offsetof(RenderPass, signal_queue_index), pass.wait_pass_num, &validator)
+        || !IsBakedArrayValid<uint32_t>(pass_offset + offsetof(RenderPass, signal_pass_index), pass.wait_pass_num, &validator)
+        || !IsBakedArrayValid<uint32_t>(pass_offset + offsetof(RenderPass, sampler_index_list), pass.sampler_num, &validator)
+        || !IsBakedArrayValid<uint32_t>(pass_offset + offsetof(RenderPass, flip_pingpong_index_list), pass.flip_pingpong_num, &validator)) {
+      logerror("baked render graph pass {} arrays out of range buffer:{} wait:{} sampler:{} flip:{}", i, pass.buffer_num, pass.wait_pass_num, pass.sampler_num, pass.flip_pingpong_num);
+      return false;
+    }
+  }
+  const auto cbuffer_list_offset = GetBakedPointerOffset(validator, cbuffer_list_slot_offset);
+  for (uint32_t i = 0; i < graph.cbuffer_list.size; i++) {
+    const auto cbuffer_offset = cbuffer_list_offset + sizeof(CBuffer) * i;
+    const auto& params = reinterpret_cast<const CBuffer*>(blob + cbuffer_offset)->params;
+    const auto params_slot_offset = cbuffer_offset + offsetof(CBuffer, params) + offsetof(ArrayOf<CBufferParam>, array);
+    if (!IsBakedArrayValid<CBufferParam>(params_slot_offset, params.size, &validator)) {
+      logerror("baked render graph cbuffer {} params out of range {}", i, params.size);
+      return false;
+    }
+    const auto params_offset = GetBakedPointerOffset(validator, params_slot_offset);
+    for (uint32_t p = 0; p < params.size; p++) {
+      if (!IsBakedStringValid(params_offset + sizeof(CBufferParam) * p + offsetof(CBufferParam, name), &validator)) {
+        logerror("baked render graph cbuffer {} param {} name out of range", i, p);
+        return false;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    if (!IsBakedStringValid(header.buffer_name_list_offset + sizeof(std::uintptr_t) * i, &validator)) {
+      logerror("baked render graph buffer name {} out of range", i);
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    if (!IsBakedStringValid(header.render_pass_name_list_offset + sizeof(std::uintptr_t) * i, &validator)) {
+      logerror("baked render graph pass name {} out of range", i);
+      return false;
+    }
+  }
+  if (validator.pointer_num != header.relocation_num) {
+    logerror("baked render graph relocates {} slots other than pointers", header.relocation_num - validator.pointer_num);
+    return false;
+  }
+  return true;
+}
+} // namespace
+ArrayOf<std::byte> BakeRenderGraph(const RenderGraphConfig& graph, const char* const * buffer_name_list, const StrHash* buffer_name_hash_list, const MemoryType& memory_type) {
+  BlobWriter measure{};
+  const auto measured_header = SerializeRenderGraph(graph, buffer_name_list, buffer_name_hash_list, &measure);
+  auto blob = AllocateArray<std::byte>(memory_type, measure.size_in_bytes, alignof(std::uintptr_t));
+  memset(blob, 0, measure.size_in_bytes);
+  BlobWriter writer{
+    .blob = blob,
+    .relocation_list = reinterpret_cast<uint32_t*>(blob + measured_header.relocation_list_offset),
+  };
+  SerializeRenderGraph(graph, buffer_name_list, buffer_name_hash_list, &writer);
+  assert(writer.size_in_bytes == measure.size_in_bytes);
+  assert(writer.relocation_num == measure.relocation_num);
+  return CreateArray(measure.size_in_bytes, blob);
+}
+bool WriteBakedRenderGraph(const char* const path, const ArrayOf<std::byte>& blob) {
+  std::ofstream file(path, std::ios::out | std::ios::binary);
+  if (!file) {
+    logerror("failed to open {}", path);
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(blob.array), blob.size);
+  return file.good();
+}
+std::pair<const char* const *, const StrHash*> LoadBakedRenderGraph(std::byte* blob, const size_t size_in_bytes, RenderGraphConfig* graph) {
+  if (blob == nullptr || size_in_bytes < sizeof(BakedRenderGraphHeader)) {
+    logerror("invalid baked render graph size {}", size_in_bytes);
+    return {nullptr, nullptr};
+  }
+  const auto header = *reinterpret_cast<const BakedRenderGraphHeader*>(blob);
+  if (!IsBakedRenderGraphHeaderValid(header, size_in_bytes)) {
+    return {nullptr, nullptr};
+  }
+  if (!IsBakedRenderGraphNameListValid(header, *reinterpret_cast<const RenderGraphConfig*>(blob + header.graph_offset), size_in_bytes)) {
+    return {nullptr, nullptr};
+  }
+  if (!IsBakedRenderGraphRelocationValid(blob, header, size_in_bytes)) {
+    return {nullptr, nullptr};
+  }
+  if (!IsBakedRenderGraphLayoutValid(blob, header, size_in_bytes)) {
+    return {nullptr, nullptr};
+  }
+  const auto relocation_list = reinterpret_cast<const uint32_t*>(blob + header.relocation_list_offset);
+  const auto blob_head = reinterpret_cast<std::uintptr_t>(blob);
+  for (uint32_t i = 0; i < header.relocation_num; i++) {
+    *reinterpret_cast<std::uintptr_t*>(blob + relocation_list[i]) += blob_head;
+  }
+  *graph = *reinterpret_cast<const RenderGraphConfig*>(blob + header.graph_offset);
+  // register names as ParseRenderGraphJson() does so that GetInternedString() and pointer comparison work the same.
+  auto buffer_name_list = reinterpret_cast<const char**>(blob + header.buffer_name_list_offset);
+  auto buffer_name_hash_list = reinterpret_cast<const StrHash*>(blob + header.buffer_name_hash_list_offset);
+  for (uint32_t i = 0; i < graph->buffer_num; i++) {
+    buffer_name_list[i] = InternString(buffer_name_list[i], buffer_name_hash_list[i]);
+  }
+  auto render_pass_name_list = reinterpret_cast<const char* const *>(blob + header.render_pass_name_list_offset);
+  for (uint32_t i = 0; i < graph->render_pass_num; i++) {
+    if (render_pass_name_list[i] == nullptr) { continue; }
+    InternString(render_pass_name_list[i], graph->render_pass_list[i].name);
+  }
+  for (uint32_t i = 0; i < graph->cbuffer_list.size; i++) {
+    auto& params = graph->cbuffer_list.array[i].params;
+    for (uint32_t p = 0; p < params.size; p++) {
+      params.array[p].name = InternString(params.array[p].name, params.array[p].name_hash);
+    }
+  }
+  return {buffer_name_list, buffer_name_hash_list};
+}
+bool BakedRenderGraphMapping::Init(const char* const path) {
+  file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    logerror("failed to open {}", path);
+    return false;
+  }
+  LARGE_INTEGER file_size{};
+  if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart == 0) {
+    logerror("invalid file size {}", path);
+    Term();
+    return false;
+  }
+  mapping_ = CreateFileMappingA(file_, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping_ == nullptr) {
+    logerror("CreateFileMapping failed {} {}", path, GetLastError());
+    Term();
+    return false;
+  }
+  data_ = static_cast<std::byte*>(MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, 0));
+  if (data_ == nullptr) {
+    logerror("MapViewOfFile failed {} {}", path, GetLastError());
+    Term();
+    return false;
+  }
+  size_in_bytes_ = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+void BakedRenderGraphMapping::Term() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+    data_ = nullptr;
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+    mapping_ = nullptr;
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+  }
+  size_in_bytes_ = 0;
+}
+bool BakeRenderGraph(const char* const render_graph_json_path, const char* const material_json_path, const char* const dst_path) {
+  nlohmann::json render_graph_json;
+  if (!LoadJsonFile(render_graph_json_path, &render_graph_json)) { return false; }
+  nlohmann::json material_json;
+  if (!LoadJsonFile(material_json_path, &material_json)) { return false; }
+  const auto material_config = ParseMaterialConfigInfo(material_json);
+  const auto material_num = GetUint32(material_json.at("materials").size());
+  if (ValidateRenderGraphJson(render_graph_json, material_num, material_config.material_hash_list, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size > 0) {
+    logerror("invalid render graph {}", render_graph_json_path);
+    return false;
+  }
+  RenderGraphConfig graph{};
+  auto [buffer_name_list, buffer_name_hash_list] = ParseRenderGraphJson(render_graph_json,
+                                                                        material_num,
+                                                                        material_config.material_hash_list,
+                                                                        material_config.rtv_format_list,
+                                                                        material_config.dsv_format,
+                                                                        &graph);
+  const auto blob = BakeRenderGraph(graph, buffer_name_list, buffer_name_hash_list, MemoryType::kFrame);
+  if (!WriteBakedRenderGraph(dst_path, blob)) { return false; }
+  loginfo("baked {} into {} ({} bytes)", render_graph_json_path, dst_path, blob.size);
+  return true;
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+#include <filesystem>
+#include "d3d12_test_util.h"
+namespace {
+template <typename T>
+void CheckArrayEqual(const uint32_t num, const T* a, const T* b) {
+  if (num == 0) { return; }
+  CHECK_EQ(memcmp(a, b, sizeof(T) * num), 0);
+}
+void CheckRenderGraphConfigEqual(const illuminate::RenderGraphConfig& a, const illuminate::RenderGraphConfig& b) {
+  using namespace illuminate; // NOLINT
+  CHECK_EQ(a.frame_buffer_num, b.frame_buffer_num);
+  CHECK_EQ(a.primarybuffer_width, b.primarybuffer_width);
+  CHECK_EQ(a.primarybuffer_height, b.primarybuffer_height);
+  CHECK_EQ(a.primarybuffer_format, b.primarybuffer_format);
+  CHECK_EQ(std::string_view(a.window_title), std::string_view(b.window_title));
+  CHECK_EQ(a.window_width, b.window_width);
+  CHECK_EQ(a.window_height, b.window_height);
+  CHECK_EQ(a.command_queue_num, b.command_queue_num);
+  CheckArrayEqual(a.command_queue_num, a.command_queue_name, b.command_queue_name);
+  CheckArrayEqual(a.command_queue_num, a.command_queue_type, b.command_queue_type);
+  CheckArrayEqual(a.command_queue_num, a.command_queue_priority, b.command_queue_priority);
+  CheckArrayEqual(a.command_queue_num, a.command_list_num_per_queue, b.command_list_num_per_queue);
+  CheckArrayEqual(kCommandQueueTypeNum, a.command_allocator_num_per_queue_type, b.command_allocator_num_per_queue_type);
+  CHECK_EQ(a.swapchain_command_queue_index, b.swapchain_command_queue_index);
+  CHECK_EQ(a.swapchain_format, b.swapchain_format);
+  CHECK_EQ(a.swapchain_usage, b.swapchain_usage);
+  CHECK_EQ(a.render_pass_num, b.render_pass_num);
+  for (uint32_t i = 0; i < a.render_pass_num; i++) {
+    const auto& pa = a.render_pass_list[i];
+    const auto& pb = b.render_pass_list[i];
+    CHECK_EQ(pa.name, pb.name);
+    CHECK_EQ(pa.type, pb.type);
+    CHECK_EQ(pa.enabled, pb.enabled);
+    CHECK_EQ(pa.index, pb.index);
+    CHECK_EQ(pa.command_queue_index, pb.command_queue_index);
+    CHECK_EQ(pa.buffer_num, pb.buffer_num);
+    CheckArrayEqual(pa.buffer_num, pa.buffer_list, pb.buffer_list);
+    CHECK_EQ(pa.max_buffer_index_offset, pb.max_buffer_index_offset);
+    CHECK_EQ(pa.material, pb.material);
+    CHECK_EQ(pa.sends_signal, pb.sends_signal);
+    CHECK_EQ(pa.wait_pass_num, pb.wait_pass_num);
+    CheckArrayEqual(pa.wait_pass_num, pa.signal_queue_index, pb.signal_queue_index);
+    CheckArrayEqual(pa.wait_pass_num, pa.signal_pass_index, pb.signal_pass_index);
+    CHECK_EQ(pa.sampler_num, pb.sampler_num);
+    CheckArrayEqual(pa.sampler_num, pa.sampler_index_list, pb.sampler_index_list);
+    CHECK_EQ(pa.flip_pingpong_num, pb.flip_pingpong_num);
+    CheckArrayEqual(pa.flip_pingpong_num, pa.flip_pingpong_index_list, pb.flip_pingpong_index_list);
+  }
+  CHECK_EQ(a.buffer_num, b.buffer_num);
+  CheckArrayEqual(a.buffer_num, a.buffer_list, b.buffer_list);
+  CHECK_EQ(a.sampler_num, b.sampler_num);
+  CheckArrayEqual(a.sampler_num, a.sampler_list, b.sampler_list);
+  CheckArrayEqual(kDescriptorTypeNum, a.descriptor_handle_num_per_type, b.descriptor_handle_num_per_type);
+  CHECK_EQ(a.gpu_handle_num_view, b.gpu_handle_num_view);
+  CHECK_EQ(a.gpu_handle_num_sampler, b.gpu_handle_num_sampler);
+  CHECK_EQ(a.max_model_num, b.max_model_num);
+  CHECK_EQ(a.max_material_num, b.max_material_num);
+  CHECK_EQ(a.max_mipmap_num, b.max_mipmap_num);
+  CHECK_EQ(a.timestamp_query_dst_resource_num, b.timestamp_query_dst_resource_num);
+  CHECK_EQ(a.cbuffer_list.size, b.cbuffer_list.size);
+  for (uint32_t i = 0; i < a.cbuffer_list.size; i++) {
+    const auto& ca = a.cbuffer_list.array[i];
+    const auto& cb = b.cbuffer_list.array[i];
+    CHECK_EQ(ca.buffer_index, cb.buffer_index);
+    CHECK_EQ(ca.need_ui_param_num, cb.need_ui_param_num);
+    CHECK_EQ(ca.params.size, cb.params.size);
+    for (uint32_t p = 0; p < ca.params.size; p++) {
+      CHECK_EQ(ca.params.array[p].name, cb.params.array[p].name); // interned
+      CHECK_EQ(ca.params.array[p].name_hash, cb.params.array[p].name_hash);
+      CHECK_EQ(ca.params.array[p].type, cb.params.array[p].type);
+      CHECK_EQ(ca.params.array[p].min, cb.params.array[p].min);
+      CHECK_EQ(ca.params.array[p].max, cb.params.array[p].max);
+      CHECK_EQ(ca.params.array[p].initial_val, cb.params.array[p].initial_val);
+      CHECK_EQ(ca.params.array[p].size_in_bytes, cb.params.array[p].size_in_bytes);
+    }
+  }
+}
+} // namespace
+TEST_CASE("baked render graph") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const char* render_graph_json_path = nullptr;
+  SUBCASE("deferred.json") {
+    render_graph_json_path = "deferred.json";
+  }
+  SUBCASE("forward.json") {
+    render_graph_json_path = "forward.json";
+  }
+  const auto material_json = LoadTestJson("material.json");
+  const auto material_config = ParseMaterialConfigInfo(material_json);
+  RenderGraphConfig graph_json{};
+  auto [buffer_name_list_json, buffer_name_hash_list_json] = ParseRenderGraphJson(LoadTestJson(render_graph_json_path),
+                                                                                  GetUint32(material_json.at("materials").size()),
+                                                                                  material_config.material_hash_list,
+                                                                                  material_config.rtv_format_list,
+                                                                                  material_config.dsv_format,
+                                                                                  &graph_json);
+  const auto blob = BakeRenderGraph(graph_json, buffer_name_list_json, buffer_name_hash_list_json, MemoryType::kFrame);
+  CHECK_GT(blob.size, sizeof(RenderGraphConfig));
+  {
+    // baking is deterministic
+    const auto blob2 = BakeRenderGraph(graph_json, buffer_name_list_json, buffer_name_hash_list_json, MemoryType::kFrame);
+    CHECK_EQ(blob2.size, blob.size);
+    CHECK_EQ(memcmp(blob2.array, blob.array, blob.size), 0);
+  }
+  const auto baked_path_str = (std::filesystem::temp_directory_path() / "baked_render_graph_test.bin").string();
+  const char* baked_path = baked_path_str.c_str();
+  CHECK_UNARY(WriteBakedRenderGraph(baked_path, blob));
+  BakedRenderGraphMapping mapping;
+  CHECK_UNARY(mapping.Init(baked_path));
+  CHECK_EQ(mapping.GetSize(), blob.size);
+  RenderGraphConfig graph_baked{};
+  auto [buffer_name_list_baked, buffer_name_hash_list_baked] = LoadBakedRenderGraph(mapping.GetData(), mapping.GetSize(), &graph_baked);
+  CHECK_NE(buffer_name_list_baked, nullptr);
+  CHECK_NE(buffer_name_hash_list_baked, nullptr);
+  CheckRenderGraphConfigEqual(graph_json, graph_baked);
+  for (uint32_t i = 0; i < graph_json.buffer_num; i++) {
+    CHECK_EQ(buffer_name_hash_list_baked[i], buffer_name_hash_list_json[i]);
+    CHECK_EQ(buffer_name_list_baked[i], buffer_name_list_json[i]); // interned
+  }
+  for (uint32_t i = 0; i < graph_baked.render_pass_num; i++) {
+    CHECK_EQ(GetInternedString(graph_baked.render_pass_list[i].name), GetInternedString(graph_json.render_pass_list[i].name));
+  }
+  mapping.Term();
+  // the mapping is copy-on-write, the file stays relocatable.
+  BakedRenderGraphMapping mapping2;
+  CHECK_UNARY(mapping2.Init(baked_path));
+  CHECK_EQ(memcmp(mapping2.GetData(), blob.array, blob.size), 0);
+  mapping2.Term();
+  std::filesystem::remove(baked_path);
+  // invalid blobs are rejected.
+  {
+    RenderGraphConfig graph_invalid{};
+    auto blob_copy = AllocateArrayFrame<std::byte>(blob.size);
+    memcpy(blob_copy, blob.array, blob.size);
+    CHECK_EQ(LoadBakedRenderGraph(blob_copy, blob.size - 1, &graph_invalid).first, nullptr);
+    reinterpret_cast<uint32_t*>(blob_copy)[1] = kBakedRenderGraphVersion + 1;
+    CHECK_EQ(LoadBakedRenderGraph(blob_copy, blob.size, &graph_invalid).first, nullptr);
+    reinterpret_cast<uint32_t*>(blob_copy)[0] = 0;
+    CHECK_EQ(LoadBakedRenderGraph(blob_copy, blob.size, &graph_invalid).first, nullptr);
+    CHECK_EQ(LoadBakedRenderGraph(nullptr, 0, &graph_invalid).first, nullptr);
+  }
+  // truncated or corrupted blobs are rejected before any pointer is patched.
+  {
+    RenderGraphConfig graph_invalid{};
+    const auto header = *reinterpret_cast<const BakedRenderGraphHeader*>(blob.array);
+    auto blob_copy = AllocateArrayFrame<std::byte>(blob.size);
+    auto blob_corrupted = AllocateArrayFrame<std::byte>(blob.size);
+    const auto load_corrupted_blob = [&](const uint32_t size_in_bytes, auto&& corrupt) {
+      memcpy(blob_copy, blob.array, blob.size);
+      auto corrupted_header = reinterpret_cast<BakedRenderGraphHeader*>(blob_copy);
+      corrupted_header->size_in_bytes = size_in_bytes;
+      corrupt(corrupted_header);
+      memcpy(blob_corrupted, blob_copy, blob.size);
+      const auto result = LoadBakedRenderGraph(blob_copy, size_in_bytes, &graph_invalid);
+      // the blob is left untouched.
+      CHECK_EQ(memcmp(blob_copy, blob_corrupted, blob.size), 0);
+      return result.first == nullptr && result.second == nullptr;
+    };
+    const auto keep_header = [](BakedRenderGraphHeader*) {};
+    // truncated right after the header, inside the graph and before the relocation list.
+    CHECK_UNARY(load_corrupted_blob(sizeof(BakedRenderGraphHeader), keep_header));
+    CHECK_UNARY(load_corrupted_blob(header.graph_offset + sizeof(RenderGraphConfig) / 2, keep_header));
+    CHECK_UNARY(load_corrupted_blob(header.relocation_list_offset, keep_header));
+    // truncated before the name lists with an intact relocation list.
+    CHECK_UNARY(load_corrupted_blob(header.buffer_name_list_offset, [&](BakedRenderGraphHeader* h) { h->relocation_num = 0; h->relocation_list_offset = header.buffer_name_list_offset; }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [](BakedRenderGraphHeader* h) { h->buffer_name_list_offset = h->size_in_bytes; }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [](BakedRenderGraphHeader* h) { h->buffer_name_hash_list_offset = h->size_in_bytes - 4; }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [](BakedRenderGraphHeader* h) { h->render_pass_name_list_offset = ~0U - 7; }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [](BakedRenderGraphHeader* h) { h->relocation_num = ~0U; }));
+    // relocation slots and targets outside the blob.
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      reinterpret_cast<uint32_t*>(blob_copy + header.relocation_list_offset)[header.relocation_num - 1] = static_cast<uint32_t>(blob.size);
+    }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      const auto slot_offset = reinterpret_cast<const uint32_t*>(blob_copy + header.relocation_list_offset)[0];
+      *reinterpret_cast<std::uintptr_t*>(blob_copy + slot_offset) = blob.size;
+    }));
+    // struct layouts.
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [](BakedRenderGraphHeader* h) { h->cbuffer_size++; }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [](BakedRenderGraphHeader* h) { h->sampler_desc_size++; }));
+    // counts not matching their arrays.
+    const auto get_pointer_offset = [&](const size_t slot_offset) { return static_cast<size_t>(*reinterpret_cast<const std::uintptr_t*>(blob.array + slot_offset)); };
+    const auto render_pass_list_offset = get_pointer_offset(header.graph_offset + offsetof(RenderGraphConfig, render_pass_list));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      reinterpret_cast<RenderGraphConfig*>(blob_copy + header.graph_offset)->sampler_num = graph_json.sampler_num + static_cast<uint32_t>(blob.size / sizeof(D3D12_SAMPLER_DESC));
+    }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      reinterpret_cast<RenderGraphConfig*>(blob_copy + header.graph_offset)->command_queue_num = ~0U;
+    }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      reinterpret_cast<RenderPass*>(blob_copy + render_pass_list_offset)->buffer_num = ~0U;
+    }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      reinterpret_cast<RenderPass*>(blob_copy + render_pass_list_offset + sizeof(RenderPass) * (graph_json.render_pass_num - 1))->wait_pass_num = ~0U;
+    }));
+    if (graph_json.cbuffer_list.size > 0) {
+      const auto cbuffer_list_offset = get_pointer_offset(header.graph_offset + offsetof(RenderGraphConfig, cbuffer_list) + offsetof(ArrayOf<CBuffer>, array));
+      CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+        reinterpret_cast<RenderGraphConfig*>(blob_copy + header.graph_offset)->cbuffer_list.size = ~0U;
+      }));
+      CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+        reinterpret_cast<CBuffer*>(blob_copy + cbuffer_list_offset)->params.size = ~0U;
+      }));
+    }
+    // pointer slots left out of or duplicated in the relocation table, and relocated counts.
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader* h) { h->relocation_num--; }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      auto relocation_list = reinterpret_cast<uint32_t*>(blob_copy + header.relocation_list_offset);
+      relocation_list[1] = relocation_list[0];
+    }));
+    CHECK_UNARY(load_corrupted_blob(static_cast<uint32_t>(blob.size), [&](BakedRenderGraphHeader*) {
+      // frame_buffer_num and primarybuffer_width share the first pointer sized slot of the graph.
+      *reinterpret_cast<std::uintptr_t*>(blob_copy + header.graph_offset) = header.graph_offset;
+      reinterpret_cast<uint32_t*>(blob_copy + header.relocation_list_offset)[0] = header.graph_offset;
+    }));
+    // the unmodified copy still loads.
+    memcpy(blob_copy, blob.array, blob.size);
+    CHECK_NE(LoadBakedRenderGraph(blob_copy, blob.size, &graph_invalid).first, nullptr);
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("baked render graph load benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t num = 1000;
+  const auto baked_path_str = (std::filesystem::temp_directory_path() / "baked_render_graph_benchmark.bin").string();
+  const char* baked_path = baked_path_str.c_str();
+  CHECK_UNARY(BakeRenderGraph("deferred.json", "material.json", baked_path));
+  ResetAllocation(MemoryType::kFrame);
+  const auto material_json = LoadTestJson("material.json");
+  const auto material_num = GetUint32(material_json.at("materials").size());
+  const auto material_config = ParseMaterialConfigInfo(material_json);
+  std::string render_graph_json_text;
+  {
+    std::ifstream file("deferred.json");
+    render_graph_json_text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  uint64_t sum = 0;
+  // json parsing allocates persistent arrays from system memory, which is not reclaimed until the end.
+  const auto json_load = MeasureTimePerOp<std::micro>(num, [&]() {
+    for (uint32_t i = 0; i < num; i++) {
+      RenderGraphConfig graph{};
+      ParseRenderGraphJson(nlohmann::json::parse(render_graph_json_text), material_num, material_config.material_hash_list, material_config.rtv_format_list, material_config.dsv_format, &graph);
+      sum += graph.buffer_num;
+    }
+  });
+  const auto baked_load = MeasureTimePerOp<std::micro>(num, [&]() {
+    for (uint32_t i = 0; i < num; i++) {
+      BakedRenderGraphMapping mapping;
+      mapping.Init(baked_path);
+      RenderGraphConfig graph{};
+      LoadBakedRenderGraph(mapping.GetData(), mapping.GetSize(), &graph);
+      sum += graph.buffer_num;
+      mapping.Term();
+    }
+  });
+  spdlog::info("render graph load benchmark deferred.json (us/op)");
+  spdlog::info("  json:{:.2f} baked:{:.2f}", json_load, baked_load);
+  CHECK_NE(sum, 0);
+  std::filesystem::remove(baked_path);
+  ClearAllAllocations();
+}
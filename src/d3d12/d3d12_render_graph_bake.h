@@ -0,0 +1,35 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_BAKE_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_BAKE_H
+#include "d3d12_header_common.h"
+#include "d3d12_render_graph.h"
+#include "d3d12_src_common.h"
+#include "illuminate/d3d12/render_graph_bake.h"
+namespace illuminate {
+/**
+ * baked render graph is a RenderGraphConfig serialized with its arrays and names into a single blob.
+ * pointers are stored as offsets from the blob head and listed in a relocation table,
+ * loading patches them in place in O(n) without any json parsing.
+ * blobs are only valid for the build that baked them (struct layouts and StrHash size are checked on load).
+ * array counts, pointer slots and the relocation table are validated against each other before anything is patched.
+ **/
+static const uint32_t kBakedRenderGraphVersion = 3;
+ArrayOf<std::byte> BakeRenderGraph(const RenderGraphConfig& graph, const char* const * buffer_name_list, const StrHash* buffer_name_hash_list, const MemoryType& memory_type);
+bool WriteBakedRenderGraph(const char* const path, const ArrayOf<std::byte>& blob);
+// blob is patched in place and must outlive graph and the returned buffer name lists.
+// all offsets and relocations are checked against size_in_bytes before patching, returns {nullptr, nullptr} for an invalid or truncated blob.
+std::pair<const char* const *, const StrHash*> LoadBakedRenderGraph(std::byte* blob, const size_t size_in_bytes, RenderGraphConfig* graph);
+// copy-on-write file mapping so that LoadBakedRenderGraph() can patch the blob without touching the file.
+class BakedRenderGraphMapping {
+ public:
+  bool Init(const char* const path);
+  void Term();
+  constexpr auto GetData() const { return data_; }
+  constexpr auto GetSize() const { return size_in_bytes_; }
+ private:
+  HANDLE file_{INVALID_HANDLE_VALUE};
+  HANDLE mapping_{nullptr};
+  std::byte* data_{nullptr};
+  size_t size_in_bytes_{0};
+};
+}
+#endif
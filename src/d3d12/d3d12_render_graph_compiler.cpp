@@ -0,0 +1,521 @@
+#include "d3d12_render_graph_compiler.h"
+#include <algorithm>
+#include "d3d12_memory_allocators.h"
+#include "d3d12_render_graph_json_parser.h"
+#include "d3d12_scene.h"
+#include "d3d12_src_common.h"
+namespace illuminate {
+namespace {
+static const uint32_t kInvalidIndex = ~0U;
+/**
+ * buffer uses are tracked per slot, i.e. the render graph buffer index,
+ * all scene buffers share the extra slot buffer_num which passes without buffers write.
+ **/
+template <typename F>
+auto ForEachRenderPassBufferUse(const RenderGraphConfig& graph, const RenderPass& render_pass, F&& f) {
+  const auto scene_slot = graph.buffer_num;
+  if (render_pass.buffer_num == 0) {
+    f(scene_slot, false, true);
+    return;
+  }
+  for (uint32_t i = 0; i < render_pass.buffer_num; i++) {
+    const auto& buffer = render_pass.buffer_list[i];
+    if (IsSceneBuffer(buffer.buffer_index)) {
+      f(scene_slot, true, false);
+      continue;
+    }
+    if (buffer.buffer_index >= graph.buffer_num) { continue; }
+    f(buffer.buffer_index, IsResourceStateReading(buffer.state), IsResourceStateWriting(buffer.state));
+  }
+}
+auto IsSinkRenderPass(const RenderGraphConfig& graph, const StrHash* buffer_name_hash_list, const RenderPass& render_pass) {
+  if (render_pass.buffer_num == 0) { return true; }
+  for (uint32_t i = 0; i < render_pass.buffer_num; i++) {
+    const auto& buffer = render_pass.buffer_list[i];
+    if (IsSceneBuffer(buffer.buffer_index) || buffer.buffer_index >= graph.buffer_num) { continue; }
+    if (!IsResourceStateWriting(buffer.state)) { continue; }
+    if (buffer_name_hash_list[buffer.buffer_index] == SID("swapchain")) { return true; }
+    if (graph.buffer_list[buffer.buffer_index].heap_type == D3D12_HEAP_TYPE_READBACK) { return true; }
+  }
+  return false;
+}
+auto CollectLiveRenderPass(const RenderGraphConfig& graph, const StrHash* buffer_name_hash_list) {
+  const auto slot_num = graph.buffer_num + 1;
+  auto frame_last_writer = AllocateAndFillArrayFrame(slot_num, kInvalidIndex);
+  uint32_t use_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t slot, const bool, const bool write) {
+      use_num++;
+      if (write) {
+        frame_last_writer[slot] = i;
+      }
+    });
+  }
+  // a use adds at most one edge for its read and one for its write.
+  auto producer_offset = AllocateArrayFrame<uint32_t>(graph.render_pass_num + 1);
+  auto producer_list = AllocateArrayFrame<uint32_t>(use_num * 2);
+  auto last_writer = AllocateAndFillArrayFrame(slot_num, kInvalidIndex);
+  uint32_t producer_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    producer_offset[i] = producer_num;
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    const auto add_producer = [&](const uint32_t pass_index) {
+      if (pass_index == kInvalidIndex || pass_index == i) { return; }
+      producer_list[producer_num] = pass_index;
+      producer_num++;
+    };
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t slot, const bool read, const bool write) {
+      if (read) {
+        add_producer(last_writer[slot] != kInvalidIndex ? last_writer[slot] : frame_last_writer[slot]);
+      }
+      if (write) {
+        add_producer(last_writer[slot]);
+      }
+    });
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t slot, const bool, const bool write) {
+      if (write) {
+        last_writer[slot] = i;
+      }
+    });
+  }
+  producer_offset[graph.render_pass_num] = producer_num;
+  auto live = AllocateAndFillArrayFrame(graph.render_pass_num, false);
+  auto stack = AllocateArrayFrame<uint32_t>(graph.render_pass_num);
+  uint32_t stack_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled || !IsSinkRenderPass(graph, buffer_name_hash_list, render_pass)) { continue; }
+    live[i] = true;
+    stack[stack_num] = i;
+    stack_num++;
+  }
+  while (stack_num > 0) {
+    stack_num--;
+    const auto pass_index = stack[stack_num];
+    for (uint32_t i = producer_offset[pass_index]; i < producer_offset[pass_index + 1]; i++) {
+      const auto producer = producer_list[i];
+      if (live[producer]) { continue; }
+      live[producer] = true;
+      stack[stack_num] = producer;
+      stack_num++;
+    }
+  }
+  return live;
+}
+auto IsRenderPassEnabled(const RenderGraphConfig& graph, const bool* render_pass_enable_flag, const uint32_t pass_index) {
+  return render_pass_enable_flag ? render_pass_enable_flag[pass_index] : graph.render_pass_list[pass_index].enabled;
+}
+// known_pass is laid out as CollectKnownFinishedPass() returns, prev_pass is the previous pass on the queue of pass_index.
+void InheritKnownFinishedPass(const uint32_t queue_num, const uint32_t queue_index, const uint32_t prev_pass, const uint32_t pass_index, uint32_t* known_pass) {
+  if (prev_pass == kInvalidIndex) { return; }
+  std::copy_n(&known_pass[prev_pass * queue_num], queue_num, &known_pass[pass_index * queue_num]);
+  known_pass[pass_index * queue_num + queue_index] = prev_pass + 1;
+}
+void MergeKnownFinishedPassOfWaits(const RenderGraphConfig& graph, const bool* render_pass_enable_flag, const uint32_t pass_index, uint32_t* known_pass) {
+  const auto queue_num = graph.command_queue_num;
+  const auto& render_pass = graph.render_pass_list[pass_index];
+  auto known = &known_pass[pass_index * queue_num];
+  for (uint32_t i = 0; i < render_pass.wait_pass_num; i++) {
+    const auto signal_pass = render_pass.signal_pass_index[i];
+    if (signal_pass >= pass_index || !IsRenderPassEnabled(graph, render_pass_enable_flag, signal_pass)) { continue; }
+    const auto signal_known = &known_pass[signal_pass * queue_num];
+    for (uint32_t q = 0; q < queue_num; q++) {
+      known[q] = std::max(known[q], signal_known[q]);
+    }
+    const auto signal_queue_index = graph.render_pass_list[signal_pass].command_queue_index;
+    known[signal_queue_index] = std::max(known[signal_queue_index], signal_pass + 1);
+  }
+}
+auto CountRenderPassBufferUse(const RenderGraphConfig& graph) {
+  uint32_t use_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t, const bool, const bool) { use_num++; });
+  }
+  return use_num;
+}
+} // namespace
+uint32_t* CollectKnownFinishedPass(const RenderGraphConfig& graph, const bool* render_pass_enable_flag, const MemoryType& memory_type) {
+  const auto queue_num = graph.command_queue_num;
+  auto known_pass = AllocateArray<uint32_t>(memory_type, graph.render_pass_num * queue_num);
+  std::fill_n(known_pass, graph.render_pass_num * queue_num, 0U);
+  FrameMemoryCheckpoint checkpoint;
+  auto last_pass_per_queue = AllocateAndFillArrayFrame(queue_num, kInvalidIndex);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    if (!IsRenderPassEnabled(graph, render_pass_enable_flag, i)) { continue; }
+    const auto queue_index = graph.render_pass_list[i].command_queue_index;
+    InheritKnownFinishedPass(queue_num, queue_index, last_pass_per_queue[queue_index], i, known_pass);
+    MergeKnownFinishedPassOfWaits(graph, render_pass_enable_flag, i, known_pass);
+    last_pass_per_queue[queue_index] = i;
+  }
+  return known_pass;
+}
+RenderPassDependency CollectRenderPassDependency(const RenderGraphConfig& graph, const MemoryType& memory_type) {
+  // predecessors are listed once per pass. a pass adds the last writer once per use, and readers of a slot once per read use,
+  // since the reader list is cleared by the pass writing the slot next, however many of its uses write the slot.
+  const auto use_num = CountRenderPassBufferUse(graph);
+  RenderPassDependency dependency{
+    .offset = AllocateArray<uint32_t>(memory_type, graph.render_pass_num + 1),
+    .pass_index_list = AllocateArray<uint32_t>(memory_type, use_num * 2),
+  };
+  FrameMemoryCheckpoint checkpoint;
+  const auto slot_num = graph.buffer_num + 1;
+  auto last_writer = AllocateAndFillArrayFrame(slot_num, kInvalidIndex);
+  // readers since the last write as a linked list per slot.
+  auto reader_head = AllocateAndFillArrayFrame(slot_num, kInvalidIndex);
+  auto reader_pass = AllocateArrayFrame<uint32_t>(use_num);
+  auto reader_next = AllocateArrayFrame<uint32_t>(use_num);
+  // the pass that last listed each pass as a predecessor, to drop duplicates from multiple uses of the same buffer.
+  auto last_successor = AllocateAndFillArrayFrame(graph.render_pass_num, kInvalidIndex);
+  uint32_t reader_num = 0;
+  uint32_t dependency_num = 0;
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    dependency.offset[i] = dependency_num;
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    const auto add_dependency = [&](const uint32_t pass_index) {
+      if (pass_index == kInvalidIndex || pass_index == i || last_successor[pass_index] == i) { return; }
+      last_successor[pass_index] = i;
+      dependency.pass_index_list[dependency_num] = pass_index;
+      dependency_num++;
+    };
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t slot, const bool, const bool write) {
+      add_dependency(last_writer[slot]);
+      if (!write) { return; }
+      for (auto r = reader_head[slot]; r != kInvalidIndex; r = reader_next[r]) {
+        add_dependency(reader_pass[r]);
+      }
+    });
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t slot, const bool, const bool write) {
+      if (!write) { return; }
+      last_writer[slot] = i;
+      reader_head[slot] = kInvalidIndex;
+    });
+    ForEachRenderPassBufferUse(graph, render_pass, [&](const uint32_t slot, const bool read, const bool) {
+      if (!read || last_writer[slot] == i) { return; }
+      reader_pass[reader_num] = i;
+      reader_next[reader_num] = reader_head[slot];
+      reader_head[slot] = reader_num;
+      reader_num++;
+    });
+  }
+  dependency.offset[graph.render_pass_num] = dependency_num;
+  return dependency;
+}
+RenderGraphCompileResult CompileRenderGraph(const StrHash* buffer_name_hash_list, const MemoryType& memory_type, RenderGraphConfig* graph) {
+  auto& r = *graph;
+  const auto queue_num = r.command_queue_num;
+  const auto max_wait_num = queue_num > 0 ? queue_num - 1 : 0;
+  for (uint32_t i = 0; i < r.render_pass_num; i++) {
+    auto& render_pass = r.render_pass_list[i];
+    render_pass.sends_signal = false;
+    render_pass.wait_pass_num = 0;
+    render_pass.signal_queue_index = AllocateArray<uint32_t>(memory_type, max_wait_num);
+    render_pass.signal_pass_index = AllocateArray<uint32_t>(memory_type, max_wait_num);
+  }
+  RenderGraphCompileResult result{};
+  {
+    FrameMemoryCheckpoint checkpoint;
+    const auto live = CollectLiveRenderPass(r, buffer_name_hash_list);
+    for (uint32_t i = 0; i < r.render_pass_num; i++) {
+      if (!r.render_pass_list[i].enabled || live[i]) { continue; }
+      r.render_pass_list[i].enabled = false;
+      result.culled_pass_num++;
+    }
+    // same vector clocks as CollectKnownFinishedPass() returns, built along with the waits.
+    const auto slot_num = r.buffer_num + 1;
+    auto known = AllocateAndFillArrayFrame(r.render_pass_num * queue_num, 0U);
+    auto last_pass_per_queue = AllocateAndFillArrayFrame(queue_num, kInvalidIndex);
+    auto last_writer = AllocateAndFillArrayFrame(slot_num, kInvalidIndex);
+    auto last_reader = AllocateAndFillArrayFrame(slot_num * queue_num, kInvalidIndex); // since last_writer, per queue.
+    auto needed = AllocateArrayFrame<uint32_t>(queue_num);
+    for (uint32_t i = 0; i < r.render_pass_num; i++) {
+      auto& render_pass = r.render_pass_list[i];
+      if (!render_pass.enabled) { continue; }
+      const auto queue_index = render_pass.command_queue_index;
+      auto pass_known = &known[i * queue_num];
+      InheritKnownFinishedPass(queue_num, queue_index, last_pass_per_queue[queue_index], i, known);
+      std::fill_n(needed, queue_num, 0U);
+      const auto add_dependency = [&](const uint32_t pass_index) {
+        if (pass_index == kInvalidIndex || pass_index == i) { return; }
+        const auto q = r.render_pass_list[pass_index].command_queue_index;
+        if (q == queue_index) { return; }
+        needed[q] = std::max(needed[q], pass_index + 1);
+      };
+      ForEachRenderPassBufferUse(r, render_pass, [&](const uint32_t slot, const bool, const bool write) {
+        add_dependency(last_writer[slot]);
+        if (!write) { return; }
+        for (uint32_t q = 0; q < queue_num; q++) {
+          add_dependency(last_reader[slot * queue_num + q]);
+        }
+      });
+      // a wait is redundant when another needed pass already knows of it.
+      for (uint32_t q = 0; q < queue_num; q++) {
+        if (needed[q] <= pass_known[q]) { continue; }
+        bool implied = false;
+        for (uint32_t k = 0; k < queue_num; k++) {
+          if (k == q || needed[k] <= pass_known[k]) { continue; }
+          if (known[(needed[k] - 1) * queue_num + q] >= needed[q]) {
+            implied = true;
+            break;
+          }
+        }
+        if (implied) { continue; }
+        const auto signal_pass = needed[q] - 1;
+        render_pass.signal_queue_index[render_pass.wait_pass_num] = q;
+        render_pass.signal_pass_index[render_pass.wait_pass_num] = signal_pass;
+        render_pass.wait_pass_num++;
+        r.render_pass_list[signal_pass].sends_signal = true;
+      }
+      MergeKnownFinishedPassOfWaits(r, nullptr, i, known);
+      result.wait_pass_num += render_pass.wait_pass_num;
+      last_pass_per_queue[queue_index] = i;
+      ForEachRenderPassBufferUse(r, render_pass, [&](const uint32_t slot, const bool, const bool write) {
+        if (!write) { return; }
+        last_writer[slot] = i;
+        std::fill_n(&last_reader[slot * queue_num], queue_num, kInvalidIndex);
+      });
+      ForEachRenderPassBufferUse(r, render_pass, [&](const uint32_t slot, const bool read, const bool) {
+        if (!read || last_writer[slot] == i) { return; }
+        last_reader[slot * queue_num + queue_index] = i;
+      });
+    }
+  }
+  ConfigureCommandAllocatorNumPerQueueType(graph);
+  return result;
+}
+}
+#include "doctest/doctest.h"
+#include "d3d12_test_util.h"
+namespace {
+auto CheckWaitPass(const illuminate::RenderGraphConfig& render_graph, const char* const pass_name, const std::initializer_list<const char*>& wait_pass_name_list) {
+  using namespace illuminate; // NOLINT
+  CAPTURE(pass_name);
+  const auto render_pass_index = FindRenderPassIndex(render_graph, CalcStrHash(pass_name));
+  REQUIRE_LT(render_pass_index, render_graph.render_pass_num);
+  const auto& render_pass = render_graph.render_pass_list[render_pass_index];
+  REQUIRE_EQ(render_pass.wait_pass_num, wait_pass_name_list.size());
+  uint32_t w = 0;
+  for (const auto wait_pass_name : wait_pass_name_list) {
+    CAPTURE(wait_pass_name);
+    const auto signal_pass = FindRenderPassIndex(render_graph, CalcStrHash(wait_pass_name));
+    REQUIRE_LT(signal_pass, render_graph.render_pass_num);
+    CHECK_EQ(render_pass.signal_pass_index[w], signal_pass);
+    CHECK_EQ(render_pass.signal_queue_index[w], render_graph.render_pass_list[signal_pass].command_queue_index);
+    CHECK_UNARY(render_graph.render_pass_list[signal_pass].sends_signal);
+    w++;
+  }
+}
+} // namespace
+TEST_CASE("render graph compiler derives hand-written waits") { // NOLINT
+  using namespace illuminate;
+  for (const auto filename : {"deferred.json", "forward.json", "config.json"}) {
+    CAPTURE(filename);
+    auto json = LoadTestJson(filename);
+    RenderGraphConfig expected{};
+    LoadTestRenderGraph(json, &expected);
+    for (auto& pass : json.at("render_pass")) {
+      pass.erase("wait_pass");
+    }
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    const auto result = CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph);
+    CHECK_EQ(result.culled_pass_num, 0);
+    const auto expected_known = CollectKnownFinishedPass(expected, nullptr, MemoryType::kFrame);
+    const auto known = CollectKnownFinishedPass(render_graph, nullptr, MemoryType::kFrame);
+    uint32_t expected_wait_pass_num = 0;
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      CAPTURE(i);
+      const auto& pass = render_graph.render_pass_list[i];
+      const auto& expected_pass = expected.render_pass_list[i];
+      CHECK_EQ(pass.enabled, expected_pass.enabled);
+      CHECK_EQ(pass.sends_signal, expected_pass.sends_signal);
+      CHECK_EQ(pass.wait_pass_num, expected_pass.wait_pass_num);
+      for (uint32_t w = 0; w < std::min(pass.wait_pass_num, expected_pass.wait_pass_num); w++) {
+        CHECK_EQ(pass.signal_pass_index[w], expected_pass.signal_pass_index[w]);
+        CHECK_EQ(pass.signal_queue_index[w], expected_pass.signal_queue_index[w]);
+      }
+      expected_wait_pass_num += expected_pass.wait_pass_num;
+      for (uint32_t q = 0; q < render_graph.command_queue_num; q++) {
+        CHECK_EQ(known[i * render_graph.command_queue_num + q], expected_known[i * render_graph.command_queue_num + q]);
+      }
+    }
+    CHECK_EQ(result.wait_pass_num, expected_wait_pass_num);
+    for (uint32_t i = 0; i < kCommandQueueTypeNum; i++) {
+      CHECK_EQ(render_graph.command_allocator_num_per_queue_type[i], expected.command_allocator_num_per_queue_type[i]);
+    }
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render graph compiler culls dead passes") { // NOLINT
+  using namespace illuminate;
+  auto json = LoadTestJson("deferred.json");
+  auto& render_pass_list = json.at("render_pass");
+  // blur and its consumer are never presented, the disabled pass stays disabled without waits.
+  const auto create_render_pass = [](const char* const name, const char* const command_queue, const std::initializer_list<std::pair<const char*, const char*>>& buffer_list) {
+    nlohmann::json pass{{"name", name}, {"type", "test"}, {"command_queue", command_queue}};
+    pass["buffer_list"] = nlohmann::json::array();
+    for (const auto& [buffer_name, state] : buffer_list) {
+      pass["buffer_list"].push_back({{"name", buffer_name}, {"state", state}});
+    }
+    return pass;
+  };
+  auto blur = create_render_pass("unused blur", "queue_compute", {{"gbuffer0", "srv_non_ps"}, {"blur", "uav"}});
+  blur["wait_pass"] = nlohmann::json::array({"gbuffer"});
+  auto blur_consumer = create_render_pass("unused blur consumer", "queue_graphics", {{"blur", "copy_source"}, {"blur2", "copy_dest"}});
+  blur_consumer["wait_pass"] = nlohmann::json::array({"unused blur"});
+  auto disabled = create_render_pass("disabled", "queue_compute", {{"primary", "srv_non_ps"}, {"swapchain", "uav"}});
+  disabled["enabled"] = false;
+  render_pass_list.insert(render_pass_list.begin() + 6, std::move(blur));
+  render_pass_list.insert(render_pass_list.begin() + 7, std::move(blur_consumer));
+  render_pass_list.push_back(std::move(disabled));
+  RenderGraphConfig render_graph{};
+  const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+  const auto result = CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph);
+  CHECK_EQ(result.culled_pass_num, 2);
+  CHECK_EQ(result.wait_pass_num, 4);
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    const auto& pass = render_graph.render_pass_list[i];
+    const auto dead = (pass.name == SID("unused blur") || pass.name == SID("unused blur consumer") || pass.name == SID("disabled"));
+    CAPTURE(i);
+    CHECK_NE(pass.enabled, dead);
+    if (dead) {
+      CHECK_EQ(pass.wait_pass_num, 0);
+      CHECK_FALSE(pass.sends_signal);
+    }
+  }
+  CheckWaitPass(render_graph, "prez", {"copy resource"});
+  CheckWaitPass(render_graph, "linear depth", {"prez"});
+  CheckWaitPass(render_graph, "lighting", {"gbuffer"});
+  CheckWaitPass(render_graph, "output to swapchain", {"lighting"});
+  SUBCASE("readback keeps its writer alive") {
+    json["buffer"].push_back({{"name", "blur2"}, {"dimension", "buffer"}, {"heap_type", "readback"}, {"num_elements", 1024}, {"stride_bytes", 4}});
+    RenderGraphConfig readback_graph{};
+    const auto readback_buffer_name_hash_list = LoadTestRenderGraph(json, &readback_graph).second;
+    CHECK_EQ(CompileRenderGraph(readback_buffer_name_hash_list, MemoryType::kFrame, &readback_graph).culled_pass_num, 0);
+    CheckWaitPass(readback_graph, "unused blur", {}); // implied by lighting waiting on gbuffer.
+    CheckWaitPass(readback_graph, "unused blur consumer", {"unused blur"});
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render graph compiler queue sync") { // NOLINT
+  using namespace illuminate;
+  SUBCASE("write after read waits on the reader") {
+    const auto json = CreateTestRenderGraphJson({
+        {"a", 1, {{"x", "uav"}}},
+        {"b", 0, {{"x", "srv_ps"}, {"y", "rtv"}}},
+        {"c", 1, {{"x", "uav"}}},
+        {"d", 0, {{"x", "srv_ps"}, {"y", "srv_ps"}, {"swapchain", "rtv"}}},
+      });
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    const auto result = CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph);
+    CHECK_EQ(result.culled_pass_num, 0);
+    CHECK_EQ(result.wait_pass_num, 3);
+    CheckWaitPass(render_graph, "a", {});
+    CheckWaitPass(render_graph, "b", {"a"});
+    CheckWaitPass(render_graph, "c", {"b"});
+    CheckWaitPass(render_graph, "d", {"c"});
+  }
+  SUBCASE("waits implied by other waits are dropped") {
+    const auto json = CreateTestRenderGraphJson({
+        {"upload", 2, {{"x", "copy_dest"}}},
+        {"simulate", 1, {{"x", "srv_non_ps"}, {"y", "uav"}}},
+        {"draw", 0, {{"x", "srv_ps"}, {"y", "srv_ps"}, {"swapchain", "rtv"}}},
+      });
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    CHECK_EQ(CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph).wait_pass_num, 2);
+    CheckWaitPass(render_graph, "simulate", {"upload"});
+    CheckWaitPass(render_graph, "draw", {"simulate"});
+  }
+  SUBCASE("waits on several queues") {
+    const auto json = CreateTestRenderGraphJson({
+        {"upload", 2, {{"x", "copy_dest"}}},
+        {"simulate", 1, {{"y", "uav"}}},
+        {"draw", 0, {{"x", "srv_ps"}, {"y", "srv_ps"}, {"swapchain", "rtv"}}},
+      });
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    CHECK_EQ(CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph).wait_pass_num, 2);
+    CheckWaitPass(render_graph, "simulate", {});
+    CheckWaitPass(render_graph, "draw", {"simulate", "upload"});
+  }
+  SUBCASE("reads before the first write depend on the previous frame") {
+    const auto json = CreateTestRenderGraphJson({
+        {"history", 0, {{"x", "srv_ps"}, {"swapchain", "rtv"}}},
+        {"accumulate", 1, {{"x", "uav"}}},
+        {"unused", 1, {{"x", "srv_non_ps"}, {"z", "uav"}}},
+      });
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    const auto result = CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph);
+    CHECK_EQ(result.culled_pass_num, 1);
+    CHECK_EQ(result.wait_pass_num, 1);
+    CHECK_UNARY(render_graph.render_pass_list[1].enabled);
+    CHECK_FALSE(render_graph.render_pass_list[2].enabled);
+    CheckWaitPass(render_graph, "accumulate", {"history"});
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render pass dependency") { // NOLINT
+  using namespace illuminate;
+  // pass 0 writes the buffer, passes 1-10 read it, pass 11 writes two mip ranges of it.
+  const uint32_t reader_num = 10;
+  auto render_graph = CreateTestRenderGraph(1, reader_num + 2, 1);
+  SetTestRenderPass(0, {{.buffer_index = 0, .state = ResourceStateType::kRtv}}, {}, &render_graph.render_pass_list[0]);
+  for (uint32_t i = 1; i <= reader_num; i++) {
+    SetTestRenderPass(0, {{.buffer_index = 0, .state = ResourceStateType::kSrvPs}}, {}, &render_graph.render_pass_list[i]);
+  }
+  SetTestRenderPass(0, {
+      {.buffer_index = 0, .state = ResourceStateType::kUav, .subresource_range = {.mip_slice = 0, .mip_num = 1}},
+      {.buffer_index = 0, .state = ResourceStateType::kUav, .subresource_range = {.mip_slice = 1, .mip_num = 1}},
+    }, {}, &render_graph.render_pass_list[reader_num + 1]);
+  const auto dependency = CollectRenderPassDependency(render_graph, MemoryType::kFrame);
+  CHECK_EQ(dependency.offset[0], 0);
+  CHECK_EQ(dependency.offset[1], 0);
+  for (uint32_t i = 1; i <= reader_num; i++) {
+    CHECK_EQ(dependency.offset[i + 1] - dependency.offset[i], 1);
+    CHECK_EQ(dependency.pass_index_list[dependency.offset[i]], 0);
+  }
+  // the writer and every reader, once each.
+  const auto writer = reader_num + 1;
+  REQUIRE_EQ(dependency.offset[writer + 1] - dependency.offset[writer], reader_num + 1);
+  auto predecessor_found = AllocateAndFillArrayFrame(writer, false);
+  for (uint32_t i = dependency.offset[writer]; i < dependency.offset[writer + 1]; i++) {
+    REQUIRE_LT(dependency.pass_index_list[i], writer);
+    CHECK_FALSE(predecessor_found[dependency.pass_index_list[i]]);
+    predecessor_found[dependency.pass_index_list[i]] = true;
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render graph compile time" * doctest::skip()) { // NOLINT
+  using namespace illuminate;
+  const uint32_t render_pass_num = 5000;
+  const uint32_t buffer_num = 1024;
+  // waits are dropped and derived by CompileRenderGraph() again.
+  auto render_graph = CreateRandomRenderGraph(render_pass_num, buffer_num, 0, 0, 12345);
+  auto buffer_name_hash_list = AllocateAndFillArraySystem(buffer_num, StrHash{});
+  buffer_name_hash_list[buffer_num - 1] = SID("swapchain");
+  for (uint32_t i = 63; i < render_pass_num; i += 64) {
+    render_graph.render_pass_list[i].buffer_list[0].buffer_index = buffer_num - 1;
+  }
+  const uint32_t loop_num = 100;
+  RenderGraphCompileResult result{};
+  const auto time_in_us = MeasureTimePerOp<std::micro>(loop_num, [&]() {
+    for (uint32_t i = 0; i < loop_num; i++) {
+      for (uint32_t j = 0; j < render_pass_num; j++) {
+        render_graph.render_pass_list[j].enabled = true;
+      }
+      result = CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph);
+      ResetAllocation(MemoryType::kFrame);
+    }
+  });
+  spdlog::info("render graph compile: passes:{} buffers:{} queues:{} culled:{} waits:{} {:.1f}us", render_pass_num, buffer_num, render_graph.command_queue_num, result.culled_pass_num, result.wait_pass_num, time_in_us);
+  CHECK_LT(result.culled_pass_num, render_pass_num);
+  ClearAllAllocations();
+}
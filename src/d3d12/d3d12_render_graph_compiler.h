@@ -0,0 +1,60 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_COMPILER_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_COMPILER_H
+#include "d3d12_render_graph.h"
+#include "illuminate/core/strid.h"
+#include "illuminate/util/util_defines.h"
+namespace illuminate {
+enum class MemoryType : uint8_t;
+// how render graph passes (CompileRenderGraph(), DetectRenderGraphHazards(), ...) classify buffer states, see below.
+constexpr inline bool IsResourceStateWriting(const ResourceStateType state) {
+  switch (state) {
+    case ResourceStateType::kUav:
+    case ResourceStateType::kRtv:
+    case ResourceStateType::kDsvWrite:
+    case ResourceStateType::kCopyDst:
+    case ResourceStateType::kCommon: {
+      return true;
+    }
+  }
+  return false;
+}
+constexpr inline bool IsResourceStateReading(const ResourceStateType state) {
+  return state == ResourceStateType::kUav || !IsResourceStateWriting(state);
+}
+/**
+ * compile step run after ParseRenderGraphJson(), disables passes whose results are never used and replaces hand-written wait_pass lists.
+ * pass dependencies come from buffer states: uav, rtv, dsv write, copy dst and common write a buffer, other states read it (uav does both).
+ * passes writing the swapchain or a readback heap buffer are sinks, and so are passes without buffers (e.g. "copy resource")
+ * since their work is invisible to the graph; the latter are assumed to write scene buffers.
+ * a buffer read before its first write in a frame depends on its last writer in the previous frame.
+ * passes not reachable backward from a sink are disabled, passes disabled beforehand are ignored and get no waits.
+ * buffers read only by a debug view are invisible to the graph, their writers may be culled.
+ * cross-queue waits are derived for read-after-write, write-after-write and write-after-read dependencies in a frame,
+ * keeping the latest needed pass per queue and dropping waits already implied by another wait (transitive reduction).
+ * frames are assumed to be ordered by other means as with hand-written waits.
+ * signals and command allocator nums are updated as ParseRenderGraphJson() does, wait lists are allocated with memory_type.
+ **/
+struct RenderGraphCompileResult {
+  uint32_t culled_pass_num{0};
+  uint32_t wait_pass_num{0}; // sum of derived waits over passes.
+};
+RenderGraphCompileResult CompileRenderGraph(const StrHash* buffer_name_hash_list, const MemoryType& memory_type, RenderGraphConfig* graph);
+/**
+ * in-frame predecessors of each enabled pass regardless of queues, following the buffer state rules above:
+ * the last writer for reads and writes, and every reader since the last write for writes.
+ * predecessors of pass i are pass_index_list[offset[i]] to pass_index_list[offset[i + 1] - 1], all of them smaller than i and listed once.
+ **/
+struct RenderPassDependency {
+  uint32_t* offset{nullptr};
+  uint32_t* pass_index_list{nullptr};
+};
+RenderPassDependency CollectRenderPassDependency(const RenderGraphConfig& graph, const MemoryType& memory_type);
+/**
+ * vector clocks of queue timelines in a frame as CompileRenderGraph() builds them:
+ * known[pass * command_queue_num + q] is (render pass index + 1) of the latest pass on queue q known to have finished when pass starts, 0 for none.
+ * passes on a queue run in order, a wait merges what the signaling pass knew. waits on later passes (unresolved) are ignored.
+ * passes are enabled as render_pass_enable_flag tells, RenderPass::enabled is used when it is nullptr. disabled passes neither run nor signal.
+ **/
+uint32_t* CollectKnownFinishedPass(const RenderGraphConfig& graph, const bool* render_pass_enable_flag, const MemoryType& memory_type);
+}
+#endif
@@ -0,0 +1,403 @@
+#include "d3d12_render_graph_export.h"
+#include <fstream>
+#include "d3d12_async_compute_scheduler.h"
+#include "d3d12_gpu_buffer_allocator.h"
+#include "d3d12_json_parser.h"
+#include "d3d12_memory_allocators.h"
+#include "d3d12_render_graph_compiler.h"
+#include "d3d12_render_graph_json_parser.h"
+#include "d3d12_scene.h"
+#include "d3d12_shader_compiler.h"
+#include "d3d12_src_common.h"
+#include "illuminate/util/string_table.h"
+#include "spdlog/fmt/fmt.h"
+namespace illuminate {
+const char* GetCommandQueueTypeName(const D3D12_COMMAND_LIST_TYPE type) {
+  switch (type) {
+    case D3D12_COMMAND_LIST_TYPE_DIRECT:  { return "direct"; }
+    case D3D12_COMMAND_LIST_TYPE_COMPUTE: { return "compute"; }
+    case D3D12_COMMAND_LIST_TYPE_COPY:    { return "copy"; }
+  }
+  return "unknown";
+}
+std::string GetRenderPassName(const RenderGraphConfig& graph, const uint32_t pass_index) {
+  const auto name = GetInternedString(graph.render_pass_list[pass_index].name);
+  return name != nullptr ? std::string(name) : fmt::format("pass {}", pass_index);
+}
+std::string GetBufferName(const RenderGraphExportInfo& info, const uint32_t buffer_index) {
+  return info.buffer_name_list != nullptr ? std::string(info.buffer_name_list[buffer_index]) : fmt::format("buffer {}", buffer_index);
+}
+uint32_t GetBarrierNum(const RenderGraphExportInfo& info, const uint32_t pass_index) {
+  uint32_t barrier_num = 0;
+  for (uint32_t i = 0; i < kBarrierExecutionTimingNum; i++) {
+    barrier_num += info.barrier_transition->barrier_config_list[pass_index][i].size;
+  }
+  return barrier_num;
+}
+bool WriteTextFile(const char* const path, const std::string_view& text) {
+  std::ofstream file(path, std::ios::out | std::ios::binary);
+  if (!file) {
+    logerror("failed to open {}", path);
+    return false;
+  }
+  file.write(text.data(), static_cast<std::streamsize>(text.size()));
+  return file.good();
+}
+bool LoadRenderGraphForExport(const char* const render_graph_json_path, const char* const material_json_path, RenderGraphConfig* graph, const char* const ** buffer_name_list) {
+  nlohmann::json render_graph_json;
+  if (!LoadJsonFile(render_graph_json_path, &render_graph_json)) { return false; }
+  nlohmann::json material_json;
+  if (!LoadJsonFile(material_json_path, &material_json)) { return false; }
+  const auto material_config = ParseMaterialConfigInfo(material_json);
+  const auto material_num = GetUint32(material_json.at("materials").size());
+  if (ValidateRenderGraphJson(render_graph_json, material_num, material_config.material_hash_list, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size > 0) {
+    logerror("invalid render graph {}", render_graph_json_path);
+    return false;
+  }
+  const auto [name_list, buffer_name_hash_list] = ParseRenderGraphJson(render_graph_json,
+                                                                       material_num,
+                                                                       material_config.material_hash_list,
+                                                                       material_config.rtv_format_list,
+                                                                       material_config.dsv_format,
+                                                                       graph);
+  CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, graph);
+  *buffer_name_list = name_list;
+  return true;
+}
+namespace {
+static const uint32_t kInvalidIndex = ~0U;
+auto GetCommandQueueLabel(const RenderGraphConfig& graph, const uint32_t queue_index) {
+  return fmt::format("queue {} ({})", queue_index, GetCommandQueueTypeName(graph.command_queue_type[queue_index]));
+}
+// first and last enabled pass using each buffer, kInvalidIndex for unused buffers.
+auto CollectBufferLifetime(const RenderGraphConfig& graph) {
+  auto lifetime = AllocateAndFillArrayFrame(graph.buffer_num * 2, kInvalidIndex);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+      const auto buffer_index = render_pass.buffer_list[j].buffer_index;
+      if (IsSceneBuffer(buffer_index) || buffer_index >= graph.buffer_num) { continue; }
+      if (lifetime[buffer_index * 2] == kInvalidIndex) {
+        lifetime[buffer_index * 2] = i;
+      }
+      lifetime[buffer_index * 2 + 1] = i;
+    }
+  }
+  return lifetime;
+}
+auto EscapeDotString(const std::string_view& str) {
+  std::string escaped;
+  for (const auto c : str) {
+    if (c == '"' || c == '\\') {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+} // namespace
+std::string CreateRenderGraphDot(const RenderGraphConfig& graph, const RenderGraphExportInfo& info) {
+  FrameMemoryCheckpoint checkpoint;
+  const auto lifetime = CollectBufferLifetime(graph);
+  std::string dot = "digraph render_graph {\n  rankdir=LR;\n  node [fontname=\"Helvetica\"];\n";
+  auto out = std::back_inserter(dot);
+  for (uint32_t q = 0; q < graph.command_queue_num; q++) {
+    fmt::format_to(out, "  subgraph cluster_queue{} {{\n    label=\"{}\";\n", q, GetCommandQueueLabel(graph, q));
+    for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+      const auto& render_pass = graph.render_pass_list[i];
+      if (render_pass.command_queue_index != q) { continue; }
+      auto label = EscapeDotString(GetRenderPassName(graph, i));
+      if (render_pass.enabled && info.render_pass_cost_msec != nullptr) {
+        label += fmt::format("\\n{:.3f} ms", info.render_pass_cost_msec[i]);
+      }
+      if (render_pass.enabled && info.barrier_transition != nullptr) {
+        label += fmt::format("\\nbarriers {}", GetBarrierNum(info, i));
+      }
+      fmt::format_to(out, "    pass{} [shape=box, label=\"{}\"{}];\n", i, label, render_pass.enabled ? "" : ", style=dotted");
+    }
+    dot += "  }\n";
+  }
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    if (lifetime[i * 2] == kInvalidIndex) { continue; }
+    fmt::format_to(out, "  buffer{} [shape=ellipse, label=\"{}\\npass {}-{}{}\"];\n", i, EscapeDotString(GetBufferName(info, i)), lifetime[i * 2], lifetime[i * 2 + 1],
+                   graph.buffer_list[i].pingpong ? " pingpong" : (graph.buffer_list[i].frame_buffered ? " frame buffered" : ""));
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+      const auto& buffer = render_pass.buffer_list[j];
+      if (IsSceneBuffer(buffer.buffer_index) || buffer.buffer_index >= graph.buffer_num) { continue; }
+      const auto state = GetResourceStateTypeName(buffer.state);
+      // same classification as CompileRenderGraph(), uav both reads and writes.
+      if (IsResourceStateReading(buffer.state)) {
+        fmt::format_to(out, "  buffer{} -> pass{} [label=\"{}\"];\n", buffer.buffer_index, i, state);
+      }
+      if (IsResourceStateWriting(buffer.state)) {
+        fmt::format_to(out, "  pass{} -> buffer{} [label=\"{}\"];\n", i, buffer.buffer_index, state);
+      }
+    }
+    for (uint32_t j = 0; j < render_pass.wait_pass_num; j++) {
+      if (render_pass.signal_pass_index[j] >= i) { continue; } // unresolved
+      fmt::format_to(out, "  pass{} -> pass{} [style=dashed, color=red];\n", render_pass.signal_pass_index[j], i);
+    }
+  }
+  dot += "}\n";
+  return dot;
+}
+nlohmann::json CreateRenderGraphTraceJson(const RenderGraphConfig& graph, const RenderGraphExportInfo& info) {
+  FrameMemoryCheckpoint checkpoint;
+  const auto render_pass_cost_msec = info.render_pass_cost_msec != nullptr ? info.render_pass_cost_msec : GetRenderPassCostMsec(RenderPassStaticCostModel{}, graph, MemoryType::kFrame);
+  const auto timeline = PredictRenderPassTimeline(graph, render_pass_cost_msec, info.fence_latency_msec, MemoryType::kFrame);
+  const auto lifetime = CollectBufferLifetime(graph);
+  const auto to_usec = [](const float msec) { return static_cast<double>(msec) * 1000.0; };
+  static const uint32_t kPidQueue = 0;
+  static const uint32_t kPidBuffer = 1;
+  auto events = nlohmann::json::array();
+  events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", kPidQueue}, {"args", {{"name", "queues"}}}});
+  events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", kPidBuffer}, {"args", {{"name", "buffers"}}}});
+  for (uint32_t q = 0; q < graph.command_queue_num; q++) {
+    events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", kPidQueue}, {"tid", q}, {"args", {{"name", GetCommandQueueLabel(graph, q)}}}});
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    nlohmann::json args{{"index", i}, {"cost_msec", render_pass_cost_msec[i]}};
+    if (info.barrier_transition != nullptr) {
+      args["barriers"] = GetBarrierNum(info, i);
+    }
+    auto wait_pass = nlohmann::json::array();
+    for (uint32_t j = 0; j < render_pass.wait_pass_num; j++) {
+      if (render_pass.signal_pass_index[j] >= i) { continue; }
+      wait_pass.push_back(GetRenderPassName(graph, render_pass.signal_pass_index[j]));
+    }
+    args["wait_pass"] = std::move(wait_pass);
+    events.push_back({{"name", GetRenderPassName(graph, i)}, {"cat", "pass"}, {"ph", "X"}, {"pid", kPidQueue}, {"tid", render_pass.command_queue_index},
+                      {"ts", to_usec(timeline.start_msec[i])}, {"dur", to_usec(timeline.end_msec[i] - timeline.start_msec[i])}, {"args", std::move(args)}});
+  }
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    const auto first_pass = lifetime[i * 2];
+    const auto last_pass = lifetime[i * 2 + 1];
+    if (first_pass == kInvalidIndex) { continue; }
+    const auto name = GetBufferName(info, i);
+    events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", kPidBuffer}, {"tid", i}, {"args", {{"name", name}}}});
+    // passes on other queues may end before the first pass starts.
+    const auto start_msec = timeline.start_msec[first_pass];
+    const auto end_msec = std::max(timeline.end_msec[last_pass], start_msec);
+    events.push_back({{"name", name}, {"cat", "buffer"}, {"ph", "X"}, {"pid", kPidBuffer}, {"tid", i},
+                      {"ts", to_usec(start_msec)}, {"dur", to_usec(end_msec - start_msec)},
+                      {"args", {{"first_pass", GetRenderPassName(graph, first_pass)}, {"last_pass", GetRenderPassName(graph, last_pass)}}}});
+  }
+  return {
+    {"traceEvents", std::move(events)},
+    {"displayTimeUnit", "ms"},
+    {"otherData", {{"frame_time_msec", timeline.frame_time_msec}, {"critical_path_msec", timeline.critical_path_msec}}},
+  };
+}
+namespace {
+BarrierTransitionInfo ConfigureRenderGraphBarrierTransitions(const RenderGraphConfig& graph, const BarrierSplitCostModel* split_cost_model, const MemoryType& memory_type) {
+  auto buffer_allocation_index_base = AllocateArrayFrame<uint32_t>(graph.buffer_num);
+  uint32_t buffer_allocation_num = 0;
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    buffer_allocation_index_base[i] = buffer_allocation_num;
+    buffer_allocation_num += GetBufferAllocationNum(graph.buffer_list[i], graph.frame_buffer_num);
+  }
+  auto initial_state = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(buffer_allocation_num);
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    const auto state = ResourceStateTypeFlags::GetResourceStateTypeFlag(graph.buffer_list[i].initial_state);
+    std::fill_n(&initial_state[buffer_allocation_index_base[i]], GetBufferAllocationNum(graph.buffer_list[i], graph.frame_buffer_num), state);
+  }
+  auto final_state = AllocateAndFillArrayFrame(buffer_allocation_num, ResourceStateTypeFlags::kNone);
+  auto render_pass_enable_flag = AllocateArrayFrame<bool>(graph.render_pass_num);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    render_pass_enable_flag[i] = graph.render_pass_list[i].enabled;
+  }
+  auto write_to_sub = AllocateArrayFrame<bool*>(graph.buffer_num);
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    write_to_sub[i] = AllocateArrayFrame<bool>(graph.render_pass_num);
+  }
+  ConfigurePingPongBufferWriteToSubList(graph.render_pass_num, graph.render_pass_list, render_pass_enable_flag, graph.buffer_num, write_to_sub);
+  // disabled passes get no buffers and hence no barriers.
+  auto render_pass_buffer_num = AllocateAndFillArrayFrame(graph.render_pass_num, 0U);
+  auto render_pass_buffer_allocation_index_list = AllocateArrayFrame<uint32_t*>(graph.render_pass_num);
+  auto render_pass_resource_state_list = AllocateArrayFrame<ResourceStateTypeFlags::FlagType*>(graph.render_pass_num);
+  auto wait_pass_num = AllocateArrayFrame<uint32_t>(graph.render_pass_num);
+  auto signal_pass_index = AllocateArrayFrame<uint32_t*>(graph.render_pass_num);
+  auto render_pass_command_queue_index = AllocateArrayFrame<uint32_t>(graph.render_pass_num);
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& render_pass = graph.render_pass_list[i];
+    wait_pass_num[i] = render_pass.wait_pass_num;
+    signal_pass_index[i] = render_pass.signal_pass_index;
+    render_pass_command_queue_index[i] = render_pass.command_queue_index;
+    render_pass_buffer_allocation_index_list[i] = AllocateArrayFrame<uint32_t>(render_pass.buffer_num);
+    render_pass_resource_state_list[i] = AllocateArrayFrame<ResourceStateTypeFlags::FlagType>(render_pass.buffer_num);
+    if (!render_pass.enabled) { continue; }
+    for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+      const auto& buffer = render_pass.buffer_list[j];
+      if (IsSceneBuffer(buffer.buffer_index) || buffer.buffer_index >= graph.buffer_num) { continue; }
+      const auto& config = graph.buffer_list[buffer.buffer_index];
+      const auto local_index = GetBufferLocalIndex(config, buffer.state, write_to_sub[buffer.buffer_index][i], 0);
+      const auto k = render_pass_buffer_num[i];
+      render_pass_buffer_allocation_index_list[i][k] = buffer_allocation_index_base[buffer.buffer_index] + local_index;
+      render_pass_resource_state_list[i][k] = ResourceStateTypeFlags::GetResourceStateTypeFlag(buffer.state);
+      render_pass_buffer_num[i]++;
+    }
+  }
+  return ConfigureBarrierTransitions(buffer_allocation_num, graph.render_pass_num, render_pass_buffer_num, render_pass_buffer_allocation_index_list, render_pass_resource_state_list,
+                                     wait_pass_num, signal_pass_index, render_pass_command_queue_index, graph.command_queue_type,
+                                     initial_state, final_state, memory_type, split_cost_model);
+}
+} // namespace
+BarrierTransitionInfo PlanRenderGraphBarrierTransitions(const RenderGraphConfig& graph, const BarrierSplitCostModel* split_cost_model, const MemoryType& memory_type) {
+  // the plan is allocated after the inputs, which hence stay until the caller's frame memory is released when planned in it.
+  if (memory_type == MemoryType::kFrame) { return ConfigureRenderGraphBarrierTransitions(graph, split_cost_model, memory_type); }
+  FrameMemoryCheckpoint checkpoint;
+  return ConfigureRenderGraphBarrierTransitions(graph, split_cost_model, memory_type);
+}
+bool ExportRenderGraph(const char* const render_graph_json_path, const char* const material_json_path, const char* const cost_json_path,
+                       const char* const dst_dot_path, const char* const dst_trace_path) {
+  nlohmann::json cost_json;
+  if (cost_json_path != nullptr && !LoadJsonFile(cost_json_path, &cost_json)) { return false; }
+  RenderGraphConfig graph{};
+  const char* const * buffer_name_list = nullptr;
+  if (!LoadRenderGraphForExport(render_graph_json_path, material_json_path, &graph, &buffer_name_list)) { return false; }
+  // headless exports show barriers split with the default cost model.
+  const BarrierSplitCostModel split_cost_model{};
+  const auto barrier_transition = PlanRenderGraphBarrierTransitions(graph, &split_cost_model, MemoryType::kFrame);
+  RenderGraphExportInfo info{
+    .buffer_name_list = buffer_name_list,
+    .render_pass_cost_msec = cost_json_path != nullptr ? ParseRenderPassCostJson(cost_json, graph, 0.0f, MemoryType::kFrame) : nullptr,
+    .barrier_transition = &barrier_transition,
+  };
+  if (!WriteTextFile(dst_dot_path, CreateRenderGraphDot(graph, info))) { return false; }
+  if (!WriteTextFile(dst_trace_path, CreateRenderGraphTraceJson(graph, info).dump(2))) { return false; }
+  loginfo("exported {} into {} and {}", render_graph_json_path, dst_dot_path, dst_trace_path);
+  return true;
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+#include <filesystem>
+#include <fstream>
+#include "d3d12_test_util.h"
+namespace {
+auto CountSubstring(const std::string& str, const std::string_view& substr) {
+  uint32_t count = 0;
+  for (auto pos = str.find(substr); pos != std::string::npos; pos = str.find(substr, pos + substr.size())) {
+    count++;
+  }
+  return count;
+}
+auto FindTraceEvent(const nlohmann::json& trace, const char* const category, const char* const name) {
+  const auto& events = trace.at("traceEvents");
+  const auto it = std::find_if(events.begin(), events.end(), [category, name](const auto& event) {
+    return event.contains("cat") && illuminate::GetStringView(event, "cat") == category && illuminate::GetStringView(event, "name") == name;
+  });
+  REQUIRE_UNARY(it != events.end());
+  return *it;
+}
+} // namespace
+TEST_CASE("render graph export") { // NOLINT
+  using namespace illuminate;
+  RenderGraphConfig render_graph{};
+  const auto [buffer_name_list, buffer_name_hash_list] = LoadTestRenderGraph(LoadTestJson("deferred.json"), &render_graph);
+  uint32_t wait_pass_num = 0;
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    wait_pass_num += render_graph.render_pass_list[i].wait_pass_num;
+  }
+  const BarrierSplitCostModel split_cost_model{};
+  const auto barrier_transition = PlanRenderGraphBarrierTransitions(render_graph, &split_cost_model, MemoryType::kFrame);
+  RenderGraphExportInfo info{
+    .buffer_name_list = buffer_name_list,
+    .render_pass_cost_msec = ParseRenderPassCostJson(LoadTestJson("deferred_timing.json"), render_graph, 0.0f, MemoryType::kFrame),
+    .barrier_transition = &barrier_transition,
+  };
+  SUBCASE("dot") {
+    const auto dot = CreateRenderGraphDot(render_graph, info);
+    CHECK_EQ(dot, CreateRenderGraphDot(render_graph, info));
+    CHECK_EQ(dot.rfind("digraph render_graph {", 0), 0);
+    CHECK_EQ(CountSubstring(dot, "subgraph cluster_queue"), render_graph.command_queue_num);
+    CHECK_EQ(CountSubstring(dot, "[shape=box"), render_graph.render_pass_num);
+    CHECK_EQ(CountSubstring(dot, "style=dashed"), wait_pass_num);
+    CHECK_NE(dot.find("label=\"queue 1 (compute)\""), std::string::npos);
+    CHECK_NE(dot.find("label=\"gbuffer\\n1.200 ms\\nbarriers "), std::string::npos);
+    const auto gbuffer = FindRenderPassIndex(render_graph, "gbuffer");
+    const auto lighting = FindRenderPassIndex(render_graph, "lighting");
+    const auto output = FindRenderPassIndex(render_graph, "output to swapchain");
+    const auto imgui = FindRenderPassIndex(render_graph, "imgui");
+    REQUIRE_LT(imgui, render_graph.render_pass_num);
+    CHECK_NE(dot.find(fmt::format("label=\"gbuffer0\\npass {}-{}\"]", gbuffer, lighting)), std::string::npos);
+    CHECK_NE(dot.find(fmt::format("label=\"primary\\npass {}-{}\"]", lighting, output)), std::string::npos);
+    CHECK_NE(dot.find(fmt::format("pass{} -> buffer", gbuffer)), std::string::npos);
+    // uav is drawn as both a read and a write as in CompileRenderGraph().
+    const auto primary = FindBufferIndex(buffer_name_hash_list, render_graph.buffer_num, "primary");
+    CHECK_NE(dot.find(fmt::format("buffer{} -> pass{} [label=\"uav\"]", primary, lighting)), std::string::npos);
+    CHECK_NE(dot.find(fmt::format("pass{} -> buffer{} [label=\"uav\"]", lighting, primary)), std::string::npos);
+    CHECK_NE(dot.find(fmt::format("buffer{} -> pass{} [label=\"srv_ps\"]", primary, output)), std::string::npos);
+    CHECK_EQ(dot.find(fmt::format("pass{} -> buffer{}", output, primary)), std::string::npos);
+    CHECK_NE(dot.find(fmt::format("pass{} -> pass{} [style=dashed", gbuffer, lighting)), std::string::npos);
+    // disabled passes are kept without edges.
+    render_graph.render_pass_list[imgui].enabled = false;
+    const auto dot_disabled = CreateRenderGraphDot(render_graph, info);
+    CHECK_EQ(CountSubstring(dot_disabled, "style=dotted"), 1);
+    CHECK_EQ(CountSubstring(dot_disabled, fmt::format("pass{} ->", imgui)), 0);
+    CHECK_EQ(CountSubstring(dot_disabled, fmt::format("-> pass{}", imgui)), 0);
+    render_graph.render_pass_list[imgui].enabled = true;
+  }
+  SUBCASE("trace") {
+    const auto trace = CreateRenderGraphTraceJson(render_graph, info);
+    CHECK_EQ(trace.dump(), CreateRenderGraphTraceJson(render_graph, info).dump());
+    // matches the async compute scheduler prediction for the authored graph.
+    CHECK_LT(std::abs(trace.at("otherData").at("frame_time_msec").get<float>() - 2.77f), 0.0001f);
+    uint32_t pass_num = 0;
+    uint32_t barrier_num = 0;
+    for (const auto& event : trace.at("traceEvents")) {
+      if (!event.contains("cat") || GetStringView(event, "cat") != "pass") { continue; }
+      pass_num++;
+      barrier_num += event.at("args").at("barriers").get<uint32_t>();
+    }
+    CHECK_EQ(pass_num, render_graph.render_pass_num);
+    uint32_t barrier_num_expected = 0;
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+        barrier_num_expected += barrier_transition.barrier_config_list[i][j].size;
+      }
+    }
+    CHECK_GT(barrier_num, 0);
+    CHECK_EQ(barrier_num, barrier_num_expected);
+    const auto gbuffer = FindTraceEvent(trace, "pass", "gbuffer");
+    CHECK_EQ(gbuffer.at("tid").get<uint32_t>(), 0);
+    CHECK_LT(std::abs(gbuffer.at("dur").get<double>() - 1200.0), 0.1);
+    const auto lighting = FindTraceEvent(trace, "pass", "lighting");
+    CHECK_EQ(lighting.at("tid").get<uint32_t>(), 1);
+    CHECK_EQ(lighting.at("args").at("wait_pass"), nlohmann::json::array({"gbuffer"}));
+    // buffers live from the start of the first pass to the end of the last.
+    const auto gbuffer0 = FindTraceEvent(trace, "buffer", "gbuffer0");
+    CHECK_EQ(gbuffer0.at("ts").get<double>(), gbuffer.at("ts").get<double>());
+    CHECK_LT(std::abs(gbuffer0.at("ts").get<double>() + gbuffer0.at("dur").get<double>() - lighting.at("ts").get<double>() - lighting.at("dur").get<double>()), 0.1);
+  }
+  SUBCASE("without split barriers") {
+    const auto unsplit_barrier_transition = PlanRenderGraphBarrierTransitions(render_graph, nullptr, MemoryType::kFrame);
+    for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+      for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+        const auto& barrier_config_list = unsplit_barrier_transition.barrier_config_list[i][j];
+        for (uint32_t k = 0; k < barrier_config_list.size; k++) {
+          CHECK_EQ(barrier_config_list.array[k].flag, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+        }
+      }
+    }
+  }
+  SUBCASE("headless export") {
+    const auto dot_path = (std::filesystem::temp_directory_path() / "render_graph_export_test.dot").string();
+    const auto trace_path = (std::filesystem::temp_directory_path() / "render_graph_export_test.json").string();
+    CHECK_UNARY(ExportRenderGraph("deferred.json", "material.json", "deferred_timing.json", dot_path.c_str(), trace_path.c_str()));
+    nlohmann::json trace;
+    CHECK_UNARY(LoadJsonFile(trace_path.c_str(), &trace));
+    CHECK_UNARY(trace.contains("traceEvents"));
+    CHECK_GT(std::filesystem::file_size(dot_path), 0);
+    CHECK_FALSE(ExportRenderGraph("not_found.json", "material.json", nullptr, dot_path.c_str(), trace_path.c_str()));
+    std::filesystem::remove(dot_path);
+    std::filesystem::remove(trace_path);
+  }
+  ClearAllAllocations();
+}
@@ -0,0 +1,46 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_EXPORT_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_EXPORT_H
+#include <string>
+#include <string_view>
+#include "d3d12_barriers.h"
+#include "d3d12_render_graph.h"
+#include "illuminate/d3d12/render_graph_export.h"
+#include <nlohmann/json.hpp>
+namespace illuminate {
+enum class MemoryType : uint8_t;
+/**
+ * text views of a render graph meant to be diffed (no pointers nor timestamps in the output).
+ * the dot graph has a cluster per queue, passes in queue order, buffers with their lifetimes (first and last enabled pass),
+ * solid edges for buffer reads and writes (as classified by IsResourceStateReading/Writing()) labelled with states and dashed edges for waits. disabled passes are drawn dotted without edges.
+ * the trace json follows the chrome trace event format (chrome://tracing, perfetto): a track per queue with the predicted
+ * timeline of enabled passes and a track per buffer spanning its lifetime.
+ * pass times come from render_pass_cost_msec, i.e. GetRenderPassCostMsec() from measured GpuTimeDurations or cost estimates.
+ * barrier counts per pass come from barrier_transition when it is set.
+ **/
+struct RenderGraphExportInfo {
+  const char* const * buffer_name_list{nullptr}; // from ParseRenderGraphJson().
+  const float* render_pass_cost_msec{nullptr};   // nullptr to omit times from the dot graph and to predict with RenderPassStaticCostModel.
+  const BarrierTransitionInfo* barrier_transition{nullptr};
+  float fence_latency_msec{0.05f};
+};
+std::string CreateRenderGraphDot(const RenderGraphConfig& graph, const RenderGraphExportInfo& info);
+nlohmann::json CreateRenderGraphTraceJson(const RenderGraphConfig& graph, const RenderGraphExportInfo& info);
+/**
+ * plans barriers of the first frame without a device: buffer allocation indices follow CreateBuffers(),
+ * buffers start in their initial states, and buffers are tracked as a whole.
+ * split_cost_model is passed to ConfigureBarrierTransitions(), nullptr to disable split barriers.
+ **/
+BarrierTransitionInfo PlanRenderGraphBarrierTransitions(const RenderGraphConfig& graph, const BarrierSplitCostModel* split_cost_model, const MemoryType& memory_type);
+// helpers shared with other headless reports (e.g. CreateBarrierModeComparisonJson()).
+const char* GetCommandQueueTypeName(const D3D12_COMMAND_LIST_TYPE type);
+// interned pass name, or "pass <index>".
+std::string GetRenderPassName(const RenderGraphConfig& graph, const uint32_t pass_index);
+// name from info.buffer_name_list, or "buffer <index>".
+std::string GetBufferName(const RenderGraphExportInfo& info, const uint32_t buffer_index);
+// legacy barriers of a pass in info.barrier_transition.
+uint32_t GetBarrierNum(const RenderGraphExportInfo& info, const uint32_t pass_index);
+bool WriteTextFile(const char* const path, const std::string_view& text);
+// parses, validates and compiles a render graph json file in frame memory.
+bool LoadRenderGraphForExport(const char* const render_graph_json_path, const char* const material_json_path, RenderGraphConfig* graph, const char* const ** buffer_name_list);
+}
+#endif
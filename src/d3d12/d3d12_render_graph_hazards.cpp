@@ -0,0 +1,252 @@
+#include "d3d12_render_graph_hazards.h"
+#include <algorithm>
+#include "d3d12_gpu_buffer_allocator.h"
+#include "d3d12_memory_allocators.h"
+#include "d3d12_render_graph_compiler.h"
+#include "d3d12_scene.h"
+#include "d3d12_src_common.h"
+#include "illuminate/util/string_table.h"
+namespace illuminate {
+namespace {
+static const uint32_t kInvalidIndex = ~0U;
+auto CountBufferAccess(const RenderGraphConfig& render_graph) {
+  uint32_t access_num = 0;
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    const auto& render_pass = render_graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    access_num += render_pass.buffer_num;
+  }
+  return access_num * render_graph.frame_buffer_num;
+}
+} // namespace
+const char* GetRenderGraphHazardTypeName(const RenderGraphHazardType type) {
+  switch (type) {
+    case RenderGraphHazardType::kReadAfterWrite:  { return "read after write"; }
+    case RenderGraphHazardType::kWriteAfterRead:  { return "write after read"; }
+    case RenderGraphHazardType::kWriteAfterWrite: { return "write after write"; }
+  }
+  return "unknown";
+}
+ArrayOf<RenderGraphHazard> DetectRenderGraphHazards(const RenderGraphConfig& render_graph, const MemoryType& memory_type) {
+  const auto queue_num = render_graph.command_queue_num;
+  // an access conflicts with at most the last writer and one reader per other queue.
+  auto hazard_list = AllocateArray<RenderGraphHazard>(memory_type, CountBufferAccess(render_graph) * std::max(queue_num, 1U));
+  uint32_t hazard_num = 0;
+  FrameMemoryCheckpoint checkpoint;
+  auto buffer_allocation_index_base = AllocateArrayFrame<uint32_t>(render_graph.buffer_num);
+  uint32_t buffer_allocation_num = 0;
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    buffer_allocation_index_base[i] = buffer_allocation_num;
+    buffer_allocation_num += GetBufferAllocationNum(render_graph.buffer_list[i], render_graph.frame_buffer_num);
+  }
+  auto render_pass_enable_flag = AllocateArrayFrame<bool>(render_graph.render_pass_num);
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    render_pass_enable_flag[i] = render_graph.render_pass_list[i].enabled;
+  }
+  auto write_to_sub = AllocateArrayFrame<bool*>(render_graph.buffer_num);
+  for (uint32_t i = 0; i < render_graph.buffer_num; i++) {
+    write_to_sub[i] = AllocateArrayFrame<bool>(render_graph.render_pass_num);
+  }
+  ConfigurePingPongBufferWriteToSubList(render_graph.render_pass_num, render_graph.render_pass_list, render_pass_enable_flag, render_graph.buffer_num, write_to_sub);
+  const auto known_pass = CollectKnownFinishedPass(render_graph, render_pass_enable_flag, MemoryType::kFrame);
+  auto last_writer = AllocateAndFillArrayFrame(buffer_allocation_num, kInvalidIndex);
+  auto last_reader = AllocateAndFillArrayFrame(buffer_allocation_num * queue_num, kInvalidIndex); // since last_writer, per queue.
+  const auto add_hazard = [&](const RenderGraphHazardType type, const uint32_t buffer_allocation_index, const uint32_t buffer_config_index, const uint32_t prev_pass, const uint32_t pass) {
+    auto& hazard = hazard_list[hazard_num];
+    hazard.type = type;
+    hazard.buffer_allocation_index = buffer_allocation_index;
+    hazard.buffer_config_index = buffer_config_index;
+    hazard.prev_pass = prev_pass;
+    hazard.pass = pass;
+    hazard_num++;
+    logerror("render graph {} hazard on buffer {} (allocation {}): {} -> {}", GetRenderGraphHazardTypeName(type), buffer_config_index, buffer_allocation_index,
+             GetInternedString(render_graph.render_pass_list[prev_pass].name), GetInternedString(render_graph.render_pass_list[pass].name));
+  };
+  // frame buffered copies are only bound in their own frames, pingpong sides do not depend on frames.
+  const auto for_each_access = [&](const RenderPass& render_pass, const uint32_t pass_index, auto&& f) {
+    for (uint32_t frame_index = 0; frame_index < render_graph.frame_buffer_num; frame_index++) {
+      for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+        const auto& buffer = render_pass.buffer_list[j];
+        if (IsSceneBuffer(buffer.buffer_index) || buffer.buffer_index >= render_graph.buffer_num) { continue; }
+        const auto& config = render_graph.buffer_list[buffer.buffer_index];
+        if ((!config.frame_buffered || config.pingpong) && frame_index > 0) { continue; }
+        const auto local_index = GetBufferLocalIndex(config, buffer.state, write_to_sub[buffer.buffer_index][pass_index], frame_index);
+        f(buffer.buffer_index, buffer_allocation_index_base[buffer.buffer_index] + local_index, buffer.state);
+      }
+    }
+  };
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    const auto& render_pass = render_graph.render_pass_list[i];
+    if (!render_pass.enabled) { continue; }
+    const auto queue_index = render_pass.command_queue_index;
+    const auto known = &known_pass[i * queue_num];
+    const auto is_ordered = [&](const uint32_t prev_pass) {
+      return render_graph.render_pass_list[prev_pass].command_queue_index == queue_index
+          || known[render_graph.render_pass_list[prev_pass].command_queue_index] > prev_pass;
+    };
+    for_each_access(render_pass, i, [&](const uint32_t buffer_config_index, const uint32_t buffer_allocation_index, const ResourceStateType state) {
+      const auto write = IsResourceStateWriting(state);
+      if (const auto writer = last_writer[buffer_allocation_index]; writer != kInvalidIndex && writer != i && !is_ordered(writer)) {
+        add_hazard(write ? RenderGraphHazardType::kWriteAfterWrite : RenderGraphHazardType::kReadAfterWrite, buffer_allocation_index, buffer_config_index, writer, i);
+      }
+      if (!write) { return; }
+      for (uint32_t q = 0; q < queue_num; q++) {
+        const auto reader = last_reader[buffer_allocation_index * queue_num + q];
+        if (q == queue_index || reader == kInvalidIndex || reader == i || is_ordered(reader)) { continue; }
+        add_hazard(RenderGraphHazardType::kWriteAfterRead, buffer_allocation_index, buffer_config_index, reader, i);
+      }
+    });
+    for_each_access(render_pass, i, [&](const uint32_t, const uint32_t buffer_allocation_index, const ResourceStateType state) {
+      if (!IsResourceStateWriting(state)) { return; }
+      last_writer[buffer_allocation_index] = i;
+      std::fill_n(&last_reader[buffer_allocation_index * queue_num], queue_num, kInvalidIndex);
+    });
+    for_each_access(render_pass, i, [&](const uint32_t, const uint32_t buffer_allocation_index, const ResourceStateType state) {
+      if (!IsResourceStateReading(state) || last_writer[buffer_allocation_index] == i) { return; }
+      last_reader[buffer_allocation_index * queue_num + queue_index] = i;
+    });
+  }
+  return {hazard_num, hazard_list};
+}
+}
+#include "doctest/doctest.h"
+#include "d3d12_test_util.h"
+namespace {
+auto& FindRenderPassJson(nlohmann::json& json, const char* const name) {
+  auto& render_pass_list = json.at("render_pass");
+  const auto it = std::find_if(render_pass_list.begin(), render_pass_list.end(), [name](const auto& pass) { return illuminate::GetStringView(pass, "name") == name; });
+  REQUIRE_UNARY(it != render_pass_list.end());
+  return *it;
+}
+} // namespace
+TEST_CASE("render graph hazards") { // NOLINT
+  using namespace illuminate;
+  SUBCASE("sample graphs") {
+    for (const auto filename : {"deferred.json", "forward.json", "config.json"}) {
+      CAPTURE(filename);
+      RenderGraphConfig render_graph{};
+      LoadTestRenderGraph(LoadTestJson(filename), &render_graph);
+      CHECK_EQ(DetectRenderGraphHazards(render_graph, MemoryType::kFrame).size, 0);
+    }
+  }
+  SUBCASE("read after write") {
+    auto json = LoadTestJson("deferred.json");
+    FindRenderPassJson(json, "lighting").erase("wait_pass");
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    const auto hazards = DetectRenderGraphHazards(render_graph, MemoryType::kFrame);
+    REQUIRE_EQ(hazards.size, 4);
+    for (uint32_t i = 0; i < hazards.size; i++) {
+      const auto& hazard = hazards.array[i];
+      CHECK_EQ(hazard.type, RenderGraphHazardType::kReadAfterWrite);
+      CHECK_EQ(hazard.prev_pass, FindRenderPassIndex(render_graph, "gbuffer"));
+      CHECK_EQ(hazard.pass, FindRenderPassIndex(render_graph, "lighting"));
+      const auto name = std::string("gbuffer") + std::to_string(i);
+      CHECK_EQ(hazard.buffer_config_index, FindBufferIndex(buffer_name_hash_list, render_graph.buffer_num, name.c_str()));
+    }
+  }
+  SUBCASE("write after read") {
+    auto json = LoadTestJson("deferred.json");
+    json.at("render_pass").push_back({{"name", "clear primary"}, {"type", "test"}, {"command_queue", "queue_compute"}, {"buffer_list", {{{"name", "primary"}, {"state", "uav"}}}}});
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    auto hazards = DetectRenderGraphHazards(render_graph, MemoryType::kFrame);
+    REQUIRE_EQ(hazards.size, 1);
+    CHECK_EQ(hazards.array[0].type, RenderGraphHazardType::kWriteAfterRead);
+    CHECK_EQ(hazards.array[0].buffer_config_index, FindBufferIndex(buffer_name_hash_list, render_graph.buffer_num, "primary"));
+    CHECK_EQ(hazards.array[0].prev_pass, FindRenderPassIndex(render_graph, "output to swapchain"));
+    CHECK_EQ(hazards.array[0].pass, FindRenderPassIndex(render_graph, "clear primary"));
+    // waiting for the reader fixes it.
+    FindRenderPassJson(json, "clear primary")["wait_pass"] = {"output to swapchain"};
+    RenderGraphConfig render_graph_fixed{};
+    LoadTestRenderGraph(json, &render_graph_fixed);
+    CHECK_EQ(DetectRenderGraphHazards(render_graph_fixed, MemoryType::kFrame).size, 0);
+  }
+  SUBCASE("write after write") {
+    auto json = LoadTestJson("forward.json");
+    json.at("render_pass").push_back({{"name", "clear primary"}, {"type", "test"}, {"command_queue", "queue_compute"}, {"wait_pass", {"copy resource"}}, {"buffer_list", {{{"name", "primary"}, {"state", "uav"}}}}});
+    RenderGraphConfig render_graph{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph).second;
+    const auto hazards = DetectRenderGraphHazards(render_graph, MemoryType::kFrame);
+    // forward writes primary and output to swapchain reads it on the graphics queue, neither is waited for.
+    REQUIRE_EQ(hazards.size, 2);
+    const auto clear_primary = FindRenderPassIndex(render_graph, "clear primary");
+    const auto primary = FindBufferIndex(buffer_name_hash_list, render_graph.buffer_num, "primary");
+    CHECK_EQ(hazards.array[0].type, RenderGraphHazardType::kWriteAfterWrite);
+    CHECK_EQ(hazards.array[0].prev_pass, FindRenderPassIndex(render_graph, "forward"));
+    CHECK_EQ(hazards.array[1].type, RenderGraphHazardType::kWriteAfterRead);
+    CHECK_EQ(hazards.array[1].prev_pass, FindRenderPassIndex(render_graph, "output to swapchain"));
+    for (uint32_t i = 0; i < hazards.size; i++) {
+      CHECK_EQ(hazards.array[i].buffer_config_index, primary);
+      CHECK_EQ(hazards.array[i].buffer_allocation_index, hazards.array[0].buffer_allocation_index);
+      CHECK_EQ(hazards.array[i].pass, clear_primary);
+    }
+  }
+  SUBCASE("transitive waits") {
+    // gbuffer and linear depth read dsv on different queues, clear dsv overwrites it on the copy queue.
+    auto json = LoadTestJson("deferred.json");
+    json.at("render_pass").push_back({{"name", "clear dsv"}, {"type", "test"}, {"command_queue", "queue_copy"}, {"wait_pass", {"lighting"}}, {"buffer_list", {{{"name", "dsv"}, {"state", "copy_dest"}}}}});
+    RenderGraphConfig render_graph{};
+    LoadTestRenderGraph(json, &render_graph);
+    // lighting follows linear depth on its queue and waited for gbuffer.
+    CHECK_EQ(DetectRenderGraphHazards(render_graph, MemoryType::kFrame).size, 0);
+    FindRenderPassJson(json, "clear dsv")["wait_pass"] = {"linear depth"};
+    RenderGraphConfig render_graph_unordered{};
+    LoadTestRenderGraph(json, &render_graph_unordered);
+    const auto hazards = DetectRenderGraphHazards(render_graph_unordered, MemoryType::kFrame);
+    // linear depth waited for prez only, which ran before gbuffer.
+    REQUIRE_EQ(hazards.size, 1);
+    CHECK_EQ(hazards.array[0].type, RenderGraphHazardType::kWriteAfterRead);
+    CHECK_EQ(hazards.array[0].prev_pass, FindRenderPassIndex(render_graph_unordered, "gbuffer"));
+  }
+  SUBCASE("copy source on another queue") {
+    // copy primary reads primary on the copy queue as output to swapchain does on the graphics queue.
+    auto json = LoadTestJson("deferred.json");
+    json.at("buffer").push_back({{"name", "primary readback"}, {"dimension", "buffer"}, {"heap_type", "readback"}, {"num_elements", 1024}, {"stride_bytes", 4}});
+    json.at("render_pass").push_back({{"name", "copy primary"}, {"type", "test"}, {"command_queue", "queue_copy"}, {"wait_pass", {"lighting"}},
+                                      {"buffer_list", {{{"name", "primary"}, {"state", "copy_source"}}, {{"name", "primary readback"}, {"state", "copy_dest"}}}}});
+    RenderGraphConfig render_graph{};
+    LoadTestRenderGraph(json, &render_graph);
+    CHECK_EQ(DetectRenderGraphHazards(render_graph, MemoryType::kFrame).size, 0);
+    FindRenderPassJson(json, "copy primary").erase("wait_pass");
+    RenderGraphConfig render_graph_unordered{};
+    LoadTestRenderGraph(json, &render_graph_unordered);
+    const auto hazards = DetectRenderGraphHazards(render_graph_unordered, MemoryType::kFrame);
+    REQUIRE_EQ(hazards.size, 1);
+    CHECK_EQ(hazards.array[0].type, RenderGraphHazardType::kReadAfterWrite);
+    CHECK_EQ(hazards.array[0].prev_pass, FindRenderPassIndex(render_graph_unordered, "lighting"));
+    CHECK_EQ(hazards.array[0].pass, FindRenderPassIndex(render_graph_unordered, "copy primary"));
+    // waits derived by the compiler leave no hazard, the copy waits for the writer only.
+    for (auto& pass : json.at("render_pass")) {
+      pass.erase("wait_pass");
+    }
+    RenderGraphConfig render_graph_compiled{};
+    const auto buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph_compiled).second;
+    CHECK_EQ(CompileRenderGraph(buffer_name_hash_list, MemoryType::kFrame, &render_graph_compiled).culled_pass_num, 0);
+    CHECK_EQ(DetectRenderGraphHazards(render_graph_compiled, MemoryType::kFrame).size, 0);
+    const auto& copy_primary = render_graph_compiled.render_pass_list[FindRenderPassIndex(render_graph_compiled, "copy primary")];
+    REQUIRE_EQ(copy_primary.wait_pass_num, 1);
+    CHECK_EQ(copy_primary.signal_pass_index[0], FindRenderPassIndex(render_graph_compiled, "lighting"));
+  }
+  SUBCASE("pingpong buffers") {
+    auto json = LoadTestJson("config.json");
+    FindRenderPassJson(json, "pingpong-b")["command_queue"] = "queue_compute";
+    RenderGraphConfig render_graph{};
+    LoadTestRenderGraph(json, &render_graph);
+    const auto hazards = DetectRenderGraphHazards(render_graph, MemoryType::kFrame);
+    const auto pingpong_a = FindRenderPassIndex(render_graph, "pingpong-a");
+    const auto pingpong_b = FindRenderPassIndex(render_graph, "pingpong-b");
+    const auto pingpong_c = FindRenderPassIndex(render_graph, "pingpong-c");
+    // b reads what a wrote and writes the other side, which c reads, then c overwrites what b read.
+    REQUIRE_EQ(hazards.size, 3);
+    CHECK_EQ(hazards.array[0].type, RenderGraphHazardType::kReadAfterWrite);
+    CHECK_EQ(hazards.array[0].prev_pass, pingpong_a);
+    CHECK_EQ(hazards.array[0].pass, pingpong_b);
+    for (uint32_t i = 1; i < hazards.size; i++) {
+      CHECK_EQ(hazards.array[i].prev_pass, pingpong_b);
+      CHECK_EQ(hazards.array[i].pass, pingpong_c);
+    }
+    CHECK_NE(hazards.array[1].buffer_allocation_index, hazards.array[2].buffer_allocation_index);
+  }
+  ClearAllAllocations();
+}
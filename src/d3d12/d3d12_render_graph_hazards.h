@@ -0,0 +1,29 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_HAZARDS_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_HAZARDS_H
+#include "d3d12_render_graph.h"
+#include "illuminate/util/util_defines.h"
+namespace illuminate {
+enum class MemoryType : uint8_t;
+/**
+ * finds buffer accesses from different queues in a frame that the graph's wait lists do not order,
+ * i.e. data races hand-written wait_pass lists can introduce.
+ * queue timelines are simulated with the vector clocks of CollectKnownFinishedPass(): passes on a queue run in order, a wait merges what the signaling pass knew.
+ * accesses are checked per buffer allocation as CreateBuffers() creates them (pingpong sides and frame buffered copies individually),
+ * buffer states are classified by IsResourceStateWriting() and IsResourceStateReading() as CompileRenderGraph() does. scene buffers are ignored.
+ * an access is checked against the last writer and, when writing, the last reader on each other queue since then,
+ * being ordered after them implies being ordered after earlier accesses on their queues, unordered earlier writers are reported on their own.
+ * frames are assumed to be ordered by other means as CompileRenderGraph() does, disabled passes are ignored.
+ * each hazard is logged, returned hazards are in pass order.
+ **/
+enum class RenderGraphHazardType : uint8_t { kReadAfterWrite, kWriteAfterRead, kWriteAfterWrite, };
+struct RenderGraphHazard {
+  RenderGraphHazardType type{};
+  uint32_t buffer_allocation_index{};
+  uint32_t buffer_config_index{};
+  uint32_t prev_pass{}; // render pass list indices, prev_pass < pass.
+  uint32_t pass{};
+};
+ArrayOf<RenderGraphHazard> DetectRenderGraphHazards(const RenderGraphConfig& render_graph, const MemoryType& memory_type);
+const char* GetRenderGraphHazardTypeName(const RenderGraphHazardType type);
+}
+#endif
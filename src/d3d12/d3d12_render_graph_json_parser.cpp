@@ -1,78 +1,73 @@
 #include "d3d12_render_graph.h"
 #include "d3d12_render_graph_json_parser.h"
+#include <charconv>
 #include "d3d12_src_common.h"
+#include "illuminate/util/perfect_hash.h"
+#include "illuminate/util/string_table.h"
 namespace illuminate {
 namespace {
+constexpr auto kHeapTypeTable = CreatePerfectHashTable<D3D12_HEAP_TYPE>({
+    {"default", D3D12_HEAP_TYPE_DEFAULT},
+    {"upload", D3D12_HEAP_TYPE_UPLOAD},
+    {"readback", D3D12_HEAP_TYPE_READBACK},
+  });
 D3D12_HEAP_TYPE GetHeapType(const nlohmann::json& j, const char* entity_name) {
   if (!j.contains(entity_name)) {
     return D3D12_HEAP_TYPE_DEFAULT;
   }
   auto str = GetStringView(j, entity_name);
-  if (str.compare("default") == 0) {
-    return D3D12_HEAP_TYPE_DEFAULT;
-  }
-  if (str.compare("upload") == 0) {
-    return D3D12_HEAP_TYPE_UPLOAD;
-  }
-  if (str.compare("readback") == 0) {
-    return D3D12_HEAP_TYPE_READBACK;
+  if (auto heap_type = kHeapTypeTable.Find(str); heap_type != nullptr) {
+    return *heap_type;
   }
   assert(false && "invalid heap type");
   return D3D12_HEAP_TYPE_DEFAULT;
 }
+constexpr auto kDimensionTable = CreatePerfectHashTable<D3D12_RESOURCE_DIMENSION>({
+    {"buffer", D3D12_RESOURCE_DIMENSION_BUFFER},
+    {"texture1d", D3D12_RESOURCE_DIMENSION_TEXTURE1D},
+    {"texture2d", D3D12_RESOURCE_DIMENSION_TEXTURE2D},
+    {"texture3d", D3D12_RESOURCE_DIMENSION_TEXTURE3D},
+  });
 D3D12_RESOURCE_DIMENSION GetDimension(const nlohmann::json& j, const char* entity_name) {
   if (!j.contains(entity_name)) {
     return D3D12_RESOURCE_DIMENSION_TEXTURE2D;
   }
   auto str = GetStringView(j, entity_name);
-  if (str.compare("buffer") == 0) {
-    return D3D12_RESOURCE_DIMENSION_BUFFER;
-  }
-  if (str.compare("texture1d") == 0) {
-    return D3D12_RESOURCE_DIMENSION_TEXTURE1D;
-  }
-  if (str.compare("texture2d") == 0) {
-    return D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-  }
-  if (str.compare("texture3d") == 0) {
-    return D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+  if (auto dimension = kDimensionTable.Find(str); dimension != nullptr) {
+    return *dimension;
   }
   assert(false && "invalid resource dimension");
   return D3D12_RESOURCE_DIMENSION_UNKNOWN;
 }
+constexpr auto kTextureLayoutTable = CreatePerfectHashTable<D3D12_TEXTURE_LAYOUT>({
+    {"unknown", D3D12_TEXTURE_LAYOUT_UNKNOWN},
+    {"row_major", D3D12_TEXTURE_LAYOUT_ROW_MAJOR},
+    {"64kb_undefined_swizzle", D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE},
+    {"64kb_standard_swizzle", D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE},
+  });
 D3D12_TEXTURE_LAYOUT GetTextureLayout(const nlohmann::json& j, const char* entity_name) {
   if (!j.contains(entity_name)) {
     return D3D12_TEXTURE_LAYOUT_UNKNOWN;
   }
   auto str = GetStringView(j, entity_name);
-  if (str.compare("unknown") == 0) {
-    return D3D12_TEXTURE_LAYOUT_UNKNOWN;
-  }
-  if (str.compare("row_major") == 0) {
-    return D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-  }
-  if (str.compare("64kb_undefined_swizzle") == 0) {
-    return D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
-  }
-  if (str.compare("64kb_standard_swizzle") == 0) {
-    return D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE;
+  if (auto layout = kTextureLayoutTable.Find(str); layout != nullptr) {
+    return *layout;
   }
   assert(false && "invalid texture layout");
   return D3D12_TEXTURE_LAYOUT_UNKNOWN;
 }
+constexpr auto kBufferSizeRelativenessTable = CreatePerfectHashTable<BufferSizeRelativeness>({
+    {"swapchain_relative", BufferSizeRelativeness::kSwapchainRelative},
+    {"primary_relative", BufferSizeRelativeness::kPrimaryBufferRelative},
+    {"absolute", BufferSizeRelativeness::kAbsolute},
+  });
 auto GetBufferSizeRelativeness(const nlohmann::json& j, const char* const name) {
   if (!j.contains(name)) {
     return BufferSizeRelativeness::kPrimaryBufferRelative;
   }
   auto str = GetStringView(j, name);
-  if (str.compare("swapchain_relative") == 0) {
-    return BufferSizeRelativeness::kSwapchainRelative;
-  }
-  if (str.compare("primary_relative") == 0) {
-    return BufferSizeRelativeness::kPrimaryBufferRelative;
-  }
-  if (str.compare("absolute") == 0) {
-    return BufferSizeRelativeness::kAbsolute;
+  if (auto size_type = kBufferSizeRelativenessTable.Find(str); size_type != nullptr) {
+    return *size_type;
   }
   logerror("invalid buffer size type {}", name);
   assert(false && "invalid buffer size type");
@@ -119,58 +114,46 @@ void GetBufferConfig(const nlohmann::json& j, BufferConfig* config) {
   config->raw_buffer = GetBool(j, "raw_buffer", false);
   // clear color/depth/stencil are set later.
 }
+constexpr auto kFilterTypeTable = CreatePerfectHashTable<D3D12_FILTER_TYPE>({
+    {"point", D3D12_FILTER_TYPE_POINT},
+    {"linear", D3D12_FILTER_TYPE_LINEAR},
+  });
 D3D12_FILTER_TYPE GetFilterType(const nlohmann::json& j, const char* const name) {
   if (!j.contains(name)) { return D3D12_FILTER_TYPE_POINT; }
-  auto str = GetStringView(j, name);
-  return (strcmp(str.data(), "linear") == 0) ? D3D12_FILTER_TYPE_LINEAR : D3D12_FILTER_TYPE_POINT;
+  auto filter_type = kFilterTypeTable.Find(GetStringView(j, name));
+  return (filter_type != nullptr) ? *filter_type : D3D12_FILTER_TYPE_POINT;
 }
+constexpr auto kAddressModeTable = CreatePerfectHashTable<D3D12_TEXTURE_ADDRESS_MODE>({
+    {"wrap", D3D12_TEXTURE_ADDRESS_MODE_WRAP},
+    {"mirror", D3D12_TEXTURE_ADDRESS_MODE_MIRROR},
+    {"clamp", D3D12_TEXTURE_ADDRESS_MODE_CLAMP},
+    {"border", D3D12_TEXTURE_ADDRESS_MODE_BORDER},
+    {"mirror_once", D3D12_TEXTURE_ADDRESS_MODE_MIRROR_ONCE},
+  });
 D3D12_TEXTURE_ADDRESS_MODE GetAddressMode(const nlohmann::json& j) {
-  auto str = GetStringView(j).data();
-  if (strcmp(str, "wrap") == 0) {
-    return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-  }
-  if (strcmp(str, "mirror") == 0) {
-    return D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
-  }
-  if (strcmp(str, "clamp") == 0) {
-    return D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-  }
-  if (strcmp(str, "border") == 0) {
-    return D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-  }
-  if (strcmp(str, "mirror_once") == 0) {
-    return D3D12_TEXTURE_ADDRESS_MODE_MIRROR_ONCE;
+  auto str = GetStringView(j);
+  if (auto mode = kAddressModeTable.Find(str); mode != nullptr) {
+    return *mode;
   }
   logerror("invalid texture address mode:{}", str);
   assert(false && "invalid texture address mode");
   return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
 }
+constexpr auto kComparisonFuncTable = CreatePerfectHashTable<D3D12_COMPARISON_FUNC>({
+    {"never", D3D12_COMPARISON_FUNC_NEVER},
+    {"less", D3D12_COMPARISON_FUNC_LESS},
+    {"equal", D3D12_COMPARISON_FUNC_EQUAL},
+    {"less_equal", D3D12_COMPARISON_FUNC_LESS_EQUAL},
+    {"greater", D3D12_COMPARISON_FUNC_GREATER},
+    {"not_equal", D3D12_COMPARISON_FUNC_NOT_EQUAL},
+    {"greater_equal", D3D12_COMPARISON_FUNC_GREATER_EQUAL},
+    {"always", D3D12_COMPARISON_FUNC_ALWAYS},
+  });
 D3D12_COMPARISON_FUNC GetComparisonFunc(const nlohmann::json& j, const char* const name) {
   if (!j.contains(name)) { return D3D12_COMPARISON_FUNC_NEVER; }
-  auto str = GetStringView(j, name).data();
-  if (strcmp(str, "never") == 0) {
-    return D3D12_COMPARISON_FUNC_NEVER;
-  }
-  if (strcmp(str, "less") == 0) {
-    return D3D12_COMPARISON_FUNC_LESS;
-  }
-  if (strcmp(str, "equal") == 0) {
-    return D3D12_COMPARISON_FUNC_EQUAL;
-  }
-  if (strcmp(str, "less_equal") == 0) {
-    return D3D12_COMPARISON_FUNC_LESS_EQUAL;
-  }
-  if (strcmp(str, "greater") == 0) {
-    return D3D12_COMPARISON_FUNC_GREATER;
-  }
-  if (strcmp(str, "not_equal") == 0) {
-    return D3D12_COMPARISON_FUNC_NOT_EQUAL;
-  }
-  if (strcmp(str, "greater_equal") == 0) {
-    return D3D12_COMPARISON_FUNC_GREATER_EQUAL;
-  }
-  if (strcmp(str, "always") == 0) {
-    return D3D12_COMPARISON_FUNC_ALWAYS;
+  auto str = GetStringView(j, name);
+  if (auto func = kComparisonFuncTable.Find(str); func != nullptr) {
+    return *func;
   }
   logerror("invalid comparison func:{}", str);
   assert(false && "invalid comparison func");
@@ -229,11 +212,11 @@ auto GetDxgiFormatFromMaterial(const RenderPassBuffer* render_graph_buffer_list,
   }
   return DXGI_FORMAT_UNKNOWN;
 }
-auto FindBufferIndex(const uint32_t buffer_num, const StrHash* name_list, const StrHash& name) {
-  for (uint32_t i = 0; i < buffer_num; i++) {
-    if (name_list[i] == name) { return i; }
-  }
-  return buffer_num;
+// name hash -> index maps are built in frame memory so that resolving names stays O(1) in large graphs.
+using IndexMap = HashMap<uint32_t, MemoryTypeAllocator>;
+auto FindMappedIndex(const IndexMap& index_map, const StrHash& name, const uint32_t not_found_val) {
+  const auto index = index_map.Get(name);
+  return index == nullptr ? not_found_val : *index;
 }
 auto InitializeBufferConfig(const uint32_t buffer_index, BufferConfig* buffer) {
   buffer->buffer_index          = buffer_index;
@@ -261,6 +244,16 @@ auto InitializeBufferConfig(const uint32_t buffer_index, BufferConfig* buffer) {
   buffer->stride_bytes          = 0;
   buffer->raw_buffer            = false;
 }
+constexpr auto kCommandQueueTypeTable = CreatePerfectHashTable<D3D12_COMMAND_LIST_TYPE>({
+    {"3d", D3D12_COMMAND_LIST_TYPE_DIRECT},
+    {"compute", D3D12_COMMAND_LIST_TYPE_COMPUTE},
+    {"copy", D3D12_COMMAND_LIST_TYPE_COPY},
+  });
+constexpr auto kCommandQueuePriorityTable = CreatePerfectHashTable<D3D12_COMMAND_QUEUE_PRIORITY>({
+    {"normal", D3D12_COMMAND_QUEUE_PRIORITY_NORMAL},
+    {"high", D3D12_COMMAND_QUEUE_PRIORITY_HIGH},
+    {"global realtime", D3D12_COMMAND_QUEUE_PRIORITY_GLOBAL_REALTIME},
+  });
 auto GetCBufferParamType(const nlohmann::json& j) {
   if (j.contains("need_ui") && j.at("need_ui") == false) {
     return CBufferParamType::kSpecial;
@@ -273,6 +266,33 @@ auto GetCBufferParamType(const nlohmann::json& j) {
   return CBufferParamType::kFloat;
 }
 } // namespace
+void ConfigureCommandAllocatorNumPerQueueType(RenderGraphConfig* graph) {
+  const auto index_direct = GetCommandQueueTypeIndex(D3D12_COMMAND_LIST_TYPE_DIRECT);
+  const auto index_compute = GetCommandQueueTypeIndex(D3D12_COMMAND_LIST_TYPE_COMPUTE);
+  const auto index_copy = GetCommandQueueTypeIndex(D3D12_COMMAND_LIST_TYPE_COPY);
+  // +1 for last pass execution
+  graph->command_allocator_num_per_queue_type[index_direct] = 1;
+  graph->command_allocator_num_per_queue_type[index_compute] = 1;
+  graph->command_allocator_num_per_queue_type[index_copy] = 1;
+  for (uint32_t i = 0; i < graph->render_pass_num; i++) {
+    const auto& pass = graph->render_pass_list[i];
+    if (!pass.sends_signal) { continue; }
+    switch (graph->command_queue_type[pass.command_queue_index]) {
+      case D3D12_COMMAND_LIST_TYPE_DIRECT: {
+        graph->command_allocator_num_per_queue_type[index_direct]++;
+        break;
+      }
+      case D3D12_COMMAND_LIST_TYPE_COMPUTE: {
+        graph->command_allocator_num_per_queue_type[index_compute]++;
+        break;
+      }
+      case D3D12_COMMAND_LIST_TYPE_COPY: {
+        graph->command_allocator_num_per_queue_type[index_copy]++;
+        break;
+      }
+    }
+  }
+}
 std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohmann::json& j, const uint32_t material_num, StrHash* material_hash_list, const DXGI_FORMAT* const * rtv_format_list, const DXGI_FORMAT* dsv_format, RenderGraphConfig* graph) {
   auto& r = *graph;
   j.at("frame_buffer_num").get_to(r.frame_buffer_num);
@@ -294,22 +314,10 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
     r.command_list_num_per_queue = AllocateArraySystem<uint32_t>(r.command_queue_num);
     for (uint32_t i = 0; i < r.command_queue_num; i++) {
       r.command_queue_name[i] = CalcEntityStrHash(command_queues[i], "name");
-      auto command_queue_type_str = GetStringView(command_queues[i], "type");
-      if (command_queue_type_str.compare("compute") == 0) {
-        r.command_queue_type[i] = D3D12_COMMAND_LIST_TYPE_COMPUTE;
-      } else if (command_queue_type_str.compare("copy") == 0) {
-        r.command_queue_type[i] = D3D12_COMMAND_LIST_TYPE_COPY;
-      } else {
-        r.command_queue_type[i] = D3D12_COMMAND_LIST_TYPE_DIRECT;
-      }
-      auto command_queue_priority_str = GetStringView(command_queues[i], "priority");
-      if (command_queue_priority_str.compare("high") == 0) {
-        r.command_queue_priority[i] = D3D12_COMMAND_QUEUE_PRIORITY_HIGH;
-      } else if (command_queue_priority_str.compare("global realtime") == 0) {
-        r.command_queue_priority[i] = D3D12_COMMAND_QUEUE_PRIORITY_GLOBAL_REALTIME;
-      } else {
-        r.command_queue_priority[i] = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
-      }
+      const auto command_queue_type = kCommandQueueTypeTable.Find(GetStringView(command_queues[i], "type"));
+      r.command_queue_type[i] = (command_queue_type != nullptr) ? *command_queue_type : D3D12_COMMAND_LIST_TYPE_DIRECT;
+      const auto command_queue_priority = kCommandQueuePriorityTable.Find(GetStringView(command_queues[i], "priority"));
+      r.command_queue_priority[i] = (command_queue_priority != nullptr) ? *command_queue_priority : D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
       r.command_list_num_per_queue[i] = command_queues[i].at("command_list_num");
     }
   }
@@ -339,21 +347,26 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
       }
     }
   }
+  MemoryTypeAllocator frame_allocator(MemoryType::kFrame);
   const uint32_t default_buffer_num = 16;
-  auto buffer_name_list_len = default_buffer_num;
+  const auto declared_buffer_num = j.contains("buffer") ? GetUint32(j.at("buffer").size()) : 0;
+  auto buffer_name_list_len = std::max(default_buffer_num, std::bit_ceil(declared_buffer_num + 1)); // +1 for swapchain
   auto buffer_name_hash_list = AllocateArrayFrame<StrHash>(buffer_name_list_len);
   auto buffer_name_list = AllocateArrayFrame<const char*>(buffer_name_list_len);
   uint32_t next_vacant_buffer_index = 0;
   auto buffer_config_list = AllocateArrayFrame<BufferConfig>(buffer_name_list_len);
+  IndexMap buffer_index_map(&frame_allocator, buffer_name_list_len);
   if (j.contains("buffer")) {
     auto& buffer_list = j.at("buffer");
-    const auto buffer_num = GetUint32(buffer_list.size());
+    const auto buffer_num = declared_buffer_num;
     next_vacant_buffer_index = buffer_num;
     for (uint32_t i = 0; i < buffer_num; i++) {
       buffer_config_list[i].buffer_index = i;
       GetBufferConfig(buffer_list[i], &buffer_config_list[i]);
-      buffer_name_list[i] = CreateString(buffer_list[i].at("name"), MemoryType::kSystem);
-      buffer_name_hash_list[i] = CalcStrHash(buffer_name_list[i]);
+      const auto buffer_name = GetStringView(buffer_list[i], "name");
+      buffer_name_hash_list[i] = CalcStrHash(buffer_name);
+      buffer_name_list[i] = InternString(buffer_name, buffer_name_hash_list[i]);
+      buffer_index_map.InsertCopy(buffer_name_hash_list[i], i);
     }
   }
   {
@@ -362,25 +375,33 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
     next_vacant_buffer_index++;
     buffer_config_list[swapchain_index].buffer_index = swapchain_index;
     buffer_config_list[swapchain_index].descriptor_only = true;
-    buffer_name_list[swapchain_index] = CreateString("swapchain", MemoryType::kFrame);
-    buffer_name_hash_list[swapchain_index] = CalcStrHash(buffer_name_list[swapchain_index]);
+    buffer_name_hash_list[swapchain_index] = SID("swapchain");
+    buffer_name_list[swapchain_index] = InternString("swapchain", buffer_name_hash_list[swapchain_index]);
+    buffer_index_map.InsertCopy(buffer_name_hash_list[swapchain_index], swapchain_index);
   }
+  IndexMap sampler_index_map(&frame_allocator, j.contains("sampler") ? GetUint32(j.at("sampler").size()) : 0);
   if (j.contains("sampler")) {
     auto& sampler_list = j.at("sampler");
     r.sampler_num = static_cast<uint32_t>(sampler_list.size());
     r.sampler_list = AllocateArraySystem<D3D12_SAMPLER_DESC>(r.sampler_num);
     for (uint32_t i = 0; i < r.sampler_num; i++) {
       GetSamplerConfig(sampler_list[i], &r.sampler_list[i]);
+      sampler_index_map.InsertCopy(CalcEntityStrHash(sampler_list[i], "name"), i);
     }
   } // sampler
   { // pass_list
     auto& render_pass_list = j.at("render_pass");
     r.render_pass_num = static_cast<uint32_t>(render_pass_list.size());
     r.render_pass_list = AllocateArraySystem<RenderPass>(r.render_pass_num);
+    IndexMap pass_index_map(&frame_allocator, r.render_pass_num);
     for (uint32_t i = 0; i < r.render_pass_num; i++) {
       auto& dst_pass = r.render_pass_list[i];
       auto& src_pass = render_pass_list[i];
       dst_pass.name = CalcEntityStrHash(src_pass, "name");
+      if (src_pass.contains("name")) {
+        InternString(GetStringView(src_pass, "name"), dst_pass.name);
+        pass_index_map.InsertCopy(dst_pass.name, i);
+      }
       dst_pass.type = CalcEntityStrHash(src_pass, "type");
       dst_pass.enabled = GetBool(src_pass, "enabled", true);
       dst_pass.index = i;
@@ -399,14 +420,20 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
           auto& src_buffer = buffer_list[buffer_index];
           dst_buffer.state = GetResourceStateType(GetStringView(src_buffer, "state"));
           dst_buffer.index_offset = GetNum(src_buffer, "index_offset", 0);
+          dst_buffer.subresource_range.mip_slice   = GetVal<uint16_t>(src_buffer, "mip_slice", 0);
+          dst_buffer.subresource_range.mip_num     = GetVal<uint16_t>(src_buffer, "mip_num", 0);
+          dst_buffer.subresource_range.array_slice = GetVal<uint16_t>(src_buffer, "array_slice", 0);
+          dst_buffer.subresource_range.array_num   = GetVal<uint16_t>(src_buffer, "array_num", 0);
+          dst_buffer.subresource_range.plane_slice = GetVal<uint8_t>(src_buffer, "plane_slice", 0);
+          dst_buffer.subresource_range.plane_num   = GetVal<uint8_t>(src_buffer, "plane_num", 0);
           dst_pass.max_buffer_index_offset = std::max(dst_buffer.index_offset, dst_pass.max_buffer_index_offset);
           auto buffer_name = GetStringView(src_buffer, "name");
-          auto buffer_name_hash = CalcStrHash(buffer_name.data());
+          auto buffer_name_hash = CalcStrHash(buffer_name);
           if (IsSceneBufferName(buffer_name_hash)) {
             dst_buffer.buffer_index = EncodeSceneBufferIndex(buffer_name_hash);
             continue;
           }
-          auto graph_buffer_index = FindBufferIndex(next_vacant_buffer_index, buffer_name_hash_list, buffer_name_hash);
+          auto graph_buffer_index = FindMappedIndex(buffer_index_map, buffer_name_hash, next_vacant_buffer_index);
           if (graph_buffer_index >= next_vacant_buffer_index) {
             if (next_vacant_buffer_index >= buffer_name_list_len) {
               const auto prev_buffer_name_list_len = buffer_name_list_len;
@@ -417,11 +444,15 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
               auto tmp2 = buffer_name_list;
               buffer_name_list = AllocateArrayFrame<const char*>(buffer_name_list_len);
               memcpy(buffer_name_list, tmp2, sizeof(char*) * prev_buffer_name_list_len);
+              auto tmp3 = buffer_config_list;
+              buffer_config_list = AllocateArrayFrame<BufferConfig>(buffer_name_list_len);
+              memcpy(buffer_config_list, tmp3, sizeof(BufferConfig) * prev_buffer_name_list_len);
             }
             graph_buffer_index = next_vacant_buffer_index;
             next_vacant_buffer_index++;
             buffer_name_hash_list[graph_buffer_index] = buffer_name_hash;
-            buffer_name_list[graph_buffer_index] = CreateString(buffer_name, MemoryType::kFrame);
+            buffer_name_list[graph_buffer_index] = InternString(buffer_name, buffer_name_hash);
+            buffer_index_map.InsertCopy(buffer_name_hash, graph_buffer_index);
             InitializeBufferConfig(graph_buffer_index, &buffer_config_list[graph_buffer_index]);
             buffer_config_list[graph_buffer_index].initial_state = dst_buffer.state;
           }
@@ -438,19 +469,14 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
         auto& sampler = src_pass.at("sampler");
         dst_pass.sampler_num = static_cast<uint32_t>(sampler.size());
         dst_pass.sampler_index_list = AllocateArraySystem<uint32_t>(dst_pass.sampler_num);
-        const auto& graph_sampler_list = j.at("sampler");
         for (uint32_t s = 0; s < dst_pass.sampler_num; s++) {
           auto sampler_name = GetStringView(sampler[s]).data();
           if (strcmp(sampler_name, kSceneSamplerName) == 0) {
             dst_pass.sampler_index_list[s] = kSceneSamplerId;
             continue;
           }
-          for (uint32_t graph_s = 0; graph_s < r.sampler_num; graph_s++) {
-            if (GetStringView(graph_sampler_list[graph_s], "name").compare(sampler_name) == 0) {
-              dst_pass.sampler_index_list[s] = graph_s;
-              break;
-            }
-          }
+          dst_pass.sampler_index_list[s] = FindMappedIndex(sampler_index_map, CalcStrHash(sampler_name), r.sampler_num);
+          assert(dst_pass.sampler_index_list[s] < r.sampler_num && "sampler not found");
         }
       } // sampler
       if (src_pass.contains("flip_pingpong")) {
@@ -459,7 +485,8 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
         dst_pass.flip_pingpong_index_list = AllocateArraySystem<uint32_t>(dst_pass.flip_pingpong_num);
         for (uint32_t p = 0; p < dst_pass.flip_pingpong_num; p++) {
           const auto strhash = CalcEntityStrHash(pingpong[p]);
-          const auto pingpong_buffer_index = FindBufferIndex(buffer_name_list_len, buffer_name_hash_list, strhash);
+          const auto pingpong_buffer_index = FindMappedIndex(buffer_index_map, strhash, next_vacant_buffer_index);
+          assert(pingpong_buffer_index < next_vacant_buffer_index && "pingpong buffer not found");
           dst_pass.flip_pingpong_index_list[p] = pingpong_buffer_index;
           buffer_config_list[pingpong_buffer_index].pingpong = true;
         }
@@ -475,14 +502,9 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
         dst_pass.signal_pass_index = AllocateArraySystem<uint32_t>(dst_pass.wait_pass_num);
         for (uint32_t p = 0; p < dst_pass.wait_pass_num; p++) {
           const auto str = GetStringView(wait_pass[p]).data();
-          const auto hash = CalcStrHash(str);
-          for (uint32_t graph_index = 0; graph_index < r.render_pass_num; graph_index++) {
-            if (dst_pass.index == graph_index) { continue; }
-            if (r.render_pass_list[graph_index].name == hash) {
-              dst_pass.signal_pass_index[p] = graph_index;
-              break;
-            }
-          }
+          const auto graph_index = FindMappedIndex(pass_index_map, CalcStrHash(str), r.render_pass_num);
+          // passes never wait on themselves, left unresolved (render_pass_num) like unknown names.
+          dst_pass.signal_pass_index[p] = (graph_index == dst_pass.index) ? r.render_pass_num : graph_index;
         }
       }
     } // wait_pass
@@ -510,14 +532,10 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
   // signals
   for (uint32_t i = 0; i < r.render_pass_num; i++) {
     for (uint32_t w = 0; w < r.render_pass_list[i].wait_pass_num; w++) {
-      for (uint32_t k = 0; k < r.render_pass_num; k++) {
-        if (i == k) { continue; }
-        if (r.render_pass_list[i].signal_pass_index[w] == k) {
-          r.render_pass_list[k].sends_signal = true;
-          r.render_pass_list[i].signal_queue_index[w] = r.render_pass_list[k].command_queue_index;
-          break;
-        }
-      }
+      const auto k = r.render_pass_list[i].signal_pass_index[w];
+      if (k >= r.render_pass_num) { continue; }
+      r.render_pass_list[k].sends_signal = true;
+      r.render_pass_list[i].signal_queue_index[w] = r.render_pass_list[k].command_queue_index;
     }
   }
   if (j.contains("cbuffer")) {
@@ -525,14 +543,15 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
     r.cbuffer_list = InitializeArray<CBuffer>(GetUint32(cbuffers.size()), MemoryType::kSystem);
     for (uint32_t i = 0; i < r.cbuffer_list.size; i++) {
       auto& dst_cbuffer = r.cbuffer_list.array[i];
-      dst_cbuffer.buffer_index = FindBufferIndex(buffer_name_list_len, buffer_name_hash_list, CalcEntityStrHash(cbuffers[i], "name"));
+      dst_cbuffer.buffer_index = FindMappedIndex(buffer_index_map, CalcEntityStrHash(cbuffers[i], "name"), r.buffer_num);
+      assert(dst_cbuffer.buffer_index < r.buffer_num && "cbuffer not found");
       dst_cbuffer.need_ui_param_num = 0;
       const auto& cbuffer_params = cbuffers[i].at("params");
       dst_cbuffer.params = InitializeArray<CBufferParam>(GetUint32(cbuffer_params.size()), MemoryType::kSystem);
       for (uint32_t p = 0; p < dst_cbuffer.params.size; p++) {
         const auto& src_param = cbuffer_params[p];
-        dst_cbuffer.params.array[p].name = CreateString(src_param.at("name"), MemoryType::kSystem);
-        dst_cbuffer.params.array[p].name_hash = CalcStrHash(dst_cbuffer.params.array[p].name);
+        dst_cbuffer.params.array[p].name_hash = CalcEntityStrHash(src_param, "name");
+        dst_cbuffer.params.array[p].name = InternString(GetStringView(src_param, "name"), dst_cbuffer.params.array[p].name_hash);
         dst_cbuffer.params.array[p].type = GetCBufferParamType(src_param);
         dst_cbuffer.params.array[p].min = GetFloat(src_param, "min", 0.0f);
         dst_cbuffer.params.array[p].max = GetFloat(src_param, "max", 1.0f);
@@ -571,34 +590,7 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
     }
     r.descriptor_handle_num_per_type[static_cast<uint32_t>(DescriptorType::kSampler)] = r.sampler_num;
   } // descriptor num
-  // command allocator num
-  {
-    const auto index_direct = GetCommandQueueTypeIndex(D3D12_COMMAND_LIST_TYPE_DIRECT);
-    const auto index_compute = GetCommandQueueTypeIndex(D3D12_COMMAND_LIST_TYPE_COMPUTE);
-    const auto index_copy = GetCommandQueueTypeIndex(D3D12_COMMAND_LIST_TYPE_COPY);
-    // +1 for last pass execution
-    r.command_allocator_num_per_queue_type[index_direct] = 1;
-    r.command_allocator_num_per_queue_type[index_compute] = 1;
-    r.command_allocator_num_per_queue_type[index_copy] = 1;
-    for (uint32_t i = 0; i < r.render_pass_num; i++) {
-      const auto& pass = r.render_pass_list[i];
-      if (!pass.sends_signal) { continue; }
-      switch (r.command_queue_type[pass.command_queue_index]) {
-        case D3D12_COMMAND_LIST_TYPE_DIRECT: {
-          r.command_allocator_num_per_queue_type[index_direct]++;
-          break;
-        }
-        case D3D12_COMMAND_LIST_TYPE_COMPUTE: {
-          r.command_allocator_num_per_queue_type[index_compute]++;
-          break;
-        }
-        case D3D12_COMMAND_LIST_TYPE_COPY: {
-          r.command_allocator_num_per_queue_type[index_copy]++;
-          break;
-        }
-      }
-    }
-  } // command allocator num
+  ConfigureCommandAllocatorNumPerQueueType(&r);
   // misc.
   r.gpu_handle_num_view = GetNum(j, "gpu_handle_num_view", r.gpu_handle_num_view);
   r.gpu_handle_num_sampler = GetNum(j, "gpu_handle_num_sampler", r.gpu_handle_num_sampler);
@@ -608,4 +600,576 @@ std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohma
   r.timestamp_query_dst_resource_num = GetNum(j, "timestamp_query_dst_resource_num", r.timestamp_query_dst_resource_num);
   return std::make_pair(buffer_name_list, buffer_name_hash_list);
 }
+namespace {
+constexpr auto kSwapchainUsageTable = CreatePerfectHashTable<DXGI_USAGE>({
+    {"READ_ONLY", DXGI_USAGE_READ_ONLY},
+    {"RENDER_TARGET_OUTPUT", DXGI_USAGE_RENDER_TARGET_OUTPUT},
+    {"SHADER_INPUT", DXGI_USAGE_SHADER_INPUT},
+    {"SHARED", DXGI_USAGE_SHARED},
+    {"UNORDERED_ACCESS", DXGI_USAGE_UNORDERED_ACCESS},
+  });
+constexpr auto kCBufferParamTypeTable = CreatePerfectHashTable<CBufferParamType>({
+    {"float", CBufferParamType::kFloat},
+    {"uint32", CBufferParamType::kUint},
+  });
+enum class JsonValueType : uint8_t { kString, kUint, kNumber, kBool, kArray, kObject, };
+auto IsJsonValueType(const nlohmann::json& j, const JsonValueType type) {
+  switch (type) {
+    case JsonValueType::kString: return j.is_string();
+    case JsonValueType::kUint:   return j.is_number_unsigned() || (j.is_number_integer() && j.get<int64_t>() >= 0);
+    case JsonValueType::kNumber: return j.is_number();
+    case JsonValueType::kBool:   return j.is_boolean();
+    case JsonValueType::kArray:  return j.is_array();
+    case JsonValueType::kObject: return j.is_object();
+  }
+  return false;
+}
+auto GetJsonValueTypeError(const JsonValueType type) {
+  switch (type) {
+    case JsonValueType::kString: return "string expected";
+    case JsonValueType::kUint:   return "unsigned integer expected";
+    case JsonValueType::kNumber: return "number expected";
+    case JsonValueType::kBool:   return "boolean expected";
+    case JsonValueType::kArray:  return "array expected";
+    case JsonValueType::kObject: return "object expected";
+  }
+  return "invalid type";
+}
+template <typename T>
+auto IsTableKey(const T& table) {
+  return [&table](const std::string_view& str) { return table.Contains(str); };
+}
+class RenderGraphJsonValidator {
+ public:
+  RenderGraphJsonValidator(const RenderGraphJsonValidation validation, const MemoryType memory_type)
+      : fast_fail_(validation == RenderGraphJsonValidation::kFastFail)
+      , memory_type_(memory_type)
+      , queue_names_(&allocator_)
+      , buffer_names_(&allocator_)
+      , sampler_names_(&allocator_)
+      , pass_names_(&allocator_)
+      , buffer_layouts_(&allocator_) {
+  }
+  void Validate(const nlohmann::json& j, const uint32_t material_num, const StrHash* material_hash_list) {
+    if (!Expect(j, JsonValueType::kObject)) { return; }
+    Get(j, "frame_buffer_num", JsonValueType::kUint, true);
+    Get(j, "primarybuffer_width", JsonValueType::kUint, false);
+    Get(j, "primarybuffer_height", JsonValueType::kUint, false);
+    CheckEnum(j, "primarybuffer_format", false, IsDxgiFormatName);
+    for (const auto key : {"gpu_handle_num_view", "gpu_handle_num_sampler", "max_model_num", "max_material_num", "max_mipmap_num", "timestamp_query_dst_resource_num"}) {
+      Get(j, key, JsonValueType::kUint, false);
+    }
+    if (const auto window = Get(j, "window", JsonValueType::kObject, true); window != nullptr) {
+      PathScope scope(this, "window");
+      Get(*window, "title", JsonValueType::kString, true);
+      Get(*window, "width", JsonValueType::kUint, true);
+      Get(*window, "height", JsonValueType::kUint, true);
+    }
+    ValidateCommandQueues(j);
+    ValidateSwapchain(j);
+    ValidateBuffers(j);
+    ValidateSamplers(j);
+    ValidateRenderPasses(j, material_num, material_hash_list);
+    ValidateCBuffers(j);
+  }
+  auto GetErrors() const { return CreateArray(error_num_, error_list_); }
+ private:
+  static const uint32_t kPathLenMax = 256;
+  class PathScope {
+   public:
+    PathScope(RenderGraphJsonValidator* validator, const char* const key) : validator_(validator), path_len_(validator->path_len_) {
+      validator_->PushPath(key);
+    }
+    PathScope(RenderGraphJsonValidator* validator, const uint32_t index) : validator_(validator), path_len_(validator->path_len_) {
+      validator_->PushPath(index);
+    }
+    ~PathScope() {
+      validator_->path_len_ = path_len_;
+      validator_->path_[path_len_] = '\0';
+    }
+    PathScope(const PathScope&) = delete;
+    PathScope& operator=(const PathScope&) = delete;
+   private:
+    RenderGraphJsonValidator* validator_;
+    uint32_t path_len_;
+  };
+  void AppendPath(const char c) {
+    if (path_len_ + 1 >= kPathLenMax) { return; }
+    path_[path_len_] = c;
+    path_len_++;
+    path_[path_len_] = '\0';
+  }
+  void PushPath(const char* const key) {
+    AppendPath('/');
+    for (auto c = key; *c != '\0'; c++) {
+      // escape as json pointer requires.
+      if (*c == '~') {
+        AppendPath('~');
+        AppendPath('0');
+      } else if (*c == '/') {
+        AppendPath('~');
+        AppendPath('1');
+      } else {
+        AppendPath(*c);
+      }
+    }
+  }
+  void PushPath(const uint32_t index) {
+    char buffer[16];
+    const auto [end, error] = std::to_chars(buffer, buffer + std::size(buffer), index);
+    AppendPath('/');
+    for (auto c = buffer; c < end; c++) {
+      AppendPath(*c);
+    }
+  }
+  bool IsStopped() const { return fast_fail_ && error_num_ > 0; }
+  void AddError(const char* const message) {
+    if (IsStopped()) { return; }
+    logerror("render graph json {}: {}", path_, message);
+    if (error_num_ >= error_list_len_) {
+      const auto prev_error_list = error_list_;
+      error_list_len_ = std::max(error_list_len_ * 2, 8U);
+      error_list_ = AllocateArray<RenderGraphJsonError>(memory_type_, error_list_len_);
+      if (error_num_ > 0) {
+        memcpy(error_list_, prev_error_list, sizeof(RenderGraphJsonError) * error_num_);
+      }
+    }
+    error_list_[error_num_].path = CreateString(path_, memory_type_);
+    error_list_[error_num_].message = message;
+    error_num_++;
+  }
+  bool Expect(const nlohmann::json& j, const JsonValueType type) {
+    if (IsJsonValueType(j, type)) { return true; }
+    AddError(GetJsonValueTypeError(type));
+    return false;
+  }
+  const nlohmann::json* Get(const nlohmann::json& j, const char* const key, const JsonValueType type, const bool required) {
+    if (!j.contains(key)) {
+      if (required) {
+        PathScope scope(this, key);
+        AddError("required key not found");
+      }
+      return nullptr;
+    }
+    const auto& value = j.at(key);
+    PathScope scope(this, key);
+    return Expect(value, type) ? &value : nullptr;
+  }
+  template <typename F>
+  void CheckEnum(const nlohmann::json& j, const F& is_valid_name) {
+    if (!Expect(j, JsonValueType::kString)) { return; }
+    if (!is_valid_name(GetStringView(j))) {
+      AddError("unknown enum value");
+    }
+  }
+  template <typename F>
+  void CheckEnum(const nlohmann::json& j, const char* const key, const bool required, const F& is_valid_name) {
+    const auto value = Get(j, key, JsonValueType::kString, required);
+    if (value == nullptr) { return; }
+    PathScope scope(this, key);
+    CheckEnum(*value, is_valid_name);
+  }
+  template <typename F>
+  void ForEachElement(const nlohmann::json& j, const char* const key, const bool required, F&& f) {
+    const auto list = Get(j, key, JsonValueType::kArray, required);
+    if (list == nullptr) { return; }
+    PathScope scope(this, key);
+    const auto num = GetUint32(list->size());
+    for (uint32_t i = 0; i < num && !IsStopped(); i++) {
+      PathScope element_scope(this, i);
+      f(i, (*list)[i]);
+    }
+  }
+  // registers j[key] to names and reports duplicates.
+  void AddName(const nlohmann::json& j, const char* const key, const bool required, IndexMap* names, const uint32_t index) {
+    const auto value = Get(j, key, JsonValueType::kString, required);
+    if (value == nullptr) { return; }
+    if (!names->InsertCopy(CalcEntityStrHash(*value), index)) {
+      PathScope scope(this, key);
+      AddError("duplicate name");
+    }
+  }
+  void CheckReference(const nlohmann::json& j, const IndexMap& names, const char* const message) {
+    if (!Expect(j, JsonValueType::kString)) { return; }
+    if (names.Get(CalcEntityStrHash(j)) == nullptr) {
+      AddError(message);
+    }
+  }
+  void CheckReference(const nlohmann::json& j, const char* const key, const bool required, const IndexMap& names, const char* const message) {
+    const auto value = Get(j, key, JsonValueType::kString, required);
+    if (value == nullptr) { return; }
+    PathScope scope(this, key);
+    CheckReference(*value, names, message);
+  }
+  // same layout as subresources are tracked with in barrier planning, values of wrong types fall back to defaults (reported elsewhere).
+  static SubresourceLayout GetBufferSubresourceLayout(const nlohmann::json& buffer) {
+    auto has = [&buffer](const char* const key, const JsonValueType type) { return buffer.contains(key) && IsJsonValueType(buffer.at(key), type); };
+    SubresourceLayout layout{};
+    if (has("descriptor_only", JsonValueType::kBool) && buffer.at("descriptor_only").get<bool>()) { return layout; }
+    auto dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    if (has("dimension", JsonValueType::kString)) {
+      if (const auto found = kDimensionTable.Find(GetStringView(buffer, "dimension")); found != nullptr) {
+        dimension = *found;
+      }
+    }
+    if (dimension == D3D12_RESOURCE_DIMENSION_BUFFER) { return layout; }
+    if (has("miplevels", JsonValueType::kUint)) {
+      layout.mip_num = std::max<uint16_t>(GetVal<uint16_t>(buffer, "miplevels", 1), 1);
+    }
+    if (dimension != D3D12_RESOURCE_DIMENSION_TEXTURE3D && has("depth_or_array_size", JsonValueType::kUint)) {
+      layout.array_num = std::max<uint16_t>(GetVal<uint16_t>(buffer, "depth_or_array_size", 1), 1);
+    }
+    if (has("format", JsonValueType::kString) && IsDxgiFormatName(GetStringView(buffer, "format"))) {
+      layout.plane_num = static_cast<uint8_t>(GetDxgiFormatPlaneNum(GetDxgiFormat(buffer, "format")));
+    }
+    return layout;
+  }
+  // values too large for SubresourceRange are clamped so that they stay out of range.
+  static SubresourceRange GetSubresourceRange(const nlohmann::json& buffer) {
+    auto get = [&buffer](const char* const key, const uint64_t max) {
+      if (!buffer.contains(key) || !IsJsonValueType(buffer.at(key), JsonValueType::kUint)) { return uint64_t{0}; }
+      return std::min(buffer.at(key).get<uint64_t>(), max);
+    };
+    return {
+      .mip_slice   = static_cast<uint16_t>(get("mip_slice",   UINT16_MAX)),
+      .mip_num     = static_cast<uint16_t>(get("mip_num",     UINT16_MAX)),
+      .array_slice = static_cast<uint16_t>(get("array_slice", UINT16_MAX)),
+      .array_num   = static_cast<uint16_t>(get("array_num",   UINT16_MAX)),
+      .plane_slice = static_cast<uint8_t>(get("plane_slice", UINT8_MAX)),
+      .plane_num   = static_cast<uint8_t>(get("plane_num",   UINT8_MAX)),
+    };
+  }
+  void ValidateCommandQueues(const nlohmann::json& j) {
+    ForEachElement(j, "command_queue", true, [&](const uint32_t i, const nlohmann::json& queue) {
+      if (!Expect(queue, JsonValueType::kObject)) { return; }
+      AddName(queue, "name", true, &queue_names_, i);
+      CheckEnum(queue, "type", true, IsTableKey(kCommandQueueTypeTable));
+      CheckEnum(queue, "priority", true, IsTableKey(kCommandQueuePriorityTable));
+      Get(queue, "command_list_num", JsonValueType::kUint, true);
+    });
+  }
+  void ValidateSwapchain(const nlohmann::json& j) {
+    const auto swapchain = Get(j, "swapchain", JsonValueType::kObject, true);
+    if (swapchain == nullptr) { return; }
+    PathScope scope(this, "swapchain");
+    CheckReference(*swapchain, "command_queue", true, queue_names_, "unknown command queue");
+    CheckEnum(*swapchain, "format", true, IsDxgiFormatName);
+    ForEachElement(*swapchain, "usage", false, [&](const uint32_t, const nlohmann::json& usage) {
+      CheckEnum(usage, IsTableKey(kSwapchainUsageTable));
+    });
+  }
+  void ValidateBuffers(const nlohmann::json& j) {
+    ForEachElement(j, "buffer", false, [&](const uint32_t i, const nlohmann::json& buffer) {
+      if (!Expect(buffer, JsonValueType::kObject)) { return; }
+      AddName(buffer, "name", true, &buffer_names_, i);
+      const auto pingpong = Get(buffer, "pingpong", JsonValueType::kBool, false);
+      const auto frame_buffered = Get(buffer, "frame_buffered", JsonValueType::kBool, false);
+      if (pingpong != nullptr && frame_buffered != nullptr && pingpong->get<bool>() && frame_buffered->get<bool>()) {
+        AddError("pingpong and frame_buffered are exclusive");
+      }
+      ForEachElement(buffer, "descriptor_types", false, [&](const uint32_t, const nlohmann::json& descriptor_type) {
+        CheckEnum(descriptor_type, IsDescriptorTypeName);
+      });
+      Get(buffer, "descriptor_only", JsonValueType::kBool, false);
+      CheckEnum(buffer, "heap_type", false, IsTableKey(kHeapTypeTable));
+      CheckEnum(buffer, "dimension", false, IsTableKey(kDimensionTable));
+      CheckEnum(buffer, "size_type", false, IsTableKey(kBufferSizeRelativenessTable));
+      CheckEnum(buffer, "layout", false, IsTableKey(kTextureLayoutTable));
+      CheckEnum(buffer, "format", false, IsDxgiFormatName);
+      CheckEnum(buffer, "initial_state", false, IsResourceStateTypeName);
+      Get(buffer, "width", JsonValueType::kNumber, false);
+      Get(buffer, "height", JsonValueType::kNumber, false);
+      for (const auto key : {"depth_or_array_size", "miplevels", "sample_count", "sample_quality", "mip_width", "mip_height", "mip_depth", "num_elements", "stride_bytes"}) {
+        Get(buffer, key, JsonValueType::kUint, false);
+      }
+      Get(buffer, "raw_buffer", JsonValueType::kBool, false);
+      if (const auto name = buffer.find("name"); name != buffer.end() && name->is_string()) {
+        buffer_layouts_.InsertCopy(CalcEntityStrHash(*name), GetBufferSubresourceLayout(buffer));
+      }
+    });
+    buffer_names_.InsertCopy(SID("swapchain"), 0);
+  }
+  void ValidateSamplers(const nlohmann::json& j) {
+    ForEachElement(j, "sampler", false, [&](const uint32_t i, const nlohmann::json& sampler) {
+      if (!Expect(sampler, JsonValueType::kObject)) { return; }
+      AddName(sampler, "name", true, &sampler_names_, i);
+      for (const auto key : {"filter_min", "filter_mag", "filter_mip"}) {
+        CheckEnum(sampler, key, false, IsTableKey(kFilterTypeTable));
+      }
+      if (const auto address_mode = Get(sampler, "address_mode", JsonValueType::kArray, false); address_mode != nullptr) {
+        PathScope scope(this, "address_mode");
+        if (address_mode->empty() || address_mode->size() > 3) {
+          AddError("1 to 3 address modes expected");
+        }
+        for (uint32_t a = 0; a < address_mode->size() && a < 3; a++) {
+          PathScope element_scope(this, a);
+          CheckEnum((*address_mode)[a], IsTableKey(kAddressModeTable));
+        }
+      }
+      CheckEnum(sampler, "comparison_func", false, IsTableKey(kComparisonFuncTable));
+      if (const auto border_color = Get(sampler, "border_color", JsonValueType::kArray, false); border_color != nullptr) {
+        PathScope scope(this, "border_color");
+        if (border_color->size() != 4) {
+          AddError("4 elements expected");
+        }
+        for (uint32_t c = 0; c < border_color->size(); c++) {
+          PathScope element_scope(this, c);
+          Expect((*border_color)[c], JsonValueType::kNumber);
+        }
+      }
+      Get(sampler, "mip_lod_bias", JsonValueType::kNumber, false);
+      Get(sampler, "max_anisotropy", JsonValueType::kUint, false);
+      Get(sampler, "min_lod", JsonValueType::kNumber, false);
+      Get(sampler, "max_lod", JsonValueType::kNumber, false);
+    });
+  }
+  void ValidateRenderPasses(const nlohmann::json& j, const uint32_t material_num, const StrHash* material_hash_list) {
+    // collect pass names beforehand, wait_pass may refer to later passes.
+    if (const auto render_pass_list = Get(j, "render_pass", JsonValueType::kArray, true); render_pass_list != nullptr) {
+      PathScope scope(this, "render_pass");
+      for (uint32_t i = 0; i < render_pass_list->size(); i++) {
+        PathScope element_scope(this, i);
+        if ((*render_pass_list)[i].is_object()) {
+          AddName((*render_pass_list)[i], "name", false, &pass_names_, i);
+        }
+      }
+    }
+    ForEachElement(j, "render_pass", false, [&](const uint32_t i, const nlohmann::json& pass) {
+      if (!Expect(pass, JsonValueType::kObject)) { return; }
+      Get(pass, "type", JsonValueType::kString, false);
+      Get(pass, "enabled", JsonValueType::kBool, false);
+      CheckReference(pass, "command_queue", false, queue_names_, "unknown command queue");
+      if (const auto material = Get(pass, "material", JsonValueType::kString, false); material != nullptr && material_hash_list != nullptr) {
+        if (FindHashIndex(material_num, material_hash_list, CalcEntityStrHash(*material)) >= material_num) {
+          PathScope scope(this, "material");
+          AddError("unknown material");
+        }
+      }
+      ForEachElement(pass, "buffer_list", false, [&](const uint32_t, const nlohmann::json& buffer) {
+        if (!Expect(buffer, JsonValueType::kObject)) { return; }
+        CheckEnum(buffer, "state", true, IsResourceStateTypeName);
+        for (const auto key : {"index_offset", "mip_slice", "mip_num", "array_slice", "array_num", "plane_slice", "plane_num"}) {
+          Get(buffer, key, JsonValueType::kUint, false);
+        }
+        const auto name = Get(buffer, "name", JsonValueType::kString, true);
+        if (name == nullptr) { return; }
+        const auto hash = CalcEntityStrHash(*name);
+        if (IsSceneBufferName(hash)) { return; }
+        buffer_names_.InsertCopy(hash, 0); // buffers are declared by their first use as well.
+        const auto layout = buffer_layouts_.Get(hash);
+        if (!IsSubresourceRangeValid(GetSubresourceRange(buffer), layout ? *layout : SubresourceLayout{})) {
+          AddError("subresource range out of range");
+        }
+      });
+      ForEachElement(pass, "sampler", false, [&](const uint32_t, const nlohmann::json& sampler) {
+        if (sampler.is_string() && GetStringView(sampler).compare(kSceneSamplerName) == 0) { return; }
+        CheckReference(sampler, sampler_names_, "unknown sampler");
+      });
+      ForEachElement(pass, "flip_pingpong", false, [&](const uint32_t, const nlohmann::json& buffer) {
+        CheckReference(buffer, buffer_names_, "unknown buffer");
+      });
+      ForEachElement(pass, "wait_pass", false, [&](const uint32_t, const nlohmann::json& wait_pass) {
+        if (!Expect(wait_pass, JsonValueType::kString)) { return; }
+        const auto index = pass_names_.Get(CalcEntityStrHash(wait_pass));
+        if (index == nullptr) {
+          AddError("unknown render pass");
+        } else if (*index == i) {
+          AddError("render pass waits on itself");
+        }
+      });
+    });
+  }
+  void ValidateCBuffers(const nlohmann::json& j) {
+    ForEachElement(j, "cbuffer", false, [&](const uint32_t, const nlohmann::json& cbuffer) {
+      if (!Expect(cbuffer, JsonValueType::kObject)) { return; }
+      CheckReference(cbuffer, "name", true, buffer_names_, "unknown buffer");
+      ForEachElement(cbuffer, "params", true, [&](const uint32_t, const nlohmann::json& param) {
+        if (!Expect(param, JsonValueType::kObject)) { return; }
+        Get(param, "name", JsonValueType::kString, true);
+        Get(param, "need_ui", JsonValueType::kBool, false);
+        CheckEnum(param, "type", false, IsTableKey(kCBufferParamTypeTable));
+        Get(param, "min", JsonValueType::kNumber, false);
+        Get(param, "max", JsonValueType::kNumber, false);
+        Get(param, "initial_val", JsonValueType::kNumber, false);
+      });
+    });
+  }
+  bool fast_fail_;
+  MemoryType memory_type_;
+  char path_[kPathLenMax]{};
+  uint32_t path_len_{0};
+  RenderGraphJsonError* error_list_{nullptr};
+  uint32_t error_list_len_{0};
+  uint32_t error_num_{0};
+  MemoryTypeAllocator allocator_{MemoryType::kFrame};
+  IndexMap queue_names_;
+  IndexMap buffer_names_;
+  IndexMap sampler_names_;
+  IndexMap pass_names_;
+  HashMap<SubresourceLayout, MemoryTypeAllocator> buffer_layouts_;
+};
+} // namespace
+ArrayOf<RenderGraphJsonError> ValidateRenderGraphJson(const nlohmann::json& j, const uint32_t material_num, const StrHash* material_hash_list, const RenderGraphJsonValidation validation, const MemoryType memory_type) {
+  RenderGraphJsonValidator validator(validation, memory_type);
+  validator.Validate(j, material_num, material_hash_list);
+  return validator.GetErrors();
+}
+bool ValidateRenderGraphJson(const char* const render_graph_json_path, const char* const material_json_path, const bool fast_fail) {
+  nlohmann::json render_graph_json;
+  if (!LoadJsonFile(render_graph_json_path, &render_graph_json)) { return false; }
+  uint32_t material_num = 0;
+  StrHash* material_hash_list = nullptr;
+  if (material_json_path != nullptr) {
+    nlohmann::json material_json;
+    if (!LoadJsonFile(material_json_path, &material_json)) { return false; }
+    if (!material_json.contains("materials") || !material_json.at("materials").is_array()) {
+      logerror("materials not found in {}", material_json_path);
+      return false;
+    }
+    material_num = CreateJsonStrHashList(material_json.at("materials"), "name", &material_hash_list, MemoryType::kFrame);
+  }
+  const auto validation = fast_fail ? RenderGraphJsonValidation::kFastFail : RenderGraphJsonValidation::kAll;
+  const auto errors = ValidateRenderGraphJson(render_graph_json, material_num, material_hash_list, validation, MemoryType::kFrame);
+  if (errors.size > 0) {
+    logerror("{}: {} error(s) found", render_graph_json_path, errors.size);
+    return false;
+  }
+  loginfo("{}: no errors found", render_graph_json_path);
+  return true;
+}
+}
+#include "doctest/doctest.h"
+#include "d3d12_test_util.h"
+TEST_CASE("render graph parser resolves names by hash") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t pass_num = 1000;
+  const uint32_t buffer_num = 1000;
+  const auto j = CreateSyntheticRenderGraphJson(pass_num, buffer_num);
+  RenderGraphConfig graph{};
+  auto [buffer_name_list, buffer_name_hash_list] = ParseSyntheticRenderGraphJson(j, &graph);
+  CHECK_EQ(graph.buffer_num, buffer_num + 1); // +swapchain
+  CHECK_EQ(graph.render_pass_num, pass_num);
+  CHECK_EQ(graph.sampler_num, 2);
+  for (uint32_t i = 0; i < buffer_num / 2; i++) {
+    CHECK_EQ(graph.buffer_list[i].format, DXGI_FORMAT_R16G16B16A16_FLOAT);
+  }
+  for (uint32_t i = 0; i < graph.render_pass_num; i++) {
+    const auto& pass = graph.render_pass_list[i];
+    const auto& src_pass = j.at("render_pass")[i];
+    CHECK_EQ(pass.buffer_num, 3);
+    for (uint32_t b = 0; b < pass.buffer_num; b++) {
+      const auto src_buffer_name = GetStringView(src_pass.at("buffer_list")[b], "name");
+      const auto buffer_index = pass.buffer_list[b].buffer_index;
+      CHECK_LT(buffer_index, graph.buffer_num);
+      CHECK_EQ(std::string_view(buffer_name_list[buffer_index]), src_buffer_name);
+      CHECK_EQ(buffer_name_hash_list[buffer_index], CalcStrHash(src_buffer_name));
+      CHECK_EQ(graph.buffer_list[buffer_index].buffer_index, buffer_index);
+    }
+    CHECK_EQ(pass.sampler_num, 1);
+    CHECK_EQ(pass.sampler_index_list[0], i % 2);
+    if (i == 0) {
+      CHECK_EQ(pass.wait_pass_num, 0);
+    } else {
+      CHECK_EQ(pass.wait_pass_num, 1);
+      CHECK_EQ(pass.signal_pass_index[0], i - 1);
+      CHECK_EQ(pass.signal_queue_index[0], graph.render_pass_list[i - 1].command_queue_index);
+    }
+    CHECK_EQ(pass.sends_signal, i + 1 < graph.render_pass_num);
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render graph json validator") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const auto material_json = LoadTestJson("material.json");
+  StrHash* material_hash_list = nullptr;
+  const auto material_num = CreateJsonStrHashList(material_json.at("materials"), "name", &material_hash_list, MemoryType::kFrame);
+  SUBCASE("valid graphs") {
+    for (const auto filename : {"deferred.json", "forward.json", "config.json"}) {
+      CAPTURE(filename);
+      CHECK_EQ(ValidateRenderGraphJson(LoadTestJson(filename), material_num, material_hash_list, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size, 0);
+    }
+    CHECK_EQ(ValidateRenderGraphJson(CreateSyntheticRenderGraphJson(100, 100), 0, nullptr, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size, 0);
+  }
+  SUBCASE("invalid graph") {
+    auto j = LoadTestJson("forward.json");
+    j["window"].erase("title");
+    j["swapchain"]["format"] = "R8G8B8A8";
+    j["sampler"][1]["name"] = j["sampler"][0]["name"];
+    j["render_pass"][1]["buffer_list"][0]["state"] = "srv";
+    j["render_pass"][1]["wait_pass"] = nlohmann::json::array({"no_such_pass"});
+    j["render_pass"][1]["material"] = "no_such_material";
+    j["render_pass"][2]["enabled"] = 1;
+    j["cbuffer"][0]["name"] = "no_such_buffer";
+    const std::pair<std::string_view, std::string_view> expected_errors[] = {
+      {"/window/title", "required key not found"},
+      {"/swapchain/format", "unknown enum value"},
+      {"/sampler/1/name", "duplicate name"},
+      {"/render_pass/1/material", "unknown material"},
+      {"/render_pass/1/buffer_list/0/state", "unknown enum value"},
+      {"/render_pass/1/wait_pass/0", "unknown render pass"},
+      {"/render_pass/2/enabled", "boolean expected"},
+      {"/cbuffer/0/name", "unknown buffer"},
+    };
+    const auto errors = ValidateRenderGraphJson(j, material_num, material_hash_list, RenderGraphJsonValidation::kAll, MemoryType::kFrame);
+    CHECK_EQ(errors.size, std::size(expected_errors));
+    for (uint32_t i = 0; i < errors.size && i < std::size(expected_errors); i++) {
+      CHECK_EQ(std::string_view(errors.array[i].path), expected_errors[i].first);
+      CHECK_EQ(std::string_view(errors.array[i].message), expected_errors[i].second);
+    }
+    const auto fast_fail_errors = ValidateRenderGraphJson(j, material_num, material_hash_list, RenderGraphJsonValidation::kFastFail, MemoryType::kFrame);
+    CHECK_EQ(fast_fail_errors.size, 1);
+    CHECK_EQ(std::string_view(fast_fail_errors.array[0].path), expected_errors[0].first);
+    // material names are not checked without a material list.
+    CHECK_EQ(ValidateRenderGraphJson(j, 0, nullptr, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size, std::size(expected_errors) - 1);
+  }
+  SUBCASE("subresource ranges") {
+    auto j = LoadTestJson("deferred.json");
+    j["buffer"][1]["miplevels"] = 4;
+    j["render_pass"][3]["buffer_list"][2]["mip_slice"] = 3;
+    j["render_pass"][3]["buffer_list"][2]["mip_num"] = 1;
+    j["render_pass"][4]["buffer_list"][1]["mip_slice"] = 2;
+    j["render_pass"][4]["buffer_list"][1]["mip_num"] = 3;
+    j["render_pass"][5]["buffer_list"][7]["array_slice"] = 1;
+    j["render_pass"][6]["buffer_list"][1]["plane_slice"] = 1;
+    j["render_pass"][1]["buffer_list"][1]["mip_slice"] = 5; // scene buffers are not checked.
+    const std::pair<std::string_view, std::string_view> expected_errors[] = {
+      {"/render_pass/4/buffer_list/1", "subresource range out of range"},
+      {"/render_pass/5/buffer_list/7", "subresource range out of range"},
+      {"/render_pass/6/buffer_list/1", "subresource range out of range"},
+    };
+    const auto errors = ValidateRenderGraphJson(j, material_num, material_hash_list, RenderGraphJsonValidation::kAll, MemoryType::kFrame);
+    CHECK_EQ(errors.size, std::size(expected_errors));
+    for (uint32_t i = 0; i < errors.size && i < std::size(expected_errors); i++) {
+      CHECK_EQ(std::string_view(errors.array[i].path), expected_errors[i].first);
+      CHECK_EQ(std::string_view(errors.array[i].message), expected_errors[i].second);
+    }
+  }
+  SUBCASE("type errors") {
+    nlohmann::json j = nlohmann::json::array();
+    CHECK_EQ(ValidateRenderGraphJson(j, 0, nullptr, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size, 1);
+    j = LoadTestJson("forward.json");
+    j["render_pass"] = nlohmann::json::array({nlohmann::json::object({{"name", "a"}}), "b"});
+    j.erase("cbuffer");
+    const auto errors = ValidateRenderGraphJson(j, 0, nullptr, RenderGraphJsonValidation::kAll, MemoryType::kFrame);
+    CHECK_EQ(errors.size, 1);
+    CHECK_EQ(std::string_view(errors.array[0].path), "/render_pass/1");
+    CHECK_EQ(std::string_view(errors.array[0].message), "object expected");
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render graph parser scaling benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t num_list[] = {1000, 2000, 5000, 10000};
+  spdlog::info("render graph parser scaling (pass num == buffer num)");
+  for (const auto num : num_list) {
+    const auto j = CreateSyntheticRenderGraphJson(num, num);
+    RenderGraphConfig graph{};
+    const auto us_per_pass = MeasureTimePerOp<std::micro>(num, [&]() { ParseSyntheticRenderGraphJson(j, &graph); });
+    uint32_t error_num = 0;
+    const auto validation_us_per_pass = MeasureTimePerOp<std::micro>(num, [&]() { error_num = ValidateRenderGraphJson(j, 0, nullptr, RenderGraphJsonValidation::kAll, MemoryType::kFrame).size; });
+    spdlog::info("  {:>5} passes total:{:.2f}ms per pass:{:.3f}us validation per pass:{:.3f}us", num, us_per_pass * num / 1000.0, us_per_pass, validation_us_per_pass);
+    CHECK_EQ(error_num, 0);
+    CHECK_EQ(graph.render_pass_num, num);
+    ClearAllAllocations();
+  }
 }
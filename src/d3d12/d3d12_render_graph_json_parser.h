@@ -5,9 +5,23 @@
 #include "d3d12_render_graph.h"
 #include "d3d12_scene.h"
 #include "d3d12_src_common.h"
+#include "illuminate/d3d12/render_graph_json_validator.h"
 #include "illuminate/util/hash_map.h"
 #include <nlohmann/json.hpp>
 namespace illuminate {
 std::pair<const char* const *, const StrHash*> ParseRenderGraphJson(const nlohmann::json& j, const uint32_t material_num, StrHash* material_hash_list, const DXGI_FORMAT* const * rtv_format_list, const DXGI_FORMAT* dsv_format, RenderGraphConfig* graph);
+// +1 per queue type for the last pass execution, +1 per signaling pass.
+void ConfigureCommandAllocatorNumPerQueueType(RenderGraphConfig* graph);
+struct RenderGraphJsonError {
+  const char* path{nullptr}; // json pointer (RFC 6901) to the invalid value, or to the missing key.
+  const char* message{nullptr};
+};
+enum class RenderGraphJsonValidation : uint8_t { kAll, kFastFail, };
+/**
+ * checks what ParseRenderGraphJson() relies on without asserting: required keys, value types, enum names,
+ * duplicate names and references to queues, buffers, samplers, passes and materials (skipped if material_hash_list is null).
+ * the document is traversed once and every error is logged and returned, kFastFail stops at the first one.
+ **/
+ArrayOf<RenderGraphJsonError> ValidateRenderGraphJson(const nlohmann::json& j, const uint32_t material_num, const StrHash* material_hash_list, const RenderGraphJsonValidation validation, const MemoryType memory_type);
 }
 #endif
@@ -0,0 +1,629 @@
+#include "d3d12_render_graph_reload.h"
+#include <algorithm>
+#include "d3d12_gpu_buffer_allocator.h"
+#include "d3d12_memory_allocators.h"
+#include "d3d12_scene.h"
+#include "d3d12_src_common.h"
+#include "illuminate/util/hash_map.h"
+namespace illuminate {
+namespace {
+static const uint32_t kInvalidIndex = ~0U;
+using IndexMap = HashMap<uint32_t, MemoryTypeAllocator>;
+template <typename T>
+auto IsArrayEqual(const uint32_t num, const T* a, const T* b) {
+  return num == 0 || memcmp(a, b, sizeof(T) * num) == 0;
+}
+auto IsFullReloadNeeded(const RenderGraphConfig& a, const RenderGraphConfig& b) {
+  if (a.frame_buffer_num != b.frame_buffer_num) { return true; }
+  if (a.window_width != b.window_width || a.window_height != b.window_height) { return true; }
+  if (a.command_queue_num != b.command_queue_num) { return true; }
+  if (!IsArrayEqual(a.command_queue_num, a.command_queue_name, b.command_queue_name)
+      || !IsArrayEqual(a.command_queue_num, a.command_queue_type, b.command_queue_type)
+      || !IsArrayEqual(a.command_queue_num, a.command_queue_priority, b.command_queue_priority)
+      || !IsArrayEqual(a.command_queue_num, a.command_list_num_per_queue, b.command_list_num_per_queue)) {
+    return true;
+  }
+  if (a.swapchain_command_queue_index != b.swapchain_command_queue_index || a.swapchain_format != b.swapchain_format || a.swapchain_usage != b.swapchain_usage) { return true; }
+  // pipeline states of passes are created with the primary buffer format.
+  if (a.primarybuffer_format != b.primarybuffer_format) { return true; }
+  if (a.gpu_handle_num_view != b.gpu_handle_num_view || a.gpu_handle_num_sampler != b.gpu_handle_num_sampler
+      || a.max_model_num != b.max_model_num || a.max_material_num != b.max_material_num || a.max_mipmap_num != b.max_mipmap_num
+      || a.timestamp_query_dst_resource_num != b.timestamp_query_dst_resource_num) {
+    return true;
+  }
+  return false;
+}
+auto IsSameResource(const BufferConfig& a, const MainBufferSize& a_main_buffer_size, const BufferConfig& b, const MainBufferSize& b_main_buffer_size) {
+  if (a.descriptor_only != b.descriptor_only || a.pingpong != b.pingpong || a.frame_buffered != b.frame_buffered) { return false; }
+  if (a.descriptor_only) { return true; }
+  if (a.heap_type != b.heap_type || a.initial_state != b.initial_state) { return false; }
+  if (memcmp(&a.clear_value, &b.clear_value, sizeof(a.clear_value)) != 0) { return false; }
+  const auto desc_a = ConvertToD3d12ResourceDesc1(a, a_main_buffer_size);
+  const auto desc_b = ConvertToD3d12ResourceDesc1(b, b_main_buffer_size);
+  return desc_a.Dimension == desc_b.Dimension
+      && desc_a.Alignment == desc_b.Alignment
+      && desc_a.Width == desc_b.Width
+      && desc_a.Height == desc_b.Height
+      && desc_a.DepthOrArraySize == desc_b.DepthOrArraySize
+      && desc_a.MipLevels == desc_b.MipLevels
+      && desc_a.Format == desc_b.Format
+      && desc_a.SampleDesc.Count == desc_b.SampleDesc.Count
+      && desc_a.SampleDesc.Quality == desc_b.SampleDesc.Quality
+      && desc_a.Layout == desc_b.Layout
+      && desc_a.Flags == desc_b.Flags
+      && desc_a.SamplerFeedbackMipRegion.Width == desc_b.SamplerFeedbackMipRegion.Width
+      && desc_a.SamplerFeedbackMipRegion.Height == desc_b.SamplerFeedbackMipRegion.Height
+      && desc_a.SamplerFeedbackMipRegion.Depth == desc_b.SamplerFeedbackMipRegion.Depth;
+}
+auto IsSameView(const BufferConfig& a, const BufferConfig& b) {
+  return a.descriptor_type_flags == b.descriptor_type_flags && a.num_elements == b.num_elements && a.stride_bytes == b.stride_bytes && a.raw_buffer == b.raw_buffer;
+}
+auto IsSameCBufferParams(const CBuffer* a, const CBuffer* b) {
+  if (a == nullptr || b == nullptr) { return a == b; }
+  if (a->params.size != b->params.size) { return false; }
+  for (uint32_t i = 0; i < a->params.size; i++) {
+    const auto& param_a = a->params.array[i];
+    const auto& param_b = b->params.array[i];
+    if (param_a.name_hash != param_b.name_hash || param_a.type != param_b.type || param_a.min != param_b.min || param_a.max != param_b.max
+        || param_a.initial_val != param_b.initial_val || param_a.size_in_bytes != param_b.size_in_bytes) {
+      return false;
+    }
+  }
+  return true;
+}
+// cbuffer of each buffer config, nullptr for buffers without params.
+auto GetCBufferPerBuffer(const RenderGraphConfig& graph) {
+  auto cbuffer = AllocateAndFillArrayFrame(graph.buffer_num, static_cast<const CBuffer*>(nullptr));
+  for (uint32_t i = 0; i < graph.cbuffer_list.size; i++) {
+    const auto& entry = graph.cbuffer_list.array[i];
+    if (entry.buffer_index < graph.buffer_num) {
+      cbuffer[entry.buffer_index] = &entry;
+    }
+  }
+  return cbuffer;
+}
+auto GetBufferReloadAction(const BufferConfig& live_config, const MainBufferSize& live_main_buffer_size, const CBuffer* live_cbuffer,
+                           const BufferConfig& reloaded_config, const MainBufferSize& reloaded_main_buffer_size, const CBuffer* reloaded_cbuffer) {
+  if (!IsSameResource(live_config, live_main_buffer_size, reloaded_config, reloaded_main_buffer_size)) {
+    return RenderGraphBufferReloadAction::kRecreate;
+  }
+  // contents are filled with initial values of the params.
+  if (!IsSameCBufferParams(live_cbuffer, reloaded_cbuffer)) {
+    return RenderGraphBufferReloadAction::kRecreate;
+  }
+  if (!IsSameView(live_config, reloaded_config)) {
+    return RenderGraphBufferReloadAction::kRecreateView;
+  }
+  return RenderGraphBufferReloadAction::kKeep;
+}
+auto CountBufferAllocationNum(const RenderGraphConfig& graph) {
+  uint32_t num = 0;
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    num += GetBufferAllocationNum(graph.buffer_list[i], graph.frame_buffer_num);
+  }
+  return num;
+}
+// allocation indices of buffer i start at offset[i] as in CreateBuffers().
+auto GetBufferAllocationOffsetList(const RenderGraphConfig& graph) {
+  auto offset = AllocateArrayFrame<uint32_t>(graph.buffer_num + 1);
+  offset[0] = 0;
+  for (uint32_t i = 0; i < graph.buffer_num; i++) {
+    offset[i + 1] = offset[i] + GetBufferAllocationNum(graph.buffer_list[i], graph.frame_buffer_num);
+  }
+  return offset;
+}
+// scene buffers and unresolved indices are the same in both graphs.
+auto GetPrevBufferIndex(const uint32_t buffer_index, const uint32_t buffer_num, const uint32_t* prev_buffer_index) {
+  if (IsSceneBuffer(buffer_index) || buffer_index >= buffer_num) { return buffer_index; }
+  return prev_buffer_index[buffer_index];
+}
+auto GetSignalPassName(const RenderGraphConfig& graph, const uint32_t render_pass_index) {
+  return render_pass_index < graph.render_pass_num ? graph.render_pass_list[render_pass_index].name : StrHash{};
+}
+auto IsSameRenderPassConfig(const RenderGraphConfig& live_graph, const RenderPass& live_pass, const RenderGraphConfig& reloaded_graph, const RenderPass& reloaded_pass, const uint32_t* prev_buffer_index) {
+  if (live_pass.type != reloaded_pass.type || live_pass.enabled != reloaded_pass.enabled || live_pass.command_queue_index != reloaded_pass.command_queue_index
+      || live_pass.material != reloaded_pass.material || live_pass.sends_signal != reloaded_pass.sends_signal || live_pass.max_buffer_index_offset != reloaded_pass.max_buffer_index_offset) {
+    return false;
+  }
+  if (live_pass.buffer_num != reloaded_pass.buffer_num || live_pass.wait_pass_num != reloaded_pass.wait_pass_num
+      || live_pass.sampler_num != reloaded_pass.sampler_num || live_pass.flip_pingpong_num != reloaded_pass.flip_pingpong_num) {
+    return false;
+  }
+  for (uint32_t i = 0; i < reloaded_pass.buffer_num; i++) {
+    const auto& live_buffer = live_pass.buffer_list[i];
+    const auto& reloaded_buffer = reloaded_pass.buffer_list[i];
+    if (GetPrevBufferIndex(reloaded_buffer.buffer_index, reloaded_graph.buffer_num, prev_buffer_index) != live_buffer.buffer_index
+        || live_buffer.index_offset != reloaded_buffer.index_offset || live_buffer.state != reloaded_buffer.state
+        || memcmp(&live_buffer.subresource_range, &reloaded_buffer.subresource_range, sizeof(live_buffer.subresource_range)) != 0) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < reloaded_pass.wait_pass_num; i++) {
+    if (live_pass.signal_queue_index[i] != reloaded_pass.signal_queue_index[i]
+        || GetSignalPassName(live_graph, live_pass.signal_pass_index[i]) != GetSignalPassName(reloaded_graph, reloaded_pass.signal_pass_index[i])) {
+      return false;
+    }
+  }
+  if (!IsArrayEqual(reloaded_pass.sampler_num, live_pass.sampler_index_list, reloaded_pass.sampler_index_list)) { return false; }
+  for (uint32_t i = 0; i < reloaded_pass.flip_pingpong_num; i++) {
+    if (GetPrevBufferIndex(reloaded_pass.flip_pingpong_index_list[i], reloaded_graph.buffer_num, prev_buffer_index) != live_pass.flip_pingpong_index_list[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+auto IsAnyBufferRecreated(const RenderPass& render_pass, const uint32_t buffer_num, const RenderGraphBufferReloadAction* buffer_action) {
+  for (uint32_t i = 0; i < render_pass.buffer_num; i++) {
+    const auto buffer_index = render_pass.buffer_list[i].buffer_index;
+    if (IsSceneBuffer(buffer_index) || buffer_index >= buffer_num) { continue; }
+    if (buffer_action[buffer_index] != RenderGraphBufferReloadAction::kKeep) { return true; }
+  }
+  return false;
+}
+} // namespace
+RenderGraphReloadPlan DiffRenderGraph(const RenderGraphConfig& live_graph, const StrHash* live_buffer_name_hash_list, const MainBufferSize& live_main_buffer_size,
+                                      const RenderGraphConfig& reloaded_graph, const StrHash* reloaded_buffer_name_hash_list, const MainBufferSize& reloaded_main_buffer_size,
+                                      const MemoryType& memory_type) {
+  RenderGraphReloadPlan plan{};
+  plan.replan_barriers = true;
+  if (IsFullReloadNeeded(live_graph, reloaded_graph)) {
+    plan.full_reload = true;
+    plan.command_allocators_changed = true;
+    plan.samplers_changed = true;
+    plan.descriptor_heaps_changed = true;
+    return plan;
+  }
+  plan.command_allocators_changed = !IsArrayEqual(kCommandQueueTypeNum, live_graph.command_allocator_num_per_queue_type, reloaded_graph.command_allocator_num_per_queue_type);
+  plan.samplers_changed = live_graph.sampler_num != reloaded_graph.sampler_num || !IsArrayEqual(reloaded_graph.sampler_num, live_graph.sampler_list, reloaded_graph.sampler_list);
+  plan.buffer_num = reloaded_graph.buffer_num;
+  plan.buffer_action = AllocateArray<RenderGraphBufferReloadAction>(memory_type, plan.buffer_num);
+  plan.prev_buffer_index = AllocateArray<uint32_t>(memory_type, plan.buffer_num);
+  plan.buffer_allocation_num = CountBufferAllocationNum(reloaded_graph);
+  plan.prev_buffer_allocation_index = AllocateArray<uint32_t>(memory_type, plan.buffer_allocation_num);
+  std::fill(plan.prev_buffer_allocation_index, plan.prev_buffer_allocation_index + plan.buffer_allocation_num, kInvalidIndex);
+  const auto live_buffer_allocation_num = CountBufferAllocationNum(live_graph);
+  plan.descriptor_heaps_changed = live_buffer_allocation_num != plan.buffer_allocation_num
+      || !IsArrayEqual(kDescriptorTypeNum, live_graph.descriptor_handle_num_per_type, reloaded_graph.descriptor_handle_num_per_type);
+  plan.released_buffer_allocation_index = AllocateArray<uint32_t>(memory_type, live_buffer_allocation_num);
+  plan.render_pass_num = reloaded_graph.render_pass_num;
+  plan.prev_render_pass_index = AllocateArray<uint32_t>(memory_type, plan.render_pass_num);
+  plan.render_pass_changed = AllocateArray<bool>(memory_type, plan.render_pass_num);
+  FrameMemoryCheckpoint checkpoint;
+  MemoryTypeAllocator frame_allocator(MemoryType::kFrame);
+  bool allocation_changed = live_buffer_allocation_num != plan.buffer_allocation_num;
+  {
+    // buffers
+    IndexMap live_buffer_index_map(&frame_allocator, live_graph.buffer_num);
+    for (uint32_t i = 0; i < live_graph.buffer_num; i++) {
+      live_buffer_index_map.InsertCopy(live_buffer_name_hash_list[i], i);
+    }
+    auto live_buffer_matched = AllocateAndFillArrayFrame(live_graph.buffer_num, false);
+    const auto live_allocation_offset = GetBufferAllocationOffsetList(live_graph);
+    const auto reloaded_allocation_offset = GetBufferAllocationOffsetList(reloaded_graph);
+    const auto live_cbuffer = GetCBufferPerBuffer(live_graph);
+    const auto reloaded_cbuffer = GetCBufferPerBuffer(reloaded_graph);
+    for (uint32_t i = 0; i < reloaded_graph.buffer_num; i++) {
+      const auto live_index = live_buffer_index_map.Get(reloaded_buffer_name_hash_list[i]);
+      if (live_index == nullptr || live_buffer_matched[*live_index]) {
+        plan.buffer_action[i] = RenderGraphBufferReloadAction::kCreate;
+        plan.prev_buffer_index[i] = kInvalidIndex;
+        plan.buffer_num_per_action[static_cast<uint32_t>(plan.buffer_action[i])]++;
+        allocation_changed = true;
+        continue;
+      }
+      live_buffer_matched[*live_index] = true;
+      plan.prev_buffer_index[i] = *live_index;
+      plan.buffer_action[i] = GetBufferReloadAction(live_graph.buffer_list[*live_index], live_main_buffer_size, live_cbuffer[*live_index],
+                                                    reloaded_graph.buffer_list[i], reloaded_main_buffer_size, reloaded_cbuffer[i]);
+      if (plan.buffer_action[i] == RenderGraphBufferReloadAction::kRecreate) {
+        plan.buffer_num_per_action[static_cast<uint32_t>(plan.buffer_action[i])]++;
+        for (uint32_t j = live_allocation_offset[*live_index]; j < live_allocation_offset[*live_index + 1]; j++) {
+          plan.released_buffer_allocation_index[plan.released_buffer_allocation_num] = j;
+          plan.released_buffer_allocation_num++;
+        }
+        allocation_changed = true;
+        continue;
+      }
+      // allocation nums match since pingpong, frame_buffered and frame_buffer_num are the same.
+      bool allocation_moved = false;
+      for (uint32_t j = reloaded_allocation_offset[i]; j < reloaded_allocation_offset[i + 1]; j++) {
+        plan.prev_buffer_allocation_index[j] = live_allocation_offset[*live_index] + j - reloaded_allocation_offset[i];
+        if (plan.prev_buffer_allocation_index[j] != j) {
+          allocation_moved = true;
+        }
+      }
+      allocation_changed = allocation_changed || allocation_moved;
+      // cpu descriptors are indexed by allocation index in a DescriptorCpu sized with descriptor_handle_num_per_type.
+      if (plan.buffer_action[i] == RenderGraphBufferReloadAction::kKeep && (allocation_moved || plan.descriptor_heaps_changed)) {
+        plan.buffer_action[i] = RenderGraphBufferReloadAction::kRecreateView;
+      }
+      plan.buffer_num_per_action[static_cast<uint32_t>(plan.buffer_action[i])]++;
+    }
+    for (uint32_t i = 0; i < live_graph.buffer_num; i++) {
+      if (live_buffer_matched[i]) { continue; }
+      plan.removed_buffer_num++;
+      for (uint32_t j = live_allocation_offset[i]; j < live_allocation_offset[i + 1]; j++) {
+        plan.released_buffer_allocation_index[plan.released_buffer_allocation_num] = j;
+        plan.released_buffer_allocation_num++;
+      }
+      allocation_changed = true;
+    }
+    std::sort(plan.released_buffer_allocation_index, plan.released_buffer_allocation_index + plan.released_buffer_allocation_num);
+  }
+  bool render_pass_config_changed = live_graph.render_pass_num != reloaded_graph.render_pass_num;
+  {
+    // render passes
+    IndexMap live_pass_index_map(&frame_allocator, live_graph.render_pass_num);
+    for (uint32_t i = 0; i < live_graph.render_pass_num; i++) {
+      live_pass_index_map.InsertCopy(live_graph.render_pass_list[i].name, i);
+    }
+    auto live_pass_matched = AllocateAndFillArrayFrame(live_graph.render_pass_num, false);
+    for (uint32_t i = 0; i < reloaded_graph.render_pass_num; i++) {
+      const auto& reloaded_pass = reloaded_graph.render_pass_list[i];
+      const auto live_index = live_pass_index_map.Get(reloaded_pass.name);
+      if (live_index == nullptr || live_pass_matched[*live_index]) {
+        plan.prev_render_pass_index[i] = kInvalidIndex;
+        plan.render_pass_changed[i] = true;
+        plan.changed_render_pass_num++;
+        render_pass_config_changed = true;
+        continue;
+      }
+      live_pass_matched[*live_index] = true;
+      plan.prev_render_pass_index[i] = *live_index;
+      if (*live_index != i) {
+        render_pass_config_changed = true;
+      }
+      if (!IsSameRenderPassConfig(live_graph, live_graph.render_pass_list[*live_index], reloaded_graph, reloaded_pass, plan.prev_buffer_index)) {
+        plan.render_pass_changed[i] = true;
+        render_pass_config_changed = true;
+      } else {
+        plan.render_pass_changed[i] = IsAnyBufferRecreated(reloaded_pass, reloaded_graph.buffer_num, plan.buffer_action);
+      }
+      if (plan.render_pass_changed[i]) {
+        plan.changed_render_pass_num++;
+      }
+    }
+    for (uint32_t i = 0; i < live_graph.render_pass_num; i++) {
+      if (!live_pass_matched[i]) {
+        plan.removed_render_pass_num++;
+      }
+    }
+  }
+  plan.replan_barriers = allocation_changed || render_pass_config_changed;
+  logdebug("render graph reload. buffers keep:{} view:{} recreate:{} create:{} remove:{} passes changed:{} removed:{} replan:{}",
+          plan.buffer_num_per_action[static_cast<uint32_t>(RenderGraphBufferReloadAction::kKeep)],
+          plan.buffer_num_per_action[static_cast<uint32_t>(RenderGraphBufferReloadAction::kRecreateView)],
+          plan.buffer_num_per_action[static_cast<uint32_t>(RenderGraphBufferReloadAction::kRecreate)],
+          plan.buffer_num_per_action[static_cast<uint32_t>(RenderGraphBufferReloadAction::kCreate)],
+          plan.removed_buffer_num, plan.changed_render_pass_num, plan.removed_render_pass_num, plan.replan_barriers);
+  return plan;
+}
+const char* GetRenderGraphBufferReloadActionName(const RenderGraphBufferReloadAction action) {
+  switch (action) {
+    case RenderGraphBufferReloadAction::kKeep:         { return "keep"; }
+    case RenderGraphBufferReloadAction::kRecreateView: { return "recreate view"; }
+    case RenderGraphBufferReloadAction::kRecreate:     { return "recreate"; }
+    case RenderGraphBufferReloadAction::kCreate:       { return "create"; }
+  }
+  return "unknown";
+}
+}
+#include "doctest/doctest.h"
+#include "d3d12_test_util.h"
+namespace {
+auto GetTestMainBufferSize(const illuminate::RenderGraphConfig& render_graph) {
+  return illuminate::MainBufferSize{
+    .swapchain = {.width = render_graph.window_width, .height = render_graph.window_height},
+    .primarybuffer = {.width = render_graph.primarybuffer_width, .height = render_graph.primarybuffer_height},
+  };
+}
+auto& FindJsonEntry(nlohmann::json& json, const char* const list_name, const char* const name) {
+  auto& list = json.at(list_name);
+  const auto it = std::find_if(list.begin(), list.end(), [name](const auto& entry) { return illuminate::GetStringView(entry, "name") == name; });
+  REQUIRE_UNARY(it != list.end());
+  return *it;
+}
+auto IsBufferUsed(const illuminate::RenderPass& render_pass, const uint32_t buffer_index) {
+  for (uint32_t i = 0; i < render_pass.buffer_num; i++) {
+    if (render_pass.buffer_list[i].buffer_index == buffer_index) { return true; }
+  }
+  return false;
+}
+auto IsAnyGraphBufferUsed(const illuminate::RenderPass& render_pass, const uint32_t buffer_num) {
+  for (uint32_t i = 0; i < render_pass.buffer_num; i++) {
+    if (!illuminate::IsSceneBuffer(render_pass.buffer_list[i].buffer_index) && render_pass.buffer_list[i].buffer_index < buffer_num) { return true; }
+  }
+  return false;
+}
+struct TestRenderGraph {
+  illuminate::RenderGraphConfig config{};
+  const illuminate::StrHash* buffer_name_hash_list{nullptr};
+  illuminate::MainBufferSize main_buffer_size{};
+};
+auto LoadReloadTestRenderGraph(const nlohmann::json& json) {
+  TestRenderGraph render_graph{};
+  render_graph.buffer_name_hash_list = LoadTestRenderGraph(json, &render_graph.config).second;
+  render_graph.main_buffer_size = GetTestMainBufferSize(render_graph.config);
+  return render_graph;
+}
+auto DiffTestRenderGraph(const TestRenderGraph& live, const TestRenderGraph& reloaded) {
+  return illuminate::DiffRenderGraph(live.config, live.buffer_name_hash_list, live.main_buffer_size,
+                                     reloaded.config, reloaded.buffer_name_hash_list, reloaded.main_buffer_size, illuminate::MemoryType::kFrame);
+}
+auto GetActionNum(const illuminate::RenderGraphReloadPlan& plan, const illuminate::RenderGraphBufferReloadAction action) {
+  return plan.buffer_num_per_action[static_cast<uint32_t>(action)];
+}
+} // namespace
+TEST_CASE("render graph reload diff") { // NOLINT
+  using namespace illuminate;
+  const auto json = LoadTestJson("deferred.json");
+  const auto live = LoadReloadTestRenderGraph(json);
+  SUBCASE("unchanged") {
+    const auto plan = DiffTestRenderGraph(live, LoadReloadTestRenderGraph(json));
+    CHECK_FALSE(plan.full_reload);
+    CHECK_FALSE(plan.replan_barriers);
+    CHECK_FALSE(plan.command_allocators_changed);
+    CHECK_FALSE(plan.samplers_changed);
+    CHECK_FALSE(plan.descriptor_heaps_changed);
+    REQUIRE_EQ(plan.buffer_num, live.config.buffer_num);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), live.config.buffer_num);
+    for (uint32_t i = 0; i < plan.buffer_num; i++) {
+      CHECK_EQ(plan.buffer_action[i], RenderGraphBufferReloadAction::kKeep);
+      CHECK_EQ(plan.prev_buffer_index[i], i);
+    }
+    for (uint32_t i = 0; i < plan.buffer_allocation_num; i++) {
+      CHECK_EQ(plan.prev_buffer_allocation_index[i], i);
+    }
+    CHECK_EQ(plan.released_buffer_allocation_num, 0);
+    CHECK_EQ(plan.removed_buffer_num, 0);
+    REQUIRE_EQ(plan.render_pass_num, live.config.render_pass_num);
+    for (uint32_t i = 0; i < plan.render_pass_num; i++) {
+      CHECK_EQ(plan.prev_render_pass_index[i], i);
+      CHECK_FALSE(plan.render_pass_changed[i]);
+    }
+    CHECK_EQ(plan.changed_render_pass_num, 0);
+    CHECK_EQ(plan.removed_render_pass_num, 0);
+  }
+  SUBCASE("buffer format") {
+    auto reloaded_json = json;
+    FindJsonEntry(reloaded_json, "buffer", "linear depth")["format"] = "R8_UNORM";
+    const auto reloaded = LoadReloadTestRenderGraph(reloaded_json);
+    const auto plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_FALSE(plan.full_reload);
+    CHECK_UNARY(plan.replan_barriers);
+    const auto linear_depth = FindBufferIndex(reloaded.buffer_name_hash_list, reloaded.config.buffer_num, "linear depth");
+    REQUIRE_LT(linear_depth, plan.buffer_num);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreate), 1);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), plan.buffer_num - 1);
+    for (uint32_t i = 0; i < plan.buffer_num; i++) {
+      CHECK_EQ(plan.buffer_action[i], (i == linear_depth) ? RenderGraphBufferReloadAction::kRecreate : RenderGraphBufferReloadAction::kKeep);
+    }
+    // buffer order is the same, only the recreated allocation is not moved.
+    REQUIRE_EQ(plan.released_buffer_allocation_num, 1);
+    CHECK_EQ(plan.prev_buffer_allocation_index[plan.released_buffer_allocation_index[0]], ~0U);
+    for (uint32_t i = 0; i < plan.buffer_allocation_num; i++) {
+      if (i == plan.released_buffer_allocation_index[0]) { continue; }
+      CHECK_EQ(plan.prev_buffer_allocation_index[i], i);
+    }
+    uint32_t user_num = 0;
+    for (uint32_t i = 0; i < plan.render_pass_num; i++) {
+      const auto used = IsBufferUsed(reloaded.config.render_pass_list[i], linear_depth);
+      CHECK_EQ(plan.render_pass_changed[i], used);
+      user_num += used ? 1 : 0;
+    }
+    CHECK_GE(user_num, 2);
+    CHECK_EQ(plan.changed_render_pass_num, user_num);
+  }
+  SUBCASE("view only") {
+    auto reloaded = LoadReloadTestRenderGraph(json);
+    const auto primary = FindBufferIndex(reloaded.buffer_name_hash_list, reloaded.config.buffer_num, "primary");
+    REQUIRE_LT(primary, reloaded.config.buffer_num);
+    auto& primary_config = reloaded.config.buffer_list[primary];
+    // descriptor nums are the same.
+    primary_config.raw_buffer = !primary_config.raw_buffer;
+    auto plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_FALSE(plan.descriptor_heaps_changed);
+    CHECK_EQ(plan.buffer_action[primary], RenderGraphBufferReloadAction::kRecreateView);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), plan.buffer_num - 1);
+    // the resource is kept, barriers stay valid.
+    CHECK_FALSE(plan.replan_barriers);
+    CHECK_EQ(plan.released_buffer_allocation_num, 0);
+    for (uint32_t i = 0; i < plan.buffer_allocation_num; i++) {
+      CHECK_EQ(plan.prev_buffer_allocation_index[i], i);
+    }
+    for (uint32_t i = 0; i < plan.render_pass_num; i++) {
+      CHECK_EQ(plan.render_pass_changed[i], IsBufferUsed(reloaded.config.render_pass_list[i], primary));
+    }
+    // a new srv changes descriptor nums, every view is recreated in re-initialized descriptor heaps.
+    primary_config.raw_buffer = !primary_config.raw_buffer;
+    REQUIRE_EQ(primary_config.descriptor_type_flags & kDescriptorTypeFlagDsv, 0);
+    primary_config.descriptor_type_flags = static_cast<DescriptorTypeFlag>(primary_config.descriptor_type_flags ^ kDescriptorTypeFlagSrv);
+    const auto srv_index = static_cast<uint32_t>(DescriptorType::kSrv);
+    if (primary_config.descriptor_type_flags & kDescriptorTypeFlagSrv) {
+      reloaded.config.descriptor_handle_num_per_type[srv_index]++;
+    } else {
+      reloaded.config.descriptor_handle_num_per_type[srv_index]--;
+    }
+    plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_UNARY(plan.descriptor_heaps_changed);
+    CHECK_FALSE(plan.replan_barriers);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreateView), plan.buffer_num);
+    for (uint32_t i = 0; i < plan.render_pass_num; i++) {
+      CHECK_EQ(plan.render_pass_changed[i], IsAnyGraphBufferUsed(reloaded.config.render_pass_list[i], reloaded.config.buffer_num));
+    }
+  }
+  SUBCASE("added and removed") {
+    auto added_json = json;
+    auto& buffer_list = added_json.at("buffer");
+    buffer_list.insert(buffer_list.begin(), nlohmann::json{{"name", "history"}, {"initial_state", "uav"}, {"format", "R16G16B16A16_FLOAT"}});
+    added_json.at("render_pass").push_back({{"name", "accumulate"}, {"type", "test"}, {"command_queue", "queue_graphics"}, {"buffer_list", {{{"name", "history"}, {"state", "uav"}}}}});
+    const auto added = LoadReloadTestRenderGraph(added_json);
+    const auto history = FindBufferIndex(added.buffer_name_hash_list, added.config.buffer_num, "history");
+    const auto accumulate = FindRenderPassIndex(added.config, "accumulate");
+    REQUIRE_EQ(history, 0);
+    {
+      const auto plan = DiffTestRenderGraph(live, added);
+      CHECK_UNARY(plan.replan_barriers);
+      CHECK_UNARY(plan.descriptor_heaps_changed);
+      CHECK_EQ(plan.buffer_action[history], RenderGraphBufferReloadAction::kCreate);
+      CHECK_EQ(plan.prev_buffer_index[history], ~0U);
+      CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreateView), live.config.buffer_num);
+      CHECK_EQ(plan.released_buffer_allocation_num, 0);
+      // every other buffer is shifted by one, allocations move along and views are recreated at new indices.
+      for (uint32_t i = 1; i < plan.buffer_num; i++) {
+        CHECK_EQ(plan.buffer_action[i], RenderGraphBufferReloadAction::kRecreateView);
+        CHECK_EQ(plan.prev_buffer_index[i], i - 1);
+        CHECK_EQ(live.buffer_name_hash_list[plan.prev_buffer_index[i]], added.buffer_name_hash_list[i]);
+      }
+      CHECK_EQ(plan.prev_buffer_allocation_index[0], ~0U);
+      for (uint32_t i = 1; i < plan.buffer_allocation_num; i++) {
+        CHECK_EQ(plan.prev_buffer_allocation_index[i], i - 1);
+      }
+      // passes refer to buffers by shifted indices, only the views they bind are recreated.
+      for (uint32_t i = 0; i < plan.render_pass_num; i++) {
+        CHECK_EQ(plan.render_pass_changed[i], i == accumulate || IsAnyGraphBufferUsed(added.config.render_pass_list[i], added.config.buffer_num));
+      }
+      CHECK_UNARY(plan.render_pass_changed[accumulate]);
+      CHECK_EQ(plan.prev_render_pass_index[accumulate], ~0U);
+    }
+    {
+      const auto plan = DiffTestRenderGraph(added, live);
+      CHECK_UNARY(plan.replan_barriers);
+      CHECK_UNARY(plan.descriptor_heaps_changed);
+      CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreateView), live.config.buffer_num);
+      CHECK_EQ(plan.removed_buffer_num, 1);
+      REQUIRE_EQ(plan.released_buffer_allocation_num, 1);
+      CHECK_EQ(plan.released_buffer_allocation_index[0], 0);
+      for (uint32_t i = 0; i < plan.buffer_allocation_num; i++) {
+        CHECK_EQ(plan.prev_buffer_allocation_index[i], i + 1);
+      }
+      for (uint32_t i = 0; i < plan.render_pass_num; i++) {
+        CHECK_EQ(plan.render_pass_changed[i], IsAnyGraphBufferUsed(live.config.render_pass_list[i], live.config.buffer_num));
+      }
+      CHECK_EQ(plan.removed_render_pass_num, 1);
+    }
+  }
+  SUBCASE("main buffer size") {
+    auto reloaded = LoadReloadTestRenderGraph(json);
+    reloaded.main_buffer_size.primarybuffer.width /= 2;
+    const auto plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_UNARY(plan.replan_barriers);
+    uint32_t recreated_num = 0;
+    for (uint32_t i = 0; i < plan.buffer_num; i++) {
+      const auto& config = reloaded.config.buffer_list[i];
+      const auto relative = !config.descriptor_only && config.size_type == BufferSizeRelativeness::kPrimaryBufferRelative;
+      CHECK_EQ(plan.buffer_action[i], relative ? RenderGraphBufferReloadAction::kRecreate : RenderGraphBufferReloadAction::kKeep);
+      recreated_num += relative ? 1 : 0;
+    }
+    CHECK_GT(recreated_num, 0);
+    CHECK_LT(recreated_num, plan.buffer_num);
+  }
+  SUBCASE("wait pass") {
+    auto reloaded_json = json;
+    FindJsonEntry(reloaded_json, "render_pass", "lighting").erase("wait_pass");
+    const auto reloaded = LoadReloadTestRenderGraph(reloaded_json);
+    const auto plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_FALSE(plan.full_reload);
+    CHECK_UNARY(plan.replan_barriers);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), plan.buffer_num);
+    const auto lighting = FindRenderPassIndex(reloaded.config, "lighting");
+    const auto gbuffer = FindRenderPassIndex(reloaded.config, "gbuffer");
+    CHECK_UNARY(plan.render_pass_changed[lighting]);
+    // gbuffer no longer signals.
+    CHECK_UNARY(plan.render_pass_changed[gbuffer]);
+    CHECK_EQ(plan.changed_render_pass_num, 2);
+    CHECK_UNARY(plan.command_allocators_changed);
+  }
+  SUBCASE("cbuffer params") {
+    auto reloaded_json = json;
+    auto& params = FindJsonEntry(reloaded_json, "cbuffer", "screen space shadow cbuffer").at("params");
+    const auto it = std::find_if(params.begin(), params.end(), [](const auto& param) { return GetStringView(param, "name") == "thickness"; });
+    REQUIRE_UNARY(it != params.end());
+    (*it)["initial_val"] = 0.5f;
+    const auto reloaded = LoadReloadTestRenderGraph(reloaded_json);
+    const auto plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_FALSE(plan.full_reload);
+    CHECK_FALSE(plan.descriptor_heaps_changed);
+    const auto cbuffer = FindBufferIndex(reloaded.buffer_name_hash_list, reloaded.config.buffer_num, "screen space shadow cbuffer");
+    REQUIRE_LT(cbuffer, plan.buffer_num);
+    CHECK_EQ(plan.buffer_action[cbuffer], RenderGraphBufferReloadAction::kRecreate);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreate), 1);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), plan.buffer_num - 1);
+    CHECK_UNARY(plan.replan_barriers);
+    CHECK_EQ(plan.released_buffer_allocation_num, GetBufferAllocationNum(reloaded.config.buffer_list[cbuffer], reloaded.config.frame_buffer_num));
+  }
+  SUBCASE("descriptor nums") {
+    auto reloaded = LoadReloadTestRenderGraph(json);
+    reloaded.config.descriptor_handle_num_per_type[static_cast<uint32_t>(DescriptorType::kCbv)]++;
+    const auto plan = DiffTestRenderGraph(live, reloaded);
+    CHECK_FALSE(plan.full_reload);
+    CHECK_UNARY(plan.descriptor_heaps_changed);
+    CHECK_FALSE(plan.replan_barriers);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), 0);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreateView), plan.buffer_num);
+  }
+  SUBCASE("samplers") {
+    auto reloaded_json = json;
+    FindJsonEntry(reloaded_json, "sampler", "bilinear")["filter_mip"] = "linear";
+    const auto plan = DiffTestRenderGraph(live, LoadReloadTestRenderGraph(reloaded_json));
+    CHECK_UNARY(plan.samplers_changed);
+    CHECK_FALSE(plan.replan_barriers);
+    CHECK_EQ(plan.changed_render_pass_num, 0);
+  }
+  SUBCASE("full reload") {
+    auto reloaded_json = json;
+    reloaded_json["frame_buffer_num"] = 3;
+    auto plan = DiffTestRenderGraph(live, LoadReloadTestRenderGraph(reloaded_json));
+    CHECK_UNARY(plan.full_reload);
+    CHECK_EQ(plan.buffer_num, 0);
+    reloaded_json = json;
+    FindJsonEntry(reloaded_json, "command_queue", "queue_compute")["priority"] = "high";
+    plan = DiffTestRenderGraph(live, LoadReloadTestRenderGraph(reloaded_json));
+    CHECK_UNARY(plan.full_reload);
+    reloaded_json = json;
+    reloaded_json["primarybuffer_format"] = "R16G16B16A16_FLOAT";
+    plan = DiffTestRenderGraph(live, LoadReloadTestRenderGraph(reloaded_json));
+    CHECK_UNARY(plan.full_reload);
+    CHECK_UNARY(plan.descriptor_heaps_changed);
+  }
+  ClearAllAllocations();
+}
+TEST_CASE("render graph reload benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate;
+  const uint32_t buffer_num = 4096;
+  const uint32_t render_pass_num = 4096;
+  const uint32_t loop_num = 100;
+  TestRenderGraph live{};
+  const auto buffer_name_hash_list = ParseSyntheticRenderGraphJson(CreateSyntheticRenderGraphJson(render_pass_num, buffer_num), &live.config).second;
+  REQUIRE_EQ(live.config.buffer_num, buffer_num + 1); // +swapchain
+  // names are parsed into frame memory, which is reset while measuring.
+  auto buffer_name_hash_list_system = AllocateArraySystem<StrHash>(live.config.buffer_num);
+  memcpy(buffer_name_hash_list_system, buffer_name_hash_list, sizeof(StrHash) * live.config.buffer_num);
+  live.buffer_name_hash_list = buffer_name_hash_list_system;
+  live.main_buffer_size = GetTestMainBufferSize(live.config);
+  const auto swapchain_index = FindBufferIndex(live.buffer_name_hash_list, live.config.buffer_num, "swapchain");
+  for (const uint32_t changed_buffer_num : {0U, 1U, 16U, 256U, buffer_num}) {
+    auto reloaded = live;
+    reloaded.config.buffer_list = AllocateArraySystem<BufferConfig>(live.config.buffer_num);
+    memcpy(reloaded.config.buffer_list, live.config.buffer_list, sizeof(BufferConfig) * live.config.buffer_num);
+    for (uint32_t i = 0; i < changed_buffer_num; i++) {
+      const auto buffer_index = (i * (buffer_num / changed_buffer_num)) % buffer_num;
+      reloaded.config.buffer_list[buffer_index < swapchain_index ? buffer_index : buffer_index + 1].format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    }
+    RenderGraphReloadPlan plan{};
+    const auto time_in_us = MeasureTimePerOp<std::micro>(loop_num, [&]() {
+      for (uint32_t i = 0; i < loop_num; i++) {
+        ResetAllocation(MemoryType::kFrame);
+        plan = DiffTestRenderGraph(live, reloaded);
+      }
+    });
+    // a full reload recreates every allocation, view and pass, an incremental one what the plan lists.
+    const auto recreated_allocation_num = plan.released_buffer_allocation_num;
+    spdlog::info("render graph reload: buffers:{} passes:{} changed buffers:{} recreated allocations:{}/{} changed passes:{}/{} replan:{} diff:{:.1f}us",
+                 buffer_num, render_pass_num, changed_buffer_num, recreated_allocation_num, plan.buffer_allocation_num,
+                 plan.changed_render_pass_num, render_pass_num, plan.replan_barriers, time_in_us);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kRecreate), changed_buffer_num);
+    CHECK_EQ(GetActionNum(plan, RenderGraphBufferReloadAction::kKeep), live.config.buffer_num - changed_buffer_num);
+  }
+  ClearAllAllocations();
+}
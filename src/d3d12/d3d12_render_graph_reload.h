@@ -0,0 +1,51 @@
+#ifndef ILLUMINATE_D3D12_RENDER_GRAPH_RELOAD_H
+#define ILLUMINATE_D3D12_RENDER_GRAPH_RELOAD_H
+#include "d3d12_render_graph.h"
+#include "illuminate/util/util_defines.h"
+namespace illuminate {
+enum class MemoryType : uint8_t;
+/**
+ * diffs a re-parsed render graph against the live one so that a hot reload recreates only what changed.
+ * buffers are matched by name hash (ParseRenderGraphJson() retval), render passes by name, first match wins for duplicate names.
+ * a matched buffer keeps its allocations when everything CreateBuffers() depends on is the same (resource desc with main buffer sizes applied,
+ * heap, initial state, clear value, allocation num) and its cbuffer params are the same (contents start from initial values).
+ * it keeps its cpu descriptors as well unless its views changed (descriptor flags, elements, stride, raw), its allocations moved
+ * or DescriptorCpu has to be re-initialized (descriptor_handle_num_per_type or allocation num differs), in which case it is kRecreateView.
+ * allocation indices follow CreateBuffers() in both graphs. applying the plan (moving kept allocations, releasing the others) is left to the caller.
+ * a render pass is changed when its config differs after buffer indices are mapped or when it uses a buffer whose allocations or views are recreated,
+ * since pass vars may hold them since init.
+ * barrier plans hold pass and allocation indices and recreated buffers restart in their initial states,
+ * so barriers are re-planned (BarrierTransitionCache re-initialized) unless passes, allocation indices and allocations are all unchanged.
+ * changes to queues, swapchain, window, frame buffer num, primary buffer format or gpu side limits cannot be applied incrementally and set full_reload only.
+ * both graphs must have gone through the same steps after parsing (e.g. FillCbvBufferCreationSize()) for cbv sizes to be compared.
+ **/
+enum class RenderGraphBufferReloadAction : uint8_t { kKeep, kRecreateView, kRecreate, kCreate, };
+static const uint32_t kRenderGraphBufferReloadActionNum = 4;
+struct RenderGraphReloadPlan {
+  bool full_reload{false};
+  bool replan_barriers{false};
+  bool command_allocators_changed{false}; // command_allocator_num_per_queue_type differs (signals changed), command lists need re-init.
+  bool samplers_changed{false};
+  bool descriptor_heaps_changed{false}; // DescriptorCpu needs re-init, no buffer is kKeep.
+  uint32_t buffer_num{0}; // of the reloaded graph, as are the lists below.
+  RenderGraphBufferReloadAction* buffer_action{nullptr};
+  uint32_t* prev_buffer_index{nullptr}; // live buffer config index, ~0U for kCreate.
+  uint32_t buffer_allocation_num{0};
+  uint32_t* prev_buffer_allocation_index{nullptr}; // live allocation to move for kKeep and kRecreateView, ~0U otherwise.
+  uint32_t released_buffer_allocation_num{0};
+  uint32_t* released_buffer_allocation_index{nullptr}; // live allocations of removed and recreated buffers.
+  uint32_t render_pass_num{0};
+  uint32_t* prev_render_pass_index{nullptr}; // ~0U for added passes.
+  bool* render_pass_changed{nullptr}; // true for added passes.
+  uint32_t buffer_num_per_action[kRenderGraphBufferReloadActionNum]{};
+  uint32_t removed_buffer_num{0};
+  uint32_t changed_render_pass_num{0}; // including added ones.
+  uint32_t removed_render_pass_num{0};
+};
+// buffer and pass lists are left empty when full_reload is set.
+RenderGraphReloadPlan DiffRenderGraph(const RenderGraphConfig& live_graph, const StrHash* live_buffer_name_hash_list, const MainBufferSize& live_main_buffer_size,
+                                      const RenderGraphConfig& reloaded_graph, const StrHash* reloaded_buffer_name_hash_list, const MainBufferSize& reloaded_main_buffer_size,
+                                      const MemoryType& memory_type);
+const char* GetRenderGraphBufferReloadActionName(const RenderGraphBufferReloadAction action);
+}
+#endif
@@ -127,14 +127,14 @@ void SetTransform(const tinygltf::Model& model, const uint32_t node_index, const
 }
 auto GetModelMaterialVariationHash(const tinygltf::Material& material) {
   StrHash hash{};
-  hash = CombineHash(CalcStrHash("MESH_DEFORM_TYPE"), hash);
-  hash = CombineHash(CalcStrHash("MESH_DEFORM_TYPE_STATIC"), hash);
-  hash = CombineHash(CalcStrHash("OPACITY_TYPE"), hash);
+  hash = CombineHash(SID("MESH_DEFORM_TYPE"), hash);
+  hash = CombineHash(SID("MESH_DEFORM_TYPE_STATIC"), hash);
+  hash = CombineHash(SID("OPACITY_TYPE"), hash);
   if (material.alphaMode.compare("MASK") == 0) {
-    hash = CombineHash(CalcStrHash("OPACITY_TYPE_ALPHA_MASK"), hash);
+    hash = CombineHash(SID("OPACITY_TYPE_ALPHA_MASK"), hash);
   } else {
     assert(material.alphaMode.compare("OPAQUE") == 0);
-    hash = CombineHash(CalcStrHash("OPACITY_TYPE_OPAQUE"), hash);
+    hash = CombineHash(SID("OPACITY_TYPE_OPAQUE"), hash);
   }
   return hash;
 }
@@ -595,15 +595,15 @@ auto CreateSamplers(const std::vector<tinygltf::Sampler>& samplers, D3d12Device*
 auto ParseTinyGltfScene(const tinygltf::Model& model, const char* const gltf_path, const uint32_t frame_index, D3d12Device* device, D3D12MA::Allocator* buffer_allocator, ResourceTransfer* resource_transfer) {
   SceneData scene_data{};
   scene_data.model_num = GetUint32(model.meshes.size());
-  scene_data.model_instance_num = AllocateArrayScene<uint32_t>(scene_data.model_num);
-  scene_data.model_submesh_num = AllocateArrayScene<uint32_t>(scene_data.model_num);
-  scene_data.model_submesh_index = AllocateArrayScene<uint32_t*>(scene_data.model_num);
-  scene_data.transform_offset = AllocateArrayScene<uint32_t>(scene_data.model_num);
+  scene_data.model_instance_num = AllocateArraySceneHeap<uint32_t>(scene_data.model_num);
+  scene_data.model_submesh_num = AllocateArraySceneHeap<uint32_t>(scene_data.model_num);
+  scene_data.model_submesh_index = AllocateArraySceneHeap<uint32_t*>(scene_data.model_num);
+  scene_data.transform_offset = AllocateArraySceneHeap<uint32_t>(scene_data.model_num);
   uint32_t mesh_num = 0;
   for (uint32_t i = 0; i < scene_data.model_num; i++) {
     scene_data.model_instance_num[i] = 0;
     scene_data.model_submesh_num[i] = GetUint32(model.meshes[i].primitives.size());
-    scene_data.model_submesh_index[i] = AllocateArrayScene<uint32_t>(scene_data.model_submesh_num[i]);
+    scene_data.model_submesh_index[i] = AllocateArraySceneHeap<uint32_t>(scene_data.model_submesh_num[i]);
     for (uint32_t j = 0; j < scene_data.model_submesh_num[i]; j++) {
       scene_data.model_submesh_index[i][j] = mesh_num;
       mesh_num++;
@@ -612,13 +612,13 @@ auto ParseTinyGltfScene(const tinygltf::Model& model, const char* const gltf_pat
   scene_data.texture_num = GetTextureNum(model);
   const auto resource_num = mesh_num * (kVertexBufferTypeNum + 1/*index buffer*/) + scene_data.texture_num + kSceneDescriptorHandleTypeNum - 2/*texture,sampler*/;
   scene_data.resource_num = 0;
-  scene_data.resources = AllocateArrayScene<ID3D12Resource*>(resource_num);
-  scene_data.allocations = AllocateArrayScene<D3D12MA::Allocation*>(resource_num);
-  scene_data.submesh_index_buffer_len = AllocateArrayScene<uint32_t>(mesh_num);
-  scene_data.submesh_index_buffer_view = AllocateArrayScene<D3D12_INDEX_BUFFER_VIEW>(mesh_num);
-  scene_data.submesh_vertex_buffer_view = AllocateArrayScene<D3D12_VERTEX_BUFFER_VIEW>(mesh_num * kVertexBufferTypeNum);
+  scene_data.resources = AllocateArraySceneHeap<ID3D12Resource*>(resource_num);
+  scene_data.allocations = AllocateArraySceneHeap<D3D12MA::Allocation*>(resource_num);
+  scene_data.submesh_index_buffer_len = AllocateArraySceneHeap<uint32_t>(mesh_num);
+  scene_data.submesh_index_buffer_view = AllocateArraySceneHeap<D3D12_INDEX_BUFFER_VIEW>(mesh_num);
+  scene_data.submesh_vertex_buffer_view = AllocateArraySceneHeap<D3D12_VERTEX_BUFFER_VIEW>(mesh_num * kVertexBufferTypeNum);
   for (uint32_t i = 0; i < kVertexBufferTypeNum; i++) {
-    scene_data.submesh_vertex_buffer_view_index[i] = AllocateArrayScene<uint32_t>(mesh_num);
+    scene_data.submesh_vertex_buffer_view_index[i] = AllocateArraySceneHeap<uint32_t>(mesh_num);
   }
   {
     const auto default_buffer_index = scene_data.resource_num;
@@ -667,8 +667,8 @@ auto ParseTinyGltfScene(const tinygltf::Model& model, const char* const gltf_pat
     scene_data.resource_num += num;
     vertex_buffer_index_offset += num;
   }
-  scene_data.submesh_material_variation_hash = AllocateArrayScene<StrHash>(mesh_num);
-  scene_data.submesh_material_index = AllocateArrayScene<uint32_t>(mesh_num);
+  scene_data.submesh_material_variation_hash = AllocateArraySceneHeap<StrHash>(mesh_num);
+  scene_data.submesh_material_index = AllocateArraySceneHeap<uint32_t>(mesh_num);
   SetSubmeshMaterials(model, &scene_data);
   for (const auto& node : model.scenes[0].nodes) {
     CountModelInstanceNum(model, node, scene_data.model_instance_num);
@@ -726,6 +726,24 @@ void ReleaseSceneData(SceneData* scene_data) {
   }
   scene_data->descriptor_heap->Release();
   scene_data->sampler_descriptor_heap->Release();
+  for (uint32_t i = 0; i < scene_data->model_num; i++) {
+    FreeSceneHeap(scene_data->model_submesh_index[i]);
+  }
+  FreeSceneHeap(scene_data->model_instance_num);
+  FreeSceneHeap(scene_data->model_submesh_num);
+  FreeSceneHeap(scene_data->model_submesh_index);
+  FreeSceneHeap(scene_data->transform_offset);
+  FreeSceneHeap(scene_data->resources);
+  FreeSceneHeap(scene_data->allocations);
+  FreeSceneHeap(scene_data->submesh_index_buffer_len);
+  FreeSceneHeap(scene_data->submesh_index_buffer_view);
+  FreeSceneHeap(scene_data->submesh_vertex_buffer_view);
+  for (uint32_t i = 0; i < kVertexBufferTypeNum; i++) {
+    FreeSceneHeap(scene_data->submesh_vertex_buffer_view_index[i]);
+  }
+  FreeSceneHeap(scene_data->submesh_material_variation_hash);
+  FreeSceneHeap(scene_data->submesh_material_index);
+  *scene_data = {};
 }
 namespace {
 static const StrHash scene_buffer_names[] = {
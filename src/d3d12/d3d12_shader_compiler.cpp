@@ -513,7 +513,7 @@ uint32_t GetVertexBufferTypeFlags(const nlohmann::json& variation) {
 auto GetMaterialBufferFormat(const uint32_t material_num, const nlohmann::json& material_json_list) {
   auto rtv_format_num = AllocateArrayFrame<uint32_t>(material_num);;
   auto rtv_format_list = AllocateArrayFrame<DXGI_FORMAT*>(material_num);;
-  auto dsv_format = AllocateArrayFrame<DXGI_FORMAT>(material_num);;
+  auto dsv_format = AllocateAndFillArrayFrame(material_num, DXGI_FORMAT_UNKNOWN);
   for (uint32_t m = 0; m < material_num; m++) {
     const auto& material = material_json_list[m];
     if (material.contains("render_target_formats")) {
@@ -619,7 +619,7 @@ auto CalcMaterialVariationParamsHash(const nlohmann::json& params, const uint32_
   }
   return hash;
 }
-void SetMaterialVariationValues(const nlohmann::json& material_json, uint32_t* material_num, uint32_t** material_hash_list, uint32_t** variation_hash_list_len, uint32_t*** variation_hash_list) {
+void SetMaterialVariationValues(const nlohmann::json& material_json, uint32_t* material_num, StrHash** material_hash_list, uint32_t** variation_hash_list_len, StrHash*** variation_hash_list) {
   const auto& material_list_json = material_json.at("materials");
   *material_num = CreateJsonStrHashList(material_list_json, "name", material_hash_list, MemoryType::kSystem);
   *variation_hash_list_len = AllocateArraySystem<uint32_t>(*material_num);
@@ -713,6 +713,19 @@ uint32_t FindMaterialVariationIndex(const MaterialList& material_list, const uin
   }
   return 0;
 }
+MaterialConfigInfo ParseMaterialConfigInfo(const nlohmann::json& material_json) {
+  const auto& material_json_list = material_json.at("materials");
+  const auto material_num = GetUint32(material_json_list.size());
+  auto [rtv_format_num, rtv_format_list, dsv_format] = GetMaterialBufferFormat(material_num, material_json_list);
+  MaterialConfigInfo config{
+    .material_hash_list = nullptr,
+    .rtv_format_num = rtv_format_num,
+    .rtv_format_list = rtv_format_list,
+    .dsv_format = dsv_format,
+  };
+  CreateJsonStrHashList(material_json_list, "name", &config.material_hash_list, MemoryType::kSystem);
+  return config;
+}
 MaterialPack BuildMaterialList(D3d12Device* device, const nlohmann::json& material_json) {
   ShaderCompiler shader_compiler;
   if (!shader_compiler.Init()) {
@@ -53,5 +53,7 @@ constexpr auto GetMaterialPso(const MaterialList& material_list, const uint32_t
 uint32_t FindMaterialVariationIndex(const MaterialList& material_list, const uint32_t material, const StrHash variation_hash);
 void ReleasePsoAndRootsig(MaterialList*);
 MaterialPack BuildMaterialList(D3d12Device* device, const nlohmann::json& material_json);
+// material names and render target formats only, without shader compilation (e.g. for baking render graphs offline).
+MaterialConfigInfo ParseMaterialConfigInfo(const nlohmann::json& material_json);
 }
 #endif
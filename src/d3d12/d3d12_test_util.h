@@ -0,0 +1,249 @@
+#ifndef ILLUMINATE_D3D12_TEST_UTIL_H
+#define ILLUMINATE_D3D12_TEST_UTIL_H
+// helpers shared by the doctest cases in d3d12 sources, files are loaded relative to resource/.
+#include <algorithm>
+#include <string>
+#include "doctest/doctest.h"
+#include "d3d12_barriers.h"
+#include "d3d12_json_parser.h"
+#include "d3d12_render_graph.h"
+#include "d3d12_render_graph_json_parser.h"
+#include "d3d12_shader_compiler.h"
+#include "d3d12_src_common.h"
+#include "../util/test_util.h"
+namespace illuminate {
+inline auto LoadTestJson(const char* const filename) {
+  nlohmann::json json;
+  CHECK_UNARY(LoadJsonFile(filename, &json));
+  return json;
+}
+// parses a render graph with the materials in material.json, returns buffer names and name hashes.
+inline auto LoadTestRenderGraph(const nlohmann::json& render_graph_json, RenderGraphConfig* render_graph) {
+  const auto material_json = LoadTestJson("material.json");
+  const auto material_config = ParseMaterialConfigInfo(material_json);
+  return ParseRenderGraphJson(render_graph_json, GetUint32(material_json.at("materials").size()), material_config.material_hash_list, material_config.rtv_format_list, material_config.dsv_format, render_graph);
+}
+inline auto FindRenderPassIndex(const RenderGraphConfig& render_graph, const StrHash& name) {
+  for (uint32_t i = 0; i < render_graph.render_pass_num; i++) {
+    if (render_graph.render_pass_list[i].name == name) { return i; }
+  }
+  return render_graph.render_pass_num;
+}
+inline auto FindRenderPassIndex(const RenderGraphConfig& render_graph, const char* const name) {
+  return FindRenderPassIndex(render_graph, CalcStrHash(name));
+}
+inline auto FindBufferIndex(const StrHash* buffer_name_hash_list, const uint32_t buffer_num, const char* const name) {
+  const auto hash = CalcStrHash(name);
+  for (uint32_t i = 0; i < buffer_num; i++) {
+    if (buffer_name_hash_list[i] == hash) { return i; }
+  }
+  return buffer_num;
+}
+// seeded random graph on direct, compute and copy queues. each pass writes the first of up to 4 distinct buffers and reads the rest.
+// the first pass runs on the direct queue and a pass waits for the previous pass when it runs on another queue,
+// so that all accesses are ordered across queues and transitions invalid on compute and copy queues have a graphics pass to move to.
+inline auto CreateRandomRenderGraph(const uint32_t render_pass_num, const uint32_t buffer_num, const uint32_t pingpong_percent, const uint32_t frame_buffered_percent, const uint32_t seed) {
+  Lcg lcg(seed);
+  RenderGraphConfig render_graph{};
+  render_graph.frame_buffer_num = 2;
+  render_graph.command_queue_num = 3;
+  render_graph.command_queue_type = AllocateArraySystem<D3D12_COMMAND_LIST_TYPE>(render_graph.command_queue_num);
+  render_graph.command_queue_type[0] = D3D12_COMMAND_LIST_TYPE_DIRECT;
+  render_graph.command_queue_type[1] = D3D12_COMMAND_LIST_TYPE_COMPUTE;
+  render_graph.command_queue_type[2] = D3D12_COMMAND_LIST_TYPE_COPY;
+  render_graph.buffer_num = buffer_num;
+  render_graph.buffer_list = AllocateArraySystem<BufferConfig>(buffer_num);
+  for (uint32_t i = 0; i < buffer_num; i++) {
+    const auto r = lcg.Next(100);
+    render_graph.buffer_list[i].initial_state = ResourceStateType::kCommon;
+    render_graph.buffer_list[i].pingpong = (r < pingpong_percent);
+    render_graph.buffer_list[i].frame_buffered = !render_graph.buffer_list[i].pingpong && (r < pingpong_percent + frame_buffered_percent);
+  }
+  const ResourceStateType write_state[]{ResourceStateType::kRtv, ResourceStateType::kUav, ResourceStateType::kCopyDst,};
+  const ResourceStateType read_state[]{ResourceStateType::kSrvPs, ResourceStateType::kSrvNonPs, ResourceStateType::kCopySrc,};
+  render_graph.render_pass_num = render_pass_num;
+  render_graph.render_pass_list = AllocateArraySystem<RenderPass>(render_pass_num);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    auto& render_pass = render_graph.render_pass_list[i];
+    const auto queue_rand = lcg.Next(8);
+    const uint32_t queue_index = (i == 0 || queue_rand < 5) ? 0 : ((queue_rand < 7) ? 1 : 2);
+    render_pass.enabled = true;
+    render_pass.index = i;
+    render_pass.command_queue_index = queue_index;
+    render_pass.buffer_num = 1 + lcg.Next(std::min(buffer_num, 4U));
+    render_pass.buffer_list = AllocateArraySystem<RenderPassBuffer>(render_pass.buffer_num);
+    for (uint32_t j = 0; j < render_pass.buffer_num; j++) {
+      const auto is_used = [&render_pass, j](const uint32_t buffer_index) {
+        for (uint32_t k = 0; k < j; k++) {
+          if (render_pass.buffer_list[k].buffer_index == buffer_index) { return true; }
+        }
+        return false;
+      };
+      auto buffer_index = lcg.Next(buffer_num);
+      while (is_used(buffer_index)) {
+        buffer_index = (buffer_index + 1) % buffer_num;
+      }
+      render_pass.buffer_list[j].buffer_index = buffer_index;
+      render_pass.buffer_list[j].state = (j == 0) ? write_state[queue_index] : read_state[queue_index];
+    }
+    if (render_graph.buffer_list[render_pass.buffer_list[0].buffer_index].pingpong) {
+      render_pass.flip_pingpong_num = 1;
+      render_pass.flip_pingpong_index_list = AllocateArraySystem<uint32_t>(1);
+      render_pass.flip_pingpong_index_list[0] = render_pass.buffer_list[0].buffer_index;
+    }
+    if (i > 0 && render_graph.render_pass_list[i - 1].command_queue_index != queue_index) {
+      render_graph.render_pass_list[i - 1].sends_signal = true;
+      render_pass.wait_pass_num = 1;
+      render_pass.signal_queue_index = AllocateArraySystem<uint32_t>(1);
+      render_pass.signal_queue_index[0] = render_graph.render_pass_list[i - 1].command_queue_index;
+      render_pass.signal_pass_index = AllocateArraySystem<uint32_t>(1);
+      render_pass.signal_pass_index[0] = i - 1;
+    }
+  }
+  return render_graph;
+}
+// 256x256 absolute-sized texture.
+inline auto CreateTestBufferConfig(const uint32_t buffer_index, const DXGI_FORMAT format, const DescriptorTypeFlag descriptor_type_flags) {
+  return BufferConfig{
+    .buffer_index = buffer_index,
+    .heap_type = D3D12_HEAP_TYPE_DEFAULT,
+    .dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+    .size_type = BufferSizeRelativeness::kAbsolute,
+    .width = 256.0f,
+    .height = 256.0f,
+    .depth_or_array_size = 1,
+    .miplevels = 1,
+    .format = format,
+    .sample_count = 1,
+    .descriptor_type_flags = descriptor_type_flags,
+  };
+}
+// passes and buffers are allocated in frame memory, passes are left to SetTestRenderPass().
+inline auto CreateTestRenderGraph(const uint32_t command_queue_num, const uint32_t render_pass_num, const uint32_t buffer_num) {
+  RenderGraphConfig render_graph{};
+  render_graph.frame_buffer_num = 2;
+  render_graph.command_queue_num = command_queue_num;
+  render_graph.render_pass_num = render_pass_num;
+  render_graph.render_pass_list = AllocateArrayFrame<RenderPass>(render_pass_num);
+  render_graph.buffer_num = buffer_num;
+  render_graph.buffer_list = AllocateArrayFrame<BufferConfig>(buffer_num);
+  for (uint32_t i = 0; i < buffer_num; i++) {
+    render_graph.buffer_list[i] = CreateTestBufferConfig(i, DXGI_FORMAT_R8G8B8A8_UNORM, kDescriptorTypeFlagSrv | kDescriptorTypeFlagRtv);
+  }
+  return render_graph;
+}
+inline void SetTestRenderPass(const uint32_t command_queue_index, const std::initializer_list<RenderPassBuffer>& buffer_list, const std::initializer_list<uint32_t>& wait_pass_list, RenderPass* render_pass) {
+  render_pass->enabled = true;
+  render_pass->command_queue_index = command_queue_index;
+  render_pass->buffer_num = static_cast<uint32_t>(buffer_list.size());
+  render_pass->buffer_list = AllocateArrayFrame<RenderPassBuffer>(render_pass->buffer_num);
+  std::copy(buffer_list.begin(), buffer_list.end(), render_pass->buffer_list);
+  render_pass->wait_pass_num = static_cast<uint32_t>(wait_pass_list.size());
+  render_pass->signal_pass_index = AllocateArrayFrame<uint32_t>(render_pass->wait_pass_num);
+  std::copy(wait_pass_list.begin(), wait_pass_list.end(), render_pass->signal_pass_index);
+}
+// half of the buffers are declared in "buffer", the rest are declared implicitly by pass buffer lists.
+inline auto CreateSyntheticRenderGraphJson(const uint32_t pass_num, const uint32_t buffer_num) {
+  auto buffer_name = [](const uint32_t index) { return "buffer" + std::to_string(index); };
+  auto pass_name = [](const uint32_t index) { return "pass" + std::to_string(index); };
+  nlohmann::json j;
+  j["frame_buffer_num"] = 2;
+  j["primarybuffer_format"] = "R8G8B8A8_UNORM";
+  j["window"] = {{"title", "synthetic"}, {"width", 1920}, {"height", 1080}};
+  j["command_queue"] = nlohmann::json::array();
+  j["command_queue"].push_back({{"name", "queue_graphics"}, {"type", "3d"}, {"priority", "normal"}, {"command_list_num", 1}});
+  j["command_queue"].push_back({{"name", "queue_compute"}, {"type", "compute"}, {"priority", "normal"}, {"command_list_num", 1}});
+  j["swapchain"] = {{"command_queue", "queue_graphics"}, {"format", "R8G8B8A8_UNORM"}};
+  j["sampler"] = nlohmann::json::array();
+  j["sampler"].push_back({{"name", "point"}});
+  j["sampler"].push_back({{"name", "bilinear"}, {"filter_min", "linear"}, {"filter_mag", "linear"}});
+  j["buffer"] = nlohmann::json::array();
+  for (uint32_t i = 0; i < buffer_num / 2; i++) {
+    j["buffer"].push_back({{"name", buffer_name(i)}, {"format", "R16G16B16A16_FLOAT"}});
+  }
+  j["render_pass"] = nlohmann::json::array();
+  for (uint32_t i = 0; i < pass_num; i++) {
+    nlohmann::json pass{{"name", pass_name(i)}, {"type", "synthetic"}, {"command_queue", (i % 8 == 7) ? "queue_compute" : "queue_graphics"}};
+    pass["buffer_list"] = nlohmann::json::array();
+    pass["buffer_list"].push_back({{"name", buffer_name((i * 7 + 1) % buffer_num)}, {"state", "srv_non_ps"}});
+    pass["buffer_list"].push_back({{"name", buffer_name((i * 13 + 3) % buffer_num)}, {"state", "srv_non_ps"}});
+    pass["buffer_list"].push_back({{"name", buffer_name(i % buffer_num)}, {"state", "uav"}});
+    pass["sampler"] = nlohmann::json::array({(i % 2 == 0) ? "point" : "bilinear"});
+    if (i > 0) {
+      pass["wait_pass"] = nlohmann::json::array({pass_name(i - 1)});
+    }
+    j["render_pass"].push_back(std::move(pass));
+  }
+  return j;
+}
+// the synthetic graph uses a single "synthetic" material instead of material.json.
+inline auto ParseSyntheticRenderGraphJson(const nlohmann::json& j, RenderGraphConfig* graph) {
+  StrHash material_hash_list[] = {SID("synthetic")};
+  const DXGI_FORMAT rtv_format[] = {DXGI_FORMAT_R8G8B8A8_UNORM};
+  const DXGI_FORMAT* rtv_format_list[] = {rtv_format};
+  const DXGI_FORMAT dsv_format[] = {DXGI_FORMAT_D32_FLOAT};
+  return ParseRenderGraphJson(j, 1, material_hash_list, rtv_format_list, dsv_format, graph);
+}
+// forward.json with the passes replaced, queue 0: graphics, 1: compute, 2: copy. buffers other than the swapchain are declared as used.
+struct TestRenderPass {
+  const char* name{};
+  uint32_t command_queue_index{};
+  std::initializer_list<std::pair<const char*, const char*>> buffer_list; // name, state
+};
+inline auto CreateTestRenderGraphJson(const std::initializer_list<TestRenderPass>& pass_list) {
+  auto j = LoadTestJson("forward.json");
+  const char* const queue_name[] = {"queue_graphics", "queue_compute", "queue_copy",};
+  j["buffer"] = nlohmann::json::array();
+  j.erase("cbuffer");
+  j["render_pass"] = nlohmann::json::array();
+  for (const auto& pass : pass_list) {
+    nlohmann::json dst_pass{{"name", pass.name}, {"type", "test"}, {"command_queue", queue_name[pass.command_queue_index]}};
+    if (pass.buffer_list.size() > 0) {
+      dst_pass["buffer_list"] = nlohmann::json::array();
+      for (const auto& [name, state] : pass.buffer_list) {
+        dst_pass["buffer_list"].push_back({{"name", name}, {"state", state}});
+        if (std::string_view(name) == "swapchain") {
+          dst_pass["material"] = "oetf"; // for the swapchain rtv format.
+        }
+        const auto& buffer_list = j["buffer"];
+        if (std::string_view(name) == "swapchain" || std::any_of(buffer_list.begin(), buffer_list.end(), [name](const auto& buffer) { return GetStringView(buffer, "name") == name; })) { continue; }
+        j["buffer"].push_back({{"name", name}, {"format", "R8G8B8A8_UNORM"}});
+      }
+    }
+    j["render_pass"].push_back(std::move(dst_pass));
+  }
+  return j;
+}
+// barrier plans as returned by ConfigureBarrierTransitions(), listed per pass and timing.
+struct TestBarrier {
+  uint32_t pass{};
+  uint32_t timing{};
+  uint32_t buffer_allocation_index{};
+  D3D12_RESOURCE_STATES state_before{};
+  D3D12_RESOURCE_STATES state_after{};
+  D3D12_RESOURCE_BARRIER_FLAGS flag{D3D12_RESOURCE_BARRIER_FLAG_NONE};
+};
+inline auto CreateTestBarrierConfigList(const uint32_t render_pass_num, const uint32_t barrier_num, const TestBarrier* barriers) {
+  auto barrier_config_list = AllocateArrayFrame<ArrayOf<BarrierConfig>*>(render_pass_num);
+  for (uint32_t i = 0; i < render_pass_num; i++) {
+    barrier_config_list[i] = AllocateArrayFrame<ArrayOf<BarrierConfig>>(kBarrierExecutionTimingNum);
+    for (uint32_t j = 0; j < kBarrierExecutionTimingNum; j++) {
+      barrier_config_list[i][j].array = AllocateArrayFrame<BarrierConfig>(barrier_num);
+      barrier_config_list[i][j].size = 0;
+    }
+  }
+  for (uint32_t i = 0; i < barrier_num; i++) {
+    auto& dst_barrier_list = barrier_config_list[barriers[i].pass][barriers[i].timing];
+    dst_barrier_list.array[dst_barrier_list.size] = {
+      .buffer_allocation_index = barriers[i].buffer_allocation_index,
+      .type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+      .flag = barriers[i].flag,
+      .state_before = barriers[i].state_before,
+      .state_after = barriers[i].state_after,
+    };
+    dst_barrier_list.size++;
+  }
+  return barrier_config_list;
+}
+} // namespace illuminate
+#endif
@@ -2,6 +2,7 @@
 #include "../d3d12_header_common.h"
 #include "d3d12_render_pass_mesh_transform.h"
 #include "d3d12_render_pass_util.h"
+#include "illuminate/util/string_table.h"
 namespace illuminate {
 namespace {
 struct Param {
@@ -72,7 +73,7 @@ void RenderPassMeshTransform::Render(RenderPassFuncArgsRenderCommon* args_common
   uint32_t vertex_buffer_type_num = 0;
   uint32_t vertex_buffer_type_index[kVertexBufferTypeNum]{};
   D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view[kVertexBufferTypeNum]{};
-  uint32_t prev_variation_hash = 0;
+  StrHash prev_variation_hash = 0;
   for (uint32_t i = 0; i < scene_data->model_num; i++) {
     if (scene_data->model_instance_num[i] == 0) { continue; }
     for (uint32_t j = 0; j < scene_data->model_submesh_num[i]; j++) {
@@ -90,7 +91,7 @@ void RenderPassMeshTransform::Render(RenderPassFuncArgsRenderCommon* args_common
         auto variation_index = FindMaterialVariationIndex(*args_common->material_list, material_id, variation_hash);
         prev_variation_hash = variation_hash;
         if (variation_index == MaterialList::kInvalidIndex) {
-          logwarn("material variation not found. pass:{} material:{} submesh:{} hash:{}", GetRenderPass(args_common, args_per_pass).name, material_id, submesh_index, variation_hash);
+          logwarn("material variation not found. pass:{} material:{} submesh:{} hash:{}", GetInternedString(GetRenderPass(args_common, args_per_pass).name), material_id, submesh_index, variation_hash);
           variation_index = 0;
         }
         logtrace("mesh transform material variation.mesh:{}-{} variation:{}", i, j, variation_index);
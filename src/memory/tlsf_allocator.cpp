@@ -0,0 +1,552 @@
+#include "illuminate/memory/tlsf_allocator.h"
+#include <bit>
+#include <cassert>
+namespace illuminate {
+// physical layout follows the reference implementation:
+// prev_physical_block lives in the last bytes of the previous block and is valid only while the previous block is free.
+// size holds the payload size with the free flags in its lower bits, next_free and prev_free overlap the payload.
+namespace tlsf_internal {
+struct BlockHeader {
+  BlockHeader* prev_physical_block;
+  size_t size;
+  BlockHeader* next_free;
+  BlockHeader* prev_free;
+};
+} // namespace tlsf_internal
+namespace {
+using tlsf_internal::BlockHeader;
+static const size_t kBlockFlagFree = 1;
+static const size_t kBlockFlagPrevFree = 2;
+static const size_t kBlockFlagMask = kBlockFlagFree | kBlockFlagPrevFree;
+static const size_t kBlockHeaderOverhead = sizeof(size_t);
+static const size_t kBlockStartOffset = offsetof(BlockHeader, size) + sizeof(size_t);
+static const size_t kBlockSizeMin = sizeof(BlockHeader) - sizeof(BlockHeader*);
+static const size_t kBlockSizeMax = size_t{1} << TlsfAllocator::kFlIndexMax;
+static_assert(kBlockStartOffset % TlsfAllocator::kAlignmentSize == 0);
+constexpr auto GetBlockSize(const BlockHeader* block) { return block->size & ~kBlockFlagMask; }
+constexpr void SetBlockSize(BlockHeader* block, const size_t size) { block->size = size | (block->size & kBlockFlagMask); }
+constexpr auto IsLastBlock(const BlockHeader* block) { return GetBlockSize(block) == 0; }
+constexpr auto IsFree(const BlockHeader* block) { return (block->size & kBlockFlagFree) != 0; }
+constexpr void SetFree(BlockHeader* block) { block->size |= kBlockFlagFree; }
+constexpr void SetUsed(BlockHeader* block) { block->size &= ~kBlockFlagFree; }
+constexpr auto IsPrevFree(const BlockHeader* block) { return (block->size & kBlockFlagPrevFree) != 0; }
+constexpr void SetPrevFree(BlockHeader* block) { block->size |= kBlockFlagPrevFree; }
+constexpr void SetPrevUsed(BlockHeader* block) { block->size &= ~kBlockFlagPrevFree; }
+auto GetBlockFromPtr(const void* ptr) { return reinterpret_cast<BlockHeader*>(reinterpret_cast<std::uintptr_t>(ptr) - kBlockStartOffset); }
+auto GetPtrFromBlock(const BlockHeader* block) { return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(block) + kBlockStartOffset); }
+auto OffsetToBlock(const void* ptr, const size_t offset) { return reinterpret_cast<BlockHeader*>(reinterpret_cast<std::uintptr_t>(ptr) + offset); }
+auto GetNextBlock(const BlockHeader* block) {
+  assert(!IsLastBlock(block));
+  return OffsetToBlock(GetPtrFromBlock(block), GetBlockSize(block) - kBlockHeaderOverhead);
+}
+auto LinkNextBlock(BlockHeader* block) {
+  auto next = GetNextBlock(block);
+  next->prev_physical_block = block;
+  return next;
+}
+void MarkAsFree(BlockHeader* block) {
+  auto next = LinkNextBlock(block);
+  SetPrevFree(next);
+  SetFree(block);
+}
+void MarkAsUsed(BlockHeader* block) {
+  SetPrevUsed(GetNextBlock(block));
+  SetUsed(block);
+}
+constexpr auto CanSplit(const BlockHeader* block, const size_t size) { return GetBlockSize(block) >= sizeof(BlockHeader) + size; }
+auto Split(BlockHeader* block, const size_t size) {
+  auto remaining = OffsetToBlock(GetPtrFromBlock(block), size - kBlockHeaderOverhead);
+  const auto remaining_size = GetBlockSize(block) - (size + kBlockHeaderOverhead);
+  assert(remaining_size >= kBlockSizeMin);
+  SetBlockSize(remaining, remaining_size);
+  SetBlockSize(block, size);
+  MarkAsFree(remaining);
+  return remaining;
+}
+auto Absorb(BlockHeader* prev, BlockHeader* block) {
+  prev->size += GetBlockSize(block) + kBlockHeaderOverhead;
+  LinkNextBlock(prev);
+  return prev;
+}
+// zero sized requests get a minimum block so that a unique pointer is returned as in malloc.
+auto AdjustRequestSize(const size_t size, const size_t alignment) {
+  const auto aligned = AlignAddress(size, alignment);
+  if (aligned >= kBlockSizeMax) { return size_t{0}; }
+  return aligned < kBlockSizeMin ? kBlockSizeMin : aligned;
+}
+void MappingInsert(const size_t size, uint32_t* fl, uint32_t* sl) {
+  if (size < TlsfAllocator::kSmallBlockSize) {
+    *fl = 0;
+    *sl = static_cast<uint32_t>(size / (TlsfAllocator::kSmallBlockSize / TlsfAllocator::kSlIndexCount));
+    return;
+  }
+  const auto fl_bit = static_cast<uint32_t>(std::bit_width(size) - 1);
+  *sl = static_cast<uint32_t>(size >> (fl_bit - TlsfAllocator::kSlIndexCountLog2)) ^ TlsfAllocator::kSlIndexCount;
+  *fl = fl_bit - (TlsfAllocator::kFlIndexShift - 1);
+}
+// rounds up to the next second level list so that any block found there is large enough.
+void MappingSearch(const size_t size, uint32_t* fl, uint32_t* sl) {
+  auto rounded_size = size;
+  if (size >= TlsfAllocator::kSmallBlockSize) {
+    rounded_size += (size_t{1} << (std::bit_width(size) - 1 - TlsfAllocator::kSlIndexCountLog2)) - 1;
+  }
+  MappingInsert(rounded_size, fl, sl);
+}
+} // namespace
+TlsfAllocator::TlsfAllocator(std::byte* buffer, const size_t size_in_byte)
+    : buffer_(buffer)
+    , size_in_byte_(size_in_byte)
+{
+  Reset();
+}
+void TlsfAllocator::Reset() {
+  fl_bitmap_ = 0;
+  for (uint32_t i = 0; i < kFlIndexCount; i++) {
+    sl_bitmap_[i] = 0;
+    for (uint32_t j = 0; j < kSlIndexCount; j++) {
+      free_list_[i][j] = nullptr;
+    }
+  }
+  used_size_in_byte_ = 0;
+  const auto buffer_head = AlignAddress(reinterpret_cast<std::uintptr_t>(buffer_), static_cast<std::uintptr_t>(kAlignmentSize));
+  const auto buffer_tail = reinterpret_cast<std::uintptr_t>(buffer_) + size_in_byte_;
+  if (buffer_ == nullptr || buffer_tail < buffer_head + kBlockHeaderOverhead * 2 + kBlockSizeMin) {
+    pool_size_in_byte_ = 0;
+    return;
+  }
+  pool_size_in_byte_ = AlignAddressWithoutOffset(static_cast<size_t>(buffer_tail - buffer_head - kBlockHeaderOverhead * 2), kAlignmentSize);
+  if (pool_size_in_byte_ >= kBlockSizeMax) {
+    pool_size_in_byte_ = kBlockSizeMax - kAlignmentSize;
+  }
+  // the first block starts before the buffer so that its size field is at the buffer head. its prev_physical_block is never accessed.
+  auto block = reinterpret_cast<BlockHeader*>(buffer_head - kBlockHeaderOverhead);
+  block->size = pool_size_in_byte_;
+  SetFree(block);
+  SetPrevUsed(block);
+  InsertFreeBlock(block);
+  // zero sized sentinel block terminates the physical chain.
+  auto sentinel = LinkNextBlock(block);
+  sentinel->size = 0;
+  SetUsed(sentinel);
+  SetPrevFree(sentinel);
+}
+bool TlsfAllocator::Grow(const size_t size_in_byte) {
+  if (size_in_byte <= size_in_byte_) { return true; }
+  if (pool_size_in_byte_ == 0) {
+    size_in_byte_ = size_in_byte;
+    Reset();
+    return pool_size_in_byte_ > 0;
+  }
+  const auto buffer_head = AlignAddress(reinterpret_cast<std::uintptr_t>(buffer_), static_cast<std::uintptr_t>(kAlignmentSize));
+  auto new_pool_size = AlignAddressWithoutOffset(static_cast<size_t>(reinterpret_cast<std::uintptr_t>(buffer_) + size_in_byte - buffer_head - kBlockHeaderOverhead * 2), kAlignmentSize);
+  if (new_pool_size >= kBlockSizeMax) {
+    new_pool_size = kBlockSizeMax - kAlignmentSize;
+  }
+  if (new_pool_size < pool_size_in_byte_ + kBlockSizeMin + kBlockHeaderOverhead) { return false; }
+  // the current sentinel becomes a free block covering the added range, followed by a new sentinel.
+  const auto added_size = new_pool_size - pool_size_in_byte_;
+  auto block = reinterpret_cast<BlockHeader*>(buffer_head + pool_size_in_byte_);
+  auto sentinel = reinterpret_cast<BlockHeader*>(buffer_head + new_pool_size);
+  sentinel->size = 0;
+  SetUsed(sentinel);
+  SetBlockSize(block, added_size - kBlockHeaderOverhead);
+  MarkAsFree(block);
+  block = MergePrev(block);
+  InsertFreeBlock(block);
+  size_in_byte_ = size_in_byte;
+  pool_size_in_byte_ = new_pool_size;
+  return true;
+}
+void* TlsfAllocator::Allocate(size_t bytes, size_t alignment_in_bytes) {
+  const auto adjusted_size = AdjustRequestSize(bytes, kAlignmentSize);
+  if (adjusted_size == 0) { return nullptr; }
+  // over-allocate for alignments beyond the default so that the leading gap can be returned as a free block.
+  const auto gap_minimum = sizeof(BlockHeader);
+  const auto aligned_size = (alignment_in_bytes > kAlignmentSize) ? AdjustRequestSize(adjusted_size + alignment_in_bytes + gap_minimum, kAlignmentSize) : adjusted_size;
+  if (aligned_size == 0) { return nullptr; }
+  auto block = LocateFreeBlock(aligned_size);
+  if (block == nullptr) { return nullptr; }
+  if (alignment_in_bytes > kAlignmentSize) {
+    const auto ptr = reinterpret_cast<std::uintptr_t>(GetPtrFromBlock(block));
+    auto aligned = AlignAddress(ptr, static_cast<std::uintptr_t>(alignment_in_bytes));
+    if (aligned != ptr && aligned - ptr < gap_minimum) {
+      const auto gap_remain = gap_minimum - (aligned - ptr);
+      aligned = AlignAddress(aligned + (gap_remain > alignment_in_bytes ? gap_remain : alignment_in_bytes), static_cast<std::uintptr_t>(alignment_in_bytes));
+    }
+    if (aligned != ptr) {
+      block = TrimFreeLeading(block, aligned - ptr);
+    }
+  }
+  TrimFree(block, adjusted_size);
+  MarkAsUsed(block);
+  used_size_in_byte_ += GetBlockSize(block) + kBlockHeaderOverhead;
+  return GetPtrFromBlock(block);
+}
+void TlsfAllocator::Free(void* ptr, [[maybe_unused]] size_t bytes, [[maybe_unused]] size_t alignment_in_bytes) {
+  if (ptr == nullptr) { return; }
+  auto block = GetBlockFromPtr(ptr);
+  assert(!IsFree(block) && "block already freed");
+  used_size_in_byte_ -= GetBlockSize(block) + kBlockHeaderOverhead;
+  MarkAsFree(block);
+  block = MergePrev(block);
+  block = MergeNext(block);
+  InsertFreeBlock(block);
+}
+size_t TlsfAllocator::GetLargestFreeBlockSizeInBytes() const {
+  if (fl_bitmap_ == 0) { return 0; }
+  const auto fl = static_cast<uint32_t>(std::bit_width(fl_bitmap_) - 1);
+  const auto sl = static_cast<uint32_t>(std::bit_width(sl_bitmap_[fl]) - 1);
+  size_t largest = 0;
+  for (auto block = free_list_[fl][sl]; block != nullptr; block = block->next_free) {
+    if (GetBlockSize(block) > largest) {
+      largest = GetBlockSize(block);
+    }
+  }
+  return largest;
+}
+size_t TlsfAllocator::GetAllocationSizeInBytes(const void* ptr) {
+  return GetBlockSize(GetBlockFromPtr(ptr));
+}
+void TlsfAllocator::InsertFreeBlock(BlockHeader* block) {
+  uint32_t fl = 0, sl = 0;
+  MappingInsert(GetBlockSize(block), &fl, &sl);
+  auto current = free_list_[fl][sl];
+  block->next_free = current;
+  block->prev_free = nullptr;
+  if (current != nullptr) {
+    current->prev_free = block;
+  }
+  free_list_[fl][sl] = block;
+  fl_bitmap_ |= 1U << fl;
+  sl_bitmap_[fl] |= 1U << sl;
+}
+void TlsfAllocator::RemoveFreeBlock(BlockHeader* block) {
+  uint32_t fl = 0, sl = 0;
+  MappingInsert(GetBlockSize(block), &fl, &sl);
+  auto prev = block->prev_free;
+  auto next = block->next_free;
+  if (next != nullptr) {
+    next->prev_free = prev;
+  }
+  if (prev != nullptr) {
+    prev->next_free = next;
+    return;
+  }
+  free_list_[fl][sl] = next;
+  if (next == nullptr) {
+    sl_bitmap_[fl] &= ~(1U << sl);
+    if (sl_bitmap_[fl] == 0) {
+      fl_bitmap_ &= ~(1U << fl);
+    }
+  }
+}
+TlsfAllocator::BlockHeader* TlsfAllocator::LocateFreeBlock(const size_t size) {
+  uint32_t fl = 0, sl = 0;
+  MappingSearch(size, &fl, &sl);
+  if (fl >= kFlIndexCount) { return nullptr; }
+  auto sl_map = sl_bitmap_[fl] & (~0U << sl);
+  if (sl_map == 0) {
+    const auto fl_map = (fl + 1 < 32) ? (fl_bitmap_ & (~0U << (fl + 1))) : 0U;
+    if (fl_map == 0) { return nullptr; }
+    fl = static_cast<uint32_t>(std::countr_zero(fl_map));
+    sl_map = sl_bitmap_[fl];
+  }
+  sl = static_cast<uint32_t>(std::countr_zero(sl_map));
+  auto block = free_list_[fl][sl];
+  assert(block != nullptr && GetBlockSize(block) >= size);
+  RemoveFreeBlock(block);
+  return block;
+}
+TlsfAllocator::BlockHeader* TlsfAllocator::MergePrev(BlockHeader* block) {
+  if (!IsPrevFree(block)) { return block; }
+  auto prev = block->prev_physical_block;
+  assert(IsFree(prev));
+  RemoveFreeBlock(prev);
+  return Absorb(prev, block);
+}
+TlsfAllocator::BlockHeader* TlsfAllocator::MergeNext(BlockHeader* block) {
+  auto next = GetNextBlock(block);
+  if (!IsFree(next)) { return block; }
+  assert(!IsLastBlock(next));
+  RemoveFreeBlock(next);
+  return Absorb(block, next);
+}
+void TlsfAllocator::TrimFree(BlockHeader* block, const size_t size) {
+  if (!CanSplit(block, size)) { return; }
+  auto remaining = Split(block, size);
+  LinkNextBlock(block);
+  SetPrevFree(remaining);
+  InsertFreeBlock(remaining);
+}
+TlsfAllocator::BlockHeader* TlsfAllocator::TrimFreeLeading(BlockHeader* block, const size_t size) {
+  if (!CanSplit(block, size)) { return block; }
+  auto remaining = Split(block, size - kBlockHeaderOverhead);
+  SetPrevFree(remaining);
+  LinkNextBlock(block);
+  InsertFreeBlock(block);
+  return remaining;
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "illuminate/core/strid.h"
+#include "spdlog/spdlog.h"
+#include "../util/test_util.h"
+TEST_CASE("TlsfAllocator") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t size_in_byte = 64 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(size_in_byte);
+  TlsfAllocator allocator(buffer.get(), size_in_byte);
+  const auto pool_size = allocator.GetFreeSizeInBytes();
+  CHECK_GT(pool_size, size_in_byte - 64);
+  CHECK_LE(pool_size, size_in_byte);
+  CHECK_EQ(allocator.GetLargestFreeBlockSizeInBytes(), pool_size);
+  auto zero_sized = allocator.Allocate(0);
+  CHECK_NE(zero_sized, nullptr);
+  allocator.Free(zero_sized);
+  CHECK_EQ(allocator.GetUsedSizeInBytes(), 0);
+  CHECK_EQ(allocator.Allocate(size_in_byte * 2), nullptr);
+  SUBCASE("allocate and free") {
+    auto a = static_cast<uint32_t*>(allocator.Allocate(sizeof(uint32_t) * 4));
+    auto b = static_cast<uint32_t*>(allocator.Allocate(sizeof(uint32_t) * 100));
+    auto c = static_cast<uint32_t*>(allocator.Allocate(sizeof(uint32_t) * 4));
+    CHECK_NE(a, nullptr);
+    CHECK_NE(b, nullptr);
+    CHECK_NE(c, nullptr);
+    CHECK_GE(TlsfAllocator::GetAllocationSizeInBytes(b), sizeof(uint32_t) * 100);
+    std::fill(a, a + 4, 1);
+    std::fill(b, b + 100, 2);
+    std::fill(c, c + 4, 3);
+    CHECK_EQ(std::count(a, a + 4, 1), 4);
+    CHECK_EQ(std::count(b, b + 100, 2), 100);
+    CHECK_EQ(std::count(c, c + 4, 3), 4);
+    CHECK_GT(allocator.GetUsedSizeInBytes(), sizeof(uint32_t) * 108);
+    // freed block in the middle is reused by an allocation of the same size.
+    allocator.Free(b);
+    auto d = allocator.Allocate(sizeof(uint32_t) * 100);
+    CHECK_EQ(d, b);
+    allocator.Free(a);
+    allocator.Free(c);
+    allocator.Free(d);
+    // all blocks are merged back into a single free block.
+    CHECK_EQ(allocator.GetUsedSizeInBytes(), 0);
+    CHECK_EQ(allocator.GetFreeSizeInBytes(), pool_size);
+    CHECK_EQ(allocator.GetLargestFreeBlockSizeInBytes(), pool_size);
+  }
+  SUBCASE("alignment") {
+    std::vector<void*> ptr_list;
+    for (const size_t alignment : {8U, 16U, 64U, 256U, 4096U}) {
+      for (const size_t size : {1U, 24U, 100U, 1000U}) {
+        CAPTURE(alignment);
+        CAPTURE(size);
+        auto ptr = allocator.Allocate(size, alignment);
+        CHECK_NE(ptr, nullptr);
+        CHECK_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0);
+        std::fill(static_cast<std::byte*>(ptr), static_cast<std::byte*>(ptr) + size, std::byte{0xCD});
+        ptr_list.push_back(ptr);
+      }
+    }
+    for (auto ptr : ptr_list) {
+      allocator.Free(ptr);
+    }
+    CHECK_EQ(allocator.GetUsedSizeInBytes(), 0);
+    CHECK_EQ(allocator.GetLargestFreeBlockSizeInBytes(), pool_size);
+  }
+  SUBCASE("exhaustion and reset") {
+    std::vector<void*> ptr_list;
+    while (auto ptr = allocator.Allocate(1000)) {
+      ptr_list.push_back(ptr);
+    }
+    CHECK_GT(ptr_list.size(), size_in_byte / 1024 - 2);
+    CHECK_LT(allocator.GetFreeSizeInBytes(), 1024 + 64);
+    // freeing every other block leaves fragmented holes that cannot hold a larger request.
+    for (size_t i = 0; i < ptr_list.size(); i += 2) {
+      allocator.Free(ptr_list[i]);
+    }
+    CHECK_EQ(allocator.Allocate(2048), nullptr);
+    // searches round up to the next second level list, so a hole is found for requests a list smaller than itself.
+    CHECK_NE(allocator.Allocate(900), nullptr);
+    allocator.Reset();
+    CHECK_EQ(allocator.GetUsedSizeInBytes(), 0);
+    CHECK_NE(allocator.Allocate(size_in_byte / 2), nullptr);
+  }
+  SUBCASE("random allocations") {
+    struct Allocation {
+      uint8_t* ptr{nullptr};
+      uint32_t size{0};
+    };
+    std::vector<Allocation> allocation_list(256);
+    Lcg lcg(12345);
+    for (uint32_t i = 0; i < 20000; i++) {
+      const auto seed = lcg.Next();
+      auto& allocation = allocation_list[(seed >> 8) % allocation_list.size()];
+      if (allocation.ptr != nullptr) {
+        CHECK_EQ(std::count(allocation.ptr, allocation.ptr + allocation.size, static_cast<uint8_t>(allocation.size)), allocation.size);
+        allocator.Free(allocation.ptr);
+        allocation = {};
+        continue;
+      }
+      const auto size = 1 + (seed >> 20) % 512;
+      allocation.ptr = static_cast<uint8_t*>(allocator.Allocate(size, (seed & 1) ? 8 : 32));
+      if (allocation.ptr == nullptr) { continue; }
+      allocation.size = size;
+      std::fill(allocation.ptr, allocation.ptr + size, static_cast<uint8_t>(size));
+    }
+    for (auto& allocation : allocation_list) {
+      allocator.Free(allocation.ptr);
+    }
+    CHECK_EQ(allocator.GetUsedSizeInBytes(), 0);
+    CHECK_EQ(allocator.GetLargestFreeBlockSizeInBytes(), pool_size);
+  }
+}
+TEST_CASE("TlsfAllocator grow") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t size_in_byte = 64 * 1024;
+  const uint32_t initial_size_in_byte = 4 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(size_in_byte);
+  TlsfAllocator allocator(buffer.get(), initial_size_in_byte);
+  const auto initial_pool_size = allocator.GetFreeSizeInBytes();
+  CHECK_LE(initial_pool_size, initial_size_in_byte);
+  auto a = static_cast<uint32_t*>(allocator.Allocate(1024));
+  auto b = static_cast<uint32_t*>(allocator.Allocate(1024));
+  CHECK_NE(a, nullptr);
+  CHECK_NE(b, nullptr);
+  std::fill(a, a + 256, 1);
+  std::fill(b, b + 256, 2);
+  CHECK_EQ(allocator.Allocate(8 * 1024), nullptr);
+  CHECK_UNARY(allocator.Grow(initial_size_in_byte * 4));
+  CHECK_EQ(allocator.GetBufferSizeInByte(), initial_size_in_byte * 4);
+  CHECK_GT(allocator.GetFreeSizeInBytes(), initial_pool_size);
+  // the free tail of the previous pool is merged with the added range.
+  auto c = static_cast<uint32_t*>(allocator.Allocate(8 * 1024));
+  CHECK_NE(c, nullptr);
+  CHECK_LT(reinterpret_cast<std::byte*>(c), buffer.get() + initial_size_in_byte);
+  std::fill(c, c + 2048, 3);
+  CHECK_EQ(std::count(a, a + 256, 1), 256);
+  CHECK_EQ(std::count(b, b + 256, 2), 256);
+  // growing with the tail in use appends a separate free block.
+  while (allocator.Allocate(64) != nullptr) {}
+  CHECK_UNARY(allocator.Grow(size_in_byte));
+  auto d = static_cast<uint32_t*>(allocator.Allocate(32 * 1024));
+  CHECK_NE(d, nullptr);
+  CHECK_GT(reinterpret_cast<std::byte*>(d), reinterpret_cast<std::byte*>(c + 2048));
+  CHECK_LE(reinterpret_cast<std::byte*>(d + 8 * 1024), buffer.get() + size_in_byte);
+  std::fill(d, d + 8 * 1024, 4);
+  CHECK_EQ(std::count(c, c + 2048, 3), 2048);
+  // shrinking is not supported and reset covers the whole grown range.
+  CHECK_UNARY(allocator.Grow(initial_size_in_byte));
+  CHECK_EQ(allocator.GetBufferSizeInByte(), size_in_byte);
+  allocator.Reset();
+  CHECK_NE(allocator.Allocate(size_in_byte / 2), nullptr);
+}
+namespace {
+// approximate mesh/texture counts of glTF-Sample-Models, used to replay scene data allocations as done in ParseTinyGltfScene (d3d12_scene.cpp).
+// d3d12 types are replaced by their sizes: kVertexBufferTypeNum, kSceneDescriptorHandleTypeNum and D3D12_INDEX/VERTEX_BUFFER_VIEW.
+const uint32_t kGltfVertexBufferTypeNum = 4;
+const uint32_t kGltfSceneDescriptorHandleTypeNum = 5;
+const size_t kGltfBufferViewSizeInBytes = 16;
+struct GltfModelShape {
+  const char* name;
+  uint32_t model_num;
+  uint32_t submesh_num_per_model;
+  uint32_t texture_num;
+};
+static const GltfModelShape gltf_model_shapes[] = {
+  {"Box", 1, 1, 0},
+  {"BoxTextured", 1, 1, 1},
+  {"Duck", 1, 1, 1},
+  {"Avocado", 1, 1, 3},
+  {"DamagedHelmet", 1, 1, 5},
+  {"SciFiHelmet", 1, 1, 4},
+  {"FlightHelmet", 6, 1, 15},
+  {"BrainStem", 59, 1, 0},
+  {"Buggy", 148, 1, 0},
+  {"Sponza", 1, 103, 69},
+  {"VC", 167, 2, 22},
+};
+struct SceneAllocationList {
+  std::vector<void*> ptr_list;
+  size_t bytes{0};
+};
+template <typename A>
+auto AllocateGltfSceneArrays(const GltfModelShape& shape, A* allocator) {
+  using namespace illuminate; // NOLINT
+  SceneAllocationList list;
+  const auto allocate = [&](const size_t bytes) {
+    list.ptr_list.push_back(allocator->Allocate(bytes, kDefaultAlignmentSize));
+    list.bytes += bytes;
+  };
+  const auto mesh_num = shape.model_num * shape.submesh_num_per_model;
+  const auto resource_num = mesh_num * (kGltfVertexBufferTypeNum + 1) + shape.texture_num + kGltfSceneDescriptorHandleTypeNum - 2;
+  allocate(sizeof(uint32_t) * shape.model_num);
+  allocate(sizeof(uint32_t) * shape.model_num);
+  allocate(sizeof(uint32_t*) * shape.model_num);
+  allocate(sizeof(uint32_t) * shape.model_num);
+  for (uint32_t i = 0; i < shape.model_num; i++) {
+    allocate(sizeof(uint32_t) * shape.submesh_num_per_model);
+  }
+  allocate(sizeof(void*) * resource_num); // ID3D12Resource*
+  allocate(sizeof(void*) * resource_num); // D3D12MA::Allocation*
+  allocate(sizeof(uint32_t) * mesh_num);
+  allocate(kGltfBufferViewSizeInBytes * mesh_num);
+  allocate(kGltfBufferViewSizeInBytes * mesh_num * kGltfVertexBufferTypeNum);
+  for (uint32_t i = 0; i < kGltfVertexBufferTypeNum; i++) {
+    allocate(sizeof(uint32_t) * mesh_num);
+  }
+  allocate(sizeof(StrHash) * mesh_num);
+  allocate(sizeof(uint32_t) * mesh_num);
+  return list;
+}
+} // namespace
+TEST_CASE("TlsfAllocator scene fragmentation benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const size_t heap_size_in_bytes = 16 * 1024 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(heap_size_in_bytes);
+  TlsfAllocator allocator(buffer.get(), heap_size_in_bytes);
+  // keep up to resident_model_num models loaded, unloading a random one before each load.
+  const uint32_t resident_model_num = 8;
+  const uint32_t load_num = 100000;
+  const auto model_shape_num = static_cast<uint32_t>(std::size(gltf_model_shapes));
+  std::vector<SceneAllocationList> resident_list(resident_model_num);
+  Lcg lcg(1);
+  size_t linear_bytes = 0;
+  size_t live_bytes = 0;
+  size_t live_bytes_peak = 0;
+  size_t used_bytes_peak = 0;
+  double fragmentation_max = 0.0;
+  double fragmentation_sum = 0.0;
+  uint64_t allocation_num = 0;
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < load_num; i++) {
+    const auto seed = lcg.Next();
+    auto& slot = resident_list[(seed >> 8) % resident_model_num];
+    for (auto ptr : slot.ptr_list) {
+      allocator.Free(ptr);
+    }
+    live_bytes -= slot.bytes;
+    slot = AllocateGltfSceneArrays(gltf_model_shapes[(seed >> 16) % model_shape_num], &allocator);
+    CHECK_EQ(std::count(slot.ptr_list.begin(), slot.ptr_list.end(), nullptr), 0);
+    allocation_num += slot.ptr_list.size();
+    live_bytes += slot.bytes;
+    linear_bytes += slot.bytes;
+    live_bytes_peak = std::max(live_bytes_peak, live_bytes);
+    used_bytes_peak = std::max(used_bytes_peak, allocator.GetUsedSizeInBytes());
+    // ratio of free memory that cannot be handed out as a single block.
+    const auto fragmentation = 1.0 - static_cast<double>(allocator.GetLargestFreeBlockSizeInBytes()) / static_cast<double>(allocator.GetFreeSizeInBytes());
+    fragmentation_max = std::max(fragmentation_max, fragmentation);
+    fragmentation_sum += fragmentation;
+  }
+  const auto duration_msec = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  spdlog::info("scene heap fragmentation benchmark loads:{} allocations:{} {:.2f}ns/allocation (incl. free)", load_num, allocation_num, duration_msec * 1000000.0 / static_cast<double>(allocation_num));
+  spdlog::info("  requested bytes live peak:{} tlsf used peak:{} (overhead {:.2f}%) linear scene arena would need:{}", live_bytes_peak, used_bytes_peak, (static_cast<double>(used_bytes_peak) / static_cast<double>(live_bytes_peak) - 1.0) * 100.0, linear_bytes);
+  spdlog::info("  fragmentation (1 - largest free block / free bytes) avg:{:.4f} max:{:.4f}", fragmentation_sum / load_num, fragmentation_max);
+  for (auto& slot : resident_list) {
+    for (auto ptr : slot.ptr_list) {
+      allocator.Free(ptr);
+    }
+  }
+  CHECK_EQ(allocator.GetUsedSizeInBytes(), 0);
+  CHECK_EQ(allocator.GetLargestFreeBlockSizeInBytes(), allocator.GetFreeSizeInBytes());
+}
@@ -0,0 +1,74 @@
+#include "illuminate/memory/virtual_memory.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+namespace illuminate {
+std::byte* ReserveVirtualMemory(const size_t size_in_bytes) {
+#ifdef _WIN32
+  return static_cast<std::byte*>(VirtualAlloc(nullptr, size_in_bytes, MEM_RESERVE, PAGE_NOACCESS));
+#else
+  auto ptr = mmap(nullptr, size_in_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : static_cast<std::byte*>(ptr);
+#endif
+}
+bool CommitVirtualMemory(std::byte* addr, const size_t size_in_bytes) {
+#ifdef _WIN32
+  return VirtualAlloc(addr, size_in_bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+  return mprotect(addr, size_in_bytes, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+void DecommitVirtualMemory(std::byte* addr, const size_t size_in_bytes) {
+#ifdef _WIN32
+  VirtualFree(addr, size_in_bytes, MEM_DECOMMIT);
+#else
+  madvise(addr, size_in_bytes, MADV_DONTNEED);
+  mprotect(addr, size_in_bytes, PROT_NONE);
+#endif
+}
+void ReleaseVirtualMemory(std::byte* addr, const size_t size_in_bytes) {
+#ifdef _WIN32
+  (void)size_in_bytes;
+  VirtualFree(addr, 0, MEM_RELEASE);
+#else
+  munmap(addr, size_in_bytes);
+#endif
+}
+size_t GetVirtualMemoryPageSize() {
+#ifdef _WIN32
+  SYSTEM_INFO info{};
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+TEST_CASE("virtual memory") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const auto page_size = GetVirtualMemoryPageSize();
+  CHECK_GT(page_size, 0);
+  CHECK_EQ(page_size & (page_size - 1), 0);
+  const size_t reserved_size = 1024 * 1024 * 1024;
+  auto ptr = ReserveVirtualMemory(reserved_size);
+  CHECK_NE(ptr, nullptr);
+  CHECK_UNARY(CommitVirtualMemory(ptr, page_size * 2));
+  ptr[0] = std::byte{1};
+  ptr[page_size * 2 - 1] = std::byte{2};
+  CHECK_EQ(ptr[0], std::byte{1});
+  CHECK_EQ(ptr[page_size * 2 - 1], std::byte{2});
+  // commit is incremental and does not touch preceding pages.
+  CHECK_UNARY(CommitVirtualMemory(ptr, page_size * 4));
+  CHECK_EQ(ptr[0], std::byte{1});
+  CHECK_UNARY(CommitVirtualMemory(ptr + reserved_size - page_size, page_size));
+  ptr[reserved_size - 1] = std::byte{3};
+  CHECK_EQ(ptr[reserved_size - 1], std::byte{3});
+  DecommitVirtualMemory(ptr, page_size * 4);
+  CHECK_UNARY(CommitVirtualMemory(ptr, page_size));
+  CHECK_EQ(ptr[0], std::byte{0});
+  ReleaseVirtualMemory(ptr, reserved_size);
+}
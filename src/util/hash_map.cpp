@@ -4,9 +4,9 @@
 TEST_CASE("hash map") {
   using namespace illuminate;
   const uint32_t buffer_size = 128;
-  std::byte buffer[buffer_size]{};
-  LinearAllocator allocator(buffer, buffer_size);
   const uint32_t table_size = 10;
+  std::byte buffer[buffer_size + HashMap<void*, LinearAllocator>::CalcTableSizeInBytes(table_size)]{};
+  LinearAllocator allocator(buffer, sizeof(buffer));
   struct TestStruct {
     uint32_t a{0}, b{0};
   };
@@ -32,3 +32,189 @@ TEST_CASE("hash map") {
   CHECK_EQ(*static_cast<uint32_t*>(*map2.Get(key)), 10);
   CHECK_EQ(*static_cast<uint32_t*>(*map2.Get(key2)), 101);
 }
+TEST_CASE("hash map collision, erase and growth") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t buffer_size = 64 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(buffer_size);
+  LinearAllocator allocator(buffer.get(), buffer_size);
+  HashMap<uint32_t, LinearAllocator> map(&allocator, 10);
+  const auto initial_capacity = map.GetCapacity();
+  CHECK_GE(initial_capacity, 10);
+  SUBCASE("keys sharing the same slot in a modulo table") {
+    CHECK_UNARY(map.Insert(1, 100));
+    CHECK_UNARY(map.Insert(1 + initial_capacity, 200));
+    CHECK_UNARY(map.Insert(1 + initial_capacity * 2, 300));
+    CHECK_UNARY_FALSE(map.Insert(1, 400));
+    CHECK_EQ(map.GetSize(), 3);
+    CHECK_EQ(*map.Get(1), 100);
+    CHECK_EQ(*map.Get(1 + initial_capacity), 200);
+    CHECK_EQ(*map.Get(1 + initial_capacity * 2), 300);
+    CHECK_EQ(map.Get(1 + initial_capacity * 3), nullptr);
+  }
+  SUBCASE("erase") {
+    CHECK_UNARY(map.Insert(SID("a"), 1));
+    CHECK_UNARY(map.Insert(SID("b"), 2));
+    CHECK_UNARY(map.Erase(SID("a")));
+    CHECK_UNARY_FALSE(map.Erase(SID("a")));
+    CHECK_EQ(map.Get(SID("a")), nullptr);
+    CHECK_EQ(*map.Get(SID("b")), 2);
+    CHECK_EQ(map.GetSize(), 1);
+    CHECK_UNARY(map.Insert(SID("a"), 3));
+    CHECK_EQ(*map.Get(SID("a")), 3);
+    CHECK_EQ(map.GetSize(), 2);
+    // repeated insert/erase must not exhaust the table with tombstones.
+    for (uint32_t i = 0; i < 1000; i++) {
+      CHECK_UNARY(map.InsertCopy(1000 + i, i));
+      CHECK_UNARY(map.Erase(1000 + i));
+    }
+    CHECK_EQ(map.GetSize(), 2);
+    CHECK_EQ(*map.Get(SID("a")), 3);
+    CHECK_EQ(*map.Get(SID("b")), 2);
+  }
+  SUBCASE("growth") {
+    const uint32_t num = 500;
+    const auto first = map.Reserve(0);
+    *first = 12345;
+    for (uint32_t i = 1; i < num; i++) {
+      CHECK_UNARY(map.InsertCopy(CombineHash(i, 7), i));
+    }
+    CHECK_EQ(map.GetSize(), num);
+    CHECK_GT(map.GetCapacity(), initial_capacity);
+    CHECK_GE(map.GetCapacity(), num);
+    // values are not moved on rehash.
+    CHECK_EQ(map.Get(0), first);
+    CHECK_EQ(*map.Get(0), 12345);
+    for (uint32_t i = 1; i < num; i++) {
+      CAPTURE(i);
+      CHECK_EQ(*map.Get(CombineHash(i, 7)), i);
+    }
+    map.Replace(CombineHash(3, 7), 33);
+    CHECK_EQ(*map.Get(CombineHash(3, 7)), 33);
+    map.Replace(num * 3, 44);
+    CHECK_EQ(*map.Get(num * 3), 44);
+  }
+  SUBCASE("allocation failure") {
+    const uint32_t small_buffer_size = 512;
+    std::byte small_buffer[small_buffer_size]{};
+    LinearAllocator small_allocator(small_buffer, small_buffer_size);
+    HashMap<uint32_t, LinearAllocator> small_map(&small_allocator, 1);
+    uint32_t inserted = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+      if (!small_map.InsertCopy(i, i)) { break; }
+      inserted++;
+    }
+    CHECK_LT(inserted, 100);
+    CHECK_EQ(small_map.GetSize(), inserted);
+    for (uint32_t i = 0; i < inserted; i++) {
+      CHECK_EQ(*small_map.Get(i), i);
+    }
+  }
+  SUBCASE("allocation failure with free") {
+    // fails every allocation once the budget is spent and counts live allocations.
+    struct LimitedAllocator {
+      void* Allocate(const size_t bytes, const size_t alignment) {
+        if (allocation_left == 0) { return nullptr; }
+        allocation_left--;
+        live_num++;
+        return allocator->Allocate(bytes, alignment);
+      }
+      void Free(void*, const size_t, const size_t) {
+        live_num--;
+      }
+      LinearAllocator* allocator{nullptr};
+      uint32_t allocation_left{0};
+      uint32_t live_num{0};
+    };
+    LimitedAllocator limited_allocator{.allocator = &allocator, .allocation_left = 1,};
+    HashMap<uint32_t, LimitedAllocator> limited_map(&limited_allocator, 1);
+    CHECK_EQ(limited_allocator.live_num, 1);
+    // value allocation fails.
+    CHECK_UNARY_FALSE(limited_map.InsertCopy(1, 1));
+    CHECK_EQ(limited_map.Reserve(1), nullptr);
+    CHECK_EQ(limited_map.GetSize(), 0);
+    // table growth fails, the value must be released and the table kept.
+    const auto max_load = limited_map.GetCapacity() - limited_map.GetCapacity() / 8;
+    limited_allocator.allocation_left = max_load + 1;
+    for (uint32_t i = 0; i < max_load; i++) {
+      CHECK_UNARY(limited_map.InsertCopy(i, i));
+    }
+    CHECK_UNARY_FALSE(limited_map.InsertCopy(max_load, max_load));
+    CHECK_EQ(limited_map.GetSize(), max_load);
+    CHECK_EQ(limited_allocator.live_num, max_load + 1);
+    for (uint32_t i = 0; i < max_load; i++) {
+      CHECK_EQ(*limited_map.Get(i), i);
+    }
+    for (uint32_t i = 0; i < max_load; i++) {
+      CHECK_UNARY(limited_map.Erase(i));
+    }
+    CHECK_EQ(limited_allocator.live_num, 1);
+  }
+}
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "spdlog/spdlog.h"
+#include "test_util.h"
+namespace {
+// previous HashMap implementation (key % table_size, no collision handling) kept for comparison.
+template <typename T, typename A>
+class ModuloHashMap {
+ public:
+  ModuloHashMap(A* allocator, const uint32_t table_size)
+      : allocator_(allocator)
+      , table_size_(table_size)
+      , table_(illuminate::AllocateArray<T*>(allocator_, table_size_))
+  {
+    for (uint32_t i = 0; i < table_size_; i++) {
+      table_[i] = nullptr;
+    }
+  }
+  const T* Get(const illuminate::StrHash key) const { return table_[key % table_size_]; }
+  bool Insert(const illuminate::StrHash key, T&& val) {
+    auto index = key % table_size_;
+    if (table_[index] != nullptr) { return false; }
+    table_[index] = illuminate::Allocate<T>(allocator_);
+    (*table_[index]) = std::move(val);
+    return true;
+  }
+ private:
+  A* allocator_{nullptr};
+  uint32_t table_size_{0};
+  T** table_{nullptr};
+};
+} // namespace
+TEST_CASE("hash map benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const size_t buffer_size = 256 * 1024 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(buffer_size);
+  LinearAllocator allocator(buffer.get(), buffer_size);
+  for (const uint32_t num : {1000U, 10000U, 100000U, 1000000U}) {
+    std::vector<StrHash> keys(num);
+    std::vector<StrHash> missing_keys(num);
+    for (uint32_t i = 0; i < num; i++) {
+      keys[i] = CalcStrHash(("buffer_" + std::to_string(i)).c_str());
+      missing_keys[i] = CalcStrHash(("missing_" + std::to_string(i)).c_str());
+    }
+    uint64_t sum = 0;
+    allocator.Reset();
+    HashMap<uint32_t, LinearAllocator> map(&allocator);
+    const auto map_insert = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { map.InsertCopy(keys[i], i); } });
+    const auto map_find = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += *map.Get(keys[i]); } });
+    const auto map_miss = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += (map.Get(missing_keys[i]) == nullptr); } });
+    allocator.Reset();
+    ModuloHashMap<uint32_t, LinearAllocator> modulo_map(&allocator, num);
+    uint32_t modulo_map_lost = 0;
+    const auto modulo_insert = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { modulo_map_lost += !modulo_map.Insert(keys[i], uint32_t{i}); } });
+    const auto modulo_find = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { auto v = modulo_map.Get(keys[i]); sum += v ? *v : 0; } });
+    std::unordered_map<StrHash, uint32_t> std_map;
+    const auto std_insert = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { std_map.emplace(keys[i], i); } });
+    const auto std_find = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += std_map.find(keys[i])->second; } });
+    const auto std_miss = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += (std_map.find(missing_keys[i]) == std_map.end()); } });
+    spdlog::info("hash map benchmark num:{} (ns/op)", num);
+    spdlog::info("  HashMap            insert:{:.2f} find:{:.2f} miss:{:.2f} capacity:{}", map_insert, map_find, map_miss, map.GetCapacity());
+    spdlog::info("  modulo table       insert:{:.2f} find:{:.2f} lost:{}", modulo_insert, modulo_find, modulo_map_lost);
+    spdlog::info("  std::unordered_map insert:{:.2f} find:{:.2f} miss:{:.2f}", std_insert, std_find, std_miss);
+    CHECK_EQ(map.GetSize(), std_map.size());
+    CHECK_NE(sum, 0);
+  }
+}
@@ -0,0 +1,122 @@
+#include "illuminate/util/perfect_hash.h"
+#include "doctest/doctest.h"
+namespace {
+enum class TestEnum : uint8_t { kWrap, kMirror, kClamp, kBorder, kMirrorOnce, };
+constexpr auto kTestTable = illuminate::CreatePerfectHashTable<TestEnum>({
+    {"wrap", TestEnum::kWrap},
+    {"mirror", TestEnum::kMirror},
+    {"clamp", TestEnum::kClamp},
+    {"border", TestEnum::kBorder},
+    {"mirror_once", TestEnum::kMirrorOnce},
+  });
+static_assert(kTestTable.GetSize() == 5);
+static_assert(*kTestTable.Find("mirror_once") == TestEnum::kMirrorOnce);
+static_assert(kTestTable.Find("mirror_twice") == nullptr);
+uint32_t TestFunc0() { return 0; }
+uint32_t TestFunc1() { return 1; }
+} // namespace
+TEST_CASE("perfect hash") { // NOLINT
+  using namespace illuminate; // NOLINT
+  SUBCASE("enum") {
+    CHECK_EQ(*kTestTable.Find("wrap"), TestEnum::kWrap);
+    CHECK_EQ(*kTestTable.Find("mirror"), TestEnum::kMirror);
+    CHECK_EQ(*kTestTable.Find("clamp"), TestEnum::kClamp);
+    CHECK_EQ(*kTestTable.Find("border"), TestEnum::kBorder);
+    CHECK_EQ(*kTestTable.Find("mirror_once"), TestEnum::kMirrorOnce);
+    CHECK_EQ(kTestTable.Find(""), nullptr);
+    CHECK_EQ(kTestTable.Find("WRAP"), nullptr);
+    CHECK_EQ(kTestTable.Find("mirro"), nullptr);
+    CHECK_EQ(kTestTable.Find("mirror_"), nullptr);
+    // string_view not pointing to a null-terminated literal.
+    const char buffer[] = "clamp_to_edge";
+    CHECK_EQ(*kTestTable.Find(std::string_view(buffer, 5)), TestEnum::kClamp);
+    CHECK_EQ(*kTestTable.FindKey(TestEnum::kMirrorOnce), "mirror_once");
+    CHECK_EQ(*kTestTable.FindKey(*kTestTable.Find("border")), "border");
+    static_assert(*kTestTable.FindKey(TestEnum::kWrap) == "wrap");
+  }
+  SUBCASE("function pointer") {
+    using Func = uint32_t(*)();
+    constexpr auto table = CreatePerfectHashTable<Func>({{"func0", TestFunc0}, {"func1", TestFunc1}});
+    CHECK_EQ((*table.Find("func0"))(), 0);
+    CHECK_EQ((*table.Find("func1"))(), 1);
+    CHECK_UNARY_FALSE(table.Contains("func2"));
+  }
+  SUBCASE("single entry") {
+    constexpr auto table = CreatePerfectHashTable<uint32_t>({{"a", 1U}});
+    CHECK_EQ(*table.Find("a"), 1);
+    CHECK_EQ(table.Find("b"), nullptr);
+  }
+  SUBCASE("many entries") {
+    constexpr auto table = CreatePerfectHashTable<uint32_t>({
+        {"UNKNOWN", 0U}, {"R32G32B32A32_TYPELESS", 1U}, {"R32G32B32A32_FLOAT", 2U}, {"R32G32B32A32_UINT", 3U},
+        {"R32G32B32A32_SINT", 4U}, {"R32G32B32_TYPELESS", 5U}, {"R32G32B32_FLOAT", 6U}, {"R32G32B32_UINT", 7U},
+        {"R32G32B32_SINT", 8U}, {"R16G16B16A16_TYPELESS", 9U}, {"R16G16B16A16_FLOAT", 10U}, {"R16G16B16A16_UNORM", 11U},
+        {"R16G16B16A16_UINT", 12U}, {"R16G16B16A16_SNORM", 13U}, {"R16G16B16A16_SINT", 14U}, {"R32G32_TYPELESS", 15U},
+        {"R32G32_FLOAT", 16U}, {"R32G32_UINT", 17U}, {"R32G32_SINT", 18U}, {"R8G8B8A8_UNORM", 28U},
+        {"R8G8B8A8_SNORM", 31U}, {"D24_UNORM_S8_UINT", 45U}, {"R32_UINT", 42U}, {"R32_FLOAT", 41U},
+        {"R8_UNORM", 61U}, {"B8G8R8A8_UNORM", 87U},
+      });
+    CHECK_EQ(table.GetSize(), 26);
+    CHECK_EQ(*table.Find("UNKNOWN"), 0);
+    CHECK_EQ(*table.Find("R16G16B16A16_SINT"), 14);
+    CHECK_EQ(*table.Find("R32G32_FLOAT"), 16);
+    CHECK_EQ(*table.Find("B8G8R8A8_UNORM"), 87);
+    CHECK_EQ(table.Find("B8G8R8A8_UNORM_SRGB"), nullptr);
+  }
+  SUBCASE("sid") {
+    static_assert(CompileTimeStrHash(std::string_view("mirror_once")) == SID("mirror_once"));
+    CHECK_EQ(CompileTimeStrHash(std::string_view("mirror_once")), CalcStrHash("mirror_once"));
+    CHECK_EQ(CompileTimeStrHash(std::string_view("")), CalcStrHash(""));
+  }
+}
+#include <cstring>
+#include <string>
+#include <vector>
+#include "spdlog/spdlog.h"
+#include "test_util.h"
+namespace {
+const char* const kBenchmarkFormatList[] = {
+  "UNKNOWN", "R16G16B16A16_FLOAT", "B8G8R8A8_UNORM", "R8G8B8A8_UNORM", "R8G8B8A8_SNORM", "D24_UNORM_S8_UINT",
+  "R32G32B32_FLOAT", "R32G32_FLOAT", "R32G32B32A32_FLOAT", "R32_UINT", "R32_FLOAT", "R8_UNORM",
+};
+// same structure as the former GetDxgiFormat.
+uint32_t GetFormatIndexByCompare(const std::string_view& str) {
+  for (uint32_t i = 0; i < std::size(kBenchmarkFormatList); i++) {
+    if (str.compare(kBenchmarkFormatList[i]) == 0) { return i; }
+  }
+  return 0;
+}
+constexpr auto kBenchmarkFormatTable = illuminate::CreatePerfectHashTable<uint32_t>({
+    {"UNKNOWN", 0U}, {"R16G16B16A16_FLOAT", 1U}, {"B8G8R8A8_UNORM", 2U}, {"R8G8B8A8_UNORM", 3U}, {"R8G8B8A8_SNORM", 4U}, {"D24_UNORM_S8_UINT", 5U},
+    {"R32G32B32_FLOAT", 6U}, {"R32G32_FLOAT", 7U}, {"R32G32B32A32_FLOAT", 8U}, {"R32_UINT", 9U}, {"R32_FLOAT", 10U}, {"R8_UNORM", 11U},
+  });
+TestEnum GetTestEnumByStrcmp(const char* const str) {
+  if (strcmp(str, "wrap") == 0) { return TestEnum::kWrap; }
+  if (strcmp(str, "mirror") == 0) { return TestEnum::kMirror; }
+  if (strcmp(str, "clamp") == 0) { return TestEnum::kClamp; }
+  if (strcmp(str, "border") == 0) { return TestEnum::kBorder; }
+  if (strcmp(str, "mirror_once") == 0) { return TestEnum::kMirrorOnce; }
+  return TestEnum::kWrap;
+}
+} // namespace
+TEST_CASE("perfect hash benchmark" * doctest::skip()) { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t num = 1000000;
+  // json strings are passed as std::string_view with a known length.
+  const std::vector<std::string> address_mode_list{"wrap", "mirror", "clamp", "border", "mirror_once"};
+  std::vector<std::string_view> address_mode_input(num);
+  std::vector<std::string_view> format_input(num);
+  for (uint32_t i = 0; i < num; i++) {
+    address_mode_input[i] = address_mode_list[(i * 7) % address_mode_list.size()];
+    format_input[i] = kBenchmarkFormatList[(i * 7) % std::size(kBenchmarkFormatList)];
+  }
+  uint64_t sum = 0;
+  const auto address_mode_strcmp = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += static_cast<uint64_t>(GetTestEnumByStrcmp(address_mode_input[i].data())); } });
+  const auto address_mode_table = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += static_cast<uint64_t>(*kTestTable.Find(address_mode_input[i])); } });
+  const auto format_compare = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += GetFormatIndexByCompare(format_input[i]); } });
+  const auto format_table = MeasureTimePerOp<std::nano>(num, [&]() { for (uint32_t i = 0; i < num; i++) { sum += *kBenchmarkFormatTable.Find(format_input[i]); } });
+  spdlog::info("perfect hash benchmark (ns/op)");
+  spdlog::info("  address mode(5)  strcmp chain:{:.2f} PerfectHashTable:{:.2f}", address_mode_strcmp, address_mode_table);
+  spdlog::info("  dxgi format(12)  compare chain:{:.2f} PerfectHashTable:{:.2f}", format_compare, format_table);
+  CHECK_NE(sum, 0);
+}
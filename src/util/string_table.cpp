@@ -0,0 +1,145 @@
+#include "illuminate/util/string_table.h"
+#include <cstdlib>
+#include <mutex>
+#include "illuminate/memory/tlsf_allocator.h"
+#include "illuminate/memory/virtual_memory.h"
+#include "spdlog/spdlog.h"
+namespace illuminate {
+namespace {
+// names live in their own reserved range so that they survive ResetAllocation() of every MemoryType.
+// pages are committed as the table grows and previous hash tables are returned to the tlsf pool on rehash.
+static const size_t global_string_table_reserved_size_in_bytes = 256 * 1024 * 1024;
+static const size_t global_string_table_commit_granularity_in_bytes = 64 * 1024;
+class GlobalStringTableAllocator {
+ public:
+  GlobalStringTableAllocator()
+      : buffer_(ReserveVirtualMemory(global_string_table_reserved_size_in_bytes))
+      , allocator_(CommitBuffer(buffer_, global_string_table_commit_granularity_in_bytes), global_string_table_commit_granularity_in_bytes)
+  {}
+  void* Allocate(const size_t bytes, const size_t alignment_in_bytes) {
+    if (auto ptr = allocator_.Allocate(bytes, alignment_in_bytes); ptr != nullptr) { return ptr; }
+    if (!Grow(allocator_.GetBufferSizeInByte() + bytes + alignment_in_bytes + sizeof(size_t) * 8)) { return nullptr; }
+    return allocator_.Allocate(bytes, alignment_in_bytes);
+  }
+  void Free(void* ptr, const size_t bytes, const size_t alignment_in_bytes) {
+    allocator_.Free(ptr, bytes, alignment_in_bytes);
+  }
+ private:
+  static std::byte* CommitBuffer(std::byte* buffer, const size_t size_in_bytes) {
+    if (buffer == nullptr || !CommitVirtualMemory(buffer, size_in_bytes)) { return nullptr; }
+    return buffer;
+  }
+  bool Grow(const size_t size_in_bytes) {
+    const auto committed_size = allocator_.GetBufferSizeInByte();
+    const auto new_committed_size = AlignAddress(size_in_bytes, global_string_table_commit_granularity_in_bytes);
+    if (new_committed_size > global_string_table_reserved_size_in_bytes) { return false; }
+    if (!CommitVirtualMemory(buffer_ + committed_size, new_committed_size - committed_size)) { return false; }
+    return allocator_.Grow(new_committed_size);
+  }
+  std::byte* const buffer_;
+  TlsfAllocator allocator_;
+};
+struct GlobalStringTable {
+  std::mutex mutex;
+  GlobalStringTableAllocator allocator;
+  StringTable<GlobalStringTableAllocator> table{&allocator};
+};
+auto GetGlobalStringTable() {
+  static GlobalStringTable table;
+  return &table;
+}
+} // namespace
+const char* InternString(const std::string_view str) {
+  return InternString(str, CalcStrHash(str));
+}
+const char* InternString(const std::string_view str, const StrHash hash) {
+  auto global_table = GetGlobalStringTable();
+  std::lock_guard<std::mutex> lock(global_table->mutex);
+  auto interned = global_table->table.Intern(str, hash);
+  if (interned != nullptr) { return interned; }
+  // names are looked up by hash only, so handing out either string would silently alias two names.
+  if (auto registered = global_table->table.Find(hash); registered != nullptr) {
+    spdlog::critical("string hash collision. hash:{} registered:{} new:{}", hash, registered, str);
+  } else {
+    spdlog::critical("global string table allocation failed. str:{} pool size:{}", str, global_table->table.GetPoolSizeInBytes());
+  }
+  std::abort();
+}
+const char* GetInternedString(const StrHash hash) {
+  auto global_table = GetGlobalStringTable();
+  std::lock_guard<std::mutex> lock(global_table->mutex);
+  return global_table->table.Find(hash);
+}
+} // namespace illuminate
+#include "doctest/doctest.h"
+TEST_CASE("string table") { // NOLINT
+  using namespace illuminate;
+  const uint32_t buffer_size = 4096;
+  std::byte buffer[buffer_size]{};
+  LinearAllocator allocator(buffer, buffer_size);
+  const uint32_t page_size = 64;
+  StringTable<LinearAllocator> table(&allocator, page_size, 4);
+  CHECK_EQ(table.GetSize(), 0);
+  CHECK_EQ(table.Find(SID("primary")), nullptr);
+  auto primary = table.Intern("primary");
+  CHECK_NE(primary, nullptr);
+  CHECK_EQ(std::string_view(primary), "primary");
+  CHECK_EQ(table.Intern("primary"), primary);
+  CHECK_EQ(table.Intern(std::string_view("primary_buffer", 7)), primary);
+  CHECK_EQ(table.Find(SID("primary")), primary);
+  CHECK_EQ(table.GetSize(), 1);
+  CHECK_EQ(table.GetPoolSizeInBytes(), 8);
+  auto swapchain = table.Intern("swapchain");
+  CHECK_NE(swapchain, primary);
+  CHECK_EQ(table.Find(SID("swapchain")), swapchain);
+  CHECK_EQ(std::string_view(table.Find(SID("primary"))), "primary");
+  // strings are packed in the same page.
+  CHECK_EQ(swapchain, primary + 8);
+  CHECK_EQ(table.Intern(""), table.Find(SID("")));
+  CHECK_EQ(std::string_view(table.Find(SID(""))), "");
+  // a different string registered with an existing hash is rejected.
+  CHECK_EQ(table.Intern("not primary", SID("primary")), nullptr);
+  CHECK_EQ(table.Find(SID("primary")), primary);
+  // long strings and table growth.
+  const char long_str[] = "a string longer than a quarter of the page size";
+  auto long_interned = table.Intern(long_str);
+  CHECK_EQ(std::string_view(long_interned), long_str);
+  CHECK_EQ(table.Find(SID(long_str)), long_interned);
+  char name[] = "name_0";
+  for (char c = '0'; c <= '9'; c++) {
+    name[5] = c;
+    CHECK_NE(table.Intern(name), nullptr);
+  }
+  CHECK_EQ(table.GetSize(), 14);
+  CHECK_EQ(std::string_view(table.Find(SID("name_7"))), "name_7");
+  CHECK_EQ(table.Find(SID("primary")), primary);
+  CHECK_EQ(table.Find(SID("swapchain")), swapchain);
+}
+TEST_CASE("global string table") { // NOLINT
+  using namespace illuminate;
+  auto str = InternString("global string table test");
+  CHECK_EQ(std::string_view(str), "global string table test");
+  CHECK_EQ(InternString("global string table test"), str);
+  CHECK_EQ(InternString("global string table test", SID("global string table test")), str);
+  CHECK_EQ(GetInternedString(SID("global string table test")), str);
+  CHECK_EQ(GetInternedString(SID("global string table test not interned")), nullptr);
+}
+TEST_CASE("global string table growth") { // NOLINT
+  using namespace illuminate;
+  // interns more names than the initially committed range holds.
+  const uint32_t num = 20000;
+  auto first = InternString("global string table growth 0");
+  auto interned_before_growth = InternString("global string table growth interned before growth");
+  char name[64]{};
+  for (uint32_t i = 0; i < num; i++) {
+    const auto len = snprintf(name, sizeof(name), "global string table growth %u", i);
+    CHECK_NE(InternString(std::string_view(name, static_cast<size_t>(len))), nullptr);
+  }
+  for (uint32_t i = 0; i < num; i += 97) {
+    const auto len = snprintf(name, sizeof(name), "global string table growth %u", i);
+    CAPTURE(i);
+    CHECK_EQ(std::string_view(GetInternedString(CalcStrHash(std::string_view(name, static_cast<size_t>(len))))), name);
+  }
+  CHECK_EQ(InternString("global string table growth 0"), first);
+  CHECK_EQ(GetInternedString(SID("global string table growth interned before growth")), interned_before_growth);
+}
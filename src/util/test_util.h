@@ -0,0 +1,29 @@
+#ifndef ILLUMINATE_UTIL_TEST_UTIL_H
+#define ILLUMINATE_UTIL_TEST_UTIL_H
+// helpers shared by the doctest cases and benchmarks in sources.
+#include <chrono>
+#include <cstdint>
+namespace illuminate {
+// runs f() once and returns the elapsed time per op in Period units (e.g. std::nano, std::micro).
+template <typename Period, typename F>
+auto MeasureTimePerOp(const uint32_t op_num, F&& f) {
+  const auto start = std::chrono::high_resolution_clock::now();
+  f();
+  const auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, Period>(end - start).count() / op_num;
+}
+// deterministic linear congruential generator for seeded test data and benchmarks.
+class Lcg {
+ public:
+  explicit Lcg(const uint32_t seed) : state_(seed) {}
+  uint32_t Next() {
+    state_ = state_ * 1664525U + 1013904223U;
+    return state_;
+  }
+  // [0, max) from the upper bits, the lower ones have short periods.
+  uint32_t Next(const uint32_t max) { return (Next() >> 8) % max; }
+ private:
+  uint32_t state_;
+};
+} // namespace illuminate
+#endif
@@ -1,4 +1,5 @@
 #include "illuminate/memory/memory_allocation.h"
+#include "illuminate/util/hash_map.h"
 #include "doctest/doctest.h"
 TEST_CASE("LinearAllocator") { // NOLINT
   using namespace illuminate; // NOLINT
@@ -269,3 +270,293 @@ TEST_CASE("DoubleEndedLinearAllocator tail") { // NOLINT
   CHECK_EQ(allocator.GetOffsetHigher(), 72);
   CHECK_EQ(allocator.GetBufferSizeInByte(), size_in_byte);
 }
+TEST_CASE("DoubleEndedLinearAllocator marker") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t size_in_byte = 128;
+  std::byte buffer[size_in_byte]{};
+  DoubleEndedLinearAllocator allocator(buffer, size_in_byte);
+  size_t offset_before = ~0U;
+  auto tail = allocator.AllocateHigher(8, kDefaultAlignmentSize, &offset_before);
+  CHECK_EQ(offset_before, 0);
+  CHECK_EQ(allocator.GetOffsetHigherAt(tail), 8);
+  auto tail2 = allocator.AllocateHigher(4, kDefaultAlignmentSize, &offset_before);
+  CHECK_EQ(offset_before, 8);
+  CHECK_EQ(allocator.GetOffsetHigherAt(tail2), 16);
+  CHECK_EQ(allocator.GetOffsetHigher(), 16);
+  CHECK_UNARY_FALSE(allocator.ResetHigherToMarker(8, 8));
+  CHECK_EQ(allocator.GetOffsetHigher(), 16);
+  CHECK_UNARY(allocator.ResetHigherToMarker(8, 16));
+  CHECK_EQ(allocator.GetOffsetHigher(), 8);
+  allocator.AllocateLower(10);
+  CHECK_UNARY_FALSE(allocator.ResetLowerToMarker(0, 8));
+  CHECK_UNARY(allocator.ResetLowerToMarker(0, 10));
+  CHECK_EQ(allocator.GetOffsetLower(), 0);
+  CHECK_EQ(allocator.GetOffsetHigher(), 8);
+  {
+    DoubleEndedLinearAllocatorJanitor janitor(&allocator);
+    CHECK_EQ(janitor.GetMarker(), 8);
+    auto a = janitor.Allocate(16);
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(a), reinterpret_cast<std::uintptr_t>(buffer) + size_in_byte - 24);
+    {
+      DoubleEndedLinearAllocatorJanitor inner_janitor(&allocator);
+      inner_janitor.Allocate(32);
+      CHECK_EQ(allocator.GetOffsetHigher(), 56);
+    }
+    CHECK_EQ(allocator.GetOffsetHigher(), 24);
+    CHECK_EQ(janitor.Allocate(8), reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(a) - 8));
+  }
+  CHECK_EQ(allocator.GetOffsetHigher(), 8);
+  {
+    // allocations followed by other users of the higher end are kept.
+    DoubleEndedLinearAllocatorJanitor janitor(&allocator);
+    janitor.Allocate(8);
+    allocator.AllocateHigher(8);
+    CHECK_EQ(allocator.GetOffsetHigher(), 24);
+  }
+  CHECK_EQ(allocator.GetOffsetHigher(), 24);
+  {
+    // allocations preceded by other users of the higher end are returned up to them.
+    DoubleEndedLinearAllocatorJanitor janitor(&allocator);
+    allocator.AllocateHigher(8);
+    janitor.Allocate(8);
+    janitor.Allocate(8);
+    CHECK_EQ(allocator.GetOffsetHigher(), 48);
+  }
+  CHECK_EQ(allocator.GetOffsetHigher(), 32);
+}
+TEST_CASE("PoolAllocator") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t size_in_byte = 4096;
+  std::byte buffer[size_in_byte]{};
+  LinearAllocator parent(buffer, size_in_byte);
+  struct TestStruct {
+    uint64_t a{0}, b{0}, c{0};
+  };
+  const uint32_t block_num_per_page = 4;
+  PoolAllocator<TestStruct, LinearAllocator> allocator(&parent, block_num_per_page);
+  TestStruct* ptr[block_num_per_page * 2]{};
+  for (uint32_t i = 0; i < block_num_per_page * 2; i++) {
+    ptr[i] = Allocate<TestStruct>(&allocator);
+    CHECK_NE(ptr[i], nullptr);
+    ptr[i]->a = i;
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(ptr[i]) % alignof(TestStruct), 0);
+  }
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), block_num_per_page * 2);
+  CHECK_EQ(allocator.GetPageNum(), 2);
+  for (uint32_t i = 0; i < block_num_per_page * 2; i++) {
+    CAPTURE(i);
+    CHECK_EQ(ptr[i]->a, i);
+  }
+  // freed blocks are reused in LIFO order without touching the parent.
+  const auto parent_offset = parent.GetOffset();
+  Free(&allocator, ptr[3]);
+  Free(&allocator, ptr[5]);
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), block_num_per_page * 2 - 2);
+  CHECK_EQ(Allocate<TestStruct>(&allocator), ptr[5]);
+  CHECK_EQ(Allocate<TestStruct>(&allocator), ptr[3]);
+  CHECK_EQ(parent.GetOffset(), parent_offset);
+  CHECK_EQ(ptr[0]->a, 0);
+  CHECK_EQ(ptr[7]->a, 7);
+  // pages are kept on reset.
+  allocator.Reset();
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), 0);
+  CHECK_EQ(Allocate<TestStruct>(&allocator), ptr[0]);
+  for (uint32_t i = 1; i < block_num_per_page * 2; i++) {
+    Allocate<TestStruct>(&allocator);
+  }
+  CHECK_EQ(parent.GetOffset(), parent_offset);
+  CHECK_EQ(allocator.GetPageNum(), 2);
+  Allocate<TestStruct>(&allocator);
+  CHECK_GT(parent.GetOffset(), parent_offset);
+  CHECK_EQ(allocator.GetPageNum(), 3);
+}
+TEST_CASE("PoolAllocator parent exhaustion") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t size_in_byte = 256;
+  std::byte buffer[size_in_byte]{};
+  LinearAllocator parent(buffer, size_in_byte);
+  PoolAllocator<uint64_t, LinearAllocator> allocator(&parent, 8);
+  uint32_t allocated_num = 0;
+  while (allocator.Allocate() != nullptr) {
+    allocated_num++;
+  }
+  CHECK_GT(allocated_num, 0);
+  CHECK_LT(allocated_num, size_in_byte / sizeof(uint64_t));
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), allocated_num);
+}
+TEST_CASE("PoolAllocator oversized requests") { // NOLINT
+  using namespace illuminate; // NOLINT
+  const uint32_t size_in_byte = 64 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(size_in_byte);
+  LinearAllocator parent(buffer.get(), size_in_byte);
+  struct TestStruct {
+    uint32_t a{0}, b{0};
+  };
+  PoolAllocator<TestStruct, LinearAllocator> allocator(&parent, 16);
+  // requests larger than a block go to the parent and never enter the free list.
+  auto large = allocator.Allocate(sizeof(TestStruct) * 4);
+  CHECK_NE(large, nullptr);
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), 0);
+  CHECK_EQ(allocator.GetPageNum(), 0);
+  allocator.Free(large, sizeof(TestStruct) * 4);
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), 0);
+  CHECK_NE(Allocate<TestStruct>(&allocator), large);
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), 1);
+  allocator.Reset();
+  // values come from the pool while tables come from the parent.
+  HashMap<TestStruct, PoolAllocator<TestStruct, LinearAllocator>> map(&allocator, 4);
+  const uint32_t num = 200;
+  for (uint32_t i = 0; i < num; i++) {
+    CHECK_UNARY(map.Insert(i, TestStruct{i, i * 2}));
+  }
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), num);
+  for (uint32_t i = 0; i < num; i++) {
+    CAPTURE(i);
+    CHECK_EQ(map.Get(i)->b, i * 2);
+  }
+  for (uint32_t i = 0; i < num; i += 2) {
+    CHECK_UNARY(map.Erase(i));
+  }
+  CHECK_EQ(allocator.GetAllocatedBlockNum(), num / 2);
+  for (uint32_t i = 1; i < num; i += 2) {
+    CHECK_EQ(map.Get(i)->a, i);
+  }
+}
+TEST_CASE("SlabAllocator") { // NOLINT
+  using namespace illuminate; // NOLINT
+  using Slab = SlabAllocator<LinearAllocator>;
+  CHECK_EQ(Slab::GetSizeClass(1, 8), 0);
+  CHECK_EQ(Slab::GetSizeClass(16, 8), 0);
+  CHECK_EQ(Slab::GetSizeClass(17, 8), 1);
+  CHECK_EQ(Slab::GetSizeClass(8, 64), 2);
+  CHECK_EQ(Slab::GetSizeClass(256, 8), 4);
+  CHECK_EQ(Slab::GetSizeClass(257, 8), Slab::kSizeClassNum);
+  const uint32_t size_in_byte = 256 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(size_in_byte);
+  LinearAllocator parent(buffer.get(), size_in_byte);
+  Slab allocator(&parent, 4096);
+  SUBCASE("size classes") {
+    for (const size_t size : {1U, 16U, 24U, 48U, 100U, 200U, 256U}) {
+      CAPTURE(size);
+      auto a = allocator.Allocate(size);
+      auto b = allocator.Allocate(size);
+      CHECK_NE(a, nullptr);
+      CHECK_NE(b, nullptr);
+      const auto block_size = Slab::kMinBlockSize << Slab::GetSizeClass(size, kDefaultAlignmentSize);
+      CHECK_EQ(reinterpret_cast<std::uintptr_t>(a) % block_size, 0);
+      CHECK_EQ(reinterpret_cast<std::uintptr_t>(b) % block_size, 0);
+      const auto addr_a = reinterpret_cast<std::uintptr_t>(a);
+      const auto addr_b = reinterpret_cast<std::uintptr_t>(b);
+      CHECK_EQ(addr_a > addr_b ? addr_a - addr_b : addr_b - addr_a, block_size);
+      CHECK_EQ(allocator.GetAllocatedBlockNum(Slab::GetSizeClass(size, kDefaultAlignmentSize)), 2);
+      allocator.Free(a, size);
+      CHECK_EQ(allocator.Allocate(size), a);
+      allocator.Free(a, size);
+      allocator.Free(b, size);
+      CHECK_EQ(allocator.GetAllocatedBlockNum(Slab::GetSizeClass(size, kDefaultAlignmentSize)), 0);
+    }
+  }
+  SUBCASE("large allocation goes to parent") {
+    const auto offset = parent.GetOffset();
+    auto ptr = allocator.Allocate(1024, 16);
+    CHECK_NE(ptr, nullptr);
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(ptr) % 16, 0);
+    CHECK_GE(parent.GetOffset(), offset + 1024);
+    allocator.Free(ptr, 1024, 16);
+  }
+  SUBCASE("HashMap") {
+    HashMap<uint64_t, Slab> map(&allocator);
+    const uint32_t num = 1000;
+    for (uint32_t loop = 0; loop < 4; loop++) {
+      for (uint32_t i = 0; i < num; i++) {
+        CHECK_UNARY(map.InsertCopy(i + 1, uint64_t{i} * 3));
+      }
+      for (uint32_t i = 0; i < num; i++) {
+        CHECK_EQ(*map.Get(i + 1), uint64_t{i} * 3);
+      }
+      for (uint32_t i = 0; i < num; i++) {
+        CHECK_UNARY(map.Erase(i + 1));
+      }
+      CHECK_EQ(map.GetSize(), 0);
+      // erased values are returned to the slab.
+      CHECK_EQ(allocator.GetAllocatedBlockNum(Slab::GetSizeClass(sizeof(uint64_t), kDefaultAlignmentSize)), 0);
+    }
+  }
+}
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "spdlog/spdlog.h"
+namespace {
+template <size_t N>
+struct BenchmarkObject {
+  std::byte data[N];
+};
+template <size_t N>
+void RunPoolAllocatorBenchmark(const uint32_t live_object_num, const uint32_t op_num) {
+  using namespace illuminate; // NOLINT
+  // same random sequence of alloc/free for both allocators.
+  std::mt19937 rng(N);
+  std::vector<uint32_t> slot_list(op_num);
+  for (auto& slot : slot_list) {
+    slot = rng() % live_object_num;
+  }
+  std::vector<void*> live(live_object_num, nullptr);
+  const auto malloc_start = std::chrono::high_resolution_clock::now();
+  for (const auto slot : slot_list) {
+    if (live[slot] == nullptr) {
+      live[slot] = malloc(N);
+      static_cast<std::byte*>(live[slot])[0] = std::byte{1};
+    } else {
+      free(live[slot]);
+      live[slot] = nullptr;
+    }
+  }
+  const auto malloc_end = std::chrono::high_resolution_clock::now();
+  for (auto& ptr : live) {
+    free(ptr);
+    ptr = nullptr;
+  }
+  const size_t parent_size_in_bytes = 64 * 1024 * 1024;
+  auto buffer = std::make_unique<std::byte[]>(parent_size_in_bytes);
+  LinearAllocator parent(buffer.get(), parent_size_in_bytes);
+  PoolAllocator<BenchmarkObject<N>, LinearAllocator> pool(&parent, 256);
+  const auto pool_start = std::chrono::high_resolution_clock::now();
+  for (const auto slot : slot_list) {
+    if (live[slot] == nullptr) {
+      live[slot] = pool.Allocate(N);
+      static_cast<std::byte*>(live[slot])[0] = std::byte{1};
+    } else {
+      pool.Free(live[slot]);
+      live[slot] = nullptr;
+    }
+  }
+  const auto pool_end = std::chrono::high_resolution_clock::now();
+  std::fill(live.begin(), live.end(), nullptr);
+  parent.Reset();
+  SlabAllocator<LinearAllocator> slab(&parent);
+  const auto slab_start = std::chrono::high_resolution_clock::now();
+  for (const auto slot : slot_list) {
+    if (live[slot] == nullptr) {
+      live[slot] = slab.Allocate(N);
+      static_cast<std::byte*>(live[slot])[0] = std::byte{1};
+    } else {
+      slab.Free(live[slot], N);
+      live[slot] = nullptr;
+    }
+  }
+  const auto slab_end = std::chrono::high_resolution_clock::now();
+  const auto to_nsec_per_op = [op_num](const auto& start, const auto& end) { return std::chrono::duration<double, std::nano>(end - start).count() / op_num; };
+  spdlog::info("pool allocator benchmark size:{:3} malloc:{:.2f}ns/op PoolAllocator:{:.2f}ns/op SlabAllocator:{:.2f}ns/op", N, to_nsec_per_op(malloc_start, malloc_end), to_nsec_per_op(pool_start, pool_end), to_nsec_per_op(slab_start, slab_end));
+}
+} // namespace
+TEST_CASE("PoolAllocator benchmark" * doctest::skip()) { // NOLINT
+  const uint32_t live_object_num = 64 * 1024;
+  const uint32_t op_num = 4 * 1024 * 1024;
+  RunPoolAllocatorBenchmark<16>(live_object_num, op_num);
+  RunPoolAllocatorBenchmark<32>(live_object_num, op_num);
+  RunPoolAllocatorBenchmark<64>(live_object_num, op_num);
+  RunPoolAllocatorBenchmark<128>(live_object_num, op_num);
+  RunPoolAllocatorBenchmark<256>(live_object_num, op_num);
+}